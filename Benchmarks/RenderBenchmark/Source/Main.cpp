@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    Offscreen render benchmark for the analyzer's SpectrumDisplay.
+
+    Usage: RenderBenchmark [--quick] [--tracks <n,n,...>] [--frames <n>] [--native]
+                           [--images <dir>] [--json <file>] [--compare <file>]
+
+      --quick           20 frames per case instead of 100
+      --tracks <list>   comma separated track counts (default 1,8,32)
+      --frames <n>      frames painted per case
+      --native          paint into the platform's native image type rather than
+                        JUCE's software renderer
+      --images <dir>    save the last frame of every case as PNG
+      --json <file>     save all metrics for later comparison
+      --compare <file>  print changes relative to a previously saved report
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "RenderBenchmarks.h"
+#include <iostream>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << "Usage: " << args.executableName
+                  << " [--quick] [--tracks <n,n,...>] [--frames <n>] [--native] [--images <dir>]"
+                     " [--json <file>] [--compare <file>]" << std::endl;
+        return 0;
+    }
+
+    // Components need a message manager, even though nothing goes on screen
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    RenderBenchmarkOptions options;
+    if (args.containsOption ("--quick"))
+        options.framesPerCase = 20;
+
+    if (args.containsOption ("--frames"))
+        options.framesPerCase = juce::jmax (1, args.getValueForOption ("--frames").getIntValue());
+
+    if (args.containsOption ("--tracks"))
+    {
+        options.trackCounts.clear();
+        for (const auto& count : juce::StringArray::fromTokens (args.getValueForOption ("--tracks"), ",", {}))
+            if (count.getIntValue() > 0)
+                options.trackCounts.push_back (count.getIntValue());
+    }
+
+    options.useNativeImages = args.containsOption ("--native");
+
+    if (args.containsOption ("--images"))
+        options.imageDirectory = args.getFileForOption ("--images");
+
+    std::cout << juce::SystemStats::getCpuModel() << ", " << juce::SystemStats::getOperatingSystemName()
+              << (options.useNativeImages ? ", native images" : ", software renderer") << std::endl;
+
+    BenchmarkReport report;
+    runRenderBenchmarks (report, options);
+
+    if (args.containsOption ("--json"))
+    {
+        auto file = args.getFileForOption ("--json");
+        if (! report.saveJson (file))
+            std::cout << "Failed to write " << file.getFullPathName() << std::endl;
+    }
+
+    if (args.containsOption ("--compare"))
+    {
+        auto file = args.getFileForOption ("--compare");
+        if (file.existsAsFile())
+            report.compareWith (file);
+        else
+            std::cout << "No previous report at " << file.getFullPathName() << std::endl;
+    }
+
+    return report.getNumFailedChecks() == 0 ? 0 : 1;
+}
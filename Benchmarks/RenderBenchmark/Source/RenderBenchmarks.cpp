@@ -0,0 +1,199 @@
+#include "RenderBenchmarks.h"
+#include "../../../MultitrackSpectrumAnalyzer/Source/SpectrumDisplay.h"
+#include "../../../MultitrackSpectrumAnalyzer/Source/PerfCounters.h"
+#include <iostream>
+
+namespace
+{
+    constexpr double sampleRate = 48000.0;
+    constexpr int numVariations = 16;  // Spectra per track, cycled frame by frame
+    constexpr int warmUpFrames = 5;
+
+    double ticksToMilliseconds(juce::int64 ticks)
+    {
+        return 1000.0 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    }
+
+    /// Precomputed spectra for one synthetic track, so generating them stays out of the timings.
+    struct SyntheticTrack
+    {
+        juce::String trackId;
+        juce::String trackName;
+        std::vector<std::vector<float>> spectra;
+    };
+
+    /// Pink-ish noise floor with a harmonic series on a per-track fundamental, so curves
+    /// have both broad shape and narrow peaks like real material.
+    SyntheticTrack makeSyntheticTrack(int index, int numTracks, juce::Random& random)
+    {
+        SyntheticTrack track;
+        track.trackId = "render-benchmark-" + juce::String(index);
+        track.trackName = "Track " + juce::String(index + 1);
+
+        const double position = numTracks > 1 ? index / static_cast<double>(numTracks - 1) : 0.5;
+        const double fundamental = 40.0 * std::pow(100.0, position);  // 40 Hz .. 4 kHz
+        const double binWidth = sampleRate / SpectrumConstants::FFT_SIZE;
+
+        for (int variation = 0; variation < numVariations; ++variation)
+        {
+            std::vector<float> magnitudes(static_cast<size_t>(SpectrumConstants::NUM_BINS));
+
+            for (int bin = 0; bin < SpectrumConstants::NUM_BINS; ++bin)
+            {
+                const double frequency = juce::jmax(binWidth, bin * binWidth);
+                double db = -35.0 - 3.0 * std::log2(frequency / 1000.0) + (random.nextDouble() - 0.5) * 6.0;
+
+                for (int harmonic = 1; harmonic <= 8; ++harmonic)
+                {
+                    const double distance = std::abs(frequency - fundamental * harmonic) / binWidth;
+                    if (distance < 2.0)
+                        db = juce::jmax(db, -12.0 - 3.0 * harmonic - 6.0 * distance);
+                }
+
+                magnitudes[static_cast<size_t>(bin)] = juce::Decibels::decibelsToGain(static_cast<float>(juce::jlimit(-120.0, 0.0, db)));
+            }
+
+            track.spectra.push_back(std::move(magnitudes));
+        }
+
+        return track;
+    }
+
+    juce::String getModeName(DisplayMode mode)
+    {
+        switch (mode)
+        {
+            case DisplayMode::Overlay: return "Overlay";
+            case DisplayMode::Stacked: return "Stacked";
+            case DisplayMode::Summed:  return "Summed";
+        }
+
+        return {};
+    }
+
+    juce::String getScalingName(DbScaling scaling)
+    {
+        return scaling == DbScaling::Linear ? "Linear" : "Compressed";
+    }
+
+    void saveImage(const juce::Image& image, const juce::File& file)
+    {
+        file.deleteFile();
+
+        juce::FileOutputStream stream(file);
+        juce::PNGImageFormat png;
+
+        if (!stream.openedOk() || !png.writeImageToStream(image, stream))
+            std::cout << "Failed to write " << file.getFullPathName() << std::endl;
+    }
+}
+
+void runRenderBenchmarks(BenchmarkReport& report, const RenderBenchmarkOptions& options)
+{
+    const std::array<juce::Point<int>, 3> sizes { { { 800, 600 }, { 1920, 1080 }, { 3840, 2160 } } };
+    const std::array<DisplayMode, 3> modes { DisplayMode::Overlay, DisplayMode::Stacked, DisplayMode::Summed };
+    const std::array<DbScaling, 2> scalings { DbScaling::Linear, DbScaling::Compressed };
+
+    juce::SoftwareImageType softwareImageType;
+    juce::NativeImageType nativeImageType;
+    const juce::ImageType& imageType = options.useNativeImages ? static_cast<const juce::ImageType&>(nativeImageType)
+                                                               : softwareImageType;
+
+    if (options.imageDirectory != juce::File())
+        options.imageDirectory.createDirectory();
+
+    for (int numTracks : options.trackCounts)
+    {
+        // Fixed seed: every run paints the same spectra
+        juce::Random random(1234);
+        std::vector<SyntheticTrack> tracks;
+        for (int i = 0; i < numTracks; ++i)
+            tracks.push_back(makeSyntheticTrack(i, numTracks, random));
+
+        TrackManager trackManager;
+        int frameCounter = 0;
+
+        auto feedFrame = [&]()
+        {
+            for (const auto& track : tracks)
+            {
+                const auto& spectrum = track.spectra[static_cast<size_t>(frameCounter % numVariations)];
+                trackManager.updateTrack(track.trackId, track.trackName, spectrum.data(),
+                                         SpectrumConstants::NUM_BINS, sampleRate);
+            }
+
+            ++frameCounter;
+        };
+
+        feedFrame();
+
+        for (const auto& size : sizes)
+        {
+            report.beginSection("SpectrumDisplay " + juce::String(size.x) + "x" + juce::String(size.y)
+                                + ", " + juce::String(numTracks) + (numTracks == 1 ? " track" : " tracks"));
+
+            for (auto mode : modes)
+            {
+                for (auto scaling : scalings)
+                {
+                    const juce::String caseName = getModeName(mode) + " " + getScalingName(scaling) + " "
+                                                + juce::String(size.x) + "x" + juce::String(size.y) + " "
+                                                + juce::String(numTracks) + "T";
+
+                    SpectrumDisplay display(trackManager);
+                    display.setBounds(0, 0, size.x, size.y);
+                    display.setDisplayMode(mode);
+                    display.setDbScaling(scaling);
+
+                    juce::Image image(juce::Image::ARGB, size.x, size.y, true, imageType);
+
+                    std::vector<double> paintTimes, refreshTimes;
+                    paintTimes.reserve(static_cast<size_t>(options.framesPerCase));
+                    refreshTimes.reserve(static_cast<size_t>(options.framesPerCase));
+                    auto perfBefore = Perf::takeSnapshot();
+
+                    for (int frame = -warmUpFrames; frame < options.framesPerCase; ++frame)
+                    {
+                        if (frame == 0)
+                            perfBefore = Perf::takeSnapshot();
+
+                        feedFrame();
+
+                        auto refreshStart = juce::Time::getHighResolutionTicks();
+                        display.refresh();
+                        auto paintStart = juce::Time::getHighResolutionTicks();
+
+                        {
+                            // Flushed when the context goes out of scope, as at the end of a real repaint
+                            juce::Graphics g(image);
+                            display.paintEntireComponent(g, true);
+                        }
+
+                        auto paintEnd = juce::Time::getHighResolutionTicks();
+
+                        if (frame >= 0)
+                        {
+                            refreshTimes.push_back(ticksToMilliseconds(paintStart - refreshStart));
+                            paintTimes.push_back(ticksToMilliseconds(paintEnd - paintStart));
+                        }
+                    }
+
+                    // Where paint time goes, from the display's own instrumentation
+                    auto perfAfter = Perf::takeSnapshot();
+                    auto prepare = perfAfter.get(Perf::Timer::paintPrepare).since(perfBefore.get(Perf::Timer::paintPrepare));
+                    auto stroke = perfAfter.get(Perf::Timer::paintStroke).since(perfBefore.get(Perf::Timer::paintStroke));
+
+                    report.addMetric(caseName + " paint p50", BenchmarkReport::percentile(paintTimes, 0.5), "ms", false);
+                    report.addMetric(caseName + " paint p95", BenchmarkReport::percentile(paintTimes, 0.95), "ms", false);
+                    report.addMetric(caseName + " paint p99", BenchmarkReport::percentile(paintTimes, 0.99), "ms", false);
+                    report.addMetric(caseName + " prepare mean", prepare.getMeanUs() / 1000.0, "ms", false);
+                    report.addMetric(caseName + " stroke mean", stroke.getMeanUs() / 1000.0, "ms", false);
+                    report.addMetric(caseName + " refresh p50", BenchmarkReport::percentile(refreshTimes, 0.5), "ms", false);
+
+                    if (options.imageDirectory != juce::File())
+                        saveImage(image, options.imageDirectory.getChildFile(caseName.replaceCharacter(' ', '_') + ".png"));
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "../../SpectrumBenchmark/Source/BenchmarkReport.h"
+
+struct RenderBenchmarkOptions
+{
+    std::vector<int> trackCounts { 1, 8, 32 };
+    int framesPerCase { 100 };
+    bool useNativeImages { false };  // Platform image type instead of JUCE's software renderer
+    juce::File imageDirectory;       // If set, the last frame of every case is saved here as PNG
+};
+
+/// SpectrumDisplay paint cost per frame, painted into an offscreen image at several
+/// sizes, in every display mode and dB scaling, for each track count. New synthetic
+/// spectra are fed before every frame so the pyramids and caches do real work.
+void runRenderBenchmarks(BenchmarkReport& report, const RenderBenchmarkOptions& options);
@@ -0,0 +1,438 @@
+#include "AccuracyChecks.h"
+#include "../../../SpectrumAnalyzerRelay/Source/SpectrumProcessor.h"
+#include "../../../SpectrumAnalyzerRelay/Source/OctaveFilterBank.h"
+
+using Spectrum = std::array<float, SpectrumConstants::NUM_BINS>;
+
+namespace
+{
+    constexpr double pi = juce::MathConstants<double>::pi;
+
+    float toDb(float magnitude)
+    {
+        return juce::Decibels::gainToDecibels(magnitude, -300.0f);
+    }
+
+    /// Feeds a whole signal and returns the spectrum of its last FFT_SIZE samples (or the
+    /// multi-resolution frame ending with it). The signal length must be a multiple of
+    /// HOP_SIZE so the last frame lines up with the end.
+    Spectrum analyseLastFrame(const std::vector<float>& signal, double sampleRate, bool multiResolution = false,
+                              const AnalysisWindow::Choice& window = {})
+    {
+        jassert(signal.size() % SpectrumConstants::HOP_SIZE == 0);
+        jassert(signal.size() >= SpectrumConstants::FFT_SIZE);
+
+        SpectrumProcessor processor;
+        processor.prepare(sampleRate);
+        processor.setMultiResolution(multiResolution);
+        processor.setWindow(window);
+        processor.process(signal.data(), static_cast<int>(signal.size()));
+
+        Spectrum spectrum;
+        processor.getSpectrum(spectrum);
+        return spectrum;
+    }
+
+    std::vector<float> makeSine(double frequency, double amplitude, double sampleRate,
+                                size_t length = SpectrumConstants::FFT_SIZE * 2)
+    {
+        std::vector<float> signal(length);
+        for (size_t i = 0; i < signal.size(); ++i)
+            signal[i] = static_cast<float>(amplitude * std::sin(2.0 * pi * frequency * static_cast<double>(i) / sampleRate + 0.3));
+        return signal;
+    }
+
+    int findPeakBin(const Spectrum& spectrum)
+    {
+        return static_cast<int>(std::max_element(spectrum.begin(), spectrum.end()) - spectrum.begin());
+    }
+
+    void checkBinCentredSines(BenchmarkReport& report, double sampleRate)
+    {
+        // Full scale and quieter sines exactly on a bin read their amplitude: the window table
+        // is normalised to unity coherent gain and doubled for the one-sided spectrum
+        const double binHz = sampleRate / SpectrumConstants::FFT_SIZE;
+        const int bins[] = { 8, 43, 171, 512, 1000 };
+        const double amplitudes[] = { 1.0, 0.5, 0.001 };
+        constexpr float toleranceDb = 0.05f;
+
+        for (double amplitude : amplitudes)
+        {
+            bool allPassed = true;
+            float worstErrorDb = 0.0f;
+            int worstPeakBin = -1, worstExpectedBin = -1;
+
+            for (int bin : bins)
+            {
+                auto spectrum = analyseLastFrame(makeSine(bin * binHz, amplitude, sampleRate), sampleRate);
+                int peakBin = findPeakBin(spectrum);
+                float errorDb = toDb(spectrum[static_cast<size_t>(bin)]) - toDb(static_cast<float>(amplitude));
+
+                if (peakBin != bin)
+                {
+                    allPassed = false;
+                    worstPeakBin = peakBin;
+                    worstExpectedBin = bin;
+                }
+
+                if (std::abs(errorDb) > std::abs(worstErrorDb))
+                    worstErrorDb = errorDb;
+            }
+
+            allPassed = allPassed && std::abs(worstErrorDb) <= toleranceDb;
+
+            juce::String detail = "worst level error " + juce::String(worstErrorDb, 3) + " dB";
+            if (worstExpectedBin >= 0)
+                detail << ", peak at bin " << worstPeakBin << " instead of " << worstExpectedBin;
+
+            report.addCheck("bin-centred sine " + juce::String(toDb(static_cast<float>(amplitude)), 0) + " dBFS",
+                            allPassed, detail);
+        }
+    }
+
+    void checkSteppedSineSweep(BenchmarkReport& report, double sampleRate)
+    {
+        // Log-spaced tones at arbitrary positions between bins: the peak must land on the
+        // nearest bin and the level stay within the Hann window's scalloping loss (1.42 dB)
+        const double binHz = sampleRate / SpectrumConstants::FFT_SIZE;
+        const double lowest = 100.0;
+        const double highest = sampleRate * 0.45;
+        constexpr int numTones = 48;
+        constexpr float maxScallopingDb = 1.45f;
+
+        int numMisplaced = 0;
+        float lowestDb = 0.0f, highestDb = -300.0f;
+
+        for (int i = 0; i < numTones; ++i)
+        {
+            double frequency = lowest * std::pow(highest / lowest, i / static_cast<double>(numTones - 1));
+            auto spectrum = analyseLastFrame(makeSine(frequency, 0.5, sampleRate), sampleRate);
+
+            int peakBin = findPeakBin(spectrum);
+            if (std::abs(peakBin - frequency / binHz) > 0.51)
+                ++numMisplaced;
+
+            float levelDb = toDb(spectrum[static_cast<size_t>(peakBin)]) - toDb(0.5f);
+            lowestDb = juce::jmin(lowestDb, levelDb);
+            highestDb = juce::jmax(highestDb, levelDb);
+        }
+
+        report.addCheck("stepped sine sweep peak position", numMisplaced == 0,
+                        juce::String(numMisplaced) + " of " + juce::String(numTones) + " tones off the nearest bin");
+        report.addCheck("stepped sine sweep level", lowestDb >= -maxScallopingDb && highestDb <= 0.05f,
+                        "peak level " + juce::String(lowestDb, 2) + " to " + juce::String(highestDb, 2) + " dB");
+    }
+
+    void checkImpulse(BenchmarkReport& report, double sampleRate)
+    {
+        // A lone impulse in the middle of the frame has a flat magnitude spectrum of
+        // window[centre] * 2 / N, where the unity-gain Hann window peaks at 2
+        std::vector<float> signal(SpectrumConstants::FFT_SIZE * 2, 0.0f);
+        signal[signal.size() - SpectrumConstants::FFT_SIZE / 2] = 1.0f;
+
+        auto spectrum = analyseLastFrame(signal, sampleRate);
+        auto range = std::minmax_element(spectrum.begin(), spectrum.end());
+        float rippleDb = toDb(*range.second) - toDb(*range.first);
+        float levelErrorDb = toDb(*range.second) - toDb(4.0f / SpectrumConstants::FFT_SIZE);
+
+        report.addCheck("impulse flatness", rippleDb <= 0.01f, "ripple " + juce::String(rippleDb, 4) + " dB");
+        report.addCheck("impulse level", std::abs(levelErrorDb) <= 0.1f, "error " + juce::String(levelErrorDb, 3) + " dB");
+    }
+
+    /// Mean squared magnitude per bin of uniform white noise in [-1, 1), over the lower
+    /// and upper halves of the spectrum.
+    std::pair<double, double> measureNoiseFloor(double sampleRate, const AnalysisWindow::Choice& window = {})
+    {
+        constexpr int numFrames = 400;
+        constexpr int warmupFrames = SpectrumConstants::FFT_SIZE / SpectrumConstants::HOP_SIZE;
+        constexpr int edgeBins = 8;  // Skip DC and Nyquist, where the one-sided scaling doesn't apply
+
+        juce::Random random(0x5eed);
+        std::vector<float> hop(SpectrumConstants::HOP_SIZE);
+        std::vector<double> binPower(SpectrumConstants::NUM_BINS, 0.0);
+        Spectrum spectrum;
+
+        SpectrumProcessor processor;
+        processor.prepare(sampleRate);
+        processor.setWindow(window);
+
+        for (int frame = 0; frame < numFrames + warmupFrames; ++frame)
+        {
+            for (auto& sample : hop)
+                sample = random.nextFloat() * 2.0f - 1.0f;
+
+            processor.process(hop.data(), static_cast<int>(hop.size()));
+            processor.getSpectrum(spectrum);
+
+            if (frame < warmupFrames)
+                continue;
+
+            for (size_t bin = 0; bin < binPower.size(); ++bin)
+                binPower[bin] += static_cast<double>(spectrum[bin]) * spectrum[bin];
+        }
+
+        double lowerHalf = 0.0, upperHalf = 0.0;
+        const int half = SpectrumConstants::NUM_BINS / 2;
+        for (int bin = edgeBins; bin < SpectrumConstants::NUM_BINS - edgeBins; ++bin)
+            (bin < half ? lowerHalf : upperHalf) += binPower[static_cast<size_t>(bin)];
+
+        lowerHalf /= (half - edgeBins) * static_cast<double>(numFrames);
+        upperHalf /= (half - edgeBins) * static_cast<double>(numFrames);
+        return { lowerHalf, upperHalf };
+    }
+
+    void checkWhiteNoise(BenchmarkReport& report, double sampleRate)
+    {
+        // Uniform noise in [-1, 1) has variance 1/3. With the unity-gain Hann window
+        // (sum of w^2 = 1.5 N, i.e. ENBW 1.5 bins) the mean squared magnitude per bin is
+        // 4 * variance * 1.5 / N
+        const auto floor = measureNoiseFloor(sampleRate);
+
+        const double expected = 4.0 * (1.0 / 3.0) * 1.5 / SpectrumConstants::FFT_SIZE;
+        double levelErrorDb = 10.0 * std::log10(0.5 * (floor.first + floor.second) / expected);
+        double tiltDb = 10.0 * std::log10(floor.second / floor.first);
+
+        report.addCheck("white noise floor", std::abs(levelErrorDb) <= 0.2,
+                        "error " + juce::String(levelErrorDb, 3) + " dB vs ENBW 1.5 bins");
+        report.addCheck("white noise tilt", std::abs(tiltDb) <= 0.25,
+                        "upper vs lower half " + juce::String(tiltDb, 3) + " dB");
+    }
+
+    void checkWindowCalibration(BenchmarkReport& report, double sampleRate, const AnalysisWindow::Choice& window)
+    {
+        // Whatever the window, a bin-centred sine reads its amplitude, an off-bin one loses no
+        // more than the window's scalloping loss, and white noise reads 4 * variance * ENBW / N
+        SpectrumProcessor reference;
+        reference.setWindow(window);
+        reference.prepare(sampleRate);
+        reference.process(std::vector<float>(SpectrumConstants::HOP_SIZE, 0.0f).data(), SpectrumConstants::HOP_SIZE);
+        const auto properties = reference.getWindowProperties();
+
+        juce::String name = AnalysisWindow::getName(window.type);
+        if (window.type == AnalysisWindow::Type::Kaiser)
+            name << " (beta " << juce::String(window.kaiserBeta, 1) << ")";
+
+        const double binHz = sampleRate / SpectrumConstants::FFT_SIZE;
+        float worstCentredDb = 0.0f;
+        for (int bin : { 43, 171, 512 })
+        {
+            auto spectrum = analyseLastFrame(makeSine(bin * binHz, 0.5, sampleRate), sampleRate, false, window);
+            const float errorDb = toDb(spectrum[static_cast<size_t>(bin)]) - toDb(0.5f);
+            worstCentredDb = std::abs(errorDb) > std::abs(worstCentredDb) ? errorDb : worstCentredDb;
+        }
+
+        float lowestDb = 0.0f;
+        for (int i = 0; i < 16; ++i)
+        {
+            const double bin = 40.0 + 31.0 * i + (i % 5) * 0.125;  // Up to half-way between bins
+            auto spectrum = analyseLastFrame(makeSine(bin * binHz, 0.5, sampleRate), sampleRate, false, window);
+            lowestDb = juce::jmin(lowestDb, toDb(*std::max_element(spectrum.begin(), spectrum.end())) - toDb(0.5f));
+        }
+
+        const auto floor = measureNoiseFloor(sampleRate, window);
+        const double expected = 4.0 * (1.0 / 3.0) * properties.noiseBandwidthBins / SpectrumConstants::FFT_SIZE;
+        const double noiseErrorDb = 10.0 * std::log10(0.5 * (floor.first + floor.second) / expected);
+
+        report.addCheck(name + " bin-centred level", std::abs(worstCentredDb) <= 0.05f,
+                        "worst " + juce::String(worstCentredDb, 3) + " dB (coherent gain "
+                        + juce::String(20.0 * std::log10(properties.coherentGain), 2) + " dB folded into the table)");
+        report.addCheck(name + " off-bin level", lowestDb >= -static_cast<float>(properties.scallopingLossDb) - 0.05f,
+                        "lowest " + juce::String(lowestDb, 2) + " dB, scalloping loss "
+                        + juce::String(properties.scallopingLossDb, 2) + " dB");
+        report.addCheck(name + " noise floor", std::abs(noiseErrorDb) <= 0.2,
+                        "error " + juce::String(noiseErrorDb, 3) + " dB vs ENBW "
+                        + juce::String(properties.noiseBandwidthBins, 3) + " bins");
+    }
+
+    // Long enough for the slowest multi-resolution stage (16x decimated) to fill its window
+    constexpr size_t multiResolutionLength = SpectrumConstants::HOP_SIZE * 48;
+
+    void checkMultiResolutionSweep(BenchmarkReport& report, double sampleRate)
+    {
+        // Log-spaced tones from 30 Hz: the peak must sit within one log bin of the tone, or
+        // within a quarter of a 2048-point FFT bin at the low end where log bins are finer
+        // than any stage resolves, and the level within the Hann scalloping loss
+        const auto& grid = getLogBinGrid();
+        const double lowest = 30.0;
+        const double highest = juce::jmin(sampleRate * 0.45, 0.95 * grid.getMaxFrequency());
+        constexpr int numTones = 48;
+        constexpr float maxScallopingDb = 1.45f;
+
+        int numMisplaced = 0;
+        float lowestDb = 0.0f, highestDb = -300.0f;
+
+        for (int i = 0; i < numTones; ++i)
+        {
+            double frequency = lowest * std::pow(highest / lowest, i / static_cast<double>(numTones - 1));
+            auto spectrum = analyseLastFrame(makeSine(frequency, 0.5, sampleRate, multiResolutionLength), sampleRate, true);
+
+            int peakBin = findPeakBin(spectrum);
+            double tolerance = juce::jmax(static_cast<double>(grid.getBandEdge(peakBin + 1) - grid.getBandEdge(peakBin)),
+                                          0.25 * sampleRate / SpectrumConstants::FFT_SIZE);
+            if (std::abs(getBinFrequency(BinLayout::Log, sampleRate, peakBin) - frequency) > tolerance)
+                ++numMisplaced;
+
+            float levelDb = toDb(spectrum[static_cast<size_t>(peakBin)]) - toDb(0.5f);
+            lowestDb = juce::jmin(lowestDb, levelDb);
+            highestDb = juce::jmax(highestDb, levelDb);
+        }
+
+        report.addCheck("multi-resolution sweep peak position", numMisplaced == 0,
+                        juce::String(numMisplaced) + " of " + juce::String(numTones) + " tones misplaced");
+        report.addCheck("multi-resolution sweep level", lowestDb >= -maxScallopingDb && highestDb <= 0.05f,
+                        "peak level " + juce::String(lowestDb, 2) + " to " + juce::String(highestDb, 2) + " dB");
+    }
+
+    void checkMultiResolutionCloseTones(BenchmarkReport& report, double sampleRate)
+    {
+        // Two tones 3/8 of a 2048-point bin apart at 60 Hz, which one FFT of that size can't
+        // separate: the slowest stage's bins are 8x finer, so a clear dip must show between them
+        const double first = 60.0;
+        const double second = first + 3.0 * sampleRate / (SpectrumConstants::FFT_SIZE * 8);
+        constexpr float minDipDb = 3.0f;
+
+        auto signal = makeSine(first, 0.25, sampleRate, multiResolutionLength);
+        auto other = makeSine(second, 0.25, sampleRate, multiResolutionLength);
+        for (size_t i = 0; i < signal.size(); ++i)
+            signal[i] += other[i];
+
+        auto spectrum = analyseLastFrame(signal, sampleRate, true);
+        auto nearestBin = [sampleRate](double frequency) {
+            return juce::roundToInt(frequencyToBin(BinLayout::Log, sampleRate, frequency));
+        };
+
+        const auto begin = spectrum.begin();
+        const int firstBin = nearestBin(first), secondBin = nearestBin(second);
+        float firstPeak = *std::max_element(begin + firstBin - 3, begin + firstBin + 4);
+        float secondPeak = *std::max_element(begin + secondBin - 3, begin + secondBin + 4);
+        float dip = *std::min_element(begin + firstBin, begin + secondBin + 1);
+        float dipDb = toDb(juce::jmin(firstPeak, secondPeak)) - toDb(dip);
+
+        report.addCheck("multi-resolution close tones", dipDb >= minDipDb,
+                        juce::String(second - first, 1) + " Hz apart, dip " + juce::String(dipDb, 1) + " dB");
+    }
+
+    /// Levels of a filterbank's newest frame after the whole signal.
+    std::vector<float> analyseBands(const std::vector<float>& signal, double sampleRate, int bandsPerOctave)
+    {
+        OctaveFilterBank bank;
+        bank.prepare(sampleRate, bandsPerOctave);
+        bank.process(signal.data(), static_cast<int>(signal.size()));
+
+        std::vector<float> levels(static_cast<size_t>(bank.getNumActiveBands()));
+        bank.getLevels(levels.data());
+        return levels;
+    }
+
+    // Long enough for the slowest envelope (3 periods of 20 Hz) to settle
+    constexpr double octaveSettleSeconds = 1.0;
+
+    void checkOctaveBandResponse(BenchmarkReport& report, double sampleRate, int bandsPerOctave)
+    {
+        // A sine at every band centre reads its amplitude in that band, one at every upper
+        // edge reads 3 dB down (Butterworth), and one two octaves away is well rejected
+        const auto length = static_cast<size_t>(octaveSettleSeconds * sampleRate);
+
+        OctaveFilterBank bank;
+        bank.prepare(sampleRate, bandsPerOctave);
+        const int numBands = bank.getNumActiveBands();
+        const juce::String name = "1/" + juce::String(bandsPerOctave) + " octave ";
+        constexpr float maxCentreErrorDb = 0.25f, maxEdgeErrorDb = 0.3f, minRejectionDb = 40.0f;
+
+        float worstCentreDb = 0.0f, worstEdgeDb = 0.0f, worstRejectionDb = 300.0f;
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto centre = analyseBands(makeSine(OctaveBands::getCentreFrequency(bandsPerOctave, band), 0.5, sampleRate, length),
+                                       sampleRate, bandsPerOctave);
+            auto edge = analyseBands(makeSine(OctaveBands::getBandEdge(bandsPerOctave, band, 1), 0.5, sampleRate, length),
+                                     sampleRate, bandsPerOctave);
+
+            const float centreDb = toDb(centre[static_cast<size_t>(band)]) - toDb(0.5f);
+            const float edgeDb = toDb(edge[static_cast<size_t>(band)]) - toDb(0.5f) + 3.01f;
+            worstCentreDb = std::abs(centreDb) > std::abs(worstCentreDb) ? centreDb : worstCentreDb;
+            worstEdgeDb = std::abs(edgeDb) > std::abs(worstEdgeDb) ? edgeDb : worstEdgeDb;
+
+            for (int other : { band - 2 * bandsPerOctave, band + 2 * bandsPerOctave })
+            {
+                if (other >= 0 && other < numBands)
+                    worstRejectionDb = juce::jmin(worstRejectionDb, toDb(0.5f) - toDb(centre[static_cast<size_t>(other)]));
+            }
+        }
+
+        report.addCheck(name + "band centre level", std::abs(worstCentreDb) <= maxCentreErrorDb,
+                        juce::String(numBands) + " bands, worst " + juce::String(worstCentreDb, 3) + " dB");
+        report.addCheck(name + "band edge level", std::abs(worstEdgeDb) <= maxEdgeErrorDb,
+                        "worst " + juce::String(worstEdgeDb, 3) + " dB from -3 dB");
+        report.addCheck(name + "rejection two octaves out", worstRejectionDb >= minRejectionDb,
+                        "worst " + juce::String(worstRejectionDb, 1) + " dB");
+    }
+
+    void checkOctaveResponseTime(BenchmarkReport& report, double sampleRate)
+    {
+        // Tone starting from silence: time to the first frame with the 1 kHz third-octave band
+        // within 3 dB of the tone's level, against the FFT's 2048-sample window
+        constexpr int band = 17;
+        constexpr float maxResponseMs = 25.0f;   // Frames are 10 ms apart
+
+        OctaveFilterBank bank;
+        bank.prepare(sampleRate, 3);
+
+        const auto tone = makeSine(1000.0, 0.5, sampleRate, static_cast<size_t>(0.2 * sampleRate));
+        std::vector<float> levels(static_cast<size_t>(bank.getNumActiveBands()));
+        constexpr int blockSize = 32;
+        int samplesToRise = -1, position = 0;
+
+        while (position + blockSize <= static_cast<int>(tone.size()) && samplesToRise < 0)
+        {
+            if (bank.process(tone.data() + position, blockSize) > 0)
+            {
+                bank.getLevels(levels.data());
+                if (toDb(levels[static_cast<size_t>(band)]) >= toDb(0.5f) - 3.0f)
+                    samplesToRise = position + blockSize - bank.getSamplesSinceLastFrame();
+            }
+            position += blockSize;
+        }
+
+        const float responseMs = samplesToRise < 0 ? 1.0e6f : static_cast<float>(1000.0 * samplesToRise / sampleRate);
+        report.addCheck("1/3 octave response time", responseMs <= maxResponseMs,
+                        juce::String(responseMs, 1) + " ms to -3 dB at 1 kHz (FFT window "
+                        + juce::String(1000.0 * SpectrumConstants::FFT_SIZE / sampleRate, 1) + " ms)");
+    }
+
+    void checkSilence(BenchmarkReport& report, double sampleRate)
+    {
+        auto spectrum = analyseLastFrame(std::vector<float>(SpectrumConstants::FFT_SIZE * 2, 0.0f), sampleRate);
+        float peak = *std::max_element(spectrum.begin(), spectrum.end());
+
+        report.addCheck("silence", peak == 0.0f, "peak magnitude " + juce::String(peak));
+    }
+}
+
+void runAccuracyChecks(BenchmarkReport& report, double sampleRate)
+{
+    report.beginSection("SpectrumProcessor accuracy @ " + juce::String(sampleRate, 0) + " Hz");
+
+    checkBinCentredSines(report, sampleRate);
+    checkSteppedSineSweep(report, sampleRate);
+    checkImpulse(report, sampleRate);
+    checkWhiteNoise(report, sampleRate);
+    checkSilence(report, sampleRate);
+
+    report.beginSection("SpectrumProcessor windows @ " + juce::String(sampleRate, 0) + " Hz");
+
+    for (auto type : { AnalysisWindow::Type::Hann, AnalysisWindow::Type::BlackmanHarris,
+                       AnalysisWindow::Type::FlatTop, AnalysisWindow::Type::Kaiser })
+        checkWindowCalibration(report, sampleRate, { type, AnalysisWindow::DEFAULT_KAISER_BETA });
+
+    report.beginSection("SpectrumProcessor multi-resolution accuracy @ " + juce::String(sampleRate, 0) + " Hz");
+
+    checkMultiResolutionSweep(report, sampleRate);
+    checkMultiResolutionCloseTones(report, sampleRate);
+
+    report.beginSection("OctaveFilterBank accuracy @ " + juce::String(sampleRate, 0) + " Hz");
+
+    checkOctaveBandResponse(report, sampleRate, 3);
+    checkOctaveBandResponse(report, sampleRate, 6);
+    checkOctaveResponseTime(report, sampleRate);
+}
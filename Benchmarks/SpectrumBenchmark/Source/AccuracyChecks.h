@@ -0,0 +1,15 @@
+#pragma once
+
+#include "BenchmarkReport.h"
+
+/// Checks SpectrumProcessor output against analytically known spectra:
+/// bin-centred and off-bin sines (peak position, 0 dBFS calibration of the
+/// window compensation, scalloping), an impulse (flat response) and white
+/// noise (noise floor, i.e. the Hann window's equivalent noise bandwidth).
+/// Every selectable window is checked for the same calibration: amplitude on a
+/// bin, scalloping off it, and a noise floor that matches its measured ENBW.
+/// The multi-resolution analysis is checked for tone position and level on its
+/// log bins, and for separating two tones closer than a 2048-point FFT can.
+/// The octave filterbank is checked for band level at band centres and edges,
+/// rejection away from the band, and how quickly a band responds to a tone.
+void runAccuracyChecks(BenchmarkReport& report, double sampleRate);
@@ -0,0 +1,52 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    thread_local size_t threadAllocationCount = 0;
+
+    void* countedAllocate(std::size_t size)
+    {
+        ++threadAllocationCount;
+
+        if (void* ptr = std::malloc(size > 0 ? size : 1))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+}
+
+size_t AllocationCounter::getThreadAllocationCount()
+{
+    return threadAllocationCount;
+}
+
+void* operator new(std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return countedAllocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    ++threadAllocationCount;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    ++threadAllocationCount;
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void operator delete(void* ptr) noexcept                        { std::free(ptr); }
+void operator delete[](void* ptr) noexcept                      { std::free(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept           { std::free(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept         { std::free(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept   { std::free(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { std::free(ptr); }
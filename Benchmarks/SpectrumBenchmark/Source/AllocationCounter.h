@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+/// Counts heap allocations made through the global operator new.
+///
+/// AllocationCounter.cpp replaces the global allocation operators for the
+/// benchmark binary; counts are kept per thread so only the code under test
+/// is measured.
+namespace AllocationCounter
+{
+    /// Number of allocations made by the calling thread since it started.
+    size_t getThreadAllocationCount();
+}
+
+/// Number of allocations the calling thread makes while this object is alive.
+class ScopedAllocationCount
+{
+public:
+    ScopedAllocationCount() : start(AllocationCounter::getThreadAllocationCount()) {}
+
+    size_t getCount() const { return AllocationCounter::getThreadAllocationCount() - start; }
+
+private:
+    size_t start;
+};
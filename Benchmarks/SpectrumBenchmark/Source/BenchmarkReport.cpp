@@ -0,0 +1,114 @@
+#include "BenchmarkReport.h"
+#include <iostream>
+
+void BenchmarkReport::beginSection(const juce::String& title)
+{
+    std::cout << std::endl << "== " << title << " ==" << std::endl;
+}
+
+void BenchmarkReport::addMetric(const juce::String& name, double value, const juce::String& unit, bool higherIsBetter)
+{
+    metrics.push_back({ name, value, unit, higherIsBetter });
+
+    std::cout << "  " << name.paddedRight(' ', 48) << juce::String(value, 3).paddedLeft(' ', 16)
+              << " " << unit << std::endl;
+}
+
+void BenchmarkReport::addCheck(const juce::String& name, bool passed, const juce::String& detail)
+{
+    checks.push_back({ name, passed, detail });
+
+    std::cout << "  [" << (passed ? "PASS" : "FAIL") << "] " << name << ": " << detail << std::endl;
+}
+
+int BenchmarkReport::getNumFailedChecks() const
+{
+    int numFailed = 0;
+    for (const auto& check : checks)
+    {
+        if (!check.passed)
+            ++numFailed;
+    }
+    return numFailed;
+}
+
+bool BenchmarkReport::saveJson(const juce::File& file) const
+{
+    auto* metricsObject = new juce::DynamicObject();
+    for (const auto& metric : metrics)
+    {
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("value", metric.value);
+        entry->setProperty("unit", metric.unit);
+        entry->setProperty("higherIsBetter", metric.higherIsBetter);
+        metricsObject->setProperty(metric.name, juce::var(entry));
+    }
+
+    auto* checksObject = new juce::DynamicObject();
+    for (const auto& check : checks)
+        checksObject->setProperty(check.name, check.passed);
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+    root->setProperty("platform", juce::SystemStats::getOperatingSystemName());
+    root->setProperty("cpu", juce::SystemStats::getCpuModel());
+    root->setProperty("metrics", juce::var(metricsObject));
+    root->setProperty("checks", juce::var(checksObject));
+
+    return file.replaceWithText(juce::JSON::toString(juce::var(root)));
+}
+
+void BenchmarkReport::compareWith(const juce::File& previousReport, double regressionThreshold) const
+{
+    auto previous = juce::JSON::parse(previousReport);
+    auto* previousMetrics = previous["metrics"].getDynamicObject();
+
+    if (previousMetrics == nullptr)
+    {
+        std::cout << std::endl << "Could not read metrics from " << previousReport.getFullPathName() << std::endl;
+        return;
+    }
+
+    std::cout << std::endl << "== Compared with " << previousReport.getFileName()
+              << " (" << previous["time"].toString() << ") ==" << std::endl;
+
+    int numRegressions = 0;
+
+    for (const auto& metric : metrics)
+    {
+        const auto& previousEntry = previousMetrics->getProperty(metric.name);
+        if (previousEntry.isVoid())
+            continue;
+
+        double previousValue = previousEntry["value"];
+        if (previousValue == 0.0)
+            continue;
+
+        double change = (metric.value - previousValue) / std::abs(previousValue);
+        bool regressed = metric.higherIsBetter ? change < -regressionThreshold : change > regressionThreshold;
+        if (regressed)
+            ++numRegressions;
+
+        std::cout << "  " << metric.name.paddedRight(' ', 48)
+                  << (change >= 0.0 ? "+" : "") << juce::String(change * 100.0, 1) << "%"
+                  << (regressed ? "  << regression" : "") << std::endl;
+    }
+
+    std::cout << "  " << numRegressions << " metric(s) regressed by more than "
+              << juce::String(regressionThreshold * 100.0, 0) << "%" << std::endl;
+}
+
+double BenchmarkReport::percentile(std::vector<double>& values, double p)
+{
+    if (values.empty())
+        return 0.0;
+
+    std::sort(values.begin(), values.end());
+
+    double position = juce::jlimit(0.0, 1.0, p) * static_cast<double>(values.size() - 1);
+    size_t lower = static_cast<size_t>(position);
+    size_t upper = juce::jmin(lower + 1, values.size() - 1);
+    double fraction = position - static_cast<double>(lower);
+
+    return values[lower] + (values[upper] - values[lower]) * fraction;
+}
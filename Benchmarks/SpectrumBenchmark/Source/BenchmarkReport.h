@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/// Collects benchmark metrics and pass/fail checks, prints them as they arrive,
+/// and saves/compares them as JSON so runs can be compared over time.
+class BenchmarkReport
+{
+public:
+    BenchmarkReport() = default;
+
+    /// Prints a section heading.
+    void beginSection(const juce::String& title);
+
+    /// Records a measured value. higherIsBetter decides which way a change counts as a regression.
+    void addMetric(const juce::String& name, double value, const juce::String& unit, bool higherIsBetter);
+
+    /// Records a pass/fail check with a human readable description of what was measured.
+    void addCheck(const juce::String& name, bool passed, const juce::String& detail);
+
+    int getNumFailedChecks() const;
+
+    /// Writes all metrics and checks as JSON.
+    bool saveJson(const juce::File& file) const;
+
+    /// Prints the change of every metric relative to a report saved by an earlier run.
+    /// Changes beyond regressionThreshold (fractional) in the wrong direction are flagged.
+    void compareWith(const juce::File& previousReport, double regressionThreshold = 0.05) const;
+
+    /// Value at fraction p (0-1) of the sorted values, interpolating between neighbours.
+    static double percentile(std::vector<double>& values, double p);
+
+private:
+    struct Metric
+    {
+        juce::String name;
+        double value;
+        juce::String unit;
+        bool higherIsBetter;
+    };
+
+    struct Check
+    {
+        juce::String name;
+        bool passed;
+        juce::String detail;
+    };
+
+    std::vector<Metric> metrics;
+    std::vector<Check> checks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BenchmarkReport)
+};
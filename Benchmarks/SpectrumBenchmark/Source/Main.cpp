@@ -0,0 +1,70 @@
+/*
+  ==============================================================================
+
+    Headless benchmark and accuracy suite for the relay's SpectrumProcessor.
+
+    Usage: SpectrumBenchmark [--quick] [--accuracy-only] [--json <file>] [--compare <file>]
+
+      --quick           5 seconds of audio per block size instead of 60
+      --accuracy-only   skip the timing benchmarks
+      --json <file>     save all metrics and checks for later comparison
+      --compare <file>  print changes relative to a previously saved report
+
+    Exits with a non-zero code if any accuracy or allocation check fails.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "AccuracyChecks.h"
+#include "ProcessorBenchmarks.h"
+#include <iostream>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << "Usage: " << args.executableName
+                  << " [--quick] [--accuracy-only] [--json <file>] [--compare <file>]" << std::endl;
+        return 0;
+    }
+
+    BenchmarkOptions options;
+    if (args.containsOption ("--quick"))
+        options.secondsOfAudio = 5.0;
+
+    std::cout << juce::SystemStats::getCpuModel() << ", " << juce::SystemStats::getOperatingSystemName() << std::endl;
+
+    BenchmarkReport report;
+    runAccuracyChecks (report, options.sampleRate);
+
+    if (! args.containsOption ("--accuracy-only"))
+    {
+        runProcessorBenchmarks (report, options);
+        runFFTBenchmarks (report, options);
+    }
+
+    if (args.containsOption ("--json"))
+    {
+        auto file = args.getFileForOption ("--json");
+        if (! report.saveJson (file))
+            std::cout << "Failed to write " << file.getFullPathName() << std::endl;
+    }
+
+    if (args.containsOption ("--compare"))
+    {
+        auto file = args.getFileForOption ("--compare");
+        if (file.existsAsFile())
+            report.compareWith (file);
+        else
+            std::cout << "No previous report at " << file.getFullPathName() << std::endl;
+    }
+
+    const int numFailed = report.getNumFailedChecks();
+    std::cout << std::endl << (numFailed == 0 ? "All checks passed" : juce::String (numFailed) + " check(s) failed") << std::endl;
+
+    return numFailed == 0 ? 0 : 1;
+}
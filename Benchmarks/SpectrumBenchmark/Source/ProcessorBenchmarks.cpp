@@ -0,0 +1,279 @@
+#include "ProcessorBenchmarks.h"
+#include "AllocationCounter.h"
+#include "../../../SpectrumAnalyzerRelay/Source/SpectrumProcessor.h"
+#include "../../../SpectrumAnalyzerRelay/Source/OctaveFilterBank.h"
+
+namespace
+{
+    double ticksToMicroseconds(juce::int64 ticks)
+    {
+        return 1.0e6 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    }
+
+    /// Music-like test signal: a few tones over noise. The content doesn't change the
+    /// processor's cost, but keeps denormals and silence shortcuts out of the picture.
+    std::vector<float> makeTestSignal(int numSamples, double sampleRate)
+    {
+        juce::Random random(42);
+        std::vector<float> signal(static_cast<size_t>(numSamples));
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            double t = i / sampleRate;
+            double tones = 0.3 * std::sin(2.0 * juce::MathConstants<double>::pi * 110.0 * t)
+                         + 0.1 * std::sin(2.0 * juce::MathConstants<double>::pi * 1234.5 * t);
+            signal[static_cast<size_t>(i)] = static_cast<float>(tones) + 0.05f * (random.nextFloat() * 2.0f - 1.0f);
+        }
+
+        return signal;
+    }
+
+    struct BlockRun
+    {
+        juce::int64 totalTicks { 0 };
+        size_t allocations { 0 };
+        int numSamplesProcessed { 0 };
+    };
+
+    /// Runs the signal through a fresh processor in blocks the way the relay's processBlock does,
+    /// recording the time of every call (in microseconds) into blockTimes.
+    BlockRun runBlocks(const std::vector<float>& signal, double sampleRate, int blockSize, std::vector<double>& blockTimes,
+                       bool multiResolution = false)
+    {
+        SpectrumProcessor processor;
+        std::array<float, SpectrumConstants::NUM_BINS> spectrum;
+
+        // Warm up caches and the FFT tables, then start from a clean state
+        processor.setMultiResolution(multiResolution);
+        processor.prepare(sampleRate);
+        processor.process(signal.data(), juce::jmin(static_cast<int>(signal.size()), SpectrumConstants::FFT_SIZE * 4));
+        processor.prepare(sampleRate);
+
+        blockTimes.clear();
+        blockTimes.reserve(signal.size() / static_cast<size_t>(blockSize) + 1);
+
+        BlockRun run;
+        ScopedAllocationCount allocationCount;
+
+        for (size_t position = 0; position + static_cast<size_t>(blockSize) <= signal.size(); position += static_cast<size_t>(blockSize))
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+
+            processor.process(signal.data() + position, blockSize);
+            if (processor.isSpectrumReady())
+                processor.getSpectrum(spectrum);
+
+            auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            run.totalTicks += elapsed;
+            run.numSamplesProcessed += blockSize;
+            blockTimes.push_back(ticksToMicroseconds(elapsed));
+        }
+
+        run.allocations = allocationCount.getCount();
+        return run;
+    }
+
+    /// Same as runBlocks, through the octave filterbank (levels read whenever a frame completes).
+    BlockRun runFilterBankBlocks(const std::vector<float>& signal, double sampleRate, int blockSize, int bandsPerOctave,
+                                 std::vector<double>& blockTimes)
+    {
+        OctaveFilterBank bank;
+        std::array<float, OctaveBands::MAX_BANDS> levels;
+
+        bank.prepare(sampleRate, bandsPerOctave);
+        bank.process(signal.data(), juce::jmin(static_cast<int>(signal.size()), SpectrumConstants::FFT_SIZE * 4));
+        bank.prepare(sampleRate, bandsPerOctave);
+
+        blockTimes.clear();
+        blockTimes.reserve(signal.size() / static_cast<size_t>(blockSize) + 1);
+
+        BlockRun run;
+        ScopedAllocationCount allocationCount;
+
+        for (size_t position = 0; position + static_cast<size_t>(blockSize) <= signal.size(); position += static_cast<size_t>(blockSize))
+        {
+            auto start = juce::Time::getHighResolutionTicks();
+
+            if (bank.process(signal.data() + position, blockSize) > 0)
+                bank.getLevels(levels.data());
+
+            auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+            run.totalTicks += elapsed;
+            run.numSamplesProcessed += blockSize;
+            blockTimes.push_back(ticksToMicroseconds(elapsed));
+        }
+
+        run.allocations = allocationCount.getCount();
+        return run;
+    }
+}
+
+void runProcessorBenchmarks(BenchmarkReport& report, const BenchmarkOptions& options)
+{
+    report.beginSection("SpectrumProcessor throughput @ " + juce::String(options.sampleRate, 0) + " Hz");
+
+    const int numSamples = juce::roundToInt(options.secondsOfAudio * options.sampleRate);
+    const auto signal = makeTestSignal(numSamples, options.sampleRate);
+    std::vector<double> blockTimes;
+
+    const int blockSizes[] = { 32, 64, 128, 256, 441, 512, 1024, 4096 };
+
+    for (int blockSize : blockSizes)
+    {
+        auto run = runBlocks(signal, options.sampleRate, blockSize, blockTimes);
+        double seconds = ticksToMicroseconds(run.totalTicks) * 1.0e-6;
+        juce::String prefix = "block " + juce::String(blockSize) + " ";
+
+        report.addMetric(prefix + "throughput", run.numSamplesProcessed / seconds / 1.0e6, "Msamples/s", true);
+        report.addMetric(prefix + "realtime factor", run.numSamplesProcessed / options.sampleRate / seconds, "x", true);
+        report.addMetric(prefix + "p50", BenchmarkReport::percentile(blockTimes, 0.5), "us", false);
+        report.addMetric(prefix + "p99", BenchmarkReport::percentile(blockTimes, 0.99), "us", false);
+        report.addMetric(prefix + "max", BenchmarkReport::percentile(blockTimes, 1.0), "us", false);
+        report.addCheck(prefix + "allocations", run.allocations == 0,
+                        juce::String(static_cast<juce::int64>(run.allocations)) + " on the audio thread");
+    }
+
+    // One hop per call, so every call performs exactly one FFT
+    report.beginSection("SpectrumProcessor per-hop latency");
+
+    runBlocks(signal, options.sampleRate, SpectrumConstants::HOP_SIZE, blockTimes);
+
+    report.addMetric("hop p50", BenchmarkReport::percentile(blockTimes, 0.5), "us", false);
+    report.addMetric("hop p99", BenchmarkReport::percentile(blockTimes, 0.99), "us", false);
+    report.addMetric("hop p99.9", BenchmarkReport::percentile(blockTimes, 0.999), "us", false);
+    report.addMetric("hop max", BenchmarkReport::percentile(blockTimes, 1.0), "us", false);
+
+    // Same signal and blocks through the multi-resolution analysis; its cost per frame
+    // (spectrum read included) against the plain FFT's
+    report.beginSection("SpectrumProcessor multi-resolution vs FFT " + juce::String(SpectrumConstants::FFT_SIZE));
+
+    for (int blockSize : { 128, 512 })
+    {
+        auto plain = runBlocks(signal, options.sampleRate, blockSize, blockTimes);
+        auto multi = runBlocks(signal, options.sampleRate, blockSize, blockTimes, true);
+        const double numFrames = static_cast<double>(multi.numSamplesProcessed) / SpectrumConstants::HOP_SIZE;
+        juce::String prefix = "block " + juce::String(blockSize) + " ";
+
+        report.addMetric(prefix + "multi-resolution per frame", ticksToMicroseconds(multi.totalTicks) / numFrames, "us", false);
+        report.addMetric(prefix + "cost vs FFT", static_cast<double>(multi.totalTicks) / static_cast<double>(plain.totalTicks), "x", false);
+        report.addMetric(prefix + "multi-resolution block p99", BenchmarkReport::percentile(blockTimes, 0.99), "us", false);
+        report.addCheck(prefix + "multi-resolution allocations", multi.allocations == 0,
+                        juce::String(static_cast<juce::int64>(multi.allocations)) + " on the audio thread");
+    }
+
+    // The octave filterbanks on the same signal, per sample since their frames are a
+    // fixed 10 ms rather than a hop, against the plain FFT over the same audio
+    report.beginSection("OctaveFilterBank vs FFT " + juce::String(SpectrumConstants::FFT_SIZE));
+
+    for (int blockSize : { 128, 512 })
+    {
+        auto plain = runBlocks(signal, options.sampleRate, blockSize, blockTimes);
+
+        for (int bandsPerOctave : { 3, 6 })
+        {
+            auto bank = runFilterBankBlocks(signal, options.sampleRate, blockSize, bandsPerOctave, blockTimes);
+            juce::String prefix = "block " + juce::String(blockSize) + " 1/" + juce::String(bandsPerOctave) + " octave ";
+
+            report.addMetric(prefix + "per sample", 1.0e3 * ticksToMicroseconds(bank.totalTicks) / bank.numSamplesProcessed, "ns", false);
+            report.addMetric(prefix + "cost vs FFT", static_cast<double>(bank.totalTicks) / static_cast<double>(plain.totalTicks), "x", false);
+            report.addMetric(prefix + "block p99", BenchmarkReport::percentile(blockTimes, 0.99), "us", false);
+            report.addCheck(prefix + "allocations", bank.allocations == 0,
+                            juce::String(static_cast<juce::int64>(bank.allocations)) + " on the audio thread");
+        }
+    }
+}
+
+void runFFTBenchmarks(BenchmarkReport& report, const BenchmarkOptions& options)
+{
+    report.beginSection("Window + FFT by size (processor uses " + juce::String(SpectrumConstants::FFT_SIZE) + ")");
+
+    juce::Random random(7);
+
+    for (int order = 9; order <= 14; ++order)
+    {
+        const int size = 1 << order;
+
+        juce::dsp::FFT fft(order);
+
+        // Hann table with the normalisation folded in, applied on the way into the FFT buffer as the processor does
+        std::vector<float> window(static_cast<size_t>(size));
+        AnalysisWindow::fill({}, window.data(), size);
+        juce::FloatVectorOperations::multiply(window.data(), 2.0f / static_cast<float>(size / 2), size);
+
+        std::vector<float> input(static_cast<size_t>(size));
+        for (auto& sample : input)
+            sample = random.nextFloat() * 2.0f - 1.0f;
+
+        std::vector<float> fftData(static_cast<size_t>(size) * 2);
+
+        // As many transforms as the processor would do over the same audio length at this size
+        const int iterations = juce::jmax(100, juce::roundToInt(options.secondsOfAudio * options.sampleRate / (size / 4)));
+
+        auto start = juce::Time::getHighResolutionTicks();
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            juce::FloatVectorOperations::multiply(fftData.data(), input.data(), window.data(), size);
+            fft.performRealOnlyForwardTransform(fftData.data(), true);
+        }
+
+        auto elapsed = juce::Time::getHighResolutionTicks() - start;
+
+        report.addMetric("fft " + juce::String(size), ticksToMicroseconds(elapsed) / iterations, "us", false);
+    }
+
+    // The pass after the FFT, per frame: the processor's fused kernel against what it
+    // replaced (magnitudes, then a log10 and rounding per bin where the analyzer recorded
+    // them), and the analyzer's decode of a received frame
+    report.beginSection("Post-FFT pass (" + juce::String(SpectrumConstants::NUM_BINS) + " bins)");
+
+    const int numBins = SpectrumConstants::NUM_BINS;
+    std::vector<float> complexBins(static_cast<size_t>(numBins) * 2);
+    for (auto& value : complexBins)
+        value = (random.nextFloat() * 2.0f - 1.0f) * std::pow(10.0f, -5.0f * random.nextFloat());
+
+    std::vector<float> magnitudes(static_cast<size_t>(numBins));
+    std::vector<juce::uint16> codes(static_cast<size_t>(numBins)), exactCodes(static_cast<size_t>(numBins));
+    const int numFrames = juce::jmax(1000, juce::roundToInt(options.secondsOfAudio * options.sampleRate / SpectrumConstants::HOP_SIZE));
+
+    auto start = juce::Time::getHighResolutionTicks();
+    for (int frame = 0; frame < numFrames; ++frame)
+        SpectrumProcessor::convertBins(complexBins.data(), magnitudes.data(), codes.data(), numBins);
+    const double fusedNs = 1000.0 * ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start) / numFrames;
+
+    start = juce::Time::getHighResolutionTicks();
+    for (int frame = 0; frame < numFrames; ++frame)
+    {
+        for (int bin = 0; bin < numBins; ++bin)
+            magnitudes[static_cast<size_t>(bin)] = std::hypot(complexBins[static_cast<size_t>(bin) * 2],
+                                                              complexBins[static_cast<size_t>(bin) * 2 + 1]);
+
+        for (int bin = 0; bin < numBins; ++bin)
+        {
+            const float magnitude = magnitudes[static_cast<size_t>(bin)];
+            const float db = magnitude > 0.0f ? 20.0f * std::log10(magnitude) : SpectrumCodes::MIN_DB;
+            exactCodes[static_cast<size_t>(bin)] = static_cast<juce::uint16>(
+                juce::jlimit(0, 65535, juce::roundToInt((db - SpectrumCodes::MIN_DB) / SpectrumCodes::DB_STEP)));
+        }
+    }
+    const double separateNs = 1000.0 * ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start) / numFrames;
+
+    start = juce::Time::getHighResolutionTicks();
+    for (int frame = 0; frame < numFrames; ++frame)
+        SpectrumCodes::toMagnitudes(codes.data(), magnitudes.data(), numBins);
+    const double decodeNs = 1000.0 * ticksToMicroseconds(juce::Time::getHighResolutionTicks() - start) / numFrames;
+
+    int worstStepError = 0;
+    for (int bin = 0; bin < numBins; ++bin)
+        worstStepError = juce::jmax(worstStepError, std::abs(static_cast<int>(codes[static_cast<size_t>(bin)])
+                                                             - static_cast<int>(exactCodes[static_cast<size_t>(bin)])));
+
+    report.addMetric("fused kernel", fusedNs, "ns/frame", false);
+    report.addMetric("separate passes", separateNs, "ns/frame", false);
+    report.addMetric("speedup", separateNs / fusedNs, "x", true);
+    report.addMetric("decode", decodeNs, "ns/frame", false);
+    report.addCheck("codes vs exact", worstStepError <= 1,
+                    "worst " + juce::String(worstStepError) + " step(s) of " + juce::String(SpectrumCodes::DB_STEP) + " dB");
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+#include "BenchmarkReport.h"
+
+struct BenchmarkOptions
+{
+    double sampleRate { 48000.0 };
+    double secondsOfAudio { 60.0 };  // Per host block size
+};
+
+/// SpectrumProcessor throughput, per-block and per-hop latency percentiles and
+/// audio-thread allocations across typical host block sizes, and the cost of the
+/// multi-resolution analysis and the octave filterbanks relative to the single FFT.
+void runProcessorBenchmarks(BenchmarkReport& report, const BenchmarkOptions& options);
+
+/// Raw window + FFT cost across FFT sizes, as a reference for the processor's
+/// fixed SpectrumConstants::FFT_SIZE, and the per-frame cost of the pass after the
+/// FFT (magnitudes and dB codes) against separate magnitude and log10 passes.
+void runFFTBenchmarks(BenchmarkReport& report, const BenchmarkOptions& options);
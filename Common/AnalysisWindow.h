@@ -0,0 +1,191 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+/// The relay's FFT analysis windows, shared with the analyzer so peak mode can
+/// rebuild a peak with the main lobe of the window that measured it.
+///
+/// Hann is the default. Blackman-Harris (4-term, -92 dB sidelobes) and Kaiser
+/// trade a wider main lobe for lower leakage; flat-top reads a tone's level to
+/// within 0.01 dB wherever it falls between bins, at the widest main lobe and
+/// highest noise floor. Shapes are symmetric, as juce::dsp::WindowingFunction's.
+namespace AnalysisWindow
+{
+    /// Stored as ints in plugin state and peak frames, so only ever append.
+    enum class Type
+    {
+        Hann,
+        BlackmanHarris,
+        FlatTop,
+        Kaiser
+    };
+
+    constexpr int NUM_TYPES = 4;
+    constexpr float DEFAULT_KAISER_BETA = 9.0f;
+    constexpr float MAX_KAISER_BETA = 40.0f;
+
+    struct Choice
+    {
+        Type type { Type::Hann };
+        float kaiserBeta { DEFAULT_KAISER_BETA };  // Kaiser only
+
+        bool operator==(const Choice& other) const
+        {
+            return type == other.type && (type != Type::Kaiser || kaiserBeta == other.kaiserBeta);
+        }
+        bool operator!=(const Choice& other) const { return !(*this == other); }
+    };
+
+    /// Figures for calibrating readings taken through a window.
+    struct Properties
+    {
+        double coherentGain { 0.0 };       // Mean of the window: gain on a bin-centred tone
+        double noiseBandwidthBins { 0.0 };  // ENBW: noise power in a bin / noise power per bin width
+        double scallopingLossDb { 0.0 };   // Level drop for a tone half-way between bins
+    };
+
+    inline juce::String getName(Type type)
+    {
+        switch (type)
+        {
+            case Type::BlackmanHarris: return "Blackman-Harris";
+            case Type::FlatTop:        return "Flat-top";
+            case Type::Kaiser:         return "Kaiser";
+            case Type::Hann:
+            default:                   return "Hann";
+        }
+    }
+
+    namespace Detail
+    {
+        /// Cosine-sum windows as w(t) = a0 + a1 cos(2 pi t / T) + a2 cos(4 pi t / T) + ...
+        /// about the centre; Kaiser has none.
+        inline int getCosineTerms(Type type, const double*& terms)
+        {
+            static constexpr double hann[] = { 0.5, 0.5 };
+            static constexpr double blackmanHarris[] = { 0.35875, 0.48829, 0.14128, 0.01168 };
+            static constexpr double flatTop[] = { 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368 };
+
+            switch (type)
+            {
+                case Type::Hann:           terms = hann;           return 2;
+                case Type::BlackmanHarris: terms = blackmanHarris; return 4;
+                case Type::FlatTop:        terms = flatTop;        return 5;
+                case Type::Kaiser:
+                default:                   terms = nullptr;        return 0;
+            }
+        }
+
+        inline double besselI0(double x)
+        {
+            double sum = 1.0, term = 1.0;
+            for (int k = 1; k < 48; ++k)
+            {
+                term *= (x / (2.0 * k)) * (x / (2.0 * k));
+                sum += term;
+            }
+            return sum;
+        }
+    }
+
+    /// Writes the window's shape (peak near 1, not normalised).
+    inline void fill(const Choice& choice, float* table, int size)
+    {
+        const double* terms = nullptr;
+        const int numTerms = Detail::getCosineTerms(choice.type, terms);
+        const double last = static_cast<double>(juce::jmax(1, size - 1));
+
+        for (int i = 0; i < size; ++i)
+        {
+            // Position from -1 to 1 across the window
+            const double t = 2.0 * i / last - 1.0;
+            double value = 0.0;
+
+            if (numTerms > 0)
+            {
+                for (int k = 0; k < numTerms; ++k)
+                    value += terms[k] * std::cos(juce::MathConstants<double>::pi * k * t);
+            }
+            else
+            {
+                const double beta = static_cast<double>(choice.kaiserBeta);
+                value = Detail::besselI0(beta * std::sqrt(juce::jmax(0.0, 1.0 - t * t))) / Detail::besselI0(beta);
+            }
+
+            table[i] = static_cast<float>(value);
+        }
+    }
+
+    /// Measures a window as written by fill().
+    inline Properties measure(const float* table, int size)
+    {
+        double sum = 0.0, sumSquares = 0.0, halfBinRe = 0.0, halfBinIm = 0.0;
+        for (int i = 0; i < size; ++i)
+        {
+            const double w = table[i];
+            const double phase = juce::MathConstants<double>::pi * i / size;
+            sum += w;
+            sumSquares += w * w;
+            halfBinRe += w * std::cos(phase);
+            halfBinIm += w * std::sin(phase);
+        }
+
+        Properties properties;
+        properties.coherentGain = sum / size;
+        properties.noiseBandwidthBins = size * sumSquares / (sum * sum);
+        properties.scallopingLossDb = -20.0 * std::log10(std::sqrt(halfBinRe * halfBinRe + halfBinIm * halfBinIm) / sum);
+        return properties;
+    }
+
+    /// Bins from the centre of the window's spectrum to the first null.
+    inline float getMainLobeHalfWidth(const Choice& choice)
+    {
+        if (choice.type == Type::Kaiser)
+            return std::sqrt(1.0f + (choice.kaiserBeta / juce::MathConstants<float>::pi) * (choice.kaiserBeta / juce::MathConstants<float>::pi));
+
+        const double* terms = nullptr;
+        return static_cast<float>(Detail::getCosineTerms(choice.type, terms));
+    }
+
+    /// Magnitude of the window's spectrum at a bin offset, relative to its peak
+    /// (continuous-time approximation, fine for windows this long). Zero outside
+    /// the main lobe.
+    inline float getResponse(const Choice& choice, float binOffset)
+    {
+        const double d = std::abs(static_cast<double>(binOffset));
+        if (d >= getMainLobeHalfWidth(choice))
+            return 0.0f;
+
+        const double pi = juce::MathConstants<double>::pi;
+
+        if (choice.type == Type::Kaiser)
+        {
+            // sinh(sqrt(beta^2 - (pi d)^2)) / sqrt(...), turning into sin() past beta
+            const double beta = static_cast<double>(choice.kaiserBeta);
+            const double s2 = beta * beta - (pi * d) * (pi * d);
+            const double s = std::sqrt(std::abs(s2));
+            const double value = s < 1.0e-6 ? 1.0 : (s2 > 0.0 ? std::sinh(s) : std::sin(s)) / s;
+            const double peak = beta < 1.0e-3 ? 1.0 : std::sinh(beta) / beta;
+            return static_cast<float>(std::abs(value / peak));
+        }
+
+        // Each cosine term is a pair of sincs k bins either side of the centre
+        const double* terms = nullptr;
+        const int numTerms = Detail::getCosineTerms(choice.type, terms);
+
+        const int nearest = static_cast<int>(std::round(d));
+        if (std::abs(d - nearest) < 1.0e-4)
+        {
+            if (nearest >= numTerms)
+                return 0.0f;
+            return static_cast<float>((nearest == 0 ? terms[0] : 0.5 * terms[nearest]) / terms[0]);
+        }
+
+        double sum = terms[0] / d;
+        for (int k = 1; k < numTerms; ++k)
+            sum += ((k % 2 == 0) ? 1.0 : -1.0) * terms[k] * d / (d * d - k * k);
+
+        return static_cast<float>(std::abs(std::sin(pi * d) / pi * sum / terms[0]));
+    }
+}
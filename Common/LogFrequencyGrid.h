@@ -0,0 +1,204 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "SpectrumData.h"
+
+/// Log-spaced frequency bands between a min and max frequency.
+///
+/// FFT bins are linear in frequency and depend on each track's sample rate, so
+/// anything that combines or compares tracks maps them onto this grid first.
+class LogFrequencyGrid
+{
+public:
+    /// Precomputed bin -> band mapping for one sample rate and FFT size.
+    class BinMapping
+    {
+    public:
+        /// Maps per-bin power to per-band power. Wide bands average the bins whose
+        /// centre falls inside them, narrow bands interpolate between neighbours.
+        template <typename OutputType>
+        void map(const float* binPower, OutputType* bandPower) const
+        {
+            for (size_t band = 0; band < entries.size(); ++band)
+            {
+                const auto& entry = entries[band];
+                float value = 0.0f;
+
+                if (entry.count > 0)
+                {
+                    for (int bin = entry.start; bin < entry.start + entry.count; ++bin)
+                        value += binPower[bin];
+                    value /= static_cast<float>(entry.count);
+                }
+                else if (entry.start >= 0)
+                {
+                    value = binPower[entry.start] * (1.0f - entry.fraction)
+                          + binPower[entry.start + 1] * entry.fraction;
+                }
+
+                bandPower[band] = static_cast<OutputType>(value);
+            }
+        }
+
+    private:
+        friend class LogFrequencyGrid;
+
+        struct Entry
+        {
+            int start { -1 };       // First bin, or -1 if the band is above Nyquist
+            int count { 0 };        // Bins to average; 0 = interpolate start/start+1
+            float fraction { 0.0f };
+        };
+
+        std::vector<Entry> entries;
+    };
+
+    LogFrequencyGrid(int numBandsToUse = SpectrumConstants::LOG_GRID_NUM_BANDS,
+                     float minFrequencyToUse = SpectrumConstants::LOG_GRID_MIN_FREQUENCY,
+                     float maxFrequencyToUse = SpectrumConstants::LOG_GRID_MAX_FREQUENCY)
+        : numBands(numBandsToUse),
+          minFrequency(minFrequencyToUse),
+          maxFrequency(maxFrequencyToUse),
+          logRatio(std::log(maxFrequencyToUse / minFrequencyToUse))
+    {
+    }
+
+    int getNumBands() const { return numBands; }
+    float getMinFrequency() const { return minFrequency; }
+    float getMaxFrequency() const { return maxFrequency; }
+
+    /// Lower edge of a band (band == numBands gives the top edge of the grid).
+    float getBandEdge(int band) const
+    {
+        return minFrequency * std::exp(logRatio * static_cast<float>(band) / static_cast<float>(numBands));
+    }
+
+    /// Geometric centre frequency of a band.
+    float getBandCentre(int band) const
+    {
+        return minFrequency * std::exp(logRatio * (static_cast<float>(band) + 0.5f) / static_cast<float>(numBands));
+    }
+
+    /// Fractional band position of a frequency (0 = bottom edge, numBands = top edge).
+    float frequencyToBand(float frequency) const
+    {
+        return static_cast<float>(numBands) * std::log(frequency / minFrequency) / logRatio;
+    }
+
+    BinMapping createBinMapping(double sampleRate, int fftSize) const
+    {
+        BinMapping mapping;
+        mapping.entries.resize(static_cast<size_t>(numBands));
+
+        const int numBins = fftSize / 2;
+        const double binHz = sampleRate / static_cast<double>(fftSize);
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto& entry = mapping.entries[static_cast<size_t>(band)];
+
+            double centre = getBandCentre(band) / binHz;
+            if (centre >= static_cast<double>(numBins - 1))
+                continue;  // Above Nyquist for this sample rate: silent
+
+            // Bins whose centre falls inside [low edge, high edge)
+            int start = static_cast<int>(std::ceil(getBandEdge(band) / binHz));
+            int end = std::min(numBins, static_cast<int>(std::ceil(getBandEdge(band + 1) / binHz)));
+
+            if (end > start)
+            {
+                entry.start = start;
+                entry.count = end - start;
+            }
+            else
+            {
+                entry.start = static_cast<int>(centre);
+                entry.fraction = static_cast<float>(centre - static_cast<double>(entry.start));
+            }
+        }
+
+        return mapping;
+    }
+
+    /// Mapping from the bins of a log-layout frame, whose bin b covers band b of binGrid.
+    BinMapping createBinMapping(const LogFrequencyGrid& binGrid) const
+    {
+        BinMapping mapping;
+        mapping.entries.resize(static_cast<size_t>(numBands));
+
+        const int numBins = binGrid.getNumBands();
+
+        for (int band = 0; band < numBands; ++band)
+        {
+            auto& entry = mapping.entries[static_cast<size_t>(band)];
+
+            // Bin b's centre sits at b + 0.5 in binGrid's band coordinates
+            double centre = binGrid.frequencyToBand(getBandCentre(band)) - 0.5;
+            if (centre < 0.0 || centre >= static_cast<double>(numBins - 1))
+                continue;  // Outside the bins' range: silent
+
+            int start = std::max(0, static_cast<int>(std::ceil(binGrid.frequencyToBand(getBandEdge(band)) - 0.5f)));
+            int end = std::min(numBins, static_cast<int>(std::ceil(binGrid.frequencyToBand(getBandEdge(band + 1)) - 0.5f)));
+
+            if (end > start)
+            {
+                entry.start = start;
+                entry.count = end - start;
+            }
+            else
+            {
+                entry.start = static_cast<int>(centre);
+                entry.fraction = static_cast<float>(centre - static_cast<double>(entry.start));
+            }
+        }
+
+        return mapping;
+    }
+
+    /// Mapping for frames of either layout.
+    BinMapping createBinMapping(double sampleRate, BinLayout layout) const;
+
+private:
+    int numBands;
+    float minFrequency;
+    float maxFrequency;
+    float logRatio;
+};
+
+/// The bins of log-layout frames: NUM_BINS bands over the common grid's range (about
+/// 1/100 octave each), so a frame's low end can be far finer than FFT bins allow.
+inline const LogFrequencyGrid& getLogBinGrid()
+{
+    static const LogFrequencyGrid grid(SpectrumConstants::NUM_BINS);
+    return grid;
+}
+
+inline LogFrequencyGrid::BinMapping LogFrequencyGrid::createBinMapping(double sampleRate, BinLayout layout) const
+{
+    return layout == BinLayout::Log ? createBinMapping(getLogBinGrid())
+                                    : createBinMapping(sampleRate, SpectrumConstants::FFT_SIZE);
+}
+
+/// Fractional bin that a frequency falls at in a frame of the given layout (bin b
+/// covers [b - 0.5, b + 0.5)), and the centre frequency of a bin.
+inline double frequencyToBin(BinLayout layout, double sampleRate, double frequency)
+{
+    if (layout == BinLayout::Log)
+        return getLogBinGrid().frequencyToBand(static_cast<float>(frequency)) - 0.5;
+
+    return frequency * SpectrumConstants::FFT_SIZE / sampleRate;
+}
+
+inline double getBinFrequency(BinLayout layout, double sampleRate, double bin)
+{
+    if (layout == BinLayout::Log)
+    {
+        const auto& grid = getLogBinGrid();
+        return grid.getMinFrequency() * std::pow(static_cast<double>(grid.getMaxFrequency() / grid.getMinFrequency()),
+                                                 (bin + 0.5) / grid.getNumBands());
+    }
+
+    return bin * sampleRate / SpectrumConstants::FFT_SIZE;
+}
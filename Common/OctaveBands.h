@@ -0,0 +1,126 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include "SpectrumData.h"
+#include "LogFrequencyGrid.h"
+
+/// Fractional-octave band levels, as measured by the relay's filterbank analysis.
+///
+/// Bands are base-2 (IEC 61260) with 1 kHz as a band centre: 31 third-octave
+/// bands from 20 Hz to 20 kHz, or 62 sixth-octave bands over the same range.
+/// A frame carries the bands below the relay's Nyquist limit, lowest first; the
+/// analyzer rebuilds a log-layout spectrum from it with reconstruct(), so
+/// everything downstream of ingest is unchanged.
+///
+/// Levels are RMS amplitudes scaled by sqrt(2), so a sine at a band centre reads
+/// its amplitude as it does in the spectrum. Broadband signals read the power of
+/// the whole band, well above what a single FFT bin of the same signal shows.
+namespace OctaveBands
+{
+    /// Layout version at the start of the blob (same rules as the frame header).
+    constexpr int FORMAT_VERSION = 1;
+
+    constexpr int MAX_BANDS = 62;
+
+    inline bool isValidBandsPerOctave(int bandsPerOctave)
+    {
+        return bandsPerOctave == 3 || bandsPerOctave == 6;
+    }
+
+    /// 31 bands at 1/3 octave, 62 at 1/6.
+    inline int getNumBands(int bandsPerOctave)
+    {
+        return bandsPerOctave == 6 ? 62 : 31;
+    }
+
+    /// Centre of a band (band 0 is the one at ~20 Hz).
+    inline double getCentreFrequency(int bandsPerOctave, int band)
+    {
+        const int referenceBand = bandsPerOctave == 6 ? 34 : 17;  // The 1 kHz band
+        return 1000.0 * std::pow(2.0, static_cast<double>(band - referenceBand) / bandsPerOctave);
+    }
+
+    /// Lower (edge -1) or upper (edge +1) edge of a band, half a band from its centre.
+    inline double getBandEdge(int bandsPerOctave, int band, int edge)
+    {
+        return getCentreFrequency(bandsPerOctave, band) * std::pow(2.0, 0.5 * edge / bandsPerOctave);
+    }
+
+    struct BandFrame
+    {
+        int bandsPerOctave { 3 };
+        std::vector<float> levels;  // From band 0 up; bands beyond the relay's Nyquist are left out
+    };
+
+    /// Rebuilds NUM_BINS log-layout magnitudes: levels interpolated (in dB, on a log
+    /// frequency axis) between band centres, held below the lowest centre, and silent
+    /// above the top edge of the highest band sent.
+    inline void reconstruct(const BandFrame& frame, float* magnitudes)
+    {
+        const auto& grid = getLogBinGrid();
+        const int numBands = static_cast<int>(frame.levels.size());
+
+        std::array<float, MAX_BANDS> levelsDb {};
+        for (int band = 0; band < numBands; ++band)
+            levelsDb[static_cast<size_t>(band)] = 20.0f * std::log10(juce::jmax(1.0e-9f, frame.levels[static_cast<size_t>(band)]));
+
+        const double lowestCentre = getCentreFrequency(frame.bandsPerOctave, 0);
+        const double topEdge = numBands > 0 ? getBandEdge(frame.bandsPerOctave, numBands - 1, 1) : 0.0;
+
+        for (int bin = 0; bin < SpectrumConstants::NUM_BINS; ++bin)
+        {
+            const double frequency = grid.getBandCentre(bin);
+            if (frequency >= topEdge)
+            {
+                magnitudes[bin] = 0.0f;
+                continue;
+            }
+
+            const float position = juce::jlimit(0.0f, static_cast<float>(numBands - 1),
+                                                static_cast<float>(frame.bandsPerOctave * std::log2(frequency / lowestCentre)));
+            const int lower = juce::jmax(0, juce::jmin(static_cast<int>(position), numBands - 2));
+            const int upper = juce::jmin(lower + 1, numBands - 1);
+            const float fraction = position - static_cast<float>(lower);
+            const float db = levelsDb[static_cast<size_t>(lower)] * (1.0f - fraction)
+                           + levelsDb[static_cast<size_t>(upper)] * fraction;
+
+            magnitudes[bin] = std::pow(10.0f, db / 20.0f);
+        }
+    }
+
+    inline juce::MemoryBlock encode(const BandFrame& frame)
+    {
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream(block, false);
+            stream.writeInt(FORMAT_VERSION);
+            stream.writeInt(frame.bandsPerOctave);
+            stream.writeInt(static_cast<int>(frame.levels.size()));
+            for (float level : frame.levels)
+                stream.writeFloat(level);
+        }
+        return block;
+    }
+
+    /// Reuses frame.levels' storage.
+    inline bool decode(const juce::MemoryBlock& block, BandFrame& frame)
+    {
+        juce::MemoryInputStream stream(block, false);
+        if (block.getSize() < 12 || stream.readInt() < 1)
+            return false;
+
+        const int bandsPerOctave = stream.readInt();
+        const int numBands = stream.readInt();
+        if (!isValidBandsPerOctave(bandsPerOctave) || numBands < 1 || numBands > getNumBands(bandsPerOctave)
+            || static_cast<size_t>(numBands) * 4 + 12 > block.getSize())
+            return false;
+
+        frame.bandsPerOctave = bandsPerOctave;
+        frame.levels.resize(static_cast<size_t>(numBands));
+        for (auto& level : frame.levels)
+            level = stream.readFloat();
+
+        return true;
+    }
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include "SpectrumData.h"
+#include "LogFrequencyGrid.h"
+#include "AnalysisWindow.h"
+
+/// Sparse description of a spectrum: its strongest peaks, at sub-bin frequency
+/// resolution, over a coarse noise floor.
+///
+/// Relays in peak mode send this instead of all NUM_BINS magnitudes (about a
+/// tenth of the bytes); the analyzer rebuilds a full spectrum from it with
+/// reconstruct(), so everything downstream of ingest is unchanged.
+namespace SpectralPeaks
+{
+    /// Layout version at the start of the blob (same rules as the frame header).
+    /// 2 appends the analysis window; version 1 frames were all Hann.
+    constexpr int FORMAT_VERSION = 2;
+
+    /// Log bands the noise floor is sent on (20 Hz - 20 kHz, ~0.4 octave each).
+    constexpr int NUM_FLOOR_BANDS = 24;
+
+    struct Peak
+    {
+        float frequency { 0.0f };  // Hz, interpolated between bins
+        float magnitude { 0.0f };  // Same normalisation as the full spectrum
+    };
+
+    struct PeakFrame
+    {
+        std::vector<Peak> peaks;   // Strongest first
+        std::array<float, NUM_FLOOR_BANDS> floor {};  // Magnitude per floor band
+        AnalysisWindow::Choice window;                // Sets the shape of each peak
+    };
+
+    inline const LogFrequencyGrid& getFloorGrid()
+    {
+        static const LogFrequencyGrid grid(NUM_FLOOR_BANDS);
+        return grid;
+    }
+
+    /// True if a peak's frequency is between 0 and Nyquist and its magnitude is non-negative.
+    inline bool isValidPeak(const Peak& peak, double sampleRate)
+    {
+        return std::isfinite(peak.frequency) && peak.frequency >= 0.0f
+            && static_cast<double>(peak.frequency) <= sampleRate / 2.0
+            && std::isfinite(peak.magnitude) && peak.magnitude >= 0.0f;
+    }
+
+    /// Rebuilds NUM_BINS magnitudes: the floor interpolated (in dB, on a log frequency
+    /// axis) between band centres, with the main lobe of the frame's window on top of
+    /// each peak. Peaks decode() would reject are left out.
+    inline void reconstruct(const PeakFrame& frame, double sampleRate, float* magnitudes)
+    {
+        const auto& grid = getFloorGrid();
+        const float binHz = static_cast<float>(sampleRate / SpectrumConstants::FFT_SIZE);
+
+        std::array<float, NUM_FLOOR_BANDS> floorDb;
+        for (int band = 0; band < NUM_FLOOR_BANDS; ++band)
+            floorDb[static_cast<size_t>(band)] = 20.0f * std::log10(juce::jmax(1.0e-9f, frame.floor[static_cast<size_t>(band)]));
+
+        for (int bin = 0; bin < SpectrumConstants::NUM_BINS; ++bin)
+        {
+            const float position = juce::jlimit(0.0f, static_cast<float>(NUM_FLOOR_BANDS - 1),
+                                                grid.frequencyToBand(juce::jmax(1.0f, static_cast<float>(bin) * binHz)) - 0.5f);
+            const int lower = juce::jmin(static_cast<int>(position), NUM_FLOOR_BANDS - 2);
+            const float fraction = position - static_cast<float>(lower);
+            const float db = floorDb[static_cast<size_t>(lower)] * (1.0f - fraction)
+                           + floorDb[static_cast<size_t>(lower) + 1] * fraction;
+
+            magnitudes[bin] = std::pow(10.0f, db / 20.0f);
+        }
+
+        const float halfWidth = AnalysisWindow::getMainLobeHalfWidth(frame.window);
+
+        for (const auto& peak : frame.peaks)
+        {
+            // Out of range, the bin arithmetic below would overflow
+            if (!isValidPeak(peak, sampleRate))
+                continue;
+
+            const float centre = peak.frequency / binHz;
+            const int first = juce::jmax(0, static_cast<int>(std::ceil(centre - halfWidth)));
+            const int last = juce::jmin(SpectrumConstants::NUM_BINS - 1, static_cast<int>(std::floor(centre + halfWidth)));
+
+            for (int bin = first; bin <= last; ++bin)
+                magnitudes[bin] = juce::jmax(magnitudes[bin],
+                                             peak.magnitude * AnalysisWindow::getResponse(frame.window, static_cast<float>(bin) - centre));
+        }
+    }
+
+    inline juce::MemoryBlock encode(const PeakFrame& frame)
+    {
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream(block, false);
+            stream.writeInt(FORMAT_VERSION);
+            stream.writeInt(static_cast<int>(frame.peaks.size()));
+            for (const auto& peak : frame.peaks)
+            {
+                stream.writeFloat(peak.frequency);
+                stream.writeFloat(peak.magnitude);
+            }
+
+            stream.writeInt(NUM_FLOOR_BANDS);
+            for (float value : frame.floor)
+                stream.writeFloat(value);
+
+            stream.writeInt(static_cast<int>(frame.window.type));
+            stream.writeFloat(frame.window.kaiserBeta);
+        }
+        return block;
+    }
+
+    /// Reuses frame.peaks' storage. Fails if any peak is invalid for the sample rate
+    /// (see isValidPeak), as for any other malformed field.
+    inline bool decode(const juce::MemoryBlock& block, double sampleRate, PeakFrame& frame)
+    {
+        if (!(std::isfinite(sampleRate) && sampleRate > 0.0))
+            return false;
+
+        juce::MemoryInputStream stream(block, false);
+        const int version = block.getSize() < 8 ? 0 : stream.readInt();
+        if (version < 1)
+            return false;
+
+        const int numPeaks = stream.readInt();
+        if (numPeaks < 0 || static_cast<size_t>(numPeaks) * 8 + 12 > block.getSize())
+            return false;
+
+        frame.peaks.resize(static_cast<size_t>(numPeaks));
+        for (auto& peak : frame.peaks)
+        {
+            peak.frequency = stream.readFloat();
+            peak.magnitude = stream.readFloat();
+
+            if (!isValidPeak(peak, sampleRate))
+                return false;
+        }
+
+        if (stream.readInt() != NUM_FLOOR_BANDS || stream.getNumBytesRemaining() < NUM_FLOOR_BANDS * 4)
+            return false;
+
+        for (auto& value : frame.floor)
+            value = stream.readFloat();
+
+        frame.window = {};
+        if (version >= 2)
+        {
+            if (stream.getNumBytesRemaining() < 8)
+                return false;
+
+            const int type = stream.readInt();
+            const float beta = stream.readFloat();
+            if (type < 0 || type >= AnalysisWindow::NUM_TYPES || !(beta >= 0.0f && beta <= AnalysisWindow::MAX_KAISER_BETA))
+                return false;
+
+            frame.window = { static_cast<AnalysisWindow::Type>(type), beta };
+        }
+
+        return true;
+    }
+}
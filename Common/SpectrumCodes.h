@@ -0,0 +1,121 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <algorithm>
+#include <cstring>
+#include "SpectrumData.h"
+
+/// Spectrum levels as 16-bit dB codes: 0.01 dB steps up from MIN_DB, with 0
+/// meaning silence. Relays quantise at the source and send these instead of
+/// float magnitudes (half the bytes, and the log is taken once, where the
+/// spectrum is computed); sessions store the same codes, so a frame received
+/// this way is recorded without converting it again.
+///
+/// The conversions are branch-free with the log and exp done by bit
+/// manipulation and short polynomials, so loops over a frame vectorise. They
+/// are accurate to about 1e-4 dB, well inside a step.
+namespace SpectrumCodes
+{
+    /// Layout version at the start of the blob (same rules as the frame header).
+    constexpr int FORMAT_VERSION = 1;
+
+    constexpr float MIN_DB = -160.0f;
+    constexpr float DB_STEP = 0.01f;
+
+    /// Code for a power (squared magnitude): 10 log10(power) as steps above MIN_DB.
+    inline juce::uint16 fromPower(float power) noexcept
+    {
+        // power = 2^e * m with m in [sqrt(1/2), sqrt(2)), then ln(m) = 2 atanh(s) as a series in s.
+        // Clamping the bits (to 1e-30 and the largest finite float) keeps zero and negative
+        // powers below MIN_DB, so they read as silence, and infinities at the top code
+        juce::int32 bits;
+        std::memcpy(&bits, &power, sizeof(bits));
+        bits = std::min(std::max(bits, 0x0da24260), 0x7f7fffff);
+        const juce::int32 exponent = (bits - 0x3f3504f3) >> 23;
+        bits -= exponent * (1 << 23);
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        const float s = (mantissa - 1.0f) / (mantissa + 1.0f);
+        const float s2 = s * s;
+        const float lnMantissa = 2.0f * s * (1.0f + s2 * (1.0f / 3.0f + s2 * (1.0f / 5.0f + s2 * (1.0f / 7.0f))));
+
+        constexpr float decibelsPerOctave = 3.0103000f;    // 10 log10(2)
+        constexpr float decibelsPerNeper = 4.3429448f;     // 10 / ln(10)
+        const float db = static_cast<float>(exponent) * decibelsPerOctave + lnMantissa * decibelsPerNeper;
+
+        const float steps = (db - MIN_DB) * (1.0f / DB_STEP) + 0.5f;
+        return static_cast<juce::uint16>(static_cast<juce::int32>(std::min(65535.0f, std::max(0.0f, steps))));
+    }
+
+    inline juce::uint16 fromMagnitude(float magnitude) noexcept
+    {
+        return fromPower(magnitude * magnitude);
+    }
+
+    inline float toMagnitude(juce::uint16 code) noexcept
+    {
+        // 10^(dB / 20) = 2^x, split into 2^n (built in the exponent bits) and 2^f for f in [-0.5, 0.5]
+        constexpr float octavesPerDecibel = 0.16609640f;   // log2(10) / 20
+        const float x = (MIN_DB + static_cast<float>(code) * DB_STEP) * octavesPerDecibel;
+        const juce::int32 n = static_cast<juce::int32>(x + 1024.5f) - 1024;
+        const float f = (x - static_cast<float>(n)) * 0.69314718f;
+
+        const float fraction = 1.0f + f * (1.0f + f * (0.5f + f * (1.0f / 6.0f + f * (1.0f / 24.0f + f * (1.0f / 120.0f + f * (1.0f / 720.0f))))));
+
+        const juce::int32 bits = (n + 127) * (1 << 23);
+        float scale;
+        std::memcpy(&scale, &bits, sizeof(scale));
+
+        return fraction * scale * static_cast<float>(std::min(1, static_cast<int>(code)));
+    }
+
+    inline void toMagnitudes(const juce::uint16* codes, float* magnitudes, int numBins) noexcept
+    {
+        for (int i = 0; i < numBins; ++i)
+            magnitudes[i] = toMagnitude(codes[i]);
+    }
+
+    inline void fromMagnitudes(const float* magnitudes, juce::uint16* codes, int numBins) noexcept
+    {
+        for (int i = 0; i < numBins; ++i)
+            codes[i] = fromMagnitude(magnitudes[i]);
+    }
+
+    inline juce::MemoryBlock encode(BinLayout layout, const juce::uint16* codes, int numBins)
+    {
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream(block, false);
+            stream.writeInt(FORMAT_VERSION);
+            stream.writeInt(static_cast<int>(layout));
+            stream.writeInt(numBins);
+            for (int i = 0; i < numBins; ++i)
+                stream.writeShort(static_cast<short>(codes[i]));
+        }
+        return block;
+    }
+
+    /// Reuses codes' storage.
+    inline bool decode(const juce::MemoryBlock& block, BinLayout& layout, std::vector<juce::uint16>& codes)
+    {
+        juce::MemoryInputStream stream(block, false);
+        if (block.getSize() < 12 || stream.readInt() < 1)
+            return false;
+
+        const int layoutValue = stream.readInt();
+        const int numBins = stream.readInt();
+        if (layoutValue < 0 || layoutValue > static_cast<int>(BinLayout::Log)
+            || numBins < 1 || numBins > SpectrumConstants::NUM_BINS
+            || static_cast<size_t>(numBins) * 2 + 12 > block.getSize())
+            return false;
+
+        layout = static_cast<BinLayout>(layoutValue);
+        codes.resize(static_cast<size_t>(numBins));
+        for (auto& code : codes)
+            code = static_cast<juce::uint16>(stream.readShort());
+
+        return true;
+    }
+}
@@ -9,10 +9,21 @@ namespace SpectrumConstants
     constexpr int NUM_BINS = FFT_SIZE / 2;     // 1024 frequency bins
     constexpr int HOP_SIZE = FFT_SIZE / 4;     // 75% overlap
 
+    // Common log-frequency grid (1/48 octave over the audible range), used wherever
+    // tracks with different sample rates have to share one frequency axis
+    constexpr int LOG_GRID_NUM_BANDS = 480;
+    constexpr float LOG_GRID_MIN_FREQUENCY = 20.0f;
+    constexpr float LOG_GRID_MAX_FREQUENCY = 20000.0f;
+
     // OSC configuration
     constexpr int DEFAULT_OSC_PORT = 58964;
     constexpr const char* OSC_ADDRESS_PREFIX = "/wxc-tools/spectrum/";
     constexpr const char* OSC_HEARTBEAT_PREFIX = "/wxc-tools/heartbeat/";
+    constexpr const char* OSC_PEAKS_PREFIX = "/wxc-tools/peaks/";
+    constexpr const char* OSC_LOG_SPECTRUM_PREFIX = "/wxc-tools/logspectrum/";
+    constexpr const char* OSC_BANDS_PREFIX = "/wxc-tools/bands/";
+    constexpr const char* OSC_CODED_SPECTRUM_PREFIX = "/wxc-tools/dbspectrum/";
+    constexpr int MAX_SENT_PEAKS = 24;          // Peak mode: strongest peaks per frame
     constexpr int HEARTBEAT_INTERVAL_MS = 500;  // Send heartbeat every 0.5 seconds
 
     // Display configuration
@@ -20,3 +31,12 @@ namespace SpectrumConstants
     constexpr float MAX_DB = 0.0f;
     constexpr int TRACK_TIMEOUT_MS = 500;  // Mark track offline after 0.5 seconds of no data
 }
+
+/// How a frame's NUM_BINS magnitudes are spaced in frequency: FFT bins, sampleRate / FFT_SIZE
+/// apart, or log-spaced bins from the relay's multi-resolution analysis or rebuilt from its
+/// octave band levels (see getLogBinGrid()).
+enum class BinLayout
+{
+    Linear,
+    Log
+};
@@ -0,0 +1,485 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SpectrumData.h"
+#include "SpectralPeaks.h"
+#include "OctaveBands.h"
+#include "SpectrumCodes.h"
+
+/// OSC messages exchanged between relays (or tools posing as relays) and the analyzer.
+///
+/// Heartbeat: /wxc-tools/heartbeat/<trackId>
+///     [trackName, sampleRate, load]
+///
+/// Spectrum:  /wxc-tools/spectrum/<trackId>
+///     [trackName, fftSize, sampleRate, magnitude[0], ..., magnitude[NUM_BINS-1], header]
+///
+/// Peaks:     /wxc-tools/peaks/<trackId>
+///     [trackName, fftSize, sampleRate, peaks, header]
+///
+/// A spectrum sent as its strongest peaks over a coarse noise floor (see
+/// SpectralPeaks), for relays in peak mode.
+///
+/// Log spectrum: /wxc-tools/logspectrum/<trackId>
+///     [trackName, fftSize, sampleRate, magnitude[0], ..., magnitude[NUM_BINS-1], header]
+///
+/// Laid out like a spectrum message, but the bins are log-spaced (BinLayout::Log),
+/// from relays using multi-resolution analysis. Receivers that predate it ignore
+/// the address rather than misreading the bins.
+///
+/// Bands:     /wxc-tools/bands/<trackId>
+///     [trackName, sampleRate, bands, header]
+///
+/// 1/3- or 1/6-octave band levels (see OctaveBands) from relays using the
+/// filterbank analysis, at a fixed 100 frames per second: a host block spanning
+/// several frames sends each, stamped with its own sample position.
+///
+/// Coded spectrum: /wxc-tools/dbspectrum/<trackId>
+///     [trackName, fftSize, sampleRate, codes, header]
+///
+/// A spectrum (either layout) as 16-bit dB codes (see SpectrumCodes), as relays
+/// send it now: about 2 KB a frame instead of 5. The float messages above are
+/// still read, for older relays and tools.
+///
+/// The header blob is always the last argument. Receivers that predate it see
+/// one extra non-float "bin" past NUM_BINS and ignore it, and messages from
+/// relays that predate it simply have no blob. The heartbeat's processing load
+/// blob is optional in the same way.
+namespace SpectrumMessages
+{
+    /// Layout version written at the start of the header blob. Newer versions only
+    /// append fields, so readers accept any version and ignore what they don't know.
+    constexpr int HEADER_FORMAT_VERSION = 3;
+
+    /// Layout version of the heartbeat's processing load blob (same rules as the header).
+    constexpr int LOAD_FORMAT_VERSION = 1;
+
+    /// Level reported for silence (and before a meter has a full block).
+    constexpr float LOUDNESS_FLOOR_DB = -120.0f;
+
+    /// A relay's loudness meter at the time of a frame (see the relay's LoudnessMeter).
+    struct LoudnessReading
+    {
+        float momentaryLufs { LOUDNESS_FLOOR_DB };  // K-weighted (ITU-R BS.1770), last 400 ms
+        float shortTermLufs { LOUDNESS_FLOOR_DB };  // K-weighted, last 3 s
+        float rmsDb { LOUDNESS_FLOOR_DB };          // Unweighted, last 400 ms, dBFS
+        float truePeakDb { LOUDNESS_FLOOR_DB };     // 4x oversampled peak, last 400 ms, dBTP
+    };
+
+    /// Per-frame metadata carried in the header blob.
+    struct FrameHeader
+    {
+        juce::uint32 sequence { 0 };          // Per-track frame counter (wraps), for loss detection
+        juce::int64 captureTimeUs { 0 };      // getMonotonicTimeMicroseconds() when the audio arrived; 0 = unknown
+        juce::int64 hostSamplePosition { -1 }; // Host timeline position of the frame's last sample; -1 = unknown
+        bool hasLoudness { false };           // False for relays that predate metering
+        LoudnessReading loudness;
+    };
+
+    /// Monotonic clock shared by all processes on the machine (used for capture stamps,
+    /// so latencies are only meaningful between a relay and an analyzer on the same host).
+    inline juce::int64 getMonotonicTimeMicroseconds()
+    {
+        return static_cast<juce::int64>(static_cast<double>(juce::Time::getHighResolutionTicks())
+                                        * (1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond())));
+    }
+
+    /// A parsed spectrum message.
+    struct SpectrumFrame
+    {
+        juce::String trackId;
+        juce::String trackName;
+        double sampleRate { 0.0 };
+        BinLayout layout { BinLayout::Linear };
+        std::vector<float> magnitudes;
+        std::vector<juce::uint16> codes;  // The frame as sent, if it came as dB codes; empty otherwise
+        bool hasHeader { false };
+        FrameHeader header;
+    };
+
+    /// A relay's own audio thread cost since its previous heartbeat.
+    struct ProcessingLoad
+    {
+        juce::uint32 numBlocks { 0 };  // processBlock calls in the interval
+        float meanBlockUs { 0.0f };    // Mean time spent in processBlock
+        float maxBlockUs { 0.0f };     // Slowest single processBlock
+        float meanFftUs { 0.0f };      // Mean time per analysis frame (an FFT frame, or 10 ms of filterbank)
+        float load { 0.0f };           // Time in processBlock / duration of the audio processed
+        float peakLoad { 0.0f };       // Highest single block's share of its own duration
+    };
+
+    /// A parsed heartbeat message.
+    struct Heartbeat
+    {
+        juce::String trackId;
+        juce::String trackName;
+        double sampleRate { 0.0 };
+        bool hasLoad { false };        // False for relays that predate load reporting
+        ProcessingLoad load;
+    };
+
+    inline juce::MemoryBlock encodeHeader(const FrameHeader& header)
+    {
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream(block, false);
+            stream.writeInt(HEADER_FORMAT_VERSION);
+            stream.writeInt(static_cast<int>(header.sequence));
+            stream.writeInt64(header.captureTimeUs);
+            stream.writeInt64(header.hostSamplePosition);
+            stream.writeInt(header.hasLoudness ? 1 : 0);
+            stream.writeFloat(header.loudness.momentaryLufs);
+            stream.writeFloat(header.loudness.shortTermLufs);
+            stream.writeFloat(header.loudness.rmsDb);
+            stream.writeFloat(header.loudness.truePeakDb);
+        }
+        return block;
+    }
+
+    inline bool decodeHeader(const juce::MemoryBlock& block, FrameHeader& header)
+    {
+        if (block.getSize() < 8)
+            return false;
+
+        juce::MemoryInputStream stream(block, false);
+        if (stream.readInt() < 1)
+            return false;
+
+        header.sequence = static_cast<juce::uint32>(stream.readInt());
+
+        // Version 2 adds the capture stamps
+        header.captureTimeUs = 0;
+        header.hostSamplePosition = -1;
+        if (block.getSize() >= 24)
+        {
+            header.captureTimeUs = stream.readInt64();
+            header.hostSamplePosition = stream.readInt64();
+        }
+
+        // Version 3 adds the loudness reading
+        header.hasLoudness = false;
+        if (block.getSize() >= 44)
+        {
+            header.hasLoudness = stream.readInt() != 0;
+            header.loudness.momentaryLufs = stream.readFloat();
+            header.loudness.shortTermLufs = stream.readFloat();
+            header.loudness.rmsDb = stream.readFloat();
+            header.loudness.truePeakDb = stream.readFloat();
+        }
+
+        return true;
+    }
+
+    inline juce::MemoryBlock encodeProcessingLoad(const ProcessingLoad& load)
+    {
+        juce::MemoryBlock block;
+        {
+            juce::MemoryOutputStream stream(block, false);
+            stream.writeInt(LOAD_FORMAT_VERSION);
+            stream.writeInt(static_cast<int>(load.numBlocks));
+            stream.writeFloat(load.meanBlockUs);
+            stream.writeFloat(load.maxBlockUs);
+            stream.writeFloat(load.meanFftUs);
+            stream.writeFloat(load.load);
+            stream.writeFloat(load.peakLoad);
+        }
+        return block;
+    }
+
+    inline bool decodeProcessingLoad(const juce::MemoryBlock& block, ProcessingLoad& load)
+    {
+        if (block.getSize() < 28)
+            return false;
+
+        juce::MemoryInputStream stream(block, false);
+        if (stream.readInt() < 1)
+            return false;
+
+        load.numBlocks = static_cast<juce::uint32>(stream.readInt());
+        load.meanBlockUs = stream.readFloat();
+        load.maxBlockUs = stream.readFloat();
+        load.meanFftUs = stream.readFloat();
+        load.load = stream.readFloat();
+        load.peakLoad = stream.readFloat();
+        return true;
+    }
+
+    /// load may be nullptr (the message then looks like one from an older relay).
+    inline juce::OSCMessage createHeartbeatMessage(const juce::String& trackId,
+                                                   const juce::String& trackName,
+                                                   double sampleRate,
+                                                   const ProcessingLoad* load = nullptr)
+    {
+        juce::String address = SpectrumConstants::OSC_HEARTBEAT_PREFIX + trackId;
+
+        juce::OSCMessage message(address.toRawUTF8());
+        message.addString(trackName);
+        message.addFloat32(static_cast<float>(sampleRate));
+
+        if (load != nullptr)
+            message.addBlob(encodeProcessingLoad(*load));
+
+        return message;
+    }
+
+    inline juce::OSCMessage createSpectrumMessage(const juce::String& trackId,
+                                                  const juce::String& trackName,
+                                                  double sampleRate,
+                                                  const float* magnitudes,
+                                                  int numBins,
+                                                  const FrameHeader& header,
+                                                  BinLayout layout = BinLayout::Linear)
+    {
+        juce::String address = (layout == BinLayout::Log ? SpectrumConstants::OSC_LOG_SPECTRUM_PREFIX
+                                                         : SpectrumConstants::OSC_ADDRESS_PREFIX) + trackId;
+
+        juce::OSCMessage message(address.toRawUTF8());
+        message.addString(trackName);
+        message.addFloat32(static_cast<float>(SpectrumConstants::FFT_SIZE));
+        message.addFloat32(static_cast<float>(sampleRate));
+
+        for (int i = 0; i < numBins; ++i)
+            message.addFloat32(magnitudes[i]);
+
+        message.addBlob(encodeHeader(header));
+        return message;
+    }
+
+    inline juce::OSCMessage createCodedSpectrumMessage(const juce::String& trackId,
+                                                       const juce::String& trackName,
+                                                       double sampleRate,
+                                                       const juce::uint16* codes,
+                                                       int numBins,
+                                                       const FrameHeader& header,
+                                                       BinLayout layout = BinLayout::Linear)
+    {
+        juce::String address = SpectrumConstants::OSC_CODED_SPECTRUM_PREFIX + trackId;
+
+        juce::OSCMessage message(address.toRawUTF8());
+        message.addString(trackName);
+        message.addFloat32(static_cast<float>(SpectrumConstants::FFT_SIZE));
+        message.addFloat32(static_cast<float>(sampleRate));
+        message.addBlob(SpectrumCodes::encode(layout, codes, numBins));
+        message.addBlob(encodeHeader(header));
+        return message;
+    }
+
+    inline juce::OSCMessage createPeaksMessage(const juce::String& trackId,
+                                               const juce::String& trackName,
+                                               double sampleRate,
+                                               const SpectralPeaks::PeakFrame& peaks,
+                                               const FrameHeader& header)
+    {
+        juce::String address = SpectrumConstants::OSC_PEAKS_PREFIX + trackId;
+
+        juce::OSCMessage message(address.toRawUTF8());
+        message.addString(trackName);
+        message.addFloat32(static_cast<float>(SpectrumConstants::FFT_SIZE));
+        message.addFloat32(static_cast<float>(sampleRate));
+        message.addBlob(SpectralPeaks::encode(peaks));
+        message.addBlob(encodeHeader(header));
+        return message;
+    }
+
+    inline juce::OSCMessage createBandsMessage(const juce::String& trackId,
+                                               const juce::String& trackName,
+                                               double sampleRate,
+                                               const OctaveBands::BandFrame& bands,
+                                               const FrameHeader& header)
+    {
+        juce::String address = SpectrumConstants::OSC_BANDS_PREFIX + trackId;
+
+        juce::OSCMessage message(address.toRawUTF8());
+        message.addString(trackName);
+        message.addFloat32(static_cast<float>(sampleRate));
+        message.addBlob(OctaveBands::encode(bands));
+        message.addBlob(encodeHeader(header));
+        return message;
+    }
+
+    /// Size of the message on the wire (OSC 1.0 encoding), for bandwidth accounting.
+    inline size_t getEncodedSize(const juce::OSCMessage& message)
+    {
+        auto padded = [](size_t size) { return (size + 3) & ~static_cast<size_t>(3); };
+
+        // Address and type tag string (",ffs...") are null-terminated and padded to 4 bytes
+        size_t size = padded(message.getAddressPattern().toString().getNumBytesAsUTF8() + 1)
+                    + padded(static_cast<size_t>(message.size()) + 2);
+
+        for (const auto& argument : message)
+        {
+            if (argument.isString())
+                size += padded(argument.getString().getNumBytesAsUTF8() + 1);
+            else if (argument.isBlob())
+                size += 4 + padded(argument.getBlob().getSize());
+            else
+                size += 4;
+        }
+
+        return size;
+    }
+
+    /// Returns false if the message isn't a well-formed heartbeat.
+    inline bool parseHeartbeatMessage(const juce::OSCMessage& message, Heartbeat& heartbeat)
+    {
+        juce::String address = message.getAddressPattern().toString();
+        juce::String prefix = SpectrumConstants::OSC_HEARTBEAT_PREFIX;
+
+        if (!address.startsWith(prefix) || message.size() < 2)
+            return false;
+
+        if (!message[0].isString() || !message[1].isFloat32())
+            return false;
+
+        heartbeat.trackId = address.substring(prefix.length());
+        heartbeat.trackName = message[0].getString();
+        heartbeat.sampleRate = static_cast<double>(message[1].getFloat32());
+        heartbeat.hasLoad = message.size() >= 3 && message[2].isBlob()
+                         && decodeProcessingLoad(message[2].getBlob(), heartbeat.load);
+        return heartbeat.trackId.isNotEmpty();
+    }
+
+    /// Returns false if the message isn't a well-formed spectrum or log spectrum message.
+    /// Reuses frame.magnitudes' storage, so keep one SpectrumFrame around per receiver.
+    inline bool parseSpectrumMessage(const juce::OSCMessage& message, SpectrumFrame& frame)
+    {
+        juce::String address = message.getAddressPattern().toString();
+        juce::String prefix = SpectrumConstants::OSC_ADDRESS_PREFIX;
+        frame.layout = BinLayout::Linear;
+
+        if (!address.startsWith(prefix))
+        {
+            prefix = SpectrumConstants::OSC_LOG_SPECTRUM_PREFIX;
+            frame.layout = BinLayout::Log;
+        }
+
+        if (!address.startsWith(prefix) || message.size() < 4)
+            return false;
+
+        if (!message[0].isString() || !message[1].isFloat32() || !message[2].isFloat32())
+            return false;
+
+        frame.trackId = address.substring(prefix.length());
+        if (frame.trackId.isEmpty())
+            return false;
+
+        frame.trackName = message[0].getString();
+        frame.sampleRate = static_cast<double>(message[2].getFloat32());
+        frame.codes.clear();
+
+        // Optional header blob in the last argument (absent from older relays)
+        int numArgs = message.size();
+        frame.hasHeader = false;
+        if (message[numArgs - 1].isBlob())
+        {
+            frame.hasHeader = decodeHeader(message[numArgs - 1].getBlob(), frame.header);
+            --numArgs;
+        }
+
+        // Magnitudes start at index 3
+        const int numBins = numArgs - 3;
+        frame.magnitudes.resize(static_cast<size_t>(numBins));
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            const auto& argument = message[i + 3];
+            frame.magnitudes[static_cast<size_t>(i)] = argument.isFloat32() ? argument.getFloat32() : 0.0f;
+        }
+
+        return numBins > 0;
+    }
+
+    /// Returns false if the message isn't a well-formed peaks message. On success
+    /// frame.magnitudes holds the spectrum rebuilt from the peaks (NUM_BINS values),
+    /// so it can be handled exactly like a parsed spectrum message.
+    inline bool parsePeaksMessage(const juce::OSCMessage& message, SpectrumFrame& frame,
+                                  SpectralPeaks::PeakFrame& peaks)
+    {
+        juce::String address = message.getAddressPattern().toString();
+        juce::String prefix = SpectrumConstants::OSC_PEAKS_PREFIX;
+
+        if (!address.startsWith(prefix) || message.size() < 4)
+            return false;
+
+        if (!message[0].isString() || !message[1].isFloat32() || !message[2].isFloat32() || !message[3].isBlob())
+            return false;
+
+        frame.trackId = address.substring(prefix.length());
+        frame.trackName = message[0].getString();
+        frame.sampleRate = static_cast<double>(message[2].getFloat32());
+        frame.layout = BinLayout::Linear;
+
+        // decode() also rejects a sample rate that is NaN or infinite
+        if (frame.trackId.isEmpty() || !SpectralPeaks::decode(message[3].getBlob(), frame.sampleRate, peaks))
+            return false;
+
+        frame.hasHeader = message.size() >= 5 && message[4].isBlob()
+                       && decodeHeader(message[4].getBlob(), frame.header);
+
+        frame.magnitudes.resize(static_cast<size_t>(SpectrumConstants::NUM_BINS));
+        SpectralPeaks::reconstruct(peaks, frame.sampleRate, frame.magnitudes.data());
+        frame.codes.clear();
+        return true;
+    }
+
+    /// Returns false if the message isn't a well-formed coded spectrum message. On success
+    /// frame.codes holds the codes as sent and frame.magnitudes the same bins decoded, so
+    /// it can be handled exactly like a parsed spectrum message. Reuses both vectors' storage.
+    inline bool parseCodedSpectrumMessage(const juce::OSCMessage& message, SpectrumFrame& frame)
+    {
+        juce::String address = message.getAddressPattern().toString();
+        juce::String prefix = SpectrumConstants::OSC_CODED_SPECTRUM_PREFIX;
+
+        if (!address.startsWith(prefix) || message.size() < 4)
+            return false;
+
+        if (!message[0].isString() || !message[1].isFloat32() || !message[2].isFloat32() || !message[3].isBlob())
+            return false;
+
+        frame.trackId = address.substring(prefix.length());
+        frame.trackName = message[0].getString();
+        frame.sampleRate = static_cast<double>(message[2].getFloat32());
+
+        if (frame.trackId.isEmpty() || !SpectrumCodes::decode(message[3].getBlob(), frame.layout, frame.codes))
+            return false;
+
+        frame.hasHeader = message.size() >= 5 && message[4].isBlob()
+                       && decodeHeader(message[4].getBlob(), frame.header);
+
+        frame.magnitudes.resize(frame.codes.size());
+        SpectrumCodes::toMagnitudes(frame.codes.data(), frame.magnitudes.data(), static_cast<int>(frame.codes.size()));
+        return true;
+    }
+
+    /// Returns false if the message isn't a well-formed bands message. frame.magnitudes
+    /// holds a log-layout spectrum rebuilt from the bands (NUM_BINS values), so it can
+    /// be handled exactly like a parsed spectrum message.
+    inline bool parseBandsMessage(const juce::OSCMessage& message, SpectrumFrame& frame,
+                                  OctaveBands::BandFrame& bands)
+    {
+        juce::String address = message.getAddressPattern().toString();
+        juce::String prefix = SpectrumConstants::OSC_BANDS_PREFIX;
+
+        if (!address.startsWith(prefix) || message.size() < 3)
+            return false;
+
+        if (!message[0].isString() || !message[1].isFloat32() || !message[2].isBlob())
+            return false;
+
+        frame.trackId = address.substring(prefix.length());
+        frame.trackName = message[0].getString();
+        frame.sampleRate = static_cast<double>(message[1].getFloat32());
+        frame.layout = BinLayout::Log;
+
+        if (frame.trackId.isEmpty() || frame.sampleRate <= 0.0 || !OctaveBands::decode(message[2].getBlob(), bands))
+            return false;
+
+        frame.hasHeader = message.size() >= 4 && message[3].isBlob()
+                       && decodeHeader(message[3].getBlob(), frame.header);
+
+        frame.magnitudes.resize(static_cast<size_t>(SpectrumConstants::NUM_BINS));
+        OctaveBands::reconstruct(bands, frame.magnitudes.data());
+        frame.codes.clear();
+        return true;
+    }
+}
@@ -0,0 +1,267 @@
+#include "AggregatorLink.h"
+#include "SessionFormat.h"
+
+/// One attached GUI. Owned by the server; removed on the next tick after it drops.
+/// It only asks for a full snapshot once its socket is up, since the server adds it
+/// to the list before JUCE hands it the socket.
+class AggregatorServer::Connection : public juce::InterprocessConnection
+{
+public:
+    Connection(std::atomic<bool>& newClientFlag)
+        : juce::InterprocessConnection(true, AggregatorLink::connectionMagic),
+          newClientWaiting(newClientFlag)
+    {
+    }
+
+    ~Connection() override
+    {
+        disconnect();
+    }
+
+    void connectionMade() override { newClientWaiting = true; }
+    void connectionLost() override { lost = true; }
+    void messageReceived(const juce::MemoryBlock&) override {}
+
+    std::atomic<bool> lost { false };
+
+private:
+    std::atomic<bool>& newClientWaiting;
+};
+
+//==============================================================================
+AggregatorServer::AggregatorServer(TrackManager& tm)
+    : trackManager(tm)
+{
+}
+
+AggregatorServer::~AggregatorServer()
+{
+    stop();
+}
+
+bool AggregatorServer::start(int newPort)
+{
+    stop();
+
+    if (!beginWaitingForSocket(newPort, "127.0.0.1"))
+        return false;
+
+    port = newPort;
+    startTimerHz(snapshotRateHz);
+    return true;
+}
+
+void AggregatorServer::stop()
+{
+    if (port == 0)
+        return;
+
+    stopTimer();
+    juce::InterprocessConnectionServer::stop();
+
+    const juce::ScopedLock sl(connectionLock);
+    connections.clear();
+    sentFrameCounts.clear();
+    port = 0;
+}
+
+int AggregatorServer::getNumClients() const
+{
+    const juce::ScopedLock sl(connectionLock);
+    return connections.size();
+}
+
+juce::InterprocessConnection* AggregatorServer::createConnectionObject()
+{
+    auto* connection = new Connection(newClientWaiting);
+
+    const juce::ScopedLock sl(connectionLock);
+    connections.add(connection);
+    return connection;
+}
+
+void AggregatorServer::timerCallback()
+{
+    const juce::ScopedLock sl(connectionLock);
+
+    for (int i = connections.size(); --i >= 0;)
+    {
+        if (connections[i]->lost.load())
+            connections.remove(i);
+    }
+
+    if (connections.isEmpty())
+        return;
+
+    // Presence on the relays' heartbeat interval; everything to a client that just attached
+    const auto now = juce::Time::getMillisecondCounter();
+    const bool includePresence = now - lastPresenceTime >= static_cast<juce::uint32>(SpectrumConstants::HEARTBEAT_INTERVAL_MS);
+    const bool includeAllSpectra = newClientWaiting.exchange(false);
+    if (includePresence || includeAllSpectra)
+        lastPresenceTime = now;
+
+    auto message = createSnapshot(includePresence || includeAllSpectra, includeAllSpectra);
+    if (message.isEmpty())
+        return;
+
+    // A connection without its socket yet gets the full snapshot once connectionMade() runs
+    for (auto* connection : connections)
+    {
+        if (connection->isConnected() && !connection->sendMessage(message))
+            connection->lost = true;
+    }
+}
+
+juce::MemoryBlock AggregatorServer::createSnapshot(bool includePresence, bool includeAllSpectra)
+{
+    trackManager.updateEnabledSnapshot(snapshot, snapshotLayoutVersion);
+
+    juce::MemoryOutputStream body;
+    int numEntries = 0;
+
+    for (const auto& track : snapshot)
+    {
+        if (includePresence)
+        {
+            body.writeString(track.trackId);
+            body.writeString(track.trackName);
+            body.writeDouble(track.sampleRate);
+
+            if (track.hasProcessingLoad)
+            {
+                auto load = SpectrumMessages::encodeProcessingLoad(track.processingLoad);
+                body.writeInt(static_cast<int>(load.getSize()));
+                body.write(load.getData(), load.getSize());
+            }
+            else
+            {
+                body.writeInt(0);
+            }
+
+            body.writeInt(0);
+            ++numEntries;
+        }
+
+        // Only tracks that received a frame since the last snapshot
+        auto& sentCount = sentFrameCounts[track.trackId];
+        if (track.status != TrackStatus::Active || track.lastSpectrumTime == 0
+            || (track.framesReceived == sentCount && !includeAllSpectra))
+            continue;
+
+        sentCount = track.framesReceived;
+
+        body.writeString(track.trackId);
+        body.writeString(track.trackName);
+        body.writeDouble(track.sampleRate);
+        body.writeInt(0);
+        body.writeInt(SpectrumConstants::NUM_BINS);
+        for (float magnitude : track.spectrum)
+            body.writeShort(static_cast<short>(SessionFormat::quantizeMagnitude(magnitude)));
+
+        body.writeInt(track.hasLoudness ? 1 : 0);
+        body.writeFloat(track.loudness.momentaryLufs);
+        body.writeFloat(track.loudness.shortTermLufs);
+        body.writeFloat(track.loudness.rmsDb);
+        body.writeFloat(track.loudness.truePeakDb);
+        body.writeInt(static_cast<int>(track.layout));
+        ++numEntries;
+    }
+
+    if (numEntries == 0)
+        return {};
+
+    juce::MemoryOutputStream message;
+    message.writeInt(AggregatorLink::protocolVersion);
+    message.writeInt(numEntries);
+    message.write(body.getData(), body.getDataSize());
+    return message.getMemoryBlock();
+}
+
+//==============================================================================
+AggregatorClient::AggregatorClient(TrackManager& tm)
+    : juce::InterprocessConnection(true, AggregatorLink::connectionMagic),
+      trackManager(tm)
+{
+    magnitudes.resize(SpectrumConstants::NUM_BINS);
+}
+
+AggregatorClient::~AggregatorClient()
+{
+    juce::InterprocessConnection::disconnect();
+}
+
+bool AggregatorClient::connect(int newPort)
+{
+    if (!connectToSocket("127.0.0.1", newPort, connectTimeoutMs))
+        return false;
+
+    port = newPort;
+    return true;
+}
+
+void AggregatorClient::disconnect()
+{
+    juce::InterprocessConnection::disconnect();
+    port = 0;
+}
+
+void AggregatorClient::connectionLost()
+{
+    if (onConnectionLost)
+        onConnectionLost();
+}
+
+void AggregatorClient::messageReceived(const juce::MemoryBlock& message)
+{
+    if (paused)
+        return;
+
+    juce::MemoryInputStream input(message, false);
+    if (input.readInt() != AggregatorLink::protocolVersion)
+        return;
+
+    const int numEntries = input.readInt();
+    for (int i = 0; i < numEntries && !input.isExhausted(); ++i)
+    {
+        const auto trackId = input.readString();
+        const auto trackName = input.readString();
+        const double sampleRate = input.readDouble();
+
+        SpectrumMessages::ProcessingLoad load;
+        bool hasLoad = false;
+        const int loadBytes = input.readInt();
+        if (loadBytes > 0)
+        {
+            juce::MemoryBlock loadBlock;
+            input.readIntoMemoryBlock(loadBlock, loadBytes);
+            hasLoad = SpectrumMessages::decodeProcessingLoad(loadBlock, load);
+        }
+
+        const int numBins = input.readInt();
+        if (numBins < 0 || numBins > SpectrumConstants::NUM_BINS)
+            return;
+
+        if (numBins == 0)
+        {
+            trackManager.updateTrackPresence(trackId, trackName, sampleRate, hasLoad ? &load : nullptr);
+            continue;
+        }
+
+        for (int bin = 0; bin < numBins; ++bin)
+            magnitudes[static_cast<size_t>(bin)] = SessionFormat::dequantizeMagnitude(static_cast<juce::uint16>(input.readShort()));
+
+        const bool hasLoudness = input.readInt() != 0;
+        SpectrumMessages::LoudnessReading loudness;
+        loudness.momentaryLufs = input.readFloat();
+        loudness.shortTermLufs = input.readFloat();
+        loudness.rmsDb = input.readFloat();
+        loudness.truePeakDb = input.readFloat();
+
+        const auto layout = input.readInt() == static_cast<int>(BinLayout::Log) ? BinLayout::Log : BinLayout::Linear;
+
+        // No header: frame loss and latency belong to the aggregator's relays, not this link
+        trackManager.updateTrack(trackId, trackName, magnitudes.data(), numBins, sampleRate, nullptr, layout);
+        if (hasLoudness)
+            trackManager.updateTrackLoudness(trackId, loudness);
+    }
+}
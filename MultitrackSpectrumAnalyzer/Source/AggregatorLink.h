@@ -0,0 +1,106 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+
+/// Local link between a headless aggregator (see HeadlessAggregator) and GUI
+/// instances attached to it with --attach.
+///
+/// The aggregator sends snapshots, not the raw frame stream: about 30 times a
+/// second, the newest spectrum of each track that received one since the last
+/// snapshot, plus every track's presence and relay load twice a second. Bins
+/// are quantized to 0.01 dB steps (see SessionFormat) to halve the size. An
+/// attached GUI feeds them into its own TrackManager, which then smooths,
+/// times out and displays them as it would live relays.
+///
+/// Snapshot message (juce::MemoryOutputStream encoding, little-endian):
+///     int version, int numEntries, then per entry:
+///     string trackId, string trackName, double sampleRate,
+///     int loadBytes, load blob (see SpectrumMessages::encodeProcessingLoad),
+///     int numBins (0 = presence only), numBins x uint16 quantized magnitudes,
+///     then if numBins > 0: int hasLoudness, 4 x float loudness reading
+///     (momentary, short-term, RMS, true peak; see SpectrumMessages::LoudnessReading),
+///     int layout (BinLayout: 0 = linear, 1 = log)
+namespace AggregatorLink
+{
+    constexpr int defaultPort = 58966;
+    constexpr int protocolVersion = 3;
+
+    /// InterprocessConnection framing magic ("WXCA").
+    constexpr juce::uint32 connectionMagic = 0x57584341;
+}
+
+/// Aggregator side: accepts GUI connections on 127.0.0.1 and sends them snapshots.
+class AggregatorServer : private juce::InterprocessConnectionServer,
+                         private juce::Timer
+{
+public:
+    AggregatorServer(TrackManager& trackManager);
+    ~AggregatorServer() override;
+
+    /// Starts listening on 127.0.0.1. False if the port is not available.
+    bool start(int port);
+    void stop();
+
+    bool isRunning() const { return port > 0; }
+    int getPort() const { return port; }
+    int getNumClients() const;
+
+private:
+    class Connection;
+
+    juce::InterprocessConnection* createConnectionObject() override;
+    void timerCallback() override;
+    juce::MemoryBlock createSnapshot(bool includePresence, bool includeAllSpectra);
+
+    TrackManager& trackManager;
+    int port { 0 };
+
+    juce::CriticalSection connectionLock;  // Connections are created on the listener thread
+    juce::OwnedArray<Connection> connections;
+    std::atomic<bool> newClientWaiting { false };
+
+    std::vector<TrackData> snapshot;
+    juce::uint32 snapshotLayoutVersion { 0 };
+    std::map<juce::String, juce::int64> sentFrameCounts;  // framesReceived when each track was last sent
+    juce::uint32 lastPresenceTime { 0 };
+
+    static constexpr int snapshotRateHz = 30;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AggregatorServer)
+};
+
+/// GUI side: receives snapshots from an aggregator into a TrackManager.
+class AggregatorClient : private juce::InterprocessConnection
+{
+public:
+    AggregatorClient(TrackManager& trackManager);
+    ~AggregatorClient() override;
+
+    /// Connects to an aggregator on 127.0.0.1. False if none is listening on the port.
+    bool connect(int port);
+    void disconnect();
+
+    bool isAttached() const { return isConnected(); }
+    int getPort() const { return port; }
+
+    /// While paused, snapshots are dropped (e.g. while a recorded session is playing).
+    void setPaused(bool shouldPause) { paused = shouldPause; }
+
+    /// Called on the message thread if the aggregator goes away.
+    std::function<void()> onConnectionLost;
+
+private:
+    void connectionMade() override {}
+    void connectionLost() override;
+    void messageReceived(const juce::MemoryBlock& message) override;
+
+    TrackManager& trackManager;
+    std::vector<float> magnitudes;  // Reused for every entry
+    int port { 0 };
+    bool paused { false };
+
+    static constexpr int connectTimeoutMs = 2000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AggregatorClient)
+};
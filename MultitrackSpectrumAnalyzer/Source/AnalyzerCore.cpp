@@ -0,0 +1,85 @@
+#include "AnalyzerCore.h"
+#include "PerfCounters.h"
+
+AnalyzerCore::AnalyzerCore()
+    : metricsExporter(trackManager)
+{
+}
+
+AnalyzerCore::~AnalyzerCore()
+{
+    metricsExporter.stop();
+    sessionRecorder.stop();
+    stopListening();
+}
+
+bool AnalyzerCore::startListening(int port)
+{
+    stopListening();
+
+    if (!oscReceiver.connect(port))
+        return false;
+
+    oscReceiver.addListener(this);
+    listeningPort = port;
+    return true;
+}
+
+void AnalyzerCore::stopListening()
+{
+    if (listeningPort == 0)
+        return;
+
+    oscReceiver.removeListener(this);
+    oscReceiver.disconnect();
+    listeningPort = 0;
+}
+
+void AnalyzerCore::oscMessageReceived(const juce::OSCMessage& message)
+{
+    if (inputPaused)
+        return;
+
+    Perf::add(Perf::Counter::packetsReceived);
+    Perf::add(Perf::Counter::bytesReceived, static_cast<juce::int64>(SpectrumMessages::getEncodedSize(message)));
+
+    SpectrumMessages::Heartbeat heartbeat;
+    bool isHeartbeat = false, isSpectrum = false;
+    {
+        Perf::ScopedTimer parseTimer(Perf::Timer::parse);
+
+        isHeartbeat = SpectrumMessages::parseHeartbeatMessage(message, heartbeat);
+        if (!isHeartbeat)
+            isSpectrum = SpectrumMessages::parseCodedSpectrumMessage(message, receivedFrame)
+                      || SpectrumMessages::parseSpectrumMessage(message, receivedFrame)
+                      || SpectrumMessages::parsePeaksMessage(message, receivedFrame, receivedPeaks)
+                      || SpectrumMessages::parseBandsMessage(message, receivedFrame, receivedBands);
+    }
+
+    // Handle heartbeat messages: /wxc-tools/heartbeat/<trackId>
+    if (isHeartbeat)
+    {
+        Perf::add(Perf::Counter::heartbeats);
+        trackManager.updateTrackPresence(heartbeat.trackId, heartbeat.trackName, heartbeat.sampleRate,
+                                         heartbeat.hasLoad ? &heartbeat.load : nullptr);
+        return;
+    }
+
+    // Handle spectrum messages: /wxc-tools/dbspectrum/<trackId> (decoded to magnitudes),
+    // /wxc-tools/spectrum/<trackId> or /wxc-tools/logspectrum/<trackId>,
+    // or /wxc-tools/peaks/<trackId> and /wxc-tools/bands/<trackId> already rebuilt into a full spectrum
+    if (isSpectrum)
+    {
+        Perf::add(Perf::Counter::spectrumFrames);
+        trackManager.updateTrack(receivedFrame.trackId, receivedFrame.trackName,
+                                 receivedFrame.magnitudes.data(),
+                                 static_cast<int>(receivedFrame.magnitudes.size()),
+                                 receivedFrame.sampleRate,
+                                 receivedFrame.hasHeader ? &receivedFrame.header : nullptr,
+                                 receivedFrame.layout);
+        sessionRecorder.recordFrame(receivedFrame);
+        return;
+    }
+
+    Perf::add(Perf::Counter::parseErrors);
+}
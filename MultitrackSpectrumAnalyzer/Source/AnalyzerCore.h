@@ -0,0 +1,52 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+#include "SessionRecorder.h"
+#include "MetricsExporter.h"
+
+/// The analyzer without its GUI: OSC ingest into a TrackManager, session
+/// recording and metrics export.
+///
+/// MainComponent displays one. In --headless mode (see HeadlessAggregator) one
+/// runs with no window at all, and GUIs attach to it over a local socket.
+/// Nothing here depends on a display or on repaints; the only timing it needs
+/// is a regular TrackManager::updateStaleTrack() call from its owner.
+class AnalyzerCore : private juce::OSCReceiver::Listener<juce::OSCReceiver::MessageLoopCallback>
+{
+public:
+    AnalyzerCore();
+    ~AnalyzerCore() override;
+
+    /// Binds the OSC port relays send to. False if it is taken (e.g. by an aggregator).
+    bool startListening(int port = SpectrumConstants::DEFAULT_OSC_PORT);
+    void stopListening();
+    bool isListening() const { return listeningPort > 0; }
+    int getListeningPort() const { return listeningPort; }
+
+    /// While paused, incoming messages are dropped unparsed, e.g. while a recorded
+    /// session is playing into the TrackManager.
+    void setInputPaused(bool shouldPause) { inputPaused = shouldPause; }
+    bool isInputPaused() const { return inputPaused; }
+
+    TrackManager& getTrackManager() { return trackManager; }
+    const TrackManager& getTrackManager() const { return trackManager; }
+    SessionRecorder& getSessionRecorder() { return sessionRecorder; }
+    MetricsExporter& getMetricsExporter() { return metricsExporter; }
+
+private:
+    void oscMessageReceived(const juce::OSCMessage& message) override;
+
+    juce::OSCReceiver oscReceiver;
+    SpectrumMessages::SpectrumFrame receivedFrame;  // Reused for every incoming spectrum message
+    SpectralPeaks::PeakFrame receivedPeaks;  // Reused by every peaks message
+    OctaveBands::BandFrame receivedBands;    // Reused by every bands message
+    TrackManager trackManager;
+    SessionRecorder sessionRecorder;
+    MetricsExporter metricsExporter;
+
+    int listeningPort { 0 };
+    bool inputPaused { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerCore)
+};
@@ -0,0 +1,90 @@
+#include "FrameScheduler.h"
+#include "PerfCounters.h"
+
+FrameScheduler::FrameScheduler(juce::Component& h, TrackManager& tm)
+    : host(h),
+      trackManager(tm),
+      vblankAttachment(&h, [this]() { onVBlank(); })
+{
+    startTimer(fallbackTimerIntervalMs);
+}
+
+FrameScheduler::~FrameScheduler()
+{
+    stopTimer();
+}
+
+void FrameScheduler::onVBlank()
+{
+    double now = juce::Time::getMillisecondCounterHiRes();
+    lastVBlankTimeMs = now;
+
+    // Adaptive cap: skip vblanks while minimised or in the background
+    if (now - lastFrameTimeMs < getMinFrameIntervalMs())
+        return;
+
+    runFrame();
+}
+
+void FrameScheduler::timerCallback()
+{
+    // Vblanks are still arriving, so they are driving frames
+    double now = juce::Time::getMillisecondCounterHiRes();
+    if (now - lastVBlankTimeMs < static_cast<double>(fallbackTimerIntervalMs))
+        return;
+
+    runFrame();
+}
+
+void FrameScheduler::runFrame()
+{
+    lastFrameTimeMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (lastFrameTimeMs - ratePeriodStartMs >= 1000.0)
+    {
+        displayRate = framesThisPeriod * 1000.0 / (lastFrameTimeMs - ratePeriodStartMs);
+        framesThisPeriod = 0;
+        ratePeriodStartMs = lastFrameTimeMs;
+    }
+
+    // Offline detection and decay animation (both bump the versions below)
+    trackManager.updateStaleTrack();
+
+    juce::uint32 layoutVersion = trackManager.getLayoutVersion();
+    if (layoutVersion != lastLayoutVersion)
+    {
+        lastLayoutVersion = layoutVersion;
+        if (onLayoutChanged)
+            onLayoutChanged();
+    }
+
+    // Nothing new and nothing animating: no repaint at all
+    juce::uint32 dataVersion = trackManager.getDataVersion();
+    if (dataVersion != lastDataVersion)
+    {
+        lastDataVersion = dataVersion;
+        ++framesThisPeriod;
+
+        // Frame pacing: time between frames that actually showed something new
+        if (lastDataFrameTimeMs > 0.0)
+            Perf::record(Perf::Timer::frameInterval, juce::roundToInt((lastFrameTimeMs - lastDataFrameTimeMs) * 1000.0));
+        lastDataFrameTimeMs = lastFrameTimeMs;
+
+        if (onDataChanged)
+            onDataChanged();
+    }
+}
+
+double FrameScheduler::getMinFrameIntervalMs() const
+{
+    if (auto* peer = host.getPeer())
+    {
+        if (peer->isMinimised())
+            return minimisedFrameIntervalMs;
+    }
+
+    if (!juce::Process::isForegroundProcess())
+        return backgroundFrameIntervalMs;
+
+    return 0.0;
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+
+/// Single display-rate driver for the whole UI.
+///
+/// Runs from the host component's vblank and only fires callbacks when the
+/// TrackManager reports new data, a layout change, or an offline track that is
+/// still decaying. When the window is minimised or the app is in the
+/// background the frame rate is capped, and a slow fallback timer keeps
+/// offline detection running if vblanks stop arriving altogether (e.g. the
+/// window is fully occluded).
+class FrameScheduler : private juce::Timer
+{
+public:
+    FrameScheduler(juce::Component& host, TrackManager& trackManager);
+    ~FrameScheduler() override;
+
+    /// Called when any track's data changed since the last frame.
+    std::function<void()> onDataChanged;
+
+    /// Called when tracks were added, reordered or changed state.
+    std::function<void()> onLayoutChanged;
+
+    /// Frames per second that actually delivered new data, averaged over the last second.
+    double getDisplayRate() const { return displayRate; }
+
+private:
+    void onVBlank();
+    void timerCallback() override;
+    void runFrame();
+    double getMinFrameIntervalMs() const;
+
+    juce::Component& host;
+    TrackManager& trackManager;
+    juce::VBlankAttachment vblankAttachment;
+
+    juce::uint32 lastDataVersion { 0 };
+    juce::uint32 lastLayoutVersion { 0 };
+    double lastFrameTimeMs { 0.0 };
+    double lastVBlankTimeMs { 0.0 };
+    double lastDataFrameTimeMs { 0.0 };
+
+    // Display rate measurement
+    int framesThisPeriod { 0 };
+    double ratePeriodStartMs { 0.0 };
+    double displayRate { 0.0 };
+
+    // Frame rate caps when the window isn't in front of the user
+    static constexpr double backgroundFrameIntervalMs = 1000.0 / 30.0;
+    static constexpr double minimisedFrameIntervalMs = 1000.0 / 4.0;
+
+    // Fallback housekeeping when vblanks stop (occluded or hidden window)
+    static constexpr int fallbackTimerIntervalMs = 250;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(FrameScheduler)
+};
@@ -0,0 +1,82 @@
+#include "HeadlessAggregator.h"
+
+HeadlessAggregator::HeadlessAggregator()
+    : server(core.getTrackManager())
+{
+}
+
+HeadlessAggregator::~HeadlessAggregator()
+{
+    stopTimer();
+    server.stop();
+
+    // Finished here rather than by the core, so a failure gets logged
+    auto& recorder = core.getSessionRecorder();
+    const auto recordFile = recorder.getStats().file;
+    if (recorder.isRecording() && !recorder.stop())
+        juce::Logger::writeToLog("Could not finish writing " + recordFile.getFullPathName());
+}
+
+bool HeadlessAggregator::start(const Options& options, juce::String& error)
+{
+    if (!core.startListening(options.oscPort))
+    {
+        error = "Failed to bind to port " + juce::String(options.oscPort);
+        return false;
+    }
+
+    if (!server.start(options.linkPort))
+    {
+        error = "Could not serve attached GUIs on port " + juce::String(options.linkPort);
+        return false;
+    }
+
+    if (options.metricsPort > 0 && !core.getMetricsExporter().start(options.metricsPort))
+    {
+        error = "Metrics exporter could not bind to port " + juce::String(options.metricsPort);
+        return false;
+    }
+
+    if (options.recordFile != juce::File() && !core.getSessionRecorder().start(options.recordFile))
+    {
+        error = "Could not create " + options.recordFile.getFullPathName();
+        return false;
+    }
+
+    startTimer(staleCheckIntervalMs);
+    logStatus();
+    return true;
+}
+
+void HeadlessAggregator::timerCallback()
+{
+    core.getTrackManager().updateStaleTrack();
+
+    if (juce::Time::getMillisecondCounter() - lastStatusLogTime >= statusLogIntervalMs)
+        logStatus();
+}
+
+void HeadlessAggregator::logStatus()
+{
+    lastStatusLogTime = juce::Time::getMillisecondCounter();
+
+    auto& trackManager = core.getTrackManager();
+    auto stats = trackManager.getIngestStats();
+
+    juce::String status = "Listening on port " + juce::String(core.getListeningPort())
+                        + " | Active tracks: " + juce::String(trackManager.getTrackCount())
+                        + " | Frames received: " + juce::String(stats.framesReceived)
+                        + ", dropped: " + juce::String(stats.framesDropped)
+                        + " | GUIs attached on port " + juce::String(server.getPort()) + ": "
+                        + juce::String(server.getNumClients());
+
+    auto& recorder = core.getSessionRecorder();
+    if (recorder.isRecording())
+        status += " | Recording " + recorder.getStats().file.getFullPathName();
+
+    auto& metricsExporter = core.getMetricsExporter();
+    if (metricsExporter.isRunning())
+        status += " | Metrics: 127.0.0.1:" + juce::String(metricsExporter.getPort());
+
+    juce::Logger::writeToLog(status);
+}
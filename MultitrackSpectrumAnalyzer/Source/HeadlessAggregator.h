@@ -0,0 +1,42 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "AnalyzerCore.h"
+#include "AggregatorLink.h"
+
+/// The analyzer's --headless mode: an AnalyzerCore with no window, for a
+/// machine racked next to the DAW. It ingests, aggregates, optionally records
+/// and exports metrics, and serves snapshots to GUIs started with --attach.
+///
+/// Without a display there is no vblank to drive the TrackManager, so a timer
+/// does the offline detection the FrameScheduler does in the GUI.
+class HeadlessAggregator : private juce::Timer
+{
+public:
+    struct Options
+    {
+        int oscPort { SpectrumConstants::DEFAULT_OSC_PORT };
+        int linkPort { AggregatorLink::defaultPort };
+        int metricsPort { 0 };   // 0 = no metrics export
+        juce::File recordFile;   // Empty = don't record
+    };
+
+    HeadlessAggregator();
+    ~HeadlessAggregator() override;
+
+    /// Binds everything the options ask for. On failure returns false and describes why in error.
+    bool start(const Options& options, juce::String& error);
+
+private:
+    void timerCallback() override;
+    void logStatus();
+
+    AnalyzerCore core;
+    AggregatorServer server;
+    juce::uint32 lastStatusLogTime { 0 };
+
+    static constexpr int staleCheckIntervalMs = 100;
+    static constexpr juce::uint32 statusLogIntervalMs = 60000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HeadlessAggregator)
+};
@@ -0,0 +1,123 @@
+#include "LatencyOverlay.h"
+
+LatencyOverlay::LatencyOverlay(TrackManager& tm)
+    : trackManager(tm)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+LatencyOverlay::~LatencyOverlay()
+{
+}
+
+void LatencyOverlay::refresh()
+{
+    rows.clear();
+    numHiddenRows = 0;
+
+    TrackListEntry entry;
+    Row row;
+
+    for (int i = 0; trackManager.getTrackListEntry(i, entry); ++i)
+    {
+        if (!entry.enabled || !trackManager.getLatencyTracker().getSummary(entry.trackId, row.summary))
+            continue;
+
+        if (static_cast<int>(rows.size()) >= maxRows)
+        {
+            ++numHiddenRows;
+            continue;
+        }
+
+        row.name = entry.trackName;
+        row.colour = entry.colour;
+        rows.push_back(row);
+    }
+
+    repaint();
+}
+
+int LatencyOverlay::getPreferredHeight() const
+{
+    int numLines = juce::jmax(1, static_cast<int>(rows.size())) + (numHiddenRows > 0 ? 1 : 0);
+    return headerHeight + numLines * rowHeight + 6;
+}
+
+void LatencyOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colour(0xe0202020));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    auto area = getLocalBounds().reduced(6, 3);
+    g.setFont(juce::FontOptions(11.0f));
+
+    // Columns: name | ingest p50/p99 | present p50/p99 | present histogram
+    auto layoutRow = [](juce::Rectangle<int> rowArea)
+    {
+        std::array<juce::Rectangle<int>, 4> columns;
+        columns[0] = rowArea.removeFromLeft(110);
+        columns[1] = rowArea.removeFromLeft(90);
+        columns[2] = rowArea.removeFromLeft(90);
+        columns[3] = rowArea.reduced(4, 2);
+        return columns;
+    };
+
+    auto header = layoutRow(area.removeFromTop(headerHeight));
+    g.setColour(juce::Colour(0xff808080));
+    g.drawText("Latency (ms)", header[0], juce::Justification::centredLeft);
+    g.drawText("ingest p50/p99", header[1], juce::Justification::centredRight);
+    g.drawText("present p50/p99", header[2], juce::Justification::centredRight);
+
+    if (rows.empty())
+    {
+        g.drawText("No timestamped frames", area.removeFromTop(rowHeight), juce::Justification::centredLeft);
+        return;
+    }
+
+    auto formatPair = [](double p50, double p99)
+    {
+        return juce::String(p50, 1) + " / " + juce::String(p99, 1);
+    };
+
+    for (const auto& row : rows)
+    {
+        auto columns = layoutRow(area.removeFromTop(rowHeight));
+
+        g.setColour(row.colour);
+        g.drawText(row.name, columns[0], juce::Justification::centredLeft, true);
+
+        g.setColour(juce::Colour(0xffc0c0c0));
+        g.drawText(formatPair(row.summary.ingestP50Ms, row.summary.ingestP99Ms), columns[1], juce::Justification::centredRight);
+        g.drawText(formatPair(row.summary.presentP50Ms, row.summary.presentP99Ms), columns[2], juce::Justification::centredRight);
+
+        drawHistogram(g, row.summary.present, columns[3].toFloat(), row.colour);
+    }
+
+    if (numHiddenRows > 0)
+    {
+        g.setColour(juce::Colour(0xff808080));
+        g.drawText("+" + juce::String(numHiddenRows) + " more", area.removeFromTop(rowHeight), juce::Justification::centredLeft);
+    }
+}
+
+void LatencyOverlay::drawHistogram(juce::Graphics& g, const LatencyHistogram& histogram, juce::Rectangle<float> area,
+                                   juce::Colour colour)
+{
+    // Buckets from 1 ms to ~1 s are the interesting range for display latency
+    constexpr int firstBucket = 14;
+    constexpr int lastBucket = 54;
+
+    juce::uint32 maxCount = 1;
+    for (int bucket = firstBucket; bucket <= lastBucket; ++bucket)
+        maxCount = juce::jmax(maxCount, histogram.getBucketCount(bucket));
+
+    const float barWidth = area.getWidth() / static_cast<float>(lastBucket - firstBucket + 1);
+
+    g.setColour(colour.withAlpha(0.7f));
+    for (int bucket = firstBucket; bucket <= lastBucket; ++bucket)
+    {
+        float height = area.getHeight() * static_cast<float>(histogram.getBucketCount(bucket)) / static_cast<float>(maxCount);
+        g.fillRect(area.getX() + (bucket - firstBucket) * barWidth, area.getBottom() - height,
+                   juce::jmax(1.0f, barWidth - 1.0f), height);
+    }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+
+/// Live table of per-track capture -> ingest -> present latency (p50/p99) with a
+/// small histogram of presentation latency, drawn over the spectrum view.
+class LatencyOverlay : public juce::Component
+{
+public:
+    LatencyOverlay(TrackManager& trackManager);
+    ~LatencyOverlay() override;
+
+    void paint(juce::Graphics& g) override;
+
+    /// Re-reads the latency figures and repaints. Called at the status bar's rate.
+    void refresh();
+
+    /// Height needed for the current rows, for the owner's layout.
+    int getPreferredHeight() const;
+
+private:
+    struct Row
+    {
+        juce::String name;
+        juce::Colour colour;
+        LatencySummary summary;
+    };
+
+    void drawHistogram(juce::Graphics& g, const LatencyHistogram& histogram, juce::Rectangle<float> area,
+                       juce::Colour colour);
+
+    TrackManager& trackManager;
+    std::vector<Row> rows;
+    int numHiddenRows { 0 };
+
+    static constexpr int maxRows = 16;
+    static constexpr int rowHeight = 16;
+    static constexpr int headerHeight = 20;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LatencyOverlay)
+};
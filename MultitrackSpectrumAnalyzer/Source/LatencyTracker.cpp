@@ -0,0 +1,116 @@
+#include "LatencyTracker.h"
+
+namespace
+{
+    constexpr double lowestBucketUs = 100.0;
+    constexpr double bucketsPerOctave = 4.0;
+}
+
+void LatencyHistogram::add(juce::int64 latencyUs)
+{
+    int bucket = 0;
+    if (latencyUs > lowestBucketUs)
+        bucket = static_cast<int>(std::log2(static_cast<double>(latencyUs) / lowestBucketUs) * bucketsPerOctave) + 1;
+
+    ++buckets[static_cast<size_t>(juce::jlimit(0, numBuckets - 1, bucket))];
+    ++count;
+}
+
+void LatencyHistogram::addFrom(const LatencyHistogram& other)
+{
+    for (size_t i = 0; i < buckets.size(); ++i)
+        buckets[i] += other.buckets[i];
+    count += other.count;
+}
+
+void LatencyHistogram::clear()
+{
+    buckets.fill(0);
+    count = 0;
+}
+
+double LatencyHistogram::getPercentileMs(double p) const
+{
+    if (count == 0)
+        return 0.0;
+
+    // Smallest bucket whose cumulative count reaches the target
+    juce::int64 target = juce::jmax(static_cast<juce::int64>(1),
+                                    static_cast<juce::int64>(std::ceil(p * static_cast<double>(count))));
+    juce::int64 cumulative = 0;
+
+    for (int bucket = 0; bucket < numBuckets; ++bucket)
+    {
+        cumulative += buckets[static_cast<size_t>(bucket)];
+        if (cumulative >= target)
+            return getBucketUpperMs(bucket);
+    }
+
+    return getBucketUpperMs(numBuckets - 1);
+}
+
+double LatencyHistogram::getBucketUpperMs(int bucket)
+{
+    return lowestBucketUs * std::pow(2.0, bucket / bucketsPerOctave) / 1000.0;
+}
+
+void LatencyTracker::recordIngest(const juce::String& trackId, juce::int64 captureTimeUs, juce::int64 ingestTimeUs)
+{
+    juce::ScopedLock sl(lock);
+    rotateWindowIfDue(ingestTimeUs);
+
+    tracks[trackId].ingest[static_cast<size_t>(currentWindow)].add(juce::jmax(static_cast<juce::int64>(0), ingestTimeUs - captureTimeUs));
+}
+
+void LatencyTracker::recordPresented(const juce::String& trackId, juce::int64 captureTimeUs, juce::int64 presentTimeUs)
+{
+    juce::ScopedLock sl(lock);
+    rotateWindowIfDue(presentTimeUs);
+
+    auto& track = tracks[trackId];
+    if (track.lastPresentedCaptureUs == captureTimeUs)
+        return;
+
+    track.lastPresentedCaptureUs = captureTimeUs;
+    track.present[static_cast<size_t>(currentWindow)].add(juce::jmax(static_cast<juce::int64>(0), presentTimeUs - captureTimeUs));
+}
+
+bool LatencyTracker::getSummary(const juce::String& trackId, LatencySummary& summary) const
+{
+    juce::ScopedLock sl(lock);
+
+    auto it = tracks.find(trackId);
+    if (it == tracks.end())
+        return false;
+
+    LatencyHistogram ingest;
+    summary.present.clear();
+    for (size_t window = 0; window < 2; ++window)
+    {
+        ingest.addFrom(it->second.ingest[window]);
+        summary.present.addFrom(it->second.present[window]);
+    }
+
+    summary.numFrames = ingest.getCount();
+    summary.ingestP50Ms = ingest.getPercentileMs(0.5);
+    summary.ingestP99Ms = ingest.getPercentileMs(0.99);
+    summary.presentP50Ms = summary.present.getPercentileMs(0.5);
+    summary.presentP99Ms = summary.present.getPercentileMs(0.99);
+    return summary.numFrames > 0;
+}
+
+void LatencyTracker::rotateWindowIfDue(juce::int64 nowUs)
+{
+    if (nowUs - windowStartUs < windowLengthUs)
+        return;
+
+    // Start a new window, dropping the oldest
+    currentWindow = 1 - currentWindow;
+    windowStartUs = nowUs;
+
+    for (auto& pair : tracks)
+    {
+        pair.second.ingest[static_cast<size_t>(currentWindow)].clear();
+        pair.second.present[static_cast<size_t>(currentWindow)].clear();
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/// Latency histogram with quarter-octave buckets from 100 us to about 20 s.
+class LatencyHistogram
+{
+public:
+    static constexpr int numBuckets = 72;
+
+    void add(juce::int64 latencyUs);
+    void addFrom(const LatencyHistogram& other);
+    void clear();
+
+    juce::int64 getCount() const { return count; }
+
+    /// Latency (ms) below which fraction p (0-1) of the samples fall, at bucket resolution.
+    double getPercentileMs(double p) const;
+
+    juce::uint32 getBucketCount(int bucket) const { return buckets[static_cast<size_t>(bucket)]; }
+    static double getBucketUpperMs(int bucket);
+
+private:
+    std::array<juce::uint32, numBuckets> buckets {};
+    juce::int64 count { 0 };
+};
+
+/// Recent latency figures for one track.
+struct LatencySummary
+{
+    juce::int64 numFrames { 0 };
+    double ingestP50Ms { 0.0 };   // Capture in the relay -> TrackManager
+    double ingestP99Ms { 0.0 };
+    double presentP50Ms { 0.0 };  // Capture in the relay -> painted
+    double presentP99Ms { 0.0 };
+    LatencyHistogram present;
+};
+
+/// Per-track capture -> ingest -> present latency, over the last 5-10 seconds.
+///
+/// Relays stamp each frame with a monotonic capture time (see SpectrumMessages).
+/// The TrackManager records ingest when a frame arrives, and the displays record
+/// presentation after painting a snapshot that contains it. With temporal
+/// smoothing the curve on screen blends several frames; latency is measured
+/// to the newest one.
+class LatencyTracker
+{
+public:
+    LatencyTracker() = default;
+
+    void recordIngest(const juce::String& trackId, juce::int64 captureTimeUs, juce::int64 ingestTimeUs);
+
+    /// Records presentation once per captured frame; repeat calls for the same frame are ignored.
+    void recordPresented(const juce::String& trackId, juce::int64 captureTimeUs, juce::int64 presentTimeUs);
+
+    /// False if no stamped frames have been seen for this track.
+    bool getSummary(const juce::String& trackId, LatencySummary& summary) const;
+
+private:
+    struct TrackLatency
+    {
+        // Two windows: the current one and the one before, so figures never cover less than one window
+        std::array<LatencyHistogram, 2> ingest;
+        std::array<LatencyHistogram, 2> present;
+        juce::int64 lastPresentedCaptureUs { 0 };
+    };
+
+    void rotateWindowIfDue(juce::int64 nowUs);
+
+    std::map<juce::String, TrackLatency> tracks;
+    int currentWindow { 0 };
+    juce::int64 windowStartUs { 0 };
+    mutable juce::CriticalSection lock;
+
+    static constexpr juce::int64 windowLengthUs = 5000000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LatencyTracker)
+};
@@ -8,6 +8,7 @@
 
 #include <JuceHeader.h>
 #include "MainComponent.h"
+#include "HeadlessAggregator.h"
 
 //==============================================================================
 class MultitrackSpectrumAnalyzerApplication  : public juce::JUCEApplication
@@ -25,7 +26,68 @@ public:
     {
         // This method is where you should put your application's initialisation code..
 
-        mainWindow.reset (new MainWindow (getApplicationName()));
+        // --metrics serves Prometheus metrics on the default port, --metrics-port <port> on another
+        juce::ArgumentList args (getApplicationName(), getCommandLineParameterArray());
+        int metricsPort = 0;
+        if (args.containsOption ("--metrics-port"))
+            metricsPort = args.getValueForOption ("--metrics-port").getIntValue();
+        else if (args.containsOption ("--metrics"))
+            metricsPort = MetricsExporter::defaultPort;
+
+        // --headless runs the ingest core with no window, for GUIs to --attach [port] to
+        if (args.containsOption ("--headless"))
+        {
+            startHeadless (args, metricsPort);
+            return;
+        }
+
+        int attachPort = 0;
+        if (args.containsOption ("--attach"))
+        {
+            attachPort = args.getValueForOption ("--attach").getIntValue();
+            if (attachPort <= 0)
+                attachPort = AggregatorLink::defaultPort;
+        }
+
+        // --play <file> replays a recorded session instead of listening, at --speed <x> (0.25 to 16, default 1)
+        juce::File sessionFile;
+        double playbackSpeed = 1.0;
+        if (args.containsOption ("--play"))
+            sessionFile = args.getFileForOption ("--play");
+        if (args.containsOption ("--speed"))
+            playbackSpeed = args.getValueForOption ("--speed").getDoubleValue();
+
+        mainWindow.reset (new MainWindow (getApplicationName(), metricsPort, attachPort, sessionFile, playbackSpeed));
+    }
+
+    // --headless [--record [file]] [--metrics | --metrics-port <port>] [--serve-port <port>]
+    void startHeadless (const juce::ArgumentList& args, int metricsPort)
+    {
+        HeadlessAggregator::Options options;
+        options.metricsPort = metricsPort;
+
+        if (args.containsOption ("--serve-port"))
+            options.linkPort = args.getValueForOption ("--serve-port").getIntValue();
+
+        if (args.containsOption ("--record"))
+        {
+            auto value = args.getValueForOption ("--record");
+            options.recordFile = value.isNotEmpty() && ! value.startsWith ("-")
+                                   ? juce::File::getCurrentWorkingDirectory().getChildFile (value)
+                                   : SessionRecorder::getDefaultSessionDirectory()
+                                         .getChildFile ("session-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S")
+                                                        + SessionRecorder::fileExtension);
+        }
+
+        headlessAggregator = std::make_unique<HeadlessAggregator>();
+
+        juce::String error;
+        if (! headlessAggregator->start (options, error))
+        {
+            juce::Logger::writeToLog (error);
+            setApplicationReturnValue (1);
+            quit();
+        }
     }
 
     void shutdown() override
@@ -33,6 +95,7 @@ public:
         // Add your application's shutdown code here..
 
         mainWindow = nullptr; // (deletes our window)
+        headlessAggregator = nullptr;
     }
 
     //==============================================================================
@@ -58,14 +121,25 @@ public:
     class MainWindow    : public juce::DocumentWindow
     {
     public:
-        MainWindow (juce::String name)
+        MainWindow (juce::String name, int metricsPort, int attachPort, const juce::File& sessionFile, double playbackSpeed)
             : DocumentWindow (name,
                               juce::Desktop::getInstance().getDefaultLookAndFeel()
                                                           .findColour (juce::ResizableWindow::backgroundColourId),
                               DocumentWindow::allButtons)
         {
             setUsingNativeTitleBar (true);
-            setContentOwned (new MainComponent(), true);
+            auto* mainComponent = new MainComponent();
+            // A port that can't be bound is reported in the status bar
+            if (metricsPort > 0)
+                mainComponent->startMetricsExporter (metricsPort);
+
+            if (attachPort > 0)
+                mainComponent->attachToAggregator (attachPort);
+
+            if (sessionFile != juce::File())
+                mainComponent->openSession (sessionFile, true, playbackSpeed > 0.0 ? playbackSpeed : 1.0);
+
+            setContentOwned (mainComponent, true);
 
            #if JUCE_IOS || JUCE_ANDROID
             setFullScreen (true);
@@ -98,6 +172,7 @@ public:
 
 private:
     std::unique_ptr<MainWindow> mainWindow;
+    std::unique_ptr<HeadlessAggregator> headlessAggregator;
 };
 
 //==============================================================================
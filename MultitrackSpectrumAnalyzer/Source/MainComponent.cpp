@@ -1,9 +1,52 @@
 #include "MainComponent.h"
 #include "../../Common/SpectrumData.h"
 
+/// Runs an OfflineAnalysis behind a progress window, then hands the session file back.
+class MainComponent::AnalysisTask : public juce::ThreadWithProgressWindow
+{
+public:
+    AnalysisTask(const juce::Array<juce::File>& files, const juce::File& sessionFile,
+                 std::function<void(const OfflineAnalysis::Result&)> onFinished)
+        : juce::ThreadWithProgressWindow("Analysing " + juce::String(files.size()) + " file(s)", true, true),
+          analysis(files, {}),
+          file(sessionFile),
+          finished(std::move(onFinished))
+    {
+    }
+
+    void run() override
+    {
+        result = analysis.run(file, [this](double progress)
+        {
+            setProgress(progress);
+            return !threadShouldExit();
+        });
+    }
+
+    void threadComplete(bool) override
+    {
+        finished(result);
+    }
+
+    const juce::File& getSessionFile() const { return file; }
+
+private:
+    OfflineAnalysis analysis;
+    juce::File file;
+    OfflineAnalysis::Result result;
+    std::function<void(const OfflineAnalysis::Result&)> finished;
+};
+
 MainComponent::MainComponent()
     : trackListPanel(trackManager),
-      spectrumDisplay(trackManager)
+      spectrumDisplay(trackManager),
+      waterfallDisplay(trackManager),
+      latencyOverlay(trackManager),
+      maskingOverlay(trackManager),
+      perfHud(trackManager),
+      frameScheduler(*this, trackManager),
+      sessionPlayer(trackManager),
+      playbackBar(sessionPlayer)
 {
     // Title label
     titleLabel.setText("Multitrack Spectrum Analyzer", juce::dontSendNotification);
@@ -27,10 +70,26 @@ MainComponent::MainComponent()
     // Spectrum display
     addAndMakeVisible(spectrumDisplay);
 
+    // Waterfall display (shown instead of the spectrum display when toggled on)
+    addChildComponent(waterfallDisplay);
+
+    // Latency overlay (floats over the display when toggled on)
+    addChildComponent(latencyOverlay);
+
+    // Masking heatmap and worst pairs (bottom-right of the display when toggled on)
+    addChildComponent(maskingOverlay);
+
+    // Performance HUD (top-left of the display when toggled on)
+    addChildComponent(perfHud);
+
+    // Playback transport (above the status bar while a session is open)
+    addChildComponent(playbackBar);
+    playbackBar.onClose = [this]() { closeSession(); };
+    sessionPlayer.onFinished = [this]() { playbackBar.refresh(); };
+
     // Start OSC receiver
-    if (oscReceiver.connect(SpectrumConstants::DEFAULT_OSC_PORT))
+    if (core.startListening())
     {
-        oscReceiver.addListener(this);
         updateStatusLabel();
     }
     else
@@ -40,18 +99,107 @@ MainComponent::MainComponent()
         statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
     }
 
-    // Start timer for stale track removal and status updates
-    // 30Hz provides smooth visual updates and consistent decay with active tracks
-    startTimerHz(30);
+    // Stale track detection, decay and repaints are driven from the display's vblank,
+    // and only do work when the track data or layout actually changed
+    frameScheduler.onDataChanged = [this]()
+    {
+        // While frozen the waterfall holds still and the spectrum shows the history
+        if (freezeToggle.getToggleState())
+            spectrumDisplay.refresh();
+        else if (waterfallDisplay.isVisible())
+            waterfallDisplay.refresh();
+        else
+            spectrumDisplay.refresh();
+
+        if (maskingOverlay.isVisible()
+            && juce::Time::getMillisecondCounter() - lastMaskingUpdateTime >= maskingUpdateIntervalMs)
+        {
+            lastMaskingUpdateTime = juce::Time::getMillisecondCounter();
+            maskingOverlay.refresh();
+            layoutMaskingOverlay();
+        }
+
+        // Loudness meters and relay CPU figures (visible rows only)
+        if (juce::Time::getMillisecondCounter() - lastMeterUpdateTime >= meterUpdateIntervalMs)
+        {
+            lastMeterUpdateTime = juce::Time::getMillisecondCounter();
+            trackListPanel.refresh();
+        }
+
+        if (juce::Time::getMillisecondCounter() - lastStatusUpdateTime >= statusUpdateIntervalMs)
+        {
+            updateStatusLabel();
+
+            if (freezeToggle.getToggleState())
+                updateHistoryRange();
+
+            if (latencyOverlay.isVisible())
+            {
+                latencyOverlay.refresh();
+                layoutLatencyOverlay();
+            }
+
+            if (perfHud.isVisible())
+            {
+                perfHud.refresh();
+                layoutPerfHud();
+            }
+        }
+    };
+    frameScheduler.onLayoutChanged = [this]()
+    {
+        trackListPanel.refresh();
+        spectrumDisplay.refresh();
+        updateStatusLabel();
+    };
 
     setSize(800, 600);
 }
 
 MainComponent::~MainComponent()
 {
-    stopTimer();
-    oscReceiver.removeListener(this);
-    oscReceiver.disconnect();
+    sessionPlayer.close();
+    analysisTask.reset();
+}
+
+bool MainComponent::startMetricsExporter(int port)
+{
+    // Shown in the status bar from its next update
+    if (core.getMetricsExporter().start(port))
+    {
+        metricsError.clear();
+        return true;
+    }
+
+    metricsError = "Metrics exporter could not bind to port " + juce::String(port);
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
+    updateStatusLabel();
+    return false;
+}
+
+bool MainComponent::attachToAggregator(int port)
+{
+    if (!aggregatorClient.connect(port))
+    {
+        statusLabel.setText("No aggregator on port " + juce::String(port), juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
+        return false;
+    }
+
+    // The aggregator owns the relays' port and does any recording; this instance only displays
+    core.stopListening();
+    recordToggle.setEnabled(false);
+    recordToggle.setTooltip("Start the aggregator with --record to record while attached");
+    aggregatorClient.onConnectionLost = [this]()
+    {
+        statusLabel.setText("Lost the aggregator on port " + juce::String(aggregatorClient.getPort()),
+                            juce::dontSendNotification);
+        statusLabel.setColour(juce::Label::textColourId, juce::Colours::red);
+    };
+
+    statusLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    updateStatusLabel();
+    return true;
 }
 
 void MainComponent::paint(juce::Graphics& g)
@@ -79,82 +227,120 @@ void MainComponent::resized()
     // dB scaling dropdown (left side)
     dbScalingLabel.setBounds(controlArea.removeFromLeft(80));
     dbScalingCombo.setBounds(controlArea.removeFromLeft(120));
+    controlArea.removeFromLeft(20); // Spacing
 
-    // Status bar at bottom
+    // Waterfall, latency overlay and performance HUD toggles
+    waterfallToggle.setBounds(controlArea.removeFromLeft(100));
+    latencyToggle.setBounds(controlArea.removeFromLeft(90));
+    maskingToggle.setBounds(controlArea.removeFromLeft(90));
+    perfToggle.setBounds(controlArea.removeFromLeft(70));
+    longTermToggle.setBounds(controlArea.removeFromLeft(95));
+    resetLongTermButton.setBounds(controlArea.removeFromLeft(50).reduced(0, 2));
+    controlArea.removeFromLeft(10); // Spacing
+    freezeToggle.setBounds(controlArea.removeFromLeft(75));
+    recordToggle.setBounds(controlArea.removeFromLeft(80));
+    openSessionButton.setBounds(controlArea.removeFromLeft(110));
+
+    // Status bar at bottom, with the playback transport above it
     statusLabel.setBounds(area.removeFromBottom(30).reduced(10, 0));
+    if (playbackBar.isVisible())
+        playbackBar.setBounds(area.removeFromBottom(32));
+
+    // History scrubber while frozen
+    if (historySlider.isVisible())
+    {
+        auto historyArea = area.removeFromBottom(32).reduced(10, 4);
+        historyLabel.setBounds(historyArea.removeFromRight(80));
+        historySlider.setBounds(historyArea);
+    }
 
     // Left sidebar for track list (resizable)
     trackListPanel.setBounds(area.removeFromLeft(trackListPanel.getPreferredWidth()));
 
-    // Spectrum display fills remaining area
+    // Spectrum (or waterfall) display fills remaining area
     spectrumDisplay.setBounds(area);
+    waterfallDisplay.setBounds(area);
+    layoutLatencyOverlay();
+    layoutMaskingOverlay();
+    layoutPerfHud();
 }
 
-void MainComponent::oscMessageReceived(const juce::OSCMessage& message)
+void MainComponent::layoutLatencyOverlay()
 {
-    juce::String address = message.getAddressPattern().toString();
-
-    // Handle heartbeat messages: /wxc-tools/heartbeat/<trackId>
-    juce::String heartbeatPrefix = SpectrumConstants::OSC_HEARTBEAT_PREFIX;
-    if (address.startsWith(heartbeatPrefix))
-    {
-        juce::String trackId = address.substring(heartbeatPrefix.length());
-        if (trackId.isEmpty() || message.size() < 2)
-            return;
-
-        if (!message[0].isString() || !message[1].isFloat32())
-            return;
-
-        juce::String trackName = message[0].getString();
-        double sampleRate = static_cast<double>(message[1].getFloat32());
-        trackManager.updateTrackPresence(trackId, trackName, sampleRate);
-        return;
-    }
-
-    // Handle spectrum messages: /wxc-tools/spectrum/<trackId>
-    juce::String spectrumPrefix = SpectrumConstants::OSC_ADDRESS_PREFIX;
-    if (address.startsWith(spectrumPrefix))
-    {
-        juce::String trackId = address.substring(spectrumPrefix.length());
-        if (trackId.isEmpty())
-            return;
-
-        // Expected format: [trackName, fftSize, sampleRate, magnitude[0], ..., magnitude[NUM_BINS-1]]
-        if (message.size() < 4)
-            return;
-
-        if (!message[0].isString() || !message[1].isFloat32() || !message[2].isFloat32())
-            return;
-
-        juce::String trackName = message[0].getString();
-        double sampleRate = static_cast<double>(message[2].getFloat32());
-
-        // Parse spectrum data (starts at index 3)
-        int numBins = message.size() - 3;
-        std::vector<float> spectrumData(static_cast<size_t>(numBins));
-
-        for (int i = 0; i < numBins; ++i)
-        {
-            if (message[i + 3].isFloat32())
-                spectrumData[static_cast<size_t>(i)] = message[i + 3].getFloat32();
-        }
+    // Top-right corner of the display, clear of the axes
+    auto displayArea = spectrumDisplay.getBounds().reduced(15);
+    int height = juce::jmin(latencyOverlay.getPreferredHeight(), displayArea.getHeight());
+    latencyOverlay.setBounds(displayArea.removeFromTop(height).removeFromRight(juce::jmin(460, displayArea.getWidth())));
+}
 
-        // Update track manager with spectrum data
-        trackManager.updateTrack(trackId, trackName, spectrumData.data(), numBins, sampleRate);
-    }
+void MainComponent::layoutMaskingOverlay()
+{
+    // Bottom-right corner of the display, above the frequency axis labels
+    auto displayArea = spectrumDisplay.getBounds().reduced(15).withTrimmedBottom(20);
+    int height = juce::jmin(maskingOverlay.getPreferredHeight(), displayArea.getHeight());
+    maskingOverlay.setBounds(displayArea.removeFromBottom(height).removeFromRight(juce::jmin(420, displayArea.getWidth())));
 }
 
-void MainComponent::timerCallback()
+void MainComponent::layoutPerfHud()
 {
-    trackManager.updateStaleTrack();
-    updateStatusLabel();
+    // Top-left corner of the display, inside the amplitude axis labels
+    auto displayArea = spectrumDisplay.getBounds().reduced(15).withTrimmedLeft(40);
+    int height = juce::jmin(perfHud.getPreferredHeight(), displayArea.getHeight());
+    perfHud.setBounds(displayArea.removeFromTop(height).removeFromLeft(juce::jmin(620, displayArea.getWidth())));
 }
 
 void MainComponent::updateStatusLabel()
 {
+    lastStatusUpdateTime = juce::Time::getMillisecondCounter();
+
     int trackCount = trackManager.getTrackCount();
     juce::String statusText = "Listening on port " + juce::String(SpectrumConstants::DEFAULT_OSC_PORT);
+    if (aggregatorClient.isAttached())
+        statusText = "Attached to aggregator on port " + juce::String(aggregatorClient.getPort());
+    if (auto* reader = sessionPlayer.getReader())
+        statusText = "Playing " + reader->getFile().getFileName() + " (live input paused)";
     statusText += " | Active tracks: " + juce::String(trackCount);
+
+    // Ingest and render health, for sizing sessions (see Tools/RelayLoadGenerator)
+    auto stats = trackManager.getIngestStats();
+    if (stats.framesReceived > 0)
+    {
+        double dropPercent = 100.0 * static_cast<double>(stats.framesDropped)
+                           / static_cast<double>(stats.framesReceived + stats.framesDropped);
+        statusText += " | Frames received: " + juce::String(stats.framesReceived)
+                    + ", dropped: " + juce::String(stats.framesDropped)
+                    + " (" + juce::String(dropPercent, 1) + "%)";
+    }
+
+    // Relay CPU: 100% = one core's worth of processBlock time
+    auto sessionLoad = trackManager.getSessionLoad();
+    if (sessionLoad.numReporting > 0)
+    {
+        statusText += " | Relay CPU: " + juce::String(sessionLoad.totalLoad * 100.0, 1) + "%"
+                    + " (worst block " + juce::String(juce::roundToInt(sessionLoad.maxPeakLoad * 100.0)) + "%)";
+    }
+
+    statusText += " | Display: " + juce::String(juce::roundToInt(frameScheduler.getDisplayRate())) + " fps";
+
+    auto& sessionRecorder = core.getSessionRecorder();
+    if (sessionRecorder.isRecording())
+    {
+        auto recorderStats = sessionRecorder.getStats();
+        statusText += " | REC " + juce::String(static_cast<double>(recorderStats.bytesWritten) / (1024.0 * 1024.0), 1) + " MB, "
+                    + juce::String(recorderStats.framesRecorded) + " frames";
+        if (recorderStats.framesDropped > 0)
+            statusText += ", " + juce::String(recorderStats.framesDropped) + " not recorded";
+    }
+    else if (recordingError.isNotEmpty())
+    {
+        statusText += " | " + recordingError;
+    }
+
+    auto& metricsExporter = core.getMetricsExporter();
+    if (metricsExporter.isRunning())
+        statusText += " | Metrics: 127.0.0.1:" + juce::String(metricsExporter.getPort());
+    else if (metricsError.isNotEmpty())
+        statusText += " | " + metricsError;
     statusLabel.setText(statusText, juce::dontSendNotification);
 }
 
@@ -169,6 +355,8 @@ void MainComponent::setupDisplayControls()
 
     displayModeCombo.addItem("Overlay", 1);
     displayModeCombo.addItem("Stacked", 2);
+    displayModeCombo.addItem("Summed", 3);
+    displayModeCombo.addItem("Summed + Layers", 4);
     displayModeCombo.setSelectedId(1, juce::dontSendNotification);
     displayModeCombo.onChange = [this]() { onDisplayModeChanged(); };
     addAndMakeVisible(displayModeCombo);
@@ -185,6 +373,76 @@ void MainComponent::setupDisplayControls()
     dbScalingCombo.setSelectedId(1, juce::dontSendNotification);
     dbScalingCombo.onChange = [this]() { onDbScalingChanged(); };
     addAndMakeVisible(dbScalingCombo);
+
+    // Waterfall view toggle
+    waterfallToggle.setButtonText("Waterfall");
+    waterfallToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    waterfallToggle.onClick = [this]() { onWaterfallToggled(); };
+    addAndMakeVisible(waterfallToggle);
+
+    // Latency overlay toggle
+    latencyToggle.setButtonText("Latency");
+    latencyToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    latencyToggle.onClick = [this]() { onLatencyToggled(); };
+    addAndMakeVisible(latencyToggle);
+
+    // Masking overlay toggle
+    maskingToggle.setButtonText("Masking");
+    maskingToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    maskingToggle.setTooltip("Show where enabled tracks compete for the same frequencies, and the worst pairs");
+    maskingToggle.onClick = [this]() { onMaskingToggled(); };
+    addAndMakeVisible(maskingToggle);
+
+    // Performance HUD toggle
+    perfToggle.setButtonText("Perf");
+    perfToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    perfToggle.onClick = [this]() { onPerfToggled(); };
+    addAndMakeVisible(perfToggle);
+
+    // Long-term average / percentile curves, accumulated since startup or the last reset
+    longTermToggle.setButtonText("Long-term");
+    longTermToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    longTermToggle.setTooltip("Show each track's long-term average spectrum and 10-90th percentile range");
+    longTermToggle.onClick = [this]() { onLongTermToggled(); };
+    addAndMakeVisible(longTermToggle);
+
+    resetLongTermButton.setTooltip("Start the long-term curves again (e.g. for the next song)");
+    resetLongTermButton.onClick = [this]()
+    {
+        trackManager.resetStatistics();
+        spectrumDisplay.setShowLongTerm(longTermToggle.getToggleState());
+    };
+    resetLongTermButton.setEnabled(false);
+    addAndMakeVisible(resetLongTermButton);
+
+    // Freeze toggle: holds the display and scrubs back through the track history
+    freezeToggle.setButtonText("Freeze");
+    freezeToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    freezeToggle.setTooltip("Hold the display and scrub back through the last "
+                            + juce::String(SpectrumHistory::defaultHistorySeconds, 0) + " seconds");
+    freezeToggle.onClick = [this]() { onFreezeToggled(); };
+    addAndMakeVisible(freezeToggle);
+
+    historySlider.setSliderStyle(juce::Slider::LinearBar);
+    historySlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    historySlider.onValueChange = [this]() { onHistoryScrubbed(); };
+    addChildComponent(historySlider);
+
+    historyLabel.setFont(juce::FontOptions(13.0f));
+    historyLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    historyLabel.setJustificationType(juce::Justification::centredRight);
+    addChildComponent(historyLabel);
+
+    // Session recording toggle
+    recordToggle.setButtonText("Record");
+    recordToggle.setColour(juce::ToggleButton::textColourId, juce::Colours::lightgrey);
+    recordToggle.setColour(juce::ToggleButton::tickColourId, juce::Colours::red);
+    recordToggle.onClick = [this]() { onRecordToggled(); };
+    addAndMakeVisible(recordToggle);
+
+    // Session playback
+    openSessionButton.onClick = [this]() { onOpenSessionClicked(); };
+    addAndMakeVisible(openSessionButton);
 }
 
 void MainComponent::onDisplayModeChanged()
@@ -194,6 +452,10 @@ void MainComponent::onDisplayModeChanged()
         spectrumDisplay.setDisplayMode(DisplayMode::Overlay);
     else if (selectedId == 2)
         spectrumDisplay.setDisplayMode(DisplayMode::Stacked);
+    else if (selectedId == 3 || selectedId == 4)
+        spectrumDisplay.setDisplayMode(DisplayMode::Summed);
+
+    spectrumDisplay.setShowSumLayers(selectedId == 4);
 }
 
 void MainComponent::onDbScalingChanged()
@@ -204,3 +466,271 @@ void MainComponent::onDbScalingChanged()
     else if (selectedId == 2)
         spectrumDisplay.setDbScaling(DbScaling::Compressed);
 }
+
+void MainComponent::onWaterfallToggled()
+{
+    bool showWaterfall = waterfallToggle.getToggleState();
+    waterfallDisplay.setVisible(showWaterfall);
+    spectrumDisplay.setVisible(!showWaterfall);
+
+    // Bring the newly visible view up to date straight away
+    if (showWaterfall)
+        waterfallDisplay.refresh();
+    else
+        spectrumDisplay.refresh();
+}
+
+
+void MainComponent::onLatencyToggled()
+{
+    bool showLatency = latencyToggle.getToggleState();
+    latencyOverlay.setVisible(showLatency);
+
+    if (showLatency)
+    {
+        latencyOverlay.refresh();
+        layoutLatencyOverlay();
+    }
+}
+
+void MainComponent::onMaskingToggled()
+{
+    bool showMasking = maskingToggle.getToggleState();
+    maskingOverlay.setVisible(showMasking);
+
+    if (showMasking)
+    {
+        maskingOverlay.refresh();
+        layoutMaskingOverlay();
+    }
+}
+
+void MainComponent::onPerfToggled()
+{
+    bool showPerf = perfToggle.getToggleState();
+    perfHud.setVisible(showPerf);
+
+    if (showPerf)
+    {
+        perfHud.refresh();
+        layoutPerfHud();
+    }
+}
+
+void MainComponent::onLongTermToggled()
+{
+    bool showLongTerm = longTermToggle.getToggleState();
+    spectrumDisplay.setShowLongTerm(showLongTerm);
+    resetLongTermButton.setEnabled(showLongTerm);
+}
+
+void MainComponent::onFreezeToggled()
+{
+    const auto& history = trackManager.getHistory();
+    freezeSlot = freezeToggle.getToggleState() ? history.getNewestSlot() : -1;
+
+    if (freezeToggle.getToggleState() && freezeSlot < 0)
+    {
+        // Nothing recorded yet
+        freezeToggle.setToggleState(false, juce::dontSendNotification);
+        return;
+    }
+
+    const bool frozen = freezeSlot >= 0;
+    historySlider.setVisible(frozen);
+    historyLabel.setVisible(frozen);
+
+    if (frozen)
+    {
+        updateHistoryRange();
+        historySlider.setValue(0.0, juce::dontSendNotification);
+        onHistoryScrubbed();
+    }
+    else
+    {
+        spectrumDisplay.setFrozenSlot(-1);
+
+        if (waterfallDisplay.isVisible())
+            waterfallDisplay.refresh();
+    }
+
+    resized();
+}
+
+void MainComponent::updateHistoryRange()
+{
+    // The ring keeps filling while frozen, so the oldest rows drop off the start
+    const auto& history = trackManager.getHistory();
+    const double slotSeconds = 1.0 / history.getSlotsPerSecond();
+    const double oldestSeconds = static_cast<double>(history.getOldestSlot() - freezeSlot) * slotSeconds;
+
+    if (oldestSeconds > 0.0)
+    {
+        // Everything before the freeze has been overwritten: back to live
+        freezeToggle.setToggleState(false, juce::dontSendNotification);
+        onFreezeToggled();
+        return;
+    }
+
+    historySlider.setRange(juce::jmin(oldestSeconds, -slotSeconds), 0.0, slotSeconds);
+}
+
+void MainComponent::onHistoryScrubbed()
+{
+    const auto& history = trackManager.getHistory();
+    const double seconds = historySlider.getValue();
+
+    spectrumDisplay.setFrozenSlot(freezeSlot + juce::roundToInt(seconds * history.getSlotsPerSecond()));
+    historyLabel.setText(juce::String(seconds, 2) + " s", juce::dontSendNotification);
+}
+
+void MainComponent::onRecordToggled()
+{
+    auto& sessionRecorder = core.getSessionRecorder();
+    if (!recordToggle.getToggleState())
+    {
+        stopRecording();
+        updateStatusLabel();
+        return;
+    }
+
+    auto file = SessionRecorder::getDefaultSessionDirectory()
+                    .getChildFile("session-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S")
+                                  + SessionRecorder::fileExtension);
+
+    if (!sessionRecorder.start(file))
+    {
+        recordToggle.setToggleState(false, juce::dontSendNotification);
+        statusLabel.setText("Could not create " + file.getFullPathName(), juce::dontSendNotification);
+        return;
+    }
+
+    recordingError.clear();
+    updateStatusLabel();
+}
+
+void MainComponent::stopRecording()
+{
+    // Waits for the writer to finish the file, however long the disk takes
+    auto& sessionRecorder = core.getSessionRecorder();
+    const auto file = sessionRecorder.getStats().file;
+    if (!sessionRecorder.stop())
+        recordingError = "Could not finish writing " + file.getFileName() + " (it may only open by recovery)";
+}
+
+void MainComponent::onOpenSessionClicked()
+{
+    sessionChooser = std::make_unique<juce::FileChooser>("Open a recorded session",
+                                                         SessionRecorder::getDefaultSessionDirectory(),
+                                                         "*" + juce::String(SessionRecorder::fileExtension));
+
+    sessionChooser->launchAsync(juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+                                [this](const juce::FileChooser& chooser)
+                                {
+                                    auto file = chooser.getResult();
+                                    if (file.existsAsFile())
+                                        openSession(file, true);
+                                });
+}
+
+bool MainComponent::openSession(const juce::File& file, bool startPlaying, double speed)
+{
+    // Recording what is being played back would only duplicate the file
+    auto& sessionRecorder = core.getSessionRecorder();
+    if (sessionRecorder.isRecording())
+    {
+        stopRecording();
+        recordToggle.setToggleState(false, juce::dontSendNotification);
+    }
+
+    juce::String error;
+    if (!sessionPlayer.open(file, error))
+    {
+        closeSession();
+        statusLabel.setText("Could not open " + file.getFileName() + ": " + error, juce::dontSendNotification);
+        return false;
+    }
+
+    // Long-term curves describe the session from its start
+    trackManager.resetStatistics();
+
+    // Live input (relays or an aggregator) waits until the session is closed
+    core.setInputPaused(true);
+    aggregatorClient.setPaused(true);
+    recordToggle.setEnabled(false);
+    sessionPlayer.setSpeed(speed);
+    sessionPlayer.seek(0);
+    if (startPlaying)
+        sessionPlayer.play();
+
+    playbackBar.setVisible(true);
+    playbackBar.refresh();
+    resized();
+    updateStatusLabel();
+    return true;
+}
+
+void MainComponent::closeSession()
+{
+    sessionPlayer.close();
+    core.setInputPaused(false);
+    aggregatorClient.setPaused(false);
+    recordToggle.setEnabled(!aggregatorClient.isAttached());
+    playbackBar.setVisible(false);
+    resized();
+    updateStatusLabel();
+}
+
+bool MainComponent::isInterestedInFileDrag(const juce::StringArray& files)
+{
+    for (const auto& path : files)
+    {
+        if (OfflineAnalysis::isSupportedFile(juce::File(path)))
+            return true;
+    }
+
+    return false;
+}
+
+void MainComponent::filesDropped(const juce::StringArray& files, int, int)
+{
+    juce::Array<juce::File> audioFiles;
+    for (const auto& path : files)
+    {
+        juce::File file(path);
+        if (OfflineAnalysis::isSupportedFile(file))
+            audioFiles.add(file);
+    }
+
+    if (!audioFiles.isEmpty())
+        analyseFiles(audioFiles);
+}
+
+void MainComponent::analyseFiles(const juce::Array<juce::File>& files)
+{
+    if (analysisTask != nullptr)
+        return;
+
+    auto sessionFile = SessionRecorder::getDefaultSessionDirectory()
+                           .getChildFile("analysis-" + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S")
+                                         + SessionRecorder::fileExtension);
+
+    analysisTask = std::make_unique<AnalysisTask>(files, sessionFile, [this](const OfflineAnalysis::Result& result)
+    {
+        auto file = analysisTask->getSessionFile();
+
+        // The task is still on the stack here
+        juce::MessageManager::callAsync([safeThis = juce::Component::SafePointer<MainComponent>(this)]()
+        {
+            if (safeThis != nullptr)
+                safeThis->analysisTask.reset();
+        });
+
+        if (result.succeeded)
+            openSession(file, true);
+        else
+            statusLabel.setText("Analysis failed: " + result.error, juce::dontSendNotification);
+    });
+
+    analysisTask->launchThread();
+}
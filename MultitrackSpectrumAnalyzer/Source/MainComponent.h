@@ -1,13 +1,21 @@
 #pragma once
 
 #include <JuceHeader.h>
-#include "TrackManager.h"
+#include "AnalyzerCore.h"
+#include "AggregatorLink.h"
 #include "TrackListPanel.h"
 #include "SpectrumDisplay.h"
+#include "WaterfallDisplay.h"
+#include "FrameScheduler.h"
+#include "LatencyOverlay.h"
+#include "MaskingOverlay.h"
+#include "PerfHud.h"
+#include "SessionPlayer.h"
+#include "PlaybackBar.h"
+#include "OfflineAnalysis.h"
 
 class MainComponent : public juce::Component,
-                      private juce::OSCReceiver::Listener<juce::OSCReceiver::MessageLoopCallback>,
-                      private juce::Timer
+                      public juce::FileDragAndDropTarget
 {
 public:
     MainComponent();
@@ -16,13 +24,43 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
+    /// Serves Prometheus metrics on 127.0.0.1:port (see MetricsExporter). False if the port is
+    /// taken, which the status bar then shows.
+    bool startMetricsExporter(int port);
+
+    /// Displays a headless aggregator's tracks (see AggregatorLink) instead of listening
+    /// for relays. False if no aggregator is running on the port.
+    bool attachToAggregator(int port);
+
+    /// Replaces live input with a recorded session (see SessionPlayer). On failure the
+    /// reason is shown in the status bar and live input carries on.
+    bool openSession(const juce::File& file, bool startPlaying, double speed = 1.0);
+
+    /// Dropped audio files are analysed offline (see OfflineAnalysis) and the result opened as a session.
+    bool isInterestedInFileDrag(const juce::StringArray& files) override;
+    void filesDropped(const juce::StringArray& files, int x, int y) override;
+
 private:
-    void oscMessageReceived(const juce::OSCMessage& message) override;
-    void timerCallback() override;
     void updateStatusLabel();
     void setupDisplayControls();
     void onDisplayModeChanged();
     void onDbScalingChanged();
+    void onWaterfallToggled();
+    void onLatencyToggled();
+    void layoutLatencyOverlay();
+    void onMaskingToggled();
+    void layoutMaskingOverlay();
+    void onPerfToggled();
+    void onLongTermToggled();
+    void onFreezeToggled();
+    void updateHistoryRange();
+    void onHistoryScrubbed();
+    void onRecordToggled();
+    void stopRecording();
+    void onOpenSessionClicked();
+    void closeSession();
+    void analyseFiles(const juce::Array<juce::File>& files);
+    void layoutPerfHud();
 
     juce::Label titleLabel;
     juce::Label statusLabel;
@@ -31,11 +69,51 @@ private:
     juce::ComboBox displayModeCombo;
     juce::Label dbScalingLabel;
     juce::ComboBox dbScalingCombo;
+    juce::ToggleButton waterfallToggle;
+    juce::ToggleButton latencyToggle;
+    juce::ToggleButton maskingToggle;
+    juce::ToggleButton perfToggle;
+    juce::ToggleButton longTermToggle;
+    juce::TextButton resetLongTermButton { "Reset" };
+    juce::ToggleButton freezeToggle;
+    juce::Slider historySlider;  // Seconds before the freeze, shown while frozen
+    juce::Label historyLabel;
+    juce::int64 freezeSlot { -1 };  // Newest history slot when Freeze was pressed
+    juce::ToggleButton recordToggle;
+    juce::String recordingError;  // Shown in the status bar until the next recording starts
+    juce::String metricsError;    // Shown in the status bar for as long as the exporter isn't running
+    juce::TextButton openSessionButton { "Open Session..." };
+    std::unique_ptr<juce::FileChooser> sessionChooser;
+
+    class AnalysisTask;
+    std::unique_ptr<AnalysisTask> analysisTask;
 
-    juce::OSCReceiver oscReceiver;
-    TrackManager trackManager;
+    juce::TooltipWindow tooltipWindow { this };
+
+    AnalyzerCore core;  // Ingest, track model, recording and metrics
+    TrackManager& trackManager { core.getTrackManager() };
+    AggregatorClient aggregatorClient { trackManager };
     TrackListPanel trackListPanel;
     SpectrumDisplay spectrumDisplay;
+    WaterfallDisplay waterfallDisplay;
+    LatencyOverlay latencyOverlay;
+    MaskingOverlay maskingOverlay;
+    PerfHud perfHud;
+    FrameScheduler frameScheduler;
+    SessionPlayer sessionPlayer;
+    PlaybackBar playbackBar;
+
+    // Status bar counters are refreshed at most this often while data flows
+    juce::uint32 lastStatusUpdateTime { 0 };
+    static constexpr juce::uint32 statusUpdateIntervalMs = 500;
+
+    // The masking heatmap is live, but needn't follow every frame
+    juce::uint32 lastMaskingUpdateTime { 0 };
+    static constexpr juce::uint32 maskingUpdateIntervalMs = 100;
+
+    // Track list loudness meters: about 15 Hz, enough for the 400 ms momentary window
+    juce::uint32 lastMeterUpdateTime { 0 };
+    static constexpr juce::uint32 meterUpdateIntervalMs = 66;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
 };
@@ -0,0 +1,179 @@
+#include "MaskingDetector.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    const float floorPower = std::pow(10.0f, MaskingDetector::floorDb / 10.0f);
+}
+
+MaskingDetector::MaskingDetector(const LogFrequencyGrid& fineGrid)
+    : numBands(fineGrid.getNumBands() / finesPerBand)
+{
+    bandEdges.resize(static_cast<size_t>(numBands) + 1);
+    for (int band = 0; band <= numBands; ++band)
+        bandEdges[static_cast<size_t>(band)] = fineGrid.getBandEdge(band * finesPerBand);
+}
+
+void MaskingDetector::updateTrack(const juce::String& trackId, const float* fineBandPower, bool includeIfNew)
+{
+    auto it = trackIndices.find(trackId);
+    if (it == trackIndices.end())
+    {
+        // setTrackIncluded() ignores tracks without a state, so the state starts out right
+        auto state = std::make_unique<TrackState>();
+        state->trackId = trackId;
+        state->included = includeIfNew;
+        state->level.calloc(static_cast<size_t>(numBands));
+        trackStates.push_back(std::move(state));
+        it = trackIndices.emplace(trackId, static_cast<int>(trackStates.size()) - 1).first;
+    }
+
+    auto& state = *trackStates[static_cast<size_t>(it->second)];
+
+    // Fold onto the coarse bands and smooth: level += smoothing * (new - level)
+    float energy = 0.0f;
+    for (int band = 0; band < numBands; ++band)
+    {
+        const float* fine = fineBandPower + band * finesPerBand;
+        float power = 0.0f;
+        for (int i = 0; i < finesPerBand; ++i)
+            power += fine[i];
+
+        state.level[band] += smoothing * (power - state.level[band]);
+        energy += state.level[band];
+    }
+
+    state.energy = energy;
+    state.changed = true;
+}
+
+void MaskingDetector::setTrackIncluded(const juce::String& trackId, bool shouldBeIncluded)
+{
+    auto it = trackIndices.find(trackId);
+    if (it == trackIndices.end())
+        return;
+
+    auto& state = *trackStates[static_cast<size_t>(it->second)];
+    state.included = shouldBeIncluded;
+    state.changed = true;
+}
+
+void MaskingDetector::update(MaskingReport& report)
+{
+    // Loudest included tracks only, so the pair count is bounded however many tracks there are
+    candidates.clear();
+    for (int i = 0; i < static_cast<int>(trackStates.size()); ++i)
+    {
+        const auto& state = *trackStates[static_cast<size_t>(i)];
+        if (state.included && state.energy >= floorPower)
+            candidates.push_back(i);
+    }
+
+    report.numTracksSkipped = juce::jmax(0, static_cast<int>(candidates.size()) - maxTracks);
+    if (report.numTracksSkipped > 0)
+    {
+        std::nth_element(candidates.begin(), candidates.begin() + maxTracks, candidates.end(),
+                         [this](int a, int b) { return trackStates[static_cast<size_t>(a)]->energy
+                                                     > trackStates[static_cast<size_t>(b)]->energy; });
+        candidates.resize(maxTracks);
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    report.numTracksCompared = static_cast<int>(candidates.size());
+
+    isCandidate.assign(trackStates.size(), false);
+    for (int index : candidates)
+        isCandidate[static_cast<size_t>(index)] = true;
+
+    // Forget pairs that dropped out of the comparison
+    for (auto it = pairs.begin(); it != pairs.end();)
+    {
+        bool keep = isCandidate[static_cast<size_t>(it->first.first)] && isCandidate[static_cast<size_t>(it->first.second)];
+        it = keep ? std::next(it) : pairs.erase(it);
+    }
+
+    // Only pairs with a track that changed since the last update are compared again
+    for (size_t i = 0; i < candidates.size(); ++i)
+    {
+        const auto& a = *trackStates[static_cast<size_t>(candidates[i])];
+
+        for (size_t j = i + 1; j < candidates.size(); ++j)
+        {
+            const auto& b = *trackStates[static_cast<size_t>(candidates[j])];
+            auto key = std::make_pair(candidates[i], candidates[j]);
+
+            auto it = pairs.find(key);
+            if (it == pairs.end())
+            {
+                it = pairs.emplace(key, PairState()).first;
+                it->second.conflict.malloc(static_cast<size_t>(numBands));
+            }
+            else if (!a.changed && !b.changed)
+            {
+                continue;
+            }
+
+            comparePair(a, b, it->second);
+        }
+    }
+
+    for (int index : candidates)
+        trackStates[static_cast<size_t>(index)]->changed = false;
+
+    // Heatmap and ranking from the pair cache
+    report.bandEdges = bandEdges;
+    report.bandConflict.assign(static_cast<size_t>(numBands), 0.0f);
+    ranking.clear();
+
+    for (const auto& pair : pairs)
+    {
+        juce::FloatVectorOperations::add(report.bandConflict.data(), pair.second.conflict.get(), numBands);
+        if (pair.second.total > 0.0f)
+            ranking.push_back({ pair.second.total, pair.first });
+    }
+
+    const auto numRanked = std::min(ranking.size(), static_cast<size_t>(maxConflicts));
+    std::partial_sort(ranking.begin(), ranking.begin() + static_cast<std::ptrdiff_t>(numRanked), ranking.end(),
+                      [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    report.conflicts.resize(numRanked);
+    for (size_t i = 0; i < numRanked; ++i)
+    {
+        const auto& key = ranking[i].second;
+        const auto* conflict = pairs[key].conflict.get();
+        auto& entry = report.conflicts[i];
+
+        entry.trackIdA = trackStates[static_cast<size_t>(key.first)]->trackId;
+        entry.trackIdB = trackStates[static_cast<size_t>(key.second)]->trackId;
+        entry.levelDb = 10.0f * std::log10(ranking[i].first);
+
+        // Region: contiguous bands within 6 dB of the strongest shared band
+        int peak = static_cast<int>(std::max_element(conflict, conflict + numBands) - conflict);
+        int low = peak;
+        int high = peak;
+        while (low > 0 && conflict[low - 1] >= conflict[peak] * 0.25f)
+            --low;
+        while (high < numBands - 1 && conflict[high + 1] >= conflict[peak] * 0.25f)
+            ++high;
+
+        entry.lowFrequency = bandEdges[static_cast<size_t>(low)];
+        entry.highFrequency = bandEdges[static_cast<size_t>(high) + 1];
+    }
+}
+
+void MaskingDetector::comparePair(const TrackState& a, const TrackState& b, PairState& pair) const
+{
+    // Shared power is the lower of the two levels; branch-free so the loops vectorise
+    float* conflict = pair.conflict.get();
+    juce::FloatVectorOperations::min(conflict, a.level.get(), b.level.get(), numBands);
+
+    float total = 0.0f;
+    for (int band = 0; band < numBands; ++band)
+    {
+        conflict[band] = conflict[band] >= floorPower ? conflict[band] : 0.0f;
+        total += conflict[band];
+    }
+
+    pair.total = total;
+}
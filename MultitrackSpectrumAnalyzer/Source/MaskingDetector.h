@@ -0,0 +1,93 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/LogFrequencyGrid.h"
+
+/// Frequency regions where two tracks compete, and which pairs compete most.
+struct MaskingReport
+{
+    struct Conflict
+    {
+        juce::String trackIdA;
+        juce::String trackIdB;
+        juce::String nameA;     // Filled in by TrackManager
+        juce::String nameB;
+        juce::Colour colourA;
+        juce::Colour colourB;
+        float levelDb { 0.0f };  // Shared power over all bands
+        float lowFrequency { 0.0f };   // Region around the strongest shared band
+        float highFrequency { 0.0f };
+    };
+
+    std::vector<float> bandEdges;     // numBands + 1 frequencies
+    std::vector<float> bandConflict;  // Shared power per band, summed over the pairs compared
+    std::vector<Conflict> conflicts;  // Strongest first, at most maxConflicts
+    int numTracksCompared { 0 };
+    int numTracksSkipped { 0 };       // Included but outside the loudest maxTracks
+};
+
+/// Incremental pairwise conflict detection on a coarse log band grid.
+///
+/// Each frame folds a track's power on the common log grid down to quarter-octave
+/// bands and smooths it, which is all the per-frame cost there is. update() then
+/// compares only the loudest maxTracks tracks, and only the pairs involving a
+/// track that changed since the last update; everything else comes from the pair
+/// cache. Two tracks conflict in a band by the power they share there (the lower
+/// of the two), counted once both are above the floor.
+class MaskingDetector
+{
+public:
+    static constexpr int finesPerBand = 12;    // Common-grid bands per detector band
+    static constexpr int maxTracks = 32;       // Loudest tracks compared (up to 496 pairs)
+    static constexpr int maxConflicts = 10;
+    static constexpr float floorDb = -60.0f;   // Quieter bands don't count as competing
+
+    explicit MaskingDetector(const LogFrequencyGrid& fineGrid);
+
+    int getNumBands() const { return numBands; }
+
+    /// Adds a frame of band power on the fine grid (LogFrequencyGrid::getNumBands() values).
+    /// A track seen for the first time starts included or not as the caller says; after
+    /// that only setTrackIncluded() changes it.
+    void updateTrack(const juce::String& trackId, const float* fineBandPower, bool includeIfNew);
+
+    /// Disabled and offline tracks are left out of the comparison.
+    void setTrackIncluded(const juce::String& trackId, bool shouldBeIncluded);
+
+    /// Recomputes pairs whose tracks changed and fills the report.
+    void update(MaskingReport& report);
+
+private:
+    struct TrackState
+    {
+        juce::String trackId;
+        juce::HeapBlock<float> level;  // Smoothed power per band
+        float energy { 0.0f };
+        bool included { true };
+        bool changed { true };
+    };
+
+    struct PairState
+    {
+        juce::HeapBlock<float> conflict;  // Shared power per band
+        float total { 0.0f };
+    };
+
+    void comparePair(const TrackState& a, const TrackState& b, PairState& pair) const;
+
+    int numBands;
+    std::vector<float> bandEdges;
+
+    std::vector<std::unique_ptr<TrackState>> trackStates;
+    std::map<juce::String, int> trackIndices;
+    std::map<std::pair<int, int>, PairState> pairs;  // Lower index first
+
+    // Scratch (avoid allocating per update)
+    std::vector<int> candidates;
+    std::vector<bool> isCandidate;
+    std::vector<std::pair<float, std::pair<int, int>>> ranking;
+
+    static constexpr float smoothing = 0.2f;   // Per frame, towards the newest level
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MaskingDetector)
+};
@@ -0,0 +1,123 @@
+#include "MaskingOverlay.h"
+#include <cmath>
+
+MaskingOverlay::MaskingOverlay(TrackManager& tm)
+    : trackManager(tm)
+{
+    setInterceptsMouseClicks(false, false);
+}
+
+MaskingOverlay::~MaskingOverlay()
+{
+}
+
+void MaskingOverlay::refresh()
+{
+    trackManager.getMaskingReport(report);
+    repaint();
+}
+
+int MaskingOverlay::getPreferredHeight() const
+{
+    int numLines = juce::jmax(1, static_cast<int>(report.conflicts.size()));
+    return headerHeight + heatmapHeight + labelHeight + numLines * rowHeight + 6;
+}
+
+void MaskingOverlay::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colour(0xe0202020));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    auto area = getLocalBounds().reduced(6, 3);
+    g.setFont(juce::FontOptions(11.0f));
+
+    auto header = area.removeFromTop(headerHeight);
+    g.setColour(juce::Colour(0xff808080));
+    g.drawText("Masking", header, juce::Justification::centredLeft);
+
+    juce::String compared = juce::String(report.numTracksCompared) + " tracks compared";
+    if (report.numTracksSkipped > 0)
+        compared << " (" << report.numTracksSkipped << " quieter skipped)";
+    g.drawText(compared, header, juce::Justification::centredRight);
+
+    drawHeatmap(g, area.removeFromTop(heatmapHeight + labelHeight).toFloat());
+
+    if (report.conflicts.empty())
+    {
+        g.setColour(juce::Colour(0xff808080));
+        g.drawText("No competing tracks", area.removeFromTop(rowHeight), juce::Justification::centredLeft);
+        return;
+    }
+
+    // Columns: track A | track B | region | shared level
+    for (const auto& conflict : report.conflicts)
+    {
+        auto row = area.removeFromTop(rowHeight);
+
+        g.setColour(conflict.colourA);
+        g.drawText(conflict.nameA, row.removeFromLeft(110), juce::Justification::centredLeft, true);
+        g.setColour(juce::Colour(0xff808080));
+        g.drawText("vs", row.removeFromLeft(20), juce::Justification::centred);
+        g.setColour(conflict.colourB);
+        g.drawText(conflict.nameB, row.removeFromLeft(110), juce::Justification::centredLeft, true);
+
+        g.setColour(juce::Colour(0xffc0c0c0));
+        g.drawText(juce::String(conflict.levelDb, 1) + " dB", row.removeFromRight(60), juce::Justification::centredRight);
+        g.drawText(formatFrequency(conflict.lowFrequency) + " - " + formatFrequency(conflict.highFrequency) + " Hz",
+                   row, juce::Justification::centredRight);
+    }
+}
+
+void MaskingOverlay::drawHeatmap(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const int numBands = static_cast<int>(report.bandConflict.size());
+    if (numBands == 0 || report.bandEdges.size() != report.bandConflict.size() + 1)
+        return;
+
+    auto strip = area.removeFromTop(static_cast<float>(heatmapHeight));
+
+    const float lowest = report.bandEdges.front();
+    const float logSpan = std::log(report.bandEdges.back() / lowest);
+    auto frequencyToX = [&](float frequency)
+    {
+        return strip.getX() + strip.getWidth() * std::log(frequency / lowest) / logSpan;
+    };
+
+    float maxPower = 0.0f;
+    for (float power : report.bandConflict)
+        maxPower = juce::jmax(maxPower, power);
+
+    // Each band coloured by its shared power relative to the strongest band
+    const juce::Colour cold(0xff202838);
+    const juce::Colour hot(0xffff5020);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        float power = report.bandConflict[static_cast<size_t>(band)];
+        float heat = 0.0f;
+        if (power > 0.0f && maxPower > 0.0f)
+            heat = juce::jlimit(0.0f, 1.0f, 1.0f + 10.0f * std::log10(power / maxPower) / heatmapRangeDb);
+
+        float x0 = frequencyToX(report.bandEdges[static_cast<size_t>(band)]);
+        float x1 = frequencyToX(report.bandEdges[static_cast<size_t>(band) + 1]);
+        g.setColour(cold.interpolatedWith(hot, heat));
+        g.fillRect(x0, strip.getY(), juce::jmax(1.0f, x1 - x0), strip.getHeight());
+    }
+
+    g.setColour(juce::Colour(0xff808080));
+    for (float frequency : { 100.0f, 1000.0f, 10000.0f })
+    {
+        float x = frequencyToX(frequency);
+        g.drawVerticalLine(juce::roundToInt(x), strip.getY(), strip.getBottom());
+        g.drawText(formatFrequency(frequency), juce::Rectangle<float>(x - 20.0f, area.getY(), 40.0f, area.getHeight()),
+                   juce::Justification::centred);
+    }
+}
+
+juce::String MaskingOverlay::formatFrequency(float frequency)
+{
+    if (frequency >= 1000.0f)
+        return juce::String(frequency / 1000.0f, frequency >= 10000.0f ? 0 : 1) + "k";
+
+    return juce::String(juce::roundToInt(frequency));
+}
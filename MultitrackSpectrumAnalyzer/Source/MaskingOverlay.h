@@ -0,0 +1,37 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+
+/// Heatmap of where enabled tracks compete across the spectrum, and a ranked
+/// list of the worst pairs (see MaskingDetector), drawn over the spectrum view.
+class MaskingOverlay : public juce::Component
+{
+public:
+    MaskingOverlay(TrackManager& trackManager);
+    ~MaskingOverlay() override;
+
+    void paint(juce::Graphics& g) override;
+
+    /// Updates the detector's pairs and repaints. Cheap enough to call a few times a second.
+    void refresh();
+
+    /// Height needed for the current rows, for the owner's layout.
+    int getPreferredHeight() const;
+
+private:
+    void drawHeatmap(juce::Graphics& g, juce::Rectangle<float> area);
+
+    static juce::String formatFrequency(float frequency);
+
+    TrackManager& trackManager;
+    MaskingReport report;
+
+    static constexpr int rowHeight = 16;
+    static constexpr int headerHeight = 20;
+    static constexpr int heatmapHeight = 18;
+    static constexpr int labelHeight = 14;
+    static constexpr float heatmapRangeDb = 30.0f;  // Below the strongest band shows as cold
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MaskingOverlay)
+};
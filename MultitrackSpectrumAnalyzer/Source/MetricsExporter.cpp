@@ -0,0 +1,240 @@
+#include "MetricsExporter.h"
+#include "PerfCounters.h"
+
+namespace
+{
+    constexpr const char* metricPrefix = "wxc_analyzer_";
+
+    juce::String escapeLabelValue(const juce::String& value)
+    {
+        return value.replace("\\", "\\\\").replace("\"", "\\\"").replace("\n", "\\n");
+    }
+
+    void addHeader(juce::String& text, const juce::String& name, const char* type, const char* help)
+    {
+        text << "# HELP " << metricPrefix << name << " " << help << "\n"
+             << "# TYPE " << metricPrefix << name << " " << type << "\n";
+    }
+
+    void addSample(juce::String& text, const juce::String& name, const juce::String& labels, double value)
+    {
+        text << metricPrefix << name;
+        if (labels.isNotEmpty())
+            text << "{" << labels << "}";
+        text << " " << juce::String(value, 6).trimCharactersAtEnd("0").trimCharactersAtEnd(".") << "\n";
+    }
+
+    void addSample(juce::String& text, const juce::String& name, const juce::String& labels, juce::int64 value)
+    {
+        text << metricPrefix << name;
+        if (labels.isNotEmpty())
+            text << "{" << labels << "}";
+        text << " " << juce::String(value) << "\n";
+    }
+}
+
+MetricsExporter::MetricsExporter(const TrackManager& tm)
+    : juce::Thread("Metrics exporter"),
+      trackManager(tm)
+{
+}
+
+MetricsExporter::~MetricsExporter()
+{
+    stop();
+}
+
+bool MetricsExporter::start(int newPort)
+{
+    stop();
+
+    // Localhost only: the figures include track names
+    if (!listener.createListener(newPort, "127.0.0.1"))
+        return false;
+
+    port = newPort;
+    return startThread(juce::Thread::Priority::low);
+}
+
+void MetricsExporter::stop()
+{
+    signalThreadShouldExit();
+
+    // Closing the listener wakes the thread from accept()
+    listener.close();
+    stopThread(requestTimeoutMs * 2);
+}
+
+void MetricsExporter::run()
+{
+    while (!threadShouldExit())
+    {
+        std::unique_ptr<juce::StreamingSocket> connection(listener.waitForNextConnection());
+
+        if (connection == nullptr || threadShouldExit())
+            break;
+
+        handleConnection(*connection);
+    }
+}
+
+void MetricsExporter::handleConnection(juce::StreamingSocket& connection)
+{
+    // Only the request line matters; scrapers send short GET requests
+    char buffer[2048];
+    int bytesRead = 0;
+
+    while (bytesRead < static_cast<int>(sizeof(buffer)) - 1)
+    {
+        if (connection.waitUntilReady(true, requestTimeoutMs) != 1)
+            return;
+
+        int n = connection.read(buffer + bytesRead, static_cast<int>(sizeof(buffer)) - 1 - bytesRead, false);
+        if (n <= 0)
+            return;
+
+        bytesRead += n;
+        buffer[bytesRead] = 0;
+
+        if (std::strstr(buffer, "\r\n\r\n") != nullptr || std::strstr(buffer, "\n\n") != nullptr)
+            break;
+    }
+
+    auto requestLine = juce::String::fromUTF8(buffer, bytesRead).upToFirstOccurrenceOf("\n", false, false).trim();
+    auto tokens = juce::StringArray::fromTokens(requestLine, " ", {});
+    const bool isGet = tokens.size() >= 2 && tokens[0] == "GET";
+    const auto path = tokens.size() >= 2 ? tokens[1].upToFirstOccurrenceOf("?", false, false) : juce::String();
+
+    juce::String status, contentType, body;
+    if (isGet && (path == "/metrics" || path == "/"))
+    {
+        status = "200 OK";
+        contentType = "text/plain; version=0.0.4; charset=utf-8";
+        body = createMetricsText();
+    }
+    else
+    {
+        status = isGet ? "404 Not Found" : "405 Method Not Allowed";
+        contentType = "text/plain; charset=utf-8";
+        body = "Metrics are served at /metrics\n";
+    }
+
+    const auto bodyUtf8 = body.toUTF8();
+    const auto bodySize = static_cast<int>(std::strlen(bodyUtf8));
+
+    juce::String header;
+    header << "HTTP/1.0 " << status << "\r\n"
+           << "Content-Type: " << contentType << "\r\n"
+           << "Content-Length: " << bodySize << "\r\n"
+           << "Connection: close\r\n\r\n";
+
+    const auto headerUtf8 = header.toUTF8();
+    if (connection.write(headerUtf8, static_cast<int>(std::strlen(headerUtf8))) < 0)
+        return;
+
+    connection.write(bodyUtf8, bodySize);
+}
+
+juce::String MetricsExporter::createMetricsText() const
+{
+    juce::String text;
+    text.preallocateBytes(64 * 1024);
+
+    // Per-track ingest state, in display order
+    struct TrackFigures
+    {
+        TrackListEntry entry;
+        juce::String labels;
+        LatencySummary latency;
+        bool hasLatency { false };
+    };
+
+    std::vector<TrackFigures> tracks;
+    TrackListEntry entry;
+    for (int i = 0; trackManager.getTrackListEntry(i, entry); ++i)
+    {
+        TrackFigures figures;
+        figures.entry = entry;
+        figures.labels = "track_id=\"" + escapeLabelValue(entry.trackId) + "\",track=\"" + escapeLabelValue(entry.trackName) + "\"";
+        figures.hasLatency = trackManager.getLatencyTracker().getSummary(entry.trackId, figures.latency);
+        tracks.push_back(std::move(figures));
+    }
+
+    addHeader(text, "tracks", "gauge", "Tracks seen since startup.");
+    addSample(text, "tracks", {}, static_cast<juce::int64>(tracks.size()));
+
+    addHeader(text, "track_online", "gauge", "1 while the track's relay is sending, 0 once it has gone offline.");
+    for (const auto& track : tracks)
+        addSample(text, "track_online", track.labels, static_cast<juce::int64>(track.entry.offline ? 0 : 1));
+
+    addHeader(text, "track_frames_received_total", "counter", "Spectrum frames received from the track's relay.");
+    for (const auto& track : tracks)
+        addSample(text, "track_frames_received_total", track.labels, track.entry.framesReceived);
+
+    addHeader(text, "track_frames_dropped_total", "counter", "Frames lost between the relay and the analyzer (sequence gaps).");
+    for (const auto& track : tracks)
+        addSample(text, "track_frames_dropped_total", track.labels, track.entry.framesDropped);
+
+    addHeader(text, "track_frames_out_of_order_total", "counter", "Frames that arrived after a newer frame.");
+    for (const auto& track : tracks)
+        addSample(text, "track_frames_out_of_order_total", track.labels, track.entry.framesOutOfOrder);
+
+    addHeader(text, "track_relay_cpu_load", "gauge",
+              "Relay processBlock time as a share of the audio it processed (1 = one core), from its last heartbeat.");
+    for (const auto& track : tracks)
+        if (track.entry.hasProcessingLoad)
+            addSample(text, "track_relay_cpu_load", track.labels, static_cast<double>(track.entry.processingLoad.load));
+
+    addHeader(text, "track_relay_block_max_seconds", "gauge", "Slowest relay processBlock since its previous heartbeat.");
+    for (const auto& track : tracks)
+        if (track.entry.hasProcessingLoad)
+            addSample(text, "track_relay_block_max_seconds", track.labels, track.entry.processingLoad.maxBlockUs / 1.0e6);
+
+    addHeader(text, "session_relay_cpu_load", "gauge", "Relay CPU load summed over online tracks (1 = one core).");
+    addSample(text, "session_relay_cpu_load", {}, trackManager.getSessionLoad().totalLoad);
+
+    addHeader(text, "track_latency_seconds", "gauge",
+              "Capture to ingest and capture to present latency over the last 5-10 seconds, at histogram bucket resolution.");
+    for (const auto& track : tracks)
+    {
+        if (!track.hasLatency || track.latency.numFrames == 0)
+            continue;
+
+        addSample(text, "track_latency_seconds", track.labels + ",stage=\"ingest\",quantile=\"0.5\"", track.latency.ingestP50Ms / 1000.0);
+        addSample(text, "track_latency_seconds", track.labels + ",stage=\"ingest\",quantile=\"0.99\"", track.latency.ingestP99Ms / 1000.0);
+        addSample(text, "track_latency_seconds", track.labels + ",stage=\"present\",quantile=\"0.5\"", track.latency.presentP50Ms / 1000.0);
+        addSample(text, "track_latency_seconds", track.labels + ",stage=\"present\",quantile=\"0.99\"", track.latency.presentP99Ms / 1000.0);
+    }
+
+    // Process-wide counters and timing histograms
+    auto snapshot = Perf::takeSnapshot();
+
+    for (int i = 0; i < Perf::numCounters; ++i)
+    {
+        const juce::String name = juce::String(Perf::getName(static_cast<Perf::Counter>(i))) + "_total";
+        addHeader(text, name, "counter", "Process-wide ingest/render counter.");
+        addSample(text, name, {}, snapshot.counters[static_cast<size_t>(i)]);
+    }
+
+    for (int i = 0; i < Perf::numTimers; ++i)
+    {
+        const juce::String name = juce::String(Perf::getName(static_cast<Perf::Timer>(i))) + "_seconds";
+        const auto& stats = snapshot.timers[static_cast<size_t>(i)];
+
+        addHeader(text, name, "histogram", "Process-wide timing, quarter-octave buckets.");
+
+        juce::int64 cumulative = 0;
+        for (int bucket = 0; bucket < Perf::numHistogramBuckets - 1; ++bucket)
+        {
+            cumulative += stats.buckets[static_cast<size_t>(bucket)];
+            addSample(text, name + "_bucket", "le=\"" + juce::String(Perf::getBucketUpperUs(bucket) / 1.0e6, 9) + "\"", cumulative);
+        }
+
+        // The last bucket is open-ended
+        addSample(text, name + "_bucket", "le=\"+Inf\"", stats.count);
+        addSample(text, name + "_sum", {}, static_cast<double>(stats.totalUs) / 1.0e6);
+        addSample(text, name + "_count", {}, stats.count);
+    }
+
+    return text;
+}
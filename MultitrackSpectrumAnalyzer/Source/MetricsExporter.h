@@ -0,0 +1,44 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+
+/// Serves the analyzer's health as Prometheus text on localhost.
+///
+/// A background thread waits in accept() and only gathers figures when a
+/// scraper connects, so an idle exporter costs nothing. Every request gets a
+/// fresh reply built from the TrackManager (per-track frame counts, loss,
+/// latency percentiles, online state, relay CPU) and the Perf counters and timers.
+///
+/// Enabled from the command line with --metrics (default port) or
+/// --metrics-port <port>; scrape http://127.0.0.1:<port>/metrics.
+class MetricsExporter : private juce::Thread
+{
+public:
+    MetricsExporter(const TrackManager& trackManager);
+    ~MetricsExporter() override;
+
+    /// Binds to 127.0.0.1 and starts serving. False if the port is not available.
+    bool start(int port);
+    void stop();
+
+    bool isRunning() const { return isThreadRunning(); }
+    int getPort() const { return port; }
+
+    /// The full reply body, in the Prometheus text exposition format.
+    juce::String createMetricsText() const;
+
+    static constexpr int defaultPort = 58965;
+
+private:
+    void run() override;
+    void handleConnection(juce::StreamingSocket& connection);
+
+    const TrackManager& trackManager;
+    juce::StreamingSocket listener;
+    int port { 0 };
+
+    static constexpr int requestTimeoutMs = 2000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MetricsExporter)
+};
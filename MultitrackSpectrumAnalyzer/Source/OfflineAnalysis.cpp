@@ -0,0 +1,362 @@
+#include "OfflineAnalysis.h"
+#include "../../SpectrumAnalyzerRelay/Source/SpectrumProcessor.h"
+#include <deque>
+
+namespace
+{
+    constexpr int hopSize = SpectrumConstants::HOP_SIZE;
+    constexpr int numBins = SpectrumConstants::NUM_BINS;
+
+    // Samples a slice reads ahead of its first frame's hop, so its first window is complete
+    constexpr int preRollSamples = SpectrumConstants::FFT_SIZE - SpectrumConstants::HOP_SIZE;
+}
+
+/// One input file, and readers for it that jobs borrow (a reader is not thread-safe).
+struct OfflineAnalysis::Stem
+{
+    juce::File file;
+    juce::String trackId;
+    juce::String trackName;
+    double sampleRate { 0.0 };
+    juce::int64 lengthInSamples { 0 };
+    int numChannels { 0 };
+    juce::int64 numFrames { 0 };
+
+    juce::CriticalSection readerLock;
+    std::vector<std::unique_ptr<juce::AudioFormatReader>> idleReaders;
+
+    /// Session time of a frame: when its last sample would have played.
+    juce::int64 getFrameTimeUs(juce::int64 frame) const
+    {
+        return static_cast<juce::int64>(static_cast<double>((frame + 1) * hopSize) * 1.0e6 / sampleRate);
+    }
+
+    /// First frame at or after timeUs (numFrames if none).
+    juce::int64 getFirstFrameAt(juce::int64 timeUs) const
+    {
+        auto frame = static_cast<juce::int64>(static_cast<double>(timeUs) * sampleRate / (1.0e6 * hopSize)) - 1;
+        frame = juce::jlimit(static_cast<juce::int64>(0), numFrames, frame);
+
+        // The estimate can be a frame out either way after rounding
+        while (frame > 0 && getFrameTimeUs(frame - 1) >= timeUs)
+            --frame;
+        while (frame < numFrames && getFrameTimeUs(frame) < timeUs)
+            ++frame;
+
+        return frame;
+    }
+};
+
+/// One time slice of every stem, analysed by one job per stem.
+struct OfflineAnalysis::Slice
+{
+    struct StemFrames
+    {
+        juce::int64 firstFrame { 0 };
+        juce::int64 numFrames { 0 };
+        std::vector<float> magnitudes;  // numFrames * NUM_BINS
+    };
+
+    std::vector<StemFrames> stemFrames;  // Same order as stems
+    std::atomic<int> jobsRemaining { 0 };
+    juce::WaitableEvent done;
+};
+
+OfflineAnalysis::OfflineAnalysis(const juce::Array<juce::File>& f, const Options& o)
+    : files(f),
+      options(o)
+{
+    formatManager.registerBasicFormats();
+}
+
+OfflineAnalysis::~OfflineAnalysis() = default;
+
+bool OfflineAnalysis::isSupportedFile(const juce::File& file)
+{
+    juce::AudioFormatManager manager;
+    manager.registerBasicFormats();
+    return manager.findFormatForFileExtension(file.getFileExtension()) != nullptr;
+}
+
+//==============================================================================
+OfflineAnalysis::Result OfflineAnalysis::run(const juce::File& sessionFile, const ProgressCallback& onProgress)
+{
+    Result result;
+    const double startMs = juce::Time::getMillisecondCounterHiRes();
+
+    if (!openFiles(result.error))
+        return result;
+
+    result.numFiles = static_cast<int>(stems.size());
+
+    juce::int64 sessionUs = 0;
+    for (const auto& stem : stems)
+    {
+        if (stem->numFrames > 0)
+            sessionUs = juce::jmax(sessionUs, stem->getFrameTimeUs(stem->numFrames - 1));
+        result.totalAudioSeconds += static_cast<double>(stem->lengthInSamples) / stem->sampleRate;
+    }
+    result.sessionSeconds = static_cast<double>(sessionUs) / 1.0e6;
+
+    // Offline, the recorder waits for the disk rather than dropping frames
+    SessionRecorder recorder;
+    if (!recorder.start(sessionFile, true))
+    {
+        result.error = "Could not create " + sessionFile.getFullPathName();
+        return result;
+    }
+
+    const int numThreads = options.numThreads > 0 ? options.numThreads : juce::SystemStats::getNumCpus();
+    const int numSlices = static_cast<int>(sessionUs / sliceUs) + 1;
+
+    // Enough slices in flight to keep every worker busy, even with a single stem
+    const int numStems = static_cast<int>(stems.size());
+    const int slicesInFlight = juce::jmax(minSlicesInFlight, (2 * numThreads + numStems - 1) / numStems);
+
+    std::deque<std::unique_ptr<Slice>> pending;
+    bool cancelled = false;
+
+    {
+        juce::ThreadPool pool(juce::ThreadPoolOptions{}.withThreadName("Offline analysis")
+                                                       .withNumberOfThreads(numThreads));
+
+        auto submitSlice = [this, &pool, &pending](int sliceIndex)
+        {
+            pending.push_back(createSlice(sliceIndex));
+            auto* slice = pending.back().get();
+
+            for (size_t i = 0; i < stems.size(); ++i)
+            {
+                auto& frames = slice->stemFrames[i];
+                if (frames.numFrames == 0)
+                    continue;
+
+                auto* stem = stems[i].get();
+                pool.addJob([this, stem, slice, &frames]()
+                {
+                    if (!readFailed.load())
+                        analyseSlice(*stem, frames.firstFrame, frames.numFrames, frames.magnitudes);
+
+                    if (--slice->jobsRemaining == 0)
+                        slice->done.signal();
+                });
+            }
+        };
+
+        int nextSlice = 0;
+        for (int written = 0; written < numSlices; ++written)
+        {
+            while (nextSlice < numSlices && nextSlice < written + slicesInFlight)
+                submitSlice(nextSlice++);
+
+            pending.front()->done.wait();
+
+            if (readFailed.load())
+                break;
+
+            writeSlice(*pending.front(), recorder);
+            pending.pop_front();
+
+            if (onProgress != nullptr && !onProgress(static_cast<double>(written + 1) / numSlices))
+            {
+                cancelled = true;
+                break;
+            }
+        }
+
+        // Queued jobs point into the pending slices
+        pool.removeAllJobs(true, -1);
+    }
+
+    const bool written = recorder.stop();
+    result.framesWritten = recorder.getStats().framesRecorded;
+    result.elapsedSeconds = (juce::Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+
+    if (readFailed.load())
+    {
+        const juce::ScopedLock sl(errorLock);
+        result.error = readError;
+    }
+    else if (cancelled)
+    {
+        result.error = "Cancelled";
+    }
+    else if (!written)
+    {
+        result.error = "Could not write " + sessionFile.getFullPathName();
+    }
+
+    result.succeeded = result.error.isEmpty();
+    if (!result.succeeded)
+        sessionFile.deleteFile();
+
+    return result;
+}
+
+bool OfflineAnalysis::openFiles(juce::String& error)
+{
+    stems.clear();
+
+    for (const auto& file : files)
+    {
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->sampleRate <= 0.0 || reader->numChannels == 0)
+        {
+            error = "Could not read " + file.getFullPathName();
+            return false;
+        }
+
+        auto stem = std::make_unique<Stem>();
+        stem->file = file;
+        stem->trackId = "file-" + juce::String::toHexString(file.getFullPathName().hashCode64());
+        stem->trackName = file.getFileNameWithoutExtension();
+        stem->sampleRate = reader->sampleRate;
+        stem->lengthInSamples = reader->lengthInSamples;
+        stem->numChannels = static_cast<int>(reader->numChannels);
+        stem->numFrames = reader->lengthInSamples / hopSize;
+        stem->idleReaders.push_back(std::move(reader));
+
+        stems.push_back(std::move(stem));
+    }
+
+    if (stems.empty())
+    {
+        error = "No audio files to analyse";
+        return false;
+    }
+
+    return true;
+}
+
+std::unique_ptr<OfflineAnalysis::Slice> OfflineAnalysis::createSlice(int sliceIndex)
+{
+    auto slice = std::make_unique<Slice>();
+    slice->stemFrames.resize(stems.size());
+
+    const juce::int64 startUs = static_cast<juce::int64>(sliceIndex) * sliceUs;
+    int numJobs = 0;
+
+    for (size_t i = 0; i < stems.size(); ++i)
+    {
+        auto& frames = slice->stemFrames[i];
+        frames.firstFrame = stems[i]->getFirstFrameAt(startUs);
+        frames.numFrames = stems[i]->getFirstFrameAt(startUs + sliceUs) - frames.firstFrame;
+
+        if (frames.numFrames > 0)
+            ++numJobs;
+    }
+
+    slice->jobsRemaining = numJobs;
+    if (numJobs == 0)
+        slice->done.signal();
+
+    return slice;
+}
+
+void OfflineAnalysis::analyseSlice(Stem& stem, juce::int64 firstFrame, juce::int64 numFrames,
+                                   std::vector<float>& magnitudes)
+{
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    {
+        const juce::ScopedLock sl(stem.readerLock);
+        if (!stem.idleReaders.empty())
+        {
+            reader = std::move(stem.idleReaders.back());
+            stem.idleReaders.pop_back();
+        }
+    }
+
+    if (reader == nullptr)
+        reader.reset(formatManager.createReaderFor(stem.file));
+
+    if (reader == nullptr)
+    {
+        const juce::ScopedLock sl(errorLock);
+        readError = "Could not read " + stem.file.getFullPathName();
+        readFailed = true;
+        return;
+    }
+
+    // Reads before the start of the file come back as silence, like the relay's empty buffer
+    const juce::int64 startSample = firstFrame * hopSize - preRollSamples;
+    const int numSamples = static_cast<int>(preRollSamples + numFrames * hopSize);
+
+    juce::AudioBuffer<float> audio(stem.numChannels, numSamples);
+    reader->read(&audio, 0, numSamples, startSample, true, true);
+
+    {
+        const juce::ScopedLock sl(stem.readerLock);
+        stem.idleReaders.push_back(std::move(reader));
+    }
+
+    // Mix to mono, as the relay does for stereo tracks
+    for (int channel = 1; channel < stem.numChannels; ++channel)
+        audio.addFrom(0, 0, audio, channel, 0, numSamples);
+    if (stem.numChannels > 1)
+        audio.applyGain(0, 0, numSamples, 1.0f / static_cast<float>(stem.numChannels));
+
+    // Whole hops only: process() keeps just the newest frame of a longer block
+    SpectrumProcessor processor;
+    processor.prepare(stem.sampleRate);
+
+    const float* samples = audio.getReadPointer(0);
+    processor.process(samples, preRollSamples);
+    samples += preRollSamples;
+
+    std::array<float, numBins> spectrum;
+    magnitudes.resize(static_cast<size_t>(numFrames * numBins));
+
+    for (juce::int64 frame = 0; frame < numFrames; ++frame)
+    {
+        processor.process(samples, hopSize);
+        samples += hopSize;
+
+        processor.getSpectrum(spectrum);
+        std::copy(spectrum.begin(), spectrum.end(), magnitudes.begin() + frame * numBins);
+    }
+}
+
+void OfflineAnalysis::writeSlice(const Slice& slice, SessionRecorder& recorder)
+{
+    // Interleave the stems' frames in time order, as they would have arrived live
+    struct FrameRef
+    {
+        juce::int64 timeUs;
+        size_t stem;
+        juce::int64 frame;
+    };
+
+    std::vector<FrameRef> order;
+    for (size_t i = 0; i < stems.size(); ++i)
+    {
+        const auto& frames = slice.stemFrames[i];
+        for (juce::int64 k = 0; k < frames.numFrames; ++k)
+            order.push_back({ stems[i]->getFrameTimeUs(frames.firstFrame + k), i, k });
+    }
+
+    std::sort(order.begin(), order.end(), [](const FrameRef& a, const FrameRef& b)
+    {
+        return a.timeUs != b.timeUs ? a.timeUs < b.timeUs : a.stem < b.stem;
+    });
+
+    SpectrumMessages::SpectrumFrame frame;
+    frame.hasHeader = true;
+
+    for (const auto& ref : order)
+    {
+        const auto& stem = *stems[ref.stem];
+        const auto& frames = slice.stemFrames[ref.stem];
+        const float* bins = frames.magnitudes.data() + ref.frame * numBins;
+        const juce::int64 frameIndex = frames.firstFrame + ref.frame;
+
+        frame.trackId = stem.trackId;
+        frame.trackName = stem.trackName;
+        frame.sampleRate = stem.sampleRate;
+        frame.magnitudes.assign(bins, bins + numBins);
+        frame.header.sequence = static_cast<juce::uint32>(frameIndex);
+        frame.header.captureTimeUs = 0;
+        frame.header.hostSamplePosition = (frameIndex + 1) * hopSize;
+
+        recorder.recordFrame(frame, ref.timeUs);
+    }
+}
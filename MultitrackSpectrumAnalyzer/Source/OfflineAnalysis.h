@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SessionRecorder.h"
+
+/// Analyses audio files (stems) without a DAW. Each file is decoded with
+/// juce_audio_formats, mixed to mono as the relay does, and run through the
+/// relay's SpectrumProcessor. The result is the frames the relay would have
+/// sent had the file been played from the start, stamped with their time in
+/// the file, and written to a session file that SessionPlayer replays.
+///
+/// Work is split into (file, time slice) jobs on a ThreadPool, so a single long
+/// file spreads across cores as well as many short ones. Each job primes its
+/// own SpectrumProcessor with the samples that precede its slice, so slices
+/// are independent and the output matches a single pass over the file. Slices
+/// are written in time order as they complete, and only a few are held in
+/// memory at once.
+class OfflineAnalysis
+{
+public:
+    struct Options
+    {
+        int numThreads { 0 };  // 0 = one per core
+    };
+
+    struct Result
+    {
+        bool succeeded { false };
+        juce::String error;
+        int numFiles { 0 };
+        double sessionSeconds { 0.0 };     // Longest file
+        double totalAudioSeconds { 0.0 };  // All files together
+        juce::int64 framesWritten { 0 };
+        double elapsedSeconds { 0.0 };
+    };
+
+    /// Called after each slice is written, with the fraction done. Return false to cancel.
+    using ProgressCallback = std::function<bool(double progress)>;
+
+    OfflineAnalysis(const juce::Array<juce::File>& files, const Options& options);
+    ~OfflineAnalysis();
+
+    /// Analyses the files into sessionFile (replacing it), blocking until done.
+    /// GUI callers should run it on a background thread.
+    Result run(const juce::File& sessionFile, const ProgressCallback& onProgress = nullptr);
+
+    /// True if the file's extension is one of the registered audio formats.
+    static bool isSupportedFile(const juce::File& file);
+
+private:
+    struct Stem;
+    struct Slice;
+
+    bool openFiles(juce::String& error);
+    std::unique_ptr<Slice> createSlice(int sliceIndex);
+    void analyseSlice(Stem& stem, juce::int64 firstFrame, juce::int64 numFrames, std::vector<float>& magnitudes);
+    void writeSlice(const Slice& slice, SessionRecorder& recorder);
+
+    juce::Array<juce::File> files;
+    Options options;
+    juce::AudioFormatManager formatManager;
+    std::vector<std::unique_ptr<Stem>> stems;
+
+    std::atomic<bool> readFailed { false };
+    juce::CriticalSection errorLock;
+    juce::String readError;
+
+    static constexpr juce::int64 sliceUs = 2000000;
+    static constexpr int minSlicesInFlight = 3;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineAnalysis)
+};
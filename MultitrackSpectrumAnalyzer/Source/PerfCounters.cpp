@@ -0,0 +1,236 @@
+#include "PerfCounters.h"
+
+namespace
+{
+    struct ThreadBlock
+    {
+        std::array<std::atomic<juce::int64>, Perf::numCounters> counters {};
+        std::array<std::array<std::atomic<juce::int64>, Perf::numHistogramBuckets>, Perf::numTimers> buckets {};
+        std::array<std::atomic<juce::int64>, Perf::numTimers> totalUs {};
+    };
+
+    struct Registry
+    {
+        juce::SpinLock lock;
+        std::vector<std::unique_ptr<ThreadBlock>> blocks;
+    };
+
+    Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    ThreadBlock& getThreadBlock()
+    {
+        thread_local ThreadBlock* block = nullptr;
+
+        if (block == nullptr)
+        {
+            auto newBlock = std::make_unique<ThreadBlock>();
+            block = newBlock.get();
+
+            auto& registry = getRegistry();
+            const juce::SpinLock::ScopedLockType sl(registry.lock);
+            registry.blocks.push_back(std::move(newBlock));
+        }
+
+        return *block;
+    }
+
+    // Only the owning thread writes, so a relaxed load + store is enough
+    inline void increment(std::atomic<juce::int64>& value, juce::int64 amount) noexcept
+    {
+        value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    int getBucket(juce::int64 microseconds) noexcept
+    {
+        if (microseconds <= 1)
+            return 0;
+
+        auto value = static_cast<juce::uint32>(juce::jmin(microseconds, static_cast<juce::int64>(0xffffffff)));
+        int octave = juce::findHighestSetBit(value);
+
+        // Two bits below the leading one pick the quarter within the octave
+        int quarter = octave >= 2 ? static_cast<int>((value >> (octave - 2)) & 3)
+                                  : static_cast<int>((value << (2 - octave)) & 3);
+
+        return juce::jmin(Perf::numHistogramBuckets - 1, octave * 4 + quarter);
+    }
+}
+
+namespace Perf
+{
+    const char* getName(Counter counter)
+    {
+        switch (counter)
+        {
+            case Counter::packetsReceived:   return "packets_received";
+            case Counter::bytesReceived:     return "bytes_received";
+            case Counter::spectrumFrames:    return "spectrum_frames";
+            case Counter::heartbeats:        return "heartbeats";
+            case Counter::parseErrors:       return "parse_errors";
+            case Counter::framesDropped:     return "frames_dropped";
+            case Counter::framesOutOfOrder:  return "frames_out_of_order";
+            case Counter::paints:            return "paints";
+            case Counter::numCounters:       break;
+        }
+        return "";
+    }
+
+    const char* getName(Timer timer)
+    {
+        switch (timer)
+        {
+            case Timer::parse:            return "parse";
+            case Timer::trackLockHold:    return "track_lock_hold";
+            case Timer::snapshotUpdate:   return "snapshot_update";
+            case Timer::paintTotal:       return "paint_total";
+            case Timer::paintBackground:  return "paint_background";
+            case Timer::paintPrepare:     return "paint_prepare";
+            case Timer::paintStroke:      return "paint_stroke";
+            case Timer::frameInterval:    return "frame_interval";
+            case Timer::numTimers:        break;
+        }
+        return "";
+    }
+
+    void add(Counter counter, juce::int64 amount) noexcept
+    {
+        increment(getThreadBlock().counters[static_cast<size_t>(counter)], amount);
+    }
+
+    void record(Timer timer, juce::int64 microseconds) noexcept
+    {
+        auto& block = getThreadBlock();
+        const auto index = static_cast<size_t>(timer);
+
+        increment(block.buckets[index][static_cast<size_t>(getBucket(microseconds))], 1);
+        increment(block.totalUs[index], juce::jmax(static_cast<juce::int64>(0), microseconds));
+    }
+
+    juce::int64 getTimeMicroseconds() noexcept
+    {
+        static const double microsecondsPerTick = 1.0e6 / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+        return static_cast<juce::int64>(static_cast<double>(juce::Time::getHighResolutionTicks()) * microsecondsPerTick);
+    }
+
+    double getBucketUpperUs(int bucket)
+    {
+        const int octave = bucket / 4;
+        const int quarter = bucket % 4;
+        return std::ldexp(1.0 + (quarter + 1) * 0.25, octave);
+    }
+
+    double TimerStats::getMeanUs() const
+    {
+        return count > 0 ? static_cast<double>(totalUs) / static_cast<double>(count) : 0.0;
+    }
+
+    double TimerStats::getPercentileUs(double p) const
+    {
+        if (count == 0)
+            return 0.0;
+
+        juce::int64 target = juce::jmax(static_cast<juce::int64>(1),
+                                        static_cast<juce::int64>(std::ceil(p * static_cast<double>(count))));
+        juce::int64 cumulative = 0;
+
+        for (int bucket = 0; bucket < numHistogramBuckets; ++bucket)
+        {
+            cumulative += buckets[static_cast<size_t>(bucket)];
+            if (cumulative >= target)
+                return getBucketUpperUs(bucket);
+        }
+
+        return getBucketUpperUs(numHistogramBuckets - 1);
+    }
+
+    double TimerStats::getMaxUs() const
+    {
+        for (int bucket = numHistogramBuckets - 1; bucket >= 0; --bucket)
+        {
+            if (buckets[static_cast<size_t>(bucket)] > 0)
+                return getBucketUpperUs(bucket);
+        }
+        return 0.0;
+    }
+
+    TimerStats TimerStats::since(const TimerStats& earlier) const
+    {
+        TimerStats difference;
+        for (size_t i = 0; i < buckets.size(); ++i)
+            difference.buckets[i] = buckets[i] - earlier.buckets[i];
+
+        difference.count = count - earlier.count;
+        difference.totalUs = totalUs - earlier.totalUs;
+        return difference;
+    }
+
+    Snapshot takeSnapshot()
+    {
+        Snapshot snapshot;
+        snapshot.timeSeconds = static_cast<double>(getTimeMicroseconds()) * 1.0e-6;
+
+        auto& registry = getRegistry();
+        const juce::SpinLock::ScopedLockType sl(registry.lock);
+
+        for (const auto& block : registry.blocks)
+        {
+            for (size_t i = 0; i < snapshot.counters.size(); ++i)
+                snapshot.counters[i] += block->counters[i].load(std::memory_order_relaxed);
+
+            for (size_t timer = 0; timer < snapshot.timers.size(); ++timer)
+            {
+                auto& stats = snapshot.timers[timer];
+                stats.totalUs += block->totalUs[timer].load(std::memory_order_relaxed);
+
+                for (size_t bucket = 0; bucket < stats.buckets.size(); ++bucket)
+                {
+                    auto value = block->buckets[timer][bucket].load(std::memory_order_relaxed);
+                    stats.buckets[bucket] += value;
+                    stats.count += value;
+                }
+            }
+        }
+
+        return snapshot;
+    }
+
+    bool dumpToFile(const juce::File& file)
+    {
+        auto snapshot = takeSnapshot();
+
+        auto* countersObject = new juce::DynamicObject();
+        for (int i = 0; i < numCounters; ++i)
+            countersObject->setProperty(getName(static_cast<Counter>(i)), snapshot.counters[static_cast<size_t>(i)]);
+
+        auto* timersObject = new juce::DynamicObject();
+        for (int i = 0; i < numTimers; ++i)
+        {
+            const auto& stats = snapshot.timers[static_cast<size_t>(i)];
+
+            juce::Array<juce::var> buckets;
+            for (auto count : stats.buckets)
+                buckets.add(count);
+
+            auto* entry = new juce::DynamicObject();
+            entry->setProperty("count", stats.count);
+            entry->setProperty("mean_us", stats.getMeanUs());
+            entry->setProperty("p50_us", stats.getPercentileUs(0.5));
+            entry->setProperty("p99_us", stats.getPercentileUs(0.99));
+            entry->setProperty("max_us", stats.getMaxUs());
+            entry->setProperty("buckets", buckets);
+            timersObject->setProperty(getName(static_cast<Timer>(i)), juce::var(entry));
+        }
+
+        auto* root = new juce::DynamicObject();
+        root->setProperty("time", juce::Time::getCurrentTime().toISO8601(true));
+        root->setProperty("bucket_layout", "quarter octaves, bucket n upper edge = (1 + (n % 4 + 1) / 4) * 2^(n / 4) us");
+        root->setProperty("counters", juce::var(countersObject));
+        root->setProperty("timers", juce::var(timersObject));
+
+        return file.replaceWithText(juce::JSON::toString(juce::var(root)));
+    }
+}
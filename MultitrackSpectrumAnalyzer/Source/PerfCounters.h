@@ -0,0 +1,103 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/// Low-overhead performance counters and timing histograms.
+///
+/// Each thread records into its own block of atomics (allocated and registered
+/// on the thread's first use), so recording is a plain relaxed load and store:
+/// no locks, no read-modify-write, no sharing between threads. Readers sum all
+/// blocks. Blocks outlive their threads, so totals never go backwards.
+namespace Perf
+{
+    enum class Counter
+    {
+        packetsReceived,
+        bytesReceived,
+        spectrumFrames,
+        heartbeats,
+        parseErrors,
+        framesDropped,
+        framesOutOfOrder,
+        paints,
+        numCounters
+    };
+
+    enum class Timer
+    {
+        parse,            // One OSC message
+        trackLockHold,    // Time spent holding the TrackManager lock
+        snapshotUpdate,   // Display pulling changed tracks and rebuilding its caches
+        paintTotal,       // Whole display paint
+        paintBackground,  // Background, grid and axes
+        paintPrepare,     // Turning spectra into paths
+        paintStroke,      // Stroking/filling paths
+        frameInterval,    // Between frames that delivered new data
+        numTimers
+    };
+
+    constexpr int numCounters = static_cast<int>(Counter::numCounters);
+    constexpr int numTimers = static_cast<int>(Timer::numTimers);
+
+    /// Quarter-octave buckets from 1 us to about 1 s.
+    constexpr int numHistogramBuckets = 80;
+
+    const char* getName(Counter counter);
+    const char* getName(Timer timer);
+
+    void add(Counter counter, juce::int64 amount = 1) noexcept;
+    void record(Timer timer, juce::int64 microseconds) noexcept;
+
+    /// Monotonic microseconds, for timing spans by hand.
+    juce::int64 getTimeMicroseconds() noexcept;
+
+    /// Records the lifetime of this object into a timer.
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(Timer t) noexcept : timer(t), start(getTimeMicroseconds()) {}
+        ~ScopedTimer() { record(timer, getTimeMicroseconds() - start); }
+
+    private:
+        Timer timer;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+
+    /// Totals of one timer, summed over all threads.
+    struct TimerStats
+    {
+        std::array<juce::int64, numHistogramBuckets> buckets {};
+        juce::int64 count { 0 };
+        juce::int64 totalUs { 0 };
+
+        double getMeanUs() const;
+
+        /// At bucket resolution (upper edge of the bucket holding the percentile).
+        double getPercentileUs(double p) const;
+
+        /// Upper edge of the highest non-empty bucket.
+        double getMaxUs() const;
+
+        /// What was recorded between an earlier snapshot and this one.
+        TimerStats since(const TimerStats& earlier) const;
+    };
+
+    struct Snapshot
+    {
+        double timeSeconds { 0.0 };
+        std::array<juce::int64, numCounters> counters {};
+        std::array<TimerStats, numTimers> timers;
+
+        juce::int64 get(Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+        const TimerStats& get(Timer timer) const { return timers[static_cast<size_t>(timer)]; }
+    };
+
+    Snapshot takeSnapshot();
+
+    /// Writes the current totals (counters, timer counts, means and percentiles) as JSON.
+    bool dumpToFile(const juce::File& file);
+
+    double getBucketUpperUs(int bucket);
+}
@@ -0,0 +1,158 @@
+#include "PerfHud.h"
+
+namespace
+{
+    juce::String formatMs(double microseconds)
+    {
+        return juce::String(microseconds / 1000.0, 2);
+    }
+}
+
+PerfHud::PerfHud(TrackManager& tm)
+    : trackManager(tm)
+{
+    // Only the button takes clicks; the rest of the display stays interactive
+    setInterceptsMouseClicks(false, true);
+
+    dumpButton.onClick = [this]() { dumpToFile(); };
+    addAndMakeVisible(dumpButton);
+}
+
+PerfHud::~PerfHud()
+{
+}
+
+void PerfHud::refresh()
+{
+    auto snapshot = Perf::takeSnapshot();
+
+    if (!hasPreviousSnapshot)
+    {
+        previousSnapshot = snapshot;
+        hasPreviousSnapshot = true;
+        lines.clear();
+        lines.add("Collecting...");
+        repaint();
+        return;
+    }
+
+    const double seconds = juce::jmax(1.0e-3, snapshot.timeSeconds - previousSnapshot.timeSeconds);
+    auto rate = [&](Perf::Counter counter)
+    {
+        return static_cast<double>(snapshot.get(counter) - previousSnapshot.get(counter)) / seconds;
+    };
+    auto interval = [&](Perf::Timer timer)
+    {
+        return snapshot.get(timer).since(previousSnapshot.get(timer));
+    };
+
+    auto parse = interval(Perf::Timer::parse);
+    auto lock = interval(Perf::Timer::trackLockHold);
+    auto snapshotUpdate = interval(Perf::Timer::snapshotUpdate);
+    auto paintTotal = interval(Perf::Timer::paintTotal);
+    auto paintBackground = interval(Perf::Timer::paintBackground);
+    auto paintPrepare = interval(Perf::Timer::paintPrepare);
+    auto paintStroke = interval(Perf::Timer::paintStroke);
+    auto frameInterval = interval(Perf::Timer::frameInterval);
+
+    lines.clear();
+
+    lines.add("Ingest    " + juce::String(juce::roundToInt(rate(Perf::Counter::packetsReceived))) + " pkt/s  "
+              + juce::String(rate(Perf::Counter::bytesReceived) / 1.0e6, 2) + " MB/s  "
+              + "parse p50 " + juce::String(juce::roundToInt(parse.getPercentileUs(0.5))) + " us"
+              + " p99 " + juce::String(juce::roundToInt(parse.getPercentileUs(0.99))) + " us  "
+              + "errors " + juce::String(snapshot.get(Perf::Counter::parseErrors)));
+
+    lines.add("Frames    dropped " + juce::String(snapshot.get(Perf::Counter::framesDropped))
+              + " (" + juce::String(rate(Perf::Counter::framesDropped), 1) + "/s)  "
+              + "out of order " + juce::String(snapshot.get(Perf::Counter::framesOutOfOrder)));
+
+    lines.add("Lock      hold p50 " + juce::String(juce::roundToInt(lock.getPercentileUs(0.5))) + " us"
+              + " p99 " + juce::String(juce::roundToInt(lock.getPercentileUs(0.99))) + " us"
+              + " max " + juce::String(juce::roundToInt(lock.getMaxUs())) + " us  "
+              + "snapshot p50 " + formatMs(snapshotUpdate.getPercentileUs(0.5)) + " ms"
+              + " p99 " + formatMs(snapshotUpdate.getPercentileUs(0.99)) + " ms");
+
+    lines.add("Paint     " + juce::String(juce::roundToInt(rate(Perf::Counter::paints))) + "/s  "
+              + "total p50 " + formatMs(paintTotal.getPercentileUs(0.5))
+              + " p99 " + formatMs(paintTotal.getPercentileUs(0.99)) + " ms  "
+              + "mean: background " + formatMs(paintBackground.getMeanUs())
+              + " prepare " + formatMs(paintPrepare.getMeanUs())
+              + " stroke " + formatMs(paintStroke.getMeanUs()) + " ms");
+
+    lines.add("Pacing    frame interval p50 " + formatMs(frameInterval.getPercentileUs(0.5))
+              + " p99 " + formatMs(frameInterval.getPercentileUs(0.99))
+              + " max " + formatMs(frameInterval.getMaxUs()) + " ms");
+
+    // Tracks losing the most frames
+    std::vector<TrackListEntry> lossyTracks;
+    TrackListEntry entry;
+    for (int i = 0; trackManager.getTrackListEntry(i, entry); ++i)
+    {
+        if (entry.framesDropped > 0 || entry.framesOutOfOrder > 0)
+            lossyTracks.push_back(entry);
+    }
+
+    std::sort(lossyTracks.begin(), lossyTracks.end(), [](const TrackListEntry& a, const TrackListEntry& b)
+    {
+        return a.framesDropped + a.framesOutOfOrder > b.framesDropped + b.framesOutOfOrder;
+    });
+
+    juce::String lossLine = "Loss      ";
+    if (lossyTracks.empty())
+        lossLine += "none";
+
+    for (size_t i = 0; i < lossyTracks.size() && i < static_cast<size_t>(maxTracksListed); ++i)
+    {
+        const auto& track = lossyTracks[i];
+        lossLine += track.trackName + " " + juce::String(track.framesDropped) + "/" + juce::String(track.framesOutOfOrder) + "  ";
+    }
+
+    if (lossyTracks.size() > static_cast<size_t>(maxTracksListed))
+        lossLine += "+" + juce::String(static_cast<int>(lossyTracks.size()) - maxTracksListed) + " more";
+
+    lines.add(lossLine.trimEnd() + "  (dropped/out of order)");
+
+    previousSnapshot = snapshot;
+    repaint();
+}
+
+int PerfHud::getPreferredHeight() const
+{
+    return 8 + (juce::jmax(1, lines.size()) + 1) * lineHeight + 22;
+}
+
+void PerfHud::paint(juce::Graphics& g)
+{
+    g.setColour(juce::Colour(0xe0202020));
+    g.fillRoundedRectangle(getLocalBounds().toFloat(), 4.0f);
+
+    auto area = getLocalBounds().reduced(6, 4);
+    g.setFont(juce::FontOptions(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    g.setColour(juce::Colour(0xffc0c0c0));
+
+    for (const auto& line : lines)
+        g.drawText(line, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+
+    if (dumpMessage.isNotEmpty())
+    {
+        g.setColour(juce::Colour(0xff808080));
+        g.drawText(dumpMessage, area.removeFromTop(lineHeight), juce::Justification::centredLeft, true);
+    }
+}
+
+void PerfHud::resized()
+{
+    dumpButton.setBounds(getLocalBounds().reduced(6, 4).removeFromBottom(20).removeFromRight(100));
+}
+
+void PerfHud::dumpToFile()
+{
+    auto file = juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+                    .getChildFile("MultitrackSpectrumAnalyzer-perf-"
+                                  + juce::Time::getCurrentTime().formatted("%Y%m%d-%H%M%S") + ".json");
+
+    dumpMessage = Perf::dumpToFile(file) ? "Saved " + file.getFullPathName()
+                                         : "Could not write " + file.getFullPathName();
+    repaint();
+}
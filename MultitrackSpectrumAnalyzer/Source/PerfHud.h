@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+#include "PerfCounters.h"
+
+/// Overlay with live ingest, lock, paint and frame pacing figures from the
+/// Perf counters, plus the tracks losing the most frames. Figures cover the
+/// time since the previous refresh().
+class PerfHud : public juce::Component
+{
+public:
+    PerfHud(TrackManager& trackManager);
+    ~PerfHud() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    /// Takes a new counter snapshot and repaints. Called at the status bar's rate.
+    void refresh();
+
+    int getPreferredHeight() const;
+
+private:
+    void dumpToFile();
+
+    TrackManager& trackManager;
+    Perf::Snapshot previousSnapshot;
+    bool hasPreviousSnapshot { false };
+
+    juce::StringArray lines;
+    juce::String dumpMessage;
+    juce::TextButton dumpButton { "Dump to file" };
+
+    static constexpr int lineHeight = 15;
+    static constexpr int maxTracksListed = 5;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PerfHud)
+};
@@ -0,0 +1,148 @@
+#include "PlaybackBar.h"
+
+namespace
+{
+    const double playbackSpeeds[] = { 0.25, 0.5, 1.0, 2.0, 4.0, 8.0, 16.0 };
+}
+
+PlaybackBar::PlaybackBar(SessionPlayer& p)
+    : player(p)
+{
+    playButton.onClick = [this]() { onPlayClicked(); };
+    addAndMakeVisible(playButton);
+
+    for (int i = 0; i < static_cast<int>(std::size(playbackSpeeds)); ++i)
+        speedCombo.addItem(juce::String(playbackSpeeds[i]) + "x", i + 1);
+    speedCombo.setSelectedId(3, juce::dontSendNotification);
+    speedCombo.onChange = [this]() { onSpeedChanged(); };
+    addAndMakeVisible(speedCombo);
+
+    // Scrubbing: pause while dragging, seek as the thumb moves, resume on release
+    positionSlider.setSliderStyle(juce::Slider::LinearBar);
+    positionSlider.setTextBoxStyle(juce::Slider::NoTextBox, false, 0, 0);
+    positionSlider.setColour(juce::Slider::trackColourId, juce::Colour(0xff3a6ea5));
+    positionSlider.onDragStart = [this]()
+    {
+        wasPlayingBeforeDrag = player.isPlaying();
+        player.pause();
+    };
+    positionSlider.onValueChange = [this]()
+    {
+        player.seek(static_cast<juce::int64>(positionSlider.getValue() * 1.0e6));
+        timeLabel.setText(formatTime(player.getPositionUs()) + " / " + formatTime(player.getDurationUs()),
+                          juce::dontSendNotification);
+    };
+    positionSlider.onDragEnd = [this]()
+    {
+        if (wasPlayingBeforeDrag)
+            player.play();
+        refresh();
+    };
+    addAndMakeVisible(positionSlider);
+
+    timeLabel.setFont(juce::FontOptions(13.0f));
+    timeLabel.setColour(juce::Label::textColourId, juce::Colours::lightgrey);
+    timeLabel.setJustificationType(juce::Justification::centred);
+    addAndMakeVisible(timeLabel);
+
+    fileLabel.setFont(juce::FontOptions(13.0f));
+    fileLabel.setColour(juce::Label::textColourId, juce::Colours::grey);
+    fileLabel.setMinimumHorizontalScale(0.5f);
+    addAndMakeVisible(fileLabel);
+
+    closeButton.onClick = [this]()
+    {
+        if (onClose)
+            onClose();
+    };
+    addAndMakeVisible(closeButton);
+}
+
+PlaybackBar::~PlaybackBar()
+{
+    stopTimer();
+}
+
+void PlaybackBar::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colour(0xff242424));
+}
+
+void PlaybackBar::resized()
+{
+    auto area = getLocalBounds().reduced(10, 4);
+
+    playButton.setBounds(area.removeFromLeft(60));
+    area.removeFromLeft(8);
+    speedCombo.setBounds(area.removeFromLeft(70));
+    area.removeFromLeft(8);
+    closeButton.setBounds(area.removeFromRight(60));
+    area.removeFromRight(8);
+    fileLabel.setBounds(area.removeFromRight(juce::jmin(220, area.getWidth() / 4)));
+    timeLabel.setBounds(area.removeFromRight(120));
+    positionSlider.setBounds(area);
+}
+
+void PlaybackBar::refresh()
+{
+    const double durationSeconds = static_cast<double>(player.getDurationUs()) / 1.0e6;
+    positionSlider.setRange(0.0, juce::jmax(durationSeconds, 0.001), 0.0);
+
+    if (!positionSlider.isMouseButtonDown())
+        positionSlider.setValue(static_cast<double>(player.getPositionUs()) / 1.0e6, juce::dontSendNotification);
+
+    timeLabel.setText(formatTime(player.getPositionUs()) + " / " + formatTime(player.getDurationUs()),
+                      juce::dontSendNotification);
+
+    if (auto* reader = player.getReader())
+    {
+        fileLabel.setText(reader->getFile().getFileName() + (reader->wasRecovered() ? " (recovered)" : ""),
+                          juce::dontSendNotification);
+        fileLabel.setTooltip(reader->getFile().getFullPathName() + "\nRecorded "
+                             + reader->getStartTime().toString(true, true));
+    }
+
+    playButton.setButtonText(player.isPlaying() ? "Pause" : "Play");
+
+    for (int i = 0; i < static_cast<int>(std::size(playbackSpeeds)); ++i)
+    {
+        if (juce::approximatelyEqual(playbackSpeeds[i], player.getSpeed()))
+            speedCombo.setSelectedId(i + 1, juce::dontSendNotification);
+    }
+
+    // Only tick while there is a playhead to follow
+    if (player.isPlaying())
+        startTimerHz(refreshRateHz);
+    else
+        stopTimer();
+}
+
+void PlaybackBar::timerCallback()
+{
+    refresh();
+}
+
+void PlaybackBar::onPlayClicked()
+{
+    if (player.isPlaying())
+        player.pause();
+    else
+        player.play();
+
+    refresh();
+}
+
+void PlaybackBar::onSpeedChanged()
+{
+    int index = speedCombo.getSelectedId() - 1;
+    if (index >= 0 && index < static_cast<int>(std::size(playbackSpeeds)))
+        player.setSpeed(playbackSpeeds[index]);
+}
+
+juce::String PlaybackBar::formatTime(juce::int64 timeUs)
+{
+    const juce::int64 totalTenths = timeUs / 100000;
+    const juce::int64 minutes = totalTenths / 600;
+    const juce::int64 seconds = (totalTenths / 10) % 60;
+    return juce::String(minutes) + ":" + juce::String(seconds).paddedLeft('0', 2) + "." + juce::String(totalTenths % 10);
+}
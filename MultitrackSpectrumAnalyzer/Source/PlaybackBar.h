@@ -0,0 +1,45 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SessionPlayer.h"
+
+/// Transport for session playback: play/pause, speed, a position slider for
+/// scrubbing, and a close button that returns to live input.
+class PlaybackBar : public juce::Component,
+                    private juce::Timer
+{
+public:
+    PlaybackBar(SessionPlayer& player);
+    ~PlaybackBar() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    /// Brings the controls in line with the player (after opening a file, or when playback ends).
+    void refresh();
+
+    /// Called when the close button is clicked.
+    std::function<void()> onClose;
+
+private:
+    void timerCallback() override;
+    void onPlayClicked();
+    void onSpeedChanged();
+
+    static juce::String formatTime(juce::int64 timeUs);
+
+    SessionPlayer& player;
+
+    juce::TextButton playButton { "Play" };
+    juce::ComboBox speedCombo;
+    juce::Slider positionSlider;
+    juce::Label timeLabel;
+    juce::Label fileLabel;
+    juce::TextButton closeButton { "Close" };
+
+    bool wasPlayingBeforeDrag { false };
+
+    static constexpr int refreshRateHz = 10;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PlaybackBar)
+};
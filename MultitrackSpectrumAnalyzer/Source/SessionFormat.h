@@ -0,0 +1,144 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumData.h"
+#include "../../Common/SpectrumCodes.h"
+
+/// On-disk layout of recorded sessions (.wxcsession), written by SessionRecorder.
+///
+///     FileHeader                      fileHeaderSize bytes
+///     chunk 0                         chunkSize bytes
+///     chunk 1 ...
+///     track table                     TrackInfo records, one per track
+///     time index                      IndexEntry per indexSlotUs of session time
+///     Footer
+///
+/// Every chunk is exactly chunkSize bytes: a ChunkHeader followed by whole
+/// records (never split across chunks) and zero padding, so chunk n starts at
+/// fileHeaderSize + n * chunkSize. Records are a RecordHeader and a payload,
+/// padded to 4 bytes. Tracks are announced by a TrackInfo record before their
+/// first frame (and again if renamed); frames refer to them by index.
+///
+/// The time index maps slot k (session time k * indexSlotUs) to the file
+/// offset of the first record at or after that time, so seeking by time is a
+/// single lookup once the file is mapped. Track table, index and footer are
+/// written when recording stops; a file without a footer (e.g. after a crash)
+/// can be recovered by walking the chunks.
+///
+/// All values are little-endian, in the structs' native layout.
+namespace SessionFormat
+{
+    constexpr char fileMagic[8] = { 'W', 'X', 'C', 'S', 'E', 'S', 'S', 'N' };
+    constexpr juce::uint32 formatVersion = 1;
+    constexpr juce::uint32 chunkMagic = 0x4b435857;   // "WXCK"
+    constexpr juce::uint32 footerMagic = 0x58444957;  // "WIDX"
+
+    constexpr int fileHeaderSize = 64;
+    constexpr int chunkSize = 1 << 20;
+    constexpr int chunkHeaderSize = 32;
+    constexpr juce::int64 indexSlotUs = 100000;
+
+    // Magnitudes are stored as SpectrumCodes: dB in 0.01 dB steps from minDb (0 = silence)
+    constexpr float minDb = SpectrumCodes::MIN_DB;
+    constexpr float dbStep = SpectrumCodes::DB_STEP;
+
+    enum RecordType : juce::uint16
+    {
+        trackInfoRecord = 1,
+        frameRecord = 2
+    };
+
+    struct FileHeader
+    {
+        char magic[8];
+        juce::uint32 version;
+        juce::uint32 chunkSize;
+        juce::int64 startTimeMs;        // Wall clock when recording started
+        juce::int64 startMonotonicUs;   // SpectrumMessages::getMonotonicTimeMicroseconds() at the same moment
+        juce::uint32 numBins;
+        juce::uint32 reserved[7];
+    };
+
+    struct ChunkHeader
+    {
+        juce::uint32 magic;
+        juce::uint32 chunkIndex;
+        juce::int64 firstTimeUs;        // Session time of the first and last records
+        juce::int64 lastTimeUs;
+        juce::uint32 numRecords;
+        juce::uint32 usedBytes;         // Including this header
+    };
+
+    struct RecordHeader
+    {
+        juce::uint16 type;
+        juce::uint16 trackIndex;
+        juce::uint32 size;              // Header, payload and padding
+        juce::int64 timeUs;             // Session time the analyzer received it
+    };
+
+    /// Followed by the track id and name (UTF-8, not terminated).
+    struct TrackInfoPayload
+    {
+        double sampleRate;
+        juce::uint32 idBytes;
+        juce::uint32 nameBytes;
+    };
+
+    /// Followed by numBins quantized magnitudes (juce::uint16).
+    struct FramePayload
+    {
+        juce::uint32 sequence;
+        juce::uint32 flags;             // frameHasHeader if the relay sent a header, frameLogBins for BinLayout::Log
+        juce::int64 captureTimeUs;      // From the relay's header (monotonic clock, 0 = unknown)
+        juce::int64 hostSamplePosition;
+        float sampleRate;
+        juce::uint32 numBins;
+    };
+
+    constexpr juce::uint32 frameHasHeader = 1;
+    constexpr juce::uint32 frameLogBins = 2;
+
+    struct IndexEntry
+    {
+        juce::int64 fileOffset;
+    };
+
+    struct Footer
+    {
+        juce::uint32 magic;
+        juce::uint32 numTracks;
+        juce::int64 trackTableOffset;
+        juce::int64 indexOffset;
+        juce::uint32 numIndexEntries;
+        juce::uint32 reserved;
+        juce::int64 indexSlotUs;
+    };
+
+    static_assert(sizeof(FileHeader) == fileHeaderSize, "FileHeader layout");
+    static_assert(sizeof(ChunkHeader) == chunkHeaderSize, "ChunkHeader layout");
+    static_assert(sizeof(RecordHeader) == 16, "RecordHeader layout");
+    static_assert(sizeof(TrackInfoPayload) == 16, "TrackInfoPayload layout");
+    static_assert(sizeof(FramePayload) == 32, "FramePayload layout");
+    static_assert(sizeof(Footer) == 40, "Footer layout");
+
+    inline juce::uint32 padToRecordAlignment(size_t size)
+    {
+        return static_cast<juce::uint32>((size + 3) & ~static_cast<size_t>(3));
+    }
+
+    inline juce::uint32 getFrameRecordSize(int numBins)
+    {
+        return padToRecordAlignment(sizeof(RecordHeader) + sizeof(FramePayload) + sizeof(juce::uint16) * static_cast<size_t>(numBins));
+    }
+
+    inline juce::uint16 quantizeMagnitude(float magnitude)
+    {
+        return SpectrumCodes::fromMagnitude(magnitude);
+    }
+
+    inline float dequantizeMagnitude(juce::uint16 value)
+    {
+        return SpectrumCodes::toMagnitude(value);
+    }
+}
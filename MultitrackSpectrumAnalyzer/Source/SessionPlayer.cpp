@@ -0,0 +1,168 @@
+#include "SessionPlayer.h"
+
+SessionPlayer::SessionPlayer(TrackManager& tm)
+    : trackManager(tm)
+{
+}
+
+SessionPlayer::~SessionPlayer()
+{
+    stopTimer();
+}
+
+bool SessionPlayer::open(const juce::File& file, juce::String& error)
+{
+    close();
+
+    auto newReader = std::make_unique<SessionReader>();
+    if (!newReader->open(file, error))
+        return false;
+
+    reader = std::move(newReader);
+    tracks = reader->getTracks();
+    cursorOffset = reader->getStartOffset();
+    positionUs = 0;
+    trackManager.setStaleHold(true);
+    return true;
+}
+
+void SessionPlayer::close()
+{
+    pause();
+    reader.reset();
+    tracks.clear();
+    firstFrameTimes.clear();
+    positionUs = 0;
+    trackManager.setStaleHold(false);
+}
+
+void SessionPlayer::play()
+{
+    if (reader == nullptr || playing)
+        return;
+
+    // Start over when play is pressed at the end
+    if (positionUs >= reader->getDurationUs())
+        seek(0);
+
+    playing = true;
+    trackManager.setStaleHold(false);
+    lastTickMs = juce::Time::getMillisecondCounterHiRes();
+    startTimerHz(tickRateHz);
+}
+
+void SessionPlayer::pause()
+{
+    playing = false;
+    stopTimer();
+
+    // No frames arrive until play resumes; keep the ones at the playhead
+    if (reader != nullptr)
+        trackManager.setStaleHold(true);
+}
+
+void SessionPlayer::setSpeed(double newSpeed)
+{
+    speed = juce::jlimit(minSpeed, maxSpeed, newSpeed);
+}
+
+void SessionPlayer::seek(juce::int64 timeUs)
+{
+    if (reader == nullptr)
+        return;
+
+    timeUs = juce::jlimit(static_cast<juce::int64>(0), reader->getDurationUs(), timeUs);
+
+    // Tracks first heard after the new position would otherwise keep their later spectra
+    if (timeUs < positionUs)
+    {
+        for (size_t i = 0; i < firstFrameTimes.size() && i < tracks.size(); ++i)
+        {
+            if (firstFrameTimes[i] > timeUs)
+            {
+                trackManager.setTrackOffline(tracks[i].trackId);
+                firstFrameTimes[i] = -1;
+            }
+        }
+    }
+
+    // The preroll is short, so it's fed in full even if that takes longer than a tick
+    cursorOffset = reader->getOffsetForTime(timeUs - seekPrerollUs);
+    feedUntil(timeUs, false);
+    positionUs = timeUs;
+}
+
+void SessionPlayer::timerCallback()
+{
+    const double now = juce::Time::getMillisecondCounterHiRes();
+    const double elapsedMs = now - lastTickMs;
+    lastTickMs = now;
+
+    const juce::int64 targetUs = positionUs + static_cast<juce::int64>(elapsedMs * 1000.0 * speed);
+
+    // If the tick's budget ran out the playhead only moves as far as was fed
+    positionUs = juce::jmax(positionUs, feedUntil(targetUs, true));
+
+    if (positionUs >= reader->getDurationUs())
+    {
+        positionUs = reader->getDurationUs();
+        pause();
+
+        if (onFinished)
+            onFinished();
+    }
+}
+
+juce::int64 SessionPlayer::feedUntil(juce::int64 timeUs, bool limitToTickBudget)
+{
+    // Each frame takes the whole TrackManager path, so the budget is time rather than frames
+    const double deadlineMs = juce::Time::getMillisecondCounterHiRes() + maxFeedMsPerTick;
+
+    for (;;)
+    {
+        juce::int64 offset = cursorOffset;
+        SessionReader::Record record;
+        if (!reader->readNext(offset, record) || record.header.timeUs > timeUs)
+            return timeUs;
+
+        // Stop short and let the next tick carry on from here
+        if (limitToTickBudget && juce::Time::getMillisecondCounterHiRes() >= deadlineMs)
+            return record.header.timeUs;
+
+        cursorOffset = offset;
+        feedRecord(record);
+    }
+}
+
+void SessionPlayer::feedRecord(const SessionReader::Record& record)
+{
+    const auto trackIndex = static_cast<size_t>(record.header.trackIndex);
+
+    if (record.header.type == SessionFormat::trackInfoRecord)
+    {
+        SessionReader::TrackInfo trackInfo;
+        if (!SessionReader::decodeTrackInfo(record, trackInfo))
+            return;
+
+        if (tracks.size() <= trackIndex)
+            tracks.resize(trackIndex + 1);
+        tracks[trackIndex] = trackInfo;
+
+        trackManager.updateTrackPresence(trackInfo.trackId, trackInfo.trackName, trackInfo.sampleRate);
+        return;
+    }
+
+    SessionFormat::FramePayload frame;
+    if (trackIndex >= tracks.size() || !SessionReader::decodeFrame(record, frame, magnitudes))
+        return;
+
+    if (firstFrameTimes.size() <= trackIndex)
+        firstFrameTimes.resize(trackIndex + 1, -1);
+    if (firstFrameTimes[trackIndex] < 0)
+        firstFrameTimes[trackIndex] = record.header.timeUs;
+
+    const auto& track = tracks[trackIndex];
+    const auto layout = (frame.flags & SessionFormat::frameLogBins) != 0 ? BinLayout::Log : BinLayout::Linear;
+    trackManager.updateTrack(track.trackId, track.trackName, magnitudes.data(),
+                             static_cast<int>(magnitudes.size()), frame.sampleRate, nullptr, layout);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+#include "SessionReader.h"
+
+/// Replays a recorded session into the TrackManager, through the same
+/// updateTrackPresence()/updateTrack() calls live OSC ingest uses, so
+/// everything downstream (displays, perf counters, metrics exporter)
+/// behaves as it would live. Tracks that stop appearing in the recording go
+/// offline as they would live. While a session is open and not playing (paused,
+/// or scrubbed while paused), the TrackManager holds every track as it is, so
+/// the frame at the playhead stays on screen.
+///
+/// Runs on the message thread. Frames are decoded lazily from the mapped
+/// file as the playhead passes them, so memory use doesn't grow with the
+/// length of the recording. Replayed frames carry no header: their sequence
+/// numbers and capture stamps belong to the original session and would show
+/// up as loss and latency.
+class SessionPlayer : private juce::Timer
+{
+public:
+    SessionPlayer(TrackManager& trackManager);
+    ~SessionPlayer() override;
+
+    /// Opens a recording, paused at the start. On failure returns false and describes why in error.
+    bool open(const juce::File& file, juce::String& error);
+    void close();
+    bool isOpen() const { return reader != nullptr; }
+
+    void play();
+    void pause();
+    bool isPlaying() const { return playing; }
+
+    /// Playback rate relative to real time, clamped to minSpeed..maxSpeed.
+    void setSpeed(double newSpeed);
+    double getSpeed() const { return speed; }
+
+    /// Moves the playhead, replaying a short stretch before it so every track shows its state at that point.
+    /// Seeking back takes tracks that have no frames yet at that point offline.
+    void seek(juce::int64 timeUs);
+
+    juce::int64 getPositionUs() const { return positionUs; }
+    juce::int64 getDurationUs() const { return reader != nullptr ? reader->getDurationUs() : 0; }
+    const SessionReader* getReader() const { return reader.get(); }
+
+    /// Called when playback reaches the end of the recording.
+    std::function<void()> onFinished;
+
+    static constexpr double minSpeed = 0.25;
+    static constexpr double maxSpeed = 16.0;
+
+private:
+    void timerCallback() override;
+
+    /// Feeds records up to timeUs into the TrackManager. Returns how far it got, which is
+    /// short of timeUs only when limited to the per-tick budget and that ran out.
+    juce::int64 feedUntil(juce::int64 timeUs, bool limitToTickBudget);
+    void feedRecord(const SessionReader::Record& record);
+
+    TrackManager& trackManager;
+    std::unique_ptr<SessionReader> reader;
+    std::vector<SessionReader::TrackInfo> tracks;  // Names as of the playhead
+    std::vector<float> magnitudes;                 // Reused for every frame
+    std::vector<juce::int64> firstFrameTimes;      // Per track index, -1 until its first frame is fed
+
+    juce::int64 cursorOffset { 0 };  // Next record to feed
+    juce::int64 positionUs { 0 };
+    double speed { 1.0 };
+    bool playing { false };
+    double lastTickMs { 0.0 };
+
+    static constexpr int tickRateHz = 100;
+    static constexpr double maxFeedMsPerTick = 4.0;    // Beyond this, fast playback runs slower rather than stalling the UI
+    static constexpr juce::int64 seekPrerollUs = 300000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionPlayer)
+};
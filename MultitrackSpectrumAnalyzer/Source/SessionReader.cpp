@@ -0,0 +1,241 @@
+#include "SessionReader.h"
+
+using namespace SessionFormat;
+
+namespace
+{
+    template <typename Type>
+    Type readStruct(const char* source)
+    {
+        Type value;
+        std::memcpy(&value, source, sizeof(Type));
+        return value;
+    }
+}
+
+bool SessionReader::open(const juce::File& fileToOpen, juce::String& error)
+{
+    file = fileToOpen;
+    mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly);
+
+    data = static_cast<const char*>(mappedFile->getData());
+    size = static_cast<juce::int64>(mappedFile->getSize());
+
+    if (data == nullptr || size < fileHeaderSize)
+    {
+        error = "Could not open " + file.getFileName();
+        return false;
+    }
+
+    auto header = readStruct<FileHeader>(data);
+    if (std::memcmp(header.magic, fileMagic, sizeof(header.magic)) != 0)
+    {
+        error = file.getFileName() + " is not a recorded session";
+        return false;
+    }
+
+    if (header.version > formatVersion || header.chunkSize < static_cast<juce::uint32>(chunkHeaderSize))
+    {
+        error = file.getFileName() + " was recorded by a newer version";
+        return false;
+    }
+
+    chunkBytes = header.chunkSize;
+    startTimeMs = header.startTimeMs;
+
+    if (!readFooter())
+        recover();
+
+    return true;
+}
+
+bool SessionReader::readFooter()
+{
+    if (size < fileHeaderSize + static_cast<juce::int64>(sizeof(Footer)))
+        return false;
+
+    const auto footer = readStruct<Footer>(data + size - sizeof(Footer));
+    const juce::int64 footerOffset = size - static_cast<juce::int64>(sizeof(Footer));
+
+    if (footer.magic != footerMagic
+        || footer.trackTableOffset < fileHeaderSize
+        || (footer.trackTableOffset - fileHeaderSize) % chunkBytes != 0
+        || footer.indexOffset < footer.trackTableOffset
+        || footer.indexOffset + static_cast<juce::int64>(footer.numIndexEntries * sizeof(IndexEntry)) != footerOffset
+        || footer.indexSlotUs <= 0)
+        return false;
+
+    chunksEnd = footer.trackTableOffset;
+    indexSlotUs = footer.indexSlotUs;
+    index.resize(static_cast<size_t>(footer.numIndexEntries));
+    if (!index.empty())
+        std::memcpy(index.data(), data + footer.indexOffset, index.size() * sizeof(IndexEntry));
+
+    // Seeking reads from these offsets, so a corrupt index is rebuilt like a missing one
+    juce::int64 previousOffset = fileHeaderSize;
+    for (const auto& entry : index)
+    {
+        if (entry.fileOffset < previousOffset || entry.fileOffset > chunksEnd)
+            return false;
+
+        previousOffset = entry.fileOffset;
+    }
+
+    // Track table: plain records, back to back
+    tracks.clear();
+    for (juce::int64 offset = footer.trackTableOffset; offset + static_cast<juce::int64>(sizeof(RecordHeader)) <= footer.indexOffset;)
+    {
+        Record record;
+        record.header = readStruct<RecordHeader>(data + offset);
+        if (record.header.size < sizeof(RecordHeader) || offset + record.header.size > footer.indexOffset)
+            return false;
+
+        record.payload = data + offset + sizeof(RecordHeader);
+        record.payloadSize = record.header.size - static_cast<juce::uint32>(sizeof(RecordHeader));
+
+        TrackInfo trackInfo;
+        if (decodeTrackInfo(record, trackInfo))
+        {
+            if (tracks.size() <= record.header.trackIndex)
+                tracks.resize(static_cast<size_t>(record.header.trackIndex) + 1);
+            tracks[record.header.trackIndex] = trackInfo;
+        }
+
+        offset += record.header.size;
+    }
+
+    // The last chunk's header knows the final record's time
+    durationUs = 0;
+    if (chunksEnd > fileHeaderSize)
+        durationUs = readStruct<ChunkHeader>(data + chunksEnd - chunkBytes).lastTimeUs;
+
+    recovered = false;
+    return true;
+}
+
+void SessionReader::recover()
+{
+    // Whole chunks only; a chunk cut short by a crash is ignored
+    chunksEnd = fileHeaderSize + ((size - fileHeaderSize) / chunkBytes) * chunkBytes;
+    indexSlotUs = SessionFormat::indexSlotUs;
+    recovered = true;
+
+    tracks.clear();
+    index.clear();
+    durationUs = 0;
+
+    juce::int64 offset = getStartOffset();
+    for (;;)
+    {
+        Record record;
+        if (!readNext(offset, record))
+            break;
+
+        // readNext may have skipped chunk headers and padding, so work back from where it stopped
+        const juce::int64 start = offset - static_cast<juce::int64>(record.header.size);
+
+        while (static_cast<juce::int64>(index.size()) * indexSlotUs <= record.header.timeUs)
+            index.push_back({ start });
+
+        if (record.header.type == trackInfoRecord)
+        {
+            TrackInfo trackInfo;
+            if (decodeTrackInfo(record, trackInfo))
+            {
+                if (tracks.size() <= record.header.trackIndex)
+                    tracks.resize(static_cast<size_t>(record.header.trackIndex) + 1);
+                tracks[record.header.trackIndex] = trackInfo;
+            }
+        }
+
+        durationUs = juce::jmax(durationUs, record.header.timeUs);
+    }
+}
+
+juce::int64 SessionReader::getChunkStart(juce::int64 offset) const
+{
+    return fileHeaderSize + ((offset - fileHeaderSize) / chunkBytes) * chunkBytes;
+}
+
+juce::int64 SessionReader::getOffsetForTime(juce::int64 timeUs) const
+{
+    if (timeUs <= 0)
+        return getStartOffset();
+
+    // Slot k points at the first record at or after k * indexSlotUs
+    const auto slot = static_cast<size_t>(timeUs / indexSlotUs);
+    if (slot >= index.size())
+        return chunksEnd;
+
+    return index[slot].fileOffset;
+}
+
+bool SessionReader::readNext(juce::int64& offset, Record& record) const
+{
+    while (offset < chunksEnd)
+    {
+        const juce::int64 chunkStart = getChunkStart(offset);
+        const auto chunk = readStruct<ChunkHeader>(data + chunkStart);
+
+        if (chunk.magic != chunkMagic || chunk.usedBytes > chunkBytes)
+            return false;
+
+        if (offset < chunkStart + chunkHeaderSize)
+            offset = chunkStart + chunkHeaderSize;
+
+        const juce::int64 chunkUsedEnd = chunkStart + chunk.usedBytes;
+        if (offset + static_cast<juce::int64>(sizeof(RecordHeader)) > chunkUsedEnd)
+        {
+            offset = chunkStart + chunkBytes;
+            continue;
+        }
+
+        record.header = readStruct<RecordHeader>(data + offset);
+        if (record.header.size < sizeof(RecordHeader) || offset + record.header.size > chunkUsedEnd)
+        {
+            // Damaged record: the rest of this chunk can't be trusted
+            offset = chunkStart + chunkBytes;
+            continue;
+        }
+
+        record.payload = data + offset + sizeof(RecordHeader);
+        record.payloadSize = record.header.size - static_cast<juce::uint32>(sizeof(RecordHeader));
+        offset += record.header.size;
+        return true;
+    }
+
+    return false;
+}
+
+bool SessionReader::decodeFrame(const Record& record, FramePayload& frame, std::vector<float>& magnitudes)
+{
+    if (record.header.type != frameRecord || record.payloadSize < sizeof(FramePayload))
+        return false;
+
+    frame = readStruct<FramePayload>(record.payload);
+    if (sizeof(FramePayload) + frame.numBins * sizeof(juce::uint16) > record.payloadSize)
+        return false;
+
+    magnitudes.resize(frame.numBins);
+    const char* bins = record.payload + sizeof(FramePayload);
+    for (juce::uint32 i = 0; i < frame.numBins; ++i)
+        magnitudes[i] = dequantizeMagnitude(readStruct<juce::uint16>(bins + i * sizeof(juce::uint16)));
+
+    return true;
+}
+
+bool SessionReader::decodeTrackInfo(const Record& record, TrackInfo& trackInfo)
+{
+    if (record.header.type != trackInfoRecord || record.payloadSize < sizeof(TrackInfoPayload))
+        return false;
+
+    const auto payload = readStruct<TrackInfoPayload>(record.payload);
+    if (sizeof(TrackInfoPayload) + payload.idBytes + payload.nameBytes > record.payloadSize)
+        return false;
+
+    const char* text = record.payload + sizeof(TrackInfoPayload);
+    trackInfo.trackId = juce::String::fromUTF8(text, static_cast<int>(payload.idBytes));
+    trackInfo.trackName = juce::String::fromUTF8(text + payload.idBytes, static_cast<int>(payload.nameBytes));
+    trackInfo.sampleRate = payload.sampleRate;
+    return true;
+}
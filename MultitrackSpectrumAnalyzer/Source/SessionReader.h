@@ -0,0 +1,87 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SessionFormat.h"
+
+/// Read-only view of a recorded .wxcsession file (see SessionFormat).
+///
+/// The file is memory-mapped and nothing is decoded up front: opening reads
+/// the header, footer and track table, and records are decoded one at a time
+/// as they are read. Seeking by time is a lookup in the file's time index.
+/// Files without a footer (recording interrupted), or whose index points
+/// outside the chunks, are recovered by walking their chunks once on open.
+class SessionReader
+{
+public:
+    SessionReader() = default;
+
+    struct TrackInfo
+    {
+        juce::String trackId;
+        juce::String trackName;
+        double sampleRate { 0.0 };
+    };
+
+    /// A record inside the mapped file; valid while the reader is open.
+    struct Record
+    {
+        SessionFormat::RecordHeader header;
+        const char* payload { nullptr };
+        juce::uint32 payloadSize { 0 };
+    };
+
+    /// Maps the file. On failure returns false and describes why in error.
+    bool open(const juce::File& file, juce::String& error);
+
+    juce::File getFile() const { return file; }
+
+    /// Wall clock time the recording started.
+    juce::Time getStartTime() const { return juce::Time(startTimeMs); }
+
+    /// Session time of the last record.
+    juce::int64 getDurationUs() const { return durationUs; }
+
+    /// Tracks by index, with the names they had at the end of the recording.
+    const std::vector<TrackInfo>& getTracks() const { return tracks; }
+
+    /// True if the file had no usable footer and its index was rebuilt on open.
+    bool wasRecovered() const { return recovered; }
+
+    /// Offset of the first record in timeUs's index slot, so records up to
+    /// indexSlotUs before timeUs may come first. The end if there are none.
+    juce::int64 getOffsetForTime(juce::int64 timeUs) const;
+
+    juce::int64 getStartOffset() const { return SessionFormat::fileHeaderSize; }
+
+    /// Reads the record at offset and moves offset past it. False at the end of the recording.
+    bool readNext(juce::int64& offset, Record& record) const;
+
+    /// Decodes a frame record. magnitudes is resized to the frame's bin count.
+    static bool decodeFrame(const Record& record, SessionFormat::FramePayload& frame, std::vector<float>& magnitudes);
+
+    static bool decodeTrackInfo(const Record& record, TrackInfo& trackInfo);
+
+private:
+    bool readFooter();
+    void recover();
+    juce::int64 getChunkStart(juce::int64 offset) const;
+
+    juce::File file;
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    const char* data { nullptr };
+    juce::int64 size { 0 };
+
+    juce::int64 chunkBytes { SessionFormat::chunkSize };
+    juce::int64 chunksEnd { 0 };
+    juce::int64 startTimeMs { 0 };
+    juce::int64 durationUs { 0 };
+    juce::int64 indexSlotUs { SessionFormat::indexSlotUs };
+    bool recovered { false };
+
+    // Time index: copied out of the file (where it has no alignment guarantee), or rebuilt by recover()
+    std::vector<SessionFormat::IndexEntry> index;
+
+    std::vector<TrackInfo> tracks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionReader)
+};
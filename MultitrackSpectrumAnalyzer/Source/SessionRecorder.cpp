@@ -0,0 +1,420 @@
+#include "SessionRecorder.h"
+
+using namespace SessionFormat;
+
+SessionRecorder::SessionRecorder()
+    : juce::Thread("Session recorder")
+{
+    ringBuffer.malloc(ringBufferSize);
+    chunk.malloc(chunkSize);
+    recordScratch.malloc(maxRecordSize);
+
+    frameScratchSize = static_cast<int>(getFrameRecordSize(SpectrumConstants::NUM_BINS));
+    frameScratch.malloc(frameScratchSize);
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    stop();
+}
+
+juce::File SessionRecorder::getDefaultSessionDirectory()
+{
+    return juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+               .getChildFile("MultitrackSpectrumAnalyzer Sessions");
+}
+
+bool SessionRecorder::start(const juce::File& file, bool waitWhenFull)
+{
+    stop();
+
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk())
+    {
+        stream.reset();
+        return false;
+    }
+
+    startMonotonicUs = SpectrumMessages::getMonotonicTimeMicroseconds();
+
+    FileHeader header {};
+    std::memcpy(header.magic, fileMagic, sizeof(header.magic));
+    header.version = formatVersion;
+    header.chunkSize = static_cast<juce::uint32>(chunkSize);
+    header.startTimeMs = juce::Time::currentTimeMillis();
+    header.startMonotonicUs = startMonotonicUs;
+    header.numBins = static_cast<juce::uint32>(SpectrumConstants::NUM_BINS);
+
+    if (!stream->write(&header, sizeof(header)))
+    {
+        stream.reset();
+        return false;
+    }
+
+    fifo.reset();
+    trackSlots.clear();
+    timeIndex.clear();
+    trackTable.clear();
+    chunkIndex = 0;
+    startNewChunk();
+    lastChunkFlushMs = juce::Time::getMillisecondCounter();
+
+    framesRecorded = 0;
+    framesDropped = 0;
+    bytesWritten = fileHeaderSize;
+    lastRecordTimeUs = 0;
+    writeFailed = false;
+
+    currentFile = file;
+    waitForWriter = waitWhenFull;
+    recording = true;
+    startThread();
+    return true;
+}
+
+bool SessionRecorder::stop()
+{
+    if (!recording.exchange(false))
+        return !writeFailed.load();
+
+    // The writer drains the ring and writes the trailer before it exits; never kill it part way
+    signalThreadShouldExit();
+    notify();
+    waitForThreadToExit(-1);
+    return !writeFailed.load();
+}
+
+SessionRecorder::Stats SessionRecorder::getStats() const
+{
+    Stats stats;
+    stats.file = currentFile;
+    stats.framesRecorded = framesRecorded.load();
+    stats.framesDropped = framesDropped.load();
+    stats.bytesWritten = bytesWritten.load();
+    stats.seconds = static_cast<double>(lastRecordTimeUs.load()) / 1.0e6;
+    return stats;
+}
+
+//==============================================================================
+void SessionRecorder::recordFrame(const SpectrumMessages::SpectrumFrame& frame)
+{
+    if (!recording.load())
+        return;
+
+    recordFrame(frame, SpectrumMessages::getMonotonicTimeMicroseconds() - startMonotonicUs);
+}
+
+void SessionRecorder::recordFrame(const SpectrumMessages::SpectrumFrame& frame, juce::int64 timeUs)
+{
+    if (!recording.load())
+        return;
+
+    auto it = trackSlots.find(frame.trackId);
+    if (it == trackSlots.end())
+    {
+        // Track indices are 16 bit
+        if (trackSlots.size() >= 0xffff)
+        {
+            ++framesDropped;
+            return;
+        }
+
+        TrackSlot slot;
+        slot.index = static_cast<int>(trackSlots.size());
+        it = trackSlots.emplace(frame.trackId, slot).first;
+    }
+
+    // Announce new and renamed tracks before their frames
+    auto& slot = it->second;
+    if (!slot.announced || slot.name != frame.trackName || slot.sampleRate != frame.sampleRate)
+    {
+        slot.name = frame.trackName;
+        slot.sampleRate = frame.sampleRate;
+        slot.announced = pushTrackInfo(slot.index, frame.trackId, frame.trackName, frame.sampleRate, timeUs);
+
+        if (!slot.announced)
+        {
+            ++framesDropped;
+            return;
+        }
+    }
+
+    const int numBins = juce::jmin(static_cast<int>(frame.magnitudes.size()), SpectrumConstants::NUM_BINS);
+    const auto size = getFrameRecordSize(numBins);
+    jassert(static_cast<int>(size) <= frameScratchSize);
+
+    RecordHeader header {};
+    header.type = frameRecord;
+    header.trackIndex = static_cast<juce::uint16>(slot.index);
+    header.size = size;
+    header.timeUs = timeUs;
+
+    FramePayload payload {};
+    payload.sequence = frame.header.sequence;
+    payload.flags = (frame.hasHeader ? frameHasHeader : 0) | (frame.layout == BinLayout::Log ? frameLogBins : 0);
+    payload.captureTimeUs = frame.hasHeader ? frame.header.captureTimeUs : 0;
+    payload.hostSamplePosition = frame.hasHeader ? frame.header.hostSamplePosition : -1;
+    payload.sampleRate = static_cast<float>(frame.sampleRate);
+    payload.numBins = static_cast<juce::uint32>(numBins);
+
+    char* dest = frameScratch.getData();
+    std::memcpy(dest, &header, sizeof(header));
+    std::memcpy(dest + sizeof(header), &payload, sizeof(payload));
+
+    // Frames that arrived as dB codes are stored as sent; others are quantised here
+    auto* bins = reinterpret_cast<juce::uint16*>(dest + sizeof(header) + sizeof(payload));
+    if (frame.codes.size() == frame.magnitudes.size())
+        std::memcpy(bins, frame.codes.data(), sizeof(juce::uint16) * static_cast<size_t>(numBins));
+    else
+        SpectrumCodes::fromMagnitudes(frame.magnitudes.data(), bins, numBins);
+
+    const size_t usedBytes = sizeof(header) + sizeof(payload) + sizeof(juce::uint16) * static_cast<size_t>(numBins);
+    std::memset(dest + usedBytes, 0, size - usedBytes);
+
+    if (!pushRecord(dest, static_cast<int>(size)))
+        ++framesDropped;
+}
+
+bool SessionRecorder::pushTrackInfo(int trackIndex, const juce::String& trackId, const juce::String& trackName,
+                                    double sampleRate, juce::int64 timeUs)
+{
+    char record[sizeof(RecordHeader) + sizeof(TrackInfoPayload) + 2 * maxNameBytes + 4] {};
+
+    const auto idBytes = juce::jmin(static_cast<int>(trackId.getNumBytesAsUTF8()), maxNameBytes);
+    const auto nameBytes = juce::jmin(static_cast<int>(trackName.getNumBytesAsUTF8()), maxNameBytes);
+
+    RecordHeader header {};
+    header.type = trackInfoRecord;
+    header.trackIndex = static_cast<juce::uint16>(trackIndex);
+    header.size = padToRecordAlignment(sizeof(RecordHeader) + sizeof(TrackInfoPayload)
+                                       + static_cast<size_t>(idBytes + nameBytes));
+    header.timeUs = timeUs;
+
+    TrackInfoPayload payload {};
+    payload.sampleRate = sampleRate;
+    payload.idBytes = static_cast<juce::uint32>(idBytes);
+    payload.nameBytes = static_cast<juce::uint32>(nameBytes);
+
+    char* dest = record;
+    std::memcpy(dest, &header, sizeof(header));
+    dest += sizeof(header);
+    std::memcpy(dest, &payload, sizeof(payload));
+    dest += sizeof(payload);
+    std::memcpy(dest, trackId.toRawUTF8(), static_cast<size_t>(idBytes));
+    dest += idBytes;
+    std::memcpy(dest, trackName.toRawUTF8(), static_cast<size_t>(nameBytes));
+
+    return pushRecord(record, static_cast<int>(header.size));
+}
+
+bool SessionRecorder::pushRecord(const void* data, int numBytes)
+{
+    // Live ingest never waits for the writer: a full ring drops the record
+    while (fifo.getFreeSpace() < numBytes)
+    {
+        if (!waitForWriter || !isThreadRunning())
+            return false;
+
+        notify();
+        juce::Thread::sleep(1);
+    }
+
+    int start1, size1, start2, size2;
+    fifo.prepareToWrite(numBytes, start1, size1, start2, size2);
+
+    const auto* source = static_cast<const char*>(data);
+    std::memcpy(ringBuffer + start1, source, static_cast<size_t>(size1));
+    if (size2 > 0)
+        std::memcpy(ringBuffer + start2, source + size1, static_cast<size_t>(size2));
+
+    // Records are published whole, so the writer never sees half of one
+    fifo.finishedWrite(size1 + size2);
+    return true;
+}
+
+//==============================================================================
+void SessionRecorder::run()
+{
+    for (;;)
+    {
+        // Checked before draining, so everything pushed before stop() gets written
+        const bool exiting = threadShouldExit();
+
+        bool wroteAny = false;
+        while (popRecord())
+            wroteAny = true;
+
+        if (exiting)
+            break;
+
+        // Keep the file close to current in case the app dies mid-session
+        if (chunkDirty && juce::Time::getMillisecondCounter() - lastChunkFlushMs >= partialChunkFlushMs)
+            writeChunk();
+
+        if (!wroteAny)
+            wait(writerIdleWaitMs);
+    }
+
+    writeTrailer();
+}
+
+bool SessionRecorder::popRecord()
+{
+    if (fifo.getNumReady() < static_cast<int>(sizeof(RecordHeader)))
+        return false;
+
+    auto readBytes = [this](char* dest, int numBytes, bool consume)
+    {
+        int start1, size1, start2, size2;
+        fifo.prepareToRead(numBytes, start1, size1, start2, size2);
+        std::memcpy(dest, ringBuffer + start1, static_cast<size_t>(size1));
+        if (size2 > 0)
+            std::memcpy(dest + size1, ringBuffer + start2, static_cast<size_t>(size2));
+
+        if (consume)
+            fifo.finishedRead(size1 + size2);
+    };
+
+    RecordHeader header;
+    readBytes(reinterpret_cast<char*>(&header), static_cast<int>(sizeof(header)), false);
+
+    if (header.size < sizeof(RecordHeader) || header.size > static_cast<juce::uint32>(maxRecordSize)
+        || fifo.getNumReady() < static_cast<int>(header.size))
+    {
+        // Only the ingest thread writes, and only whole records, so this means a bug
+        jassertfalse;
+        fifo.reset();
+        return false;
+    }
+
+    readBytes(recordScratch.getData(), static_cast<int>(header.size), true);
+    appendRecord(recordScratch.getData(), header.size);
+    return true;
+}
+
+void SessionRecorder::appendRecord(const char* record, juce::uint32 size)
+{
+    RecordHeader header;
+    std::memcpy(&header, record, sizeof(header));
+
+    if (chunkUsed + static_cast<int>(size) > chunkSize)
+    {
+        writeChunk();
+        ++chunkIndex;
+        startNewChunk();
+    }
+
+    const juce::int64 fileOffset = fileHeaderSize + static_cast<juce::int64>(chunkIndex) * chunkSize + chunkUsed;
+
+    // Every index slot up to this record's time starts here
+    while (static_cast<juce::int64>(timeIndex.size()) * indexSlotUs <= header.timeUs)
+        timeIndex.push_back({ fileOffset });
+
+    std::memcpy(chunk + chunkUsed, record, size);
+    chunkUsed += static_cast<int>(size);
+
+    if (chunkRecords == 0)
+        chunkFirstTimeUs = header.timeUs;
+    chunkLastTimeUs = header.timeUs;
+    ++chunkRecords;
+    chunkDirty = true;
+
+    if (header.type == trackInfoRecord)
+    {
+        if (trackTable.size() <= header.trackIndex)
+            trackTable.resize(static_cast<size_t>(header.trackIndex) + 1);
+        trackTable[header.trackIndex] = juce::MemoryBlock(record, size);
+    }
+    else
+    {
+        ++framesRecorded;
+    }
+
+    lastRecordTimeUs = header.timeUs;
+}
+
+void SessionRecorder::startNewChunk()
+{
+    std::memset(chunk, 0, static_cast<size_t>(chunkSize));
+    chunkUsed = chunkHeaderSize;
+    chunkRecords = 0;
+    chunkFirstTimeUs = 0;
+    chunkLastTimeUs = 0;
+    chunkDirty = false;
+}
+
+void SessionRecorder::writeChunk()
+{
+    ChunkHeader header {};
+    header.magic = chunkMagic;
+    header.chunkIndex = chunkIndex;
+    header.firstTimeUs = chunkFirstTimeUs;
+    header.lastTimeUs = chunkLastTimeUs;
+    header.numRecords = chunkRecords;
+    header.usedBytes = static_cast<juce::uint32>(chunkUsed);
+    std::memcpy(chunk, &header, sizeof(header));
+
+    // Always the whole chunk, so chunk n is at a fixed offset; a partly filled
+    // chunk is rewritten in place as it fills up
+    const juce::int64 offset = fileHeaderSize + static_cast<juce::int64>(chunkIndex) * chunkSize;
+    if (stream->setPosition(offset) && stream->write(chunk, static_cast<size_t>(chunkSize)))
+    {
+        stream->flush();
+        bytesWritten = offset + chunkSize;
+    }
+    else
+    {
+        writeFailed = true;
+    }
+
+    chunkDirty = false;
+    lastChunkFlushMs = juce::Time::getMillisecondCounter();
+}
+
+void SessionRecorder::writeTrailer()
+{
+    if (stream == nullptr)
+        return;
+
+    if (chunkRecords > 0)
+        writeChunk();
+
+    const juce::uint32 numChunks = chunkRecords > 0 ? chunkIndex + 1 : chunkIndex;
+    const juce::int64 trailerOffset = fileHeaderSize + static_cast<juce::int64>(numChunks) * chunkSize;
+
+    Footer footer {};
+    footer.magic = footerMagic;
+    footer.indexSlotUs = indexSlotUs;
+
+    bool written = stream->setPosition(trailerOffset);
+    if (written)
+    {
+        footer.trackTableOffset = trailerOffset;
+        for (const auto& trackInfo : trackTable)
+        {
+            if (trackInfo.getSize() > 0)
+            {
+                written = stream->write(trackInfo.getData(), trackInfo.getSize()) && written;
+                ++footer.numTracks;
+            }
+        }
+
+        footer.indexOffset = stream->getPosition();
+        footer.numIndexEntries = static_cast<juce::uint32>(timeIndex.size());
+        if (!timeIndex.empty())
+            written = stream->write(timeIndex.data(), timeIndex.size() * sizeof(IndexEntry)) && written;
+
+        written = stream->write(&footer, sizeof(footer)) && written;
+        stream->flush();
+        written = written && stream->getStatus().wasOk();
+        bytesWritten = stream->getPosition();
+    }
+
+    if (!written)
+        writeFailed = true;
+
+    stream.reset();
+}
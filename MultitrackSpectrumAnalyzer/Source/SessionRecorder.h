@@ -0,0 +1,120 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumMessages.h"
+#include "SessionFormat.h"
+
+/// Records every spectrum frame the analyzer receives to a .wxcsession file
+/// (see SessionFormat).
+///
+/// recordFrame() runs on the ingest (message) thread and never touches the
+/// disk: it serialises the frame into a preallocated lock-free ring buffer and
+/// returns. A background thread drains the ring into chunks and writes them
+/// out. If the writer falls behind far enough to fill the ring, frames are
+/// dropped and counted rather than blocking ingest. Offline writers (see
+/// OfflineAnalysis) start with waitWhenFull instead, and are throttled to the
+/// disk's pace rather than losing frames.
+class SessionRecorder : private juce::Thread
+{
+public:
+    SessionRecorder();
+    ~SessionRecorder() override;
+
+    /// Starts recording to a new file (replacing any existing one). False if it can't be created.
+    /// With waitWhenFull, recordFrame() waits for the writer instead of dropping frames.
+    bool start(const juce::File& file, bool waitWhenFull = false);
+
+    /// Writes out everything still buffered, the track table and the time index, then closes the file.
+    /// Waits for the writer however long the disk takes, since a writer cut off mid-trailer leaves a
+    /// file that only opens by recovery. False if any of the session failed to be written.
+    bool stop();
+
+    bool isRecording() const { return recording.load(); }
+
+    /// Ingest thread only. Stamps the frame with the time since start().
+    void recordFrame(const SpectrumMessages::SpectrumFrame& frame);
+
+    /// Same, with the session time given by the caller. Times must not go backwards.
+    void recordFrame(const SpectrumMessages::SpectrumFrame& frame, juce::int64 timeUs);
+
+    struct Stats
+    {
+        juce::File file;
+        juce::int64 framesRecorded { 0 };
+        juce::int64 framesDropped { 0 };  // Ring buffer full
+        juce::int64 bytesWritten { 0 };
+        double seconds { 0.0 };
+    };
+
+    Stats getStats() const;
+
+    /// Where the Record button saves sessions.
+    static juce::File getDefaultSessionDirectory();
+
+    static constexpr const char* fileExtension = ".wxcsession";
+
+private:
+    void run() override;
+
+    // Ingest side
+    bool pushRecord(const void* data, int numBytes);
+    bool pushTrackInfo(int trackIndex, const juce::String& trackId, const juce::String& trackName,
+                       double sampleRate, juce::int64 timeUs);
+
+    // Writer side
+    bool popRecord();
+    void appendRecord(const char* record, juce::uint32 size);
+    void writeChunk();
+    void startNewChunk();
+    void writeTrailer();
+
+    struct TrackSlot
+    {
+        int index { 0 };
+        juce::String name;
+        double sampleRate { 0.0 };
+        bool announced { false };  // TrackInfo record made it into the ring
+    };
+
+    std::atomic<bool> recording { false };
+    bool waitForWriter { false };
+    juce::File currentFile;
+    juce::int64 startMonotonicUs { 0 };
+
+    // Ring buffer between the ingest and writer threads
+    juce::AbstractFifo fifo { ringBufferSize };
+    juce::HeapBlock<char> ringBuffer;
+
+    // Ingest thread state
+    std::map<juce::String, TrackSlot> trackSlots;
+    juce::HeapBlock<char> frameScratch;
+    int frameScratchSize { 0 };
+
+    // Writer thread state
+    std::unique_ptr<juce::FileOutputStream> stream;
+    juce::HeapBlock<char> chunk;
+    int chunkUsed { 0 };
+    juce::uint32 chunkIndex { 0 };
+    juce::uint32 chunkRecords { 0 };
+    juce::int64 chunkFirstTimeUs { 0 };
+    juce::int64 chunkLastTimeUs { 0 };
+    bool chunkDirty { false };
+    juce::uint32 lastChunkFlushMs { 0 };
+    std::vector<SessionFormat::IndexEntry> timeIndex;
+    std::vector<juce::MemoryBlock> trackTable;  // Latest TrackInfo record per track index
+    juce::HeapBlock<char> recordScratch;
+
+    std::atomic<juce::int64> framesRecorded { 0 };
+    std::atomic<juce::int64> framesDropped { 0 };
+    std::atomic<juce::int64> bytesWritten { 0 };
+    std::atomic<juce::int64> lastRecordTimeUs { 0 };
+    std::atomic<bool> writeFailed { false };
+
+    static constexpr int ringBufferSize = 16 * 1024 * 1024;
+    static constexpr int maxRecordSize = 64 * 1024;
+    static constexpr int maxNameBytes = 1024;
+    static constexpr int writerIdleWaitMs = 20;
+    static constexpr juce::uint32 partialChunkFlushMs = 1000;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SessionRecorder)
+};
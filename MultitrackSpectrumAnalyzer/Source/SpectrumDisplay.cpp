@@ -1,21 +1,27 @@
 #include "SpectrumDisplay.h"
 #include "../../Common/SpectrumData.h"
+#include "PerfCounters.h"
+#include <algorithm>
 #include <cmath>
 
 SpectrumDisplay::SpectrumDisplay(TrackManager& tm)
     : trackManager(tm)
 {
-    startTimerHz(60);
+    // Force a full snapshot on the first refresh
+    cachedLayoutVersion = trackManager.getLayoutVersion() - 1;
 }
 
 SpectrumDisplay::~SpectrumDisplay()
 {
-    stopTimer();
 }
 
 void SpectrumDisplay::setDisplayMode(DisplayMode mode)
 {
     displayMode = mode;
+
+    if (displayMode == DisplayMode::Summed)
+        updateSummedCache();
+
     repaint();
 }
 
@@ -25,15 +31,84 @@ void SpectrumDisplay::setDbScaling(DbScaling scaling)
     repaint();
 }
 
+void SpectrumDisplay::setShowSumLayers(bool shouldShow)
+{
+    showSumLayers = shouldShow;
+    updateSummedCache();
+    repaint();
+}
+
+void SpectrumDisplay::setShowLongTerm(bool shouldShow)
+{
+    showLongTerm = shouldShow;
+
+    if (showLongTerm)
+        updateStatisticsCache();
+    else
+        cachedStatistics.clear();
+
+    repaint();
+}
+
+void SpectrumDisplay::setFrozenSlot(juce::int64 slot)
+{
+    if (slot == frozenSlot)
+        return;
+
+    const bool wasFrozen = isFrozen();
+    frozenSlot = juce::jmax<juce::int64>(-1, slot);
+
+    // Live curves weren't kept up to date while frozen
+    if (wasFrozen && !isFrozen())
+    {
+        trackManager.updateEnabledSnapshot(cachedTracks, cachedLayoutVersion);
+        updatePyramids();
+        updateSummedCache();
+    }
+
+    repaint();
+}
+
+void SpectrumDisplay::setViewRange(float newMinFrequency, float newMaxFrequency, float newMinDb, float newMaxDb)
+{
+    // Keep the requested span, then slide it back inside the limits
+    float ratio = juce::jlimit(minFrequencyRatio, defaultMaxFrequency / defaultMinFrequency,
+                               newMaxFrequency / juce::jmax(1.0f, newMinFrequency));
+    newMinFrequency = juce::jlimit(defaultMinFrequency, defaultMaxFrequency / ratio, newMinFrequency);
+    newMaxFrequency = newMinFrequency * ratio;
+
+    float dbSpan = juce::jlimit(minDbSpan, highestDb - lowestDb, newMaxDb - newMinDb);
+    newMinDb = juce::jlimit(lowestDb, highestDb - dbSpan, newMinDb);
+    newMaxDb = newMinDb + dbSpan;
+
+    if (newMinFrequency == minFrequency && newMaxFrequency == maxFrequency
+        && newMinDb == minDb && newMaxDb == maxDb)
+        return;
+
+    minFrequency = newMinFrequency;
+    maxFrequency = newMaxFrequency;
+    minDb = newMinDb;
+    maxDb = newMaxDb;
+
+    // Bin -> pixel tables depend on the frequency view
+    curvePointCache.clear();
+    repaint();
+}
+
+void SpectrumDisplay::resetView()
+{
+    setViewRange(defaultMinFrequency, defaultMaxFrequency, defaultMinDb, defaultMaxDb);
+}
+
 void SpectrumDisplay::paint(juce::Graphics& g)
 {
+    const juce::int64 paintStartUs = Perf::getTimeMicroseconds();
+    paintPrepareUs = 0;
+    paintStrokeUs = 0;
+
     g.fillAll(juce::Colour(0xff1a1a1a));
 
-    auto bounds = getLocalBounds().toFloat();
-    auto plotArea = bounds.withTrimmedLeft(static_cast<float>(leftMargin))
-                          .withTrimmedBottom(static_cast<float>(bottomMargin))
-                          .withTrimmedTop(static_cast<float>(topMargin))
-                          .withTrimmedRight(static_cast<float>(rightMargin));
+    auto plotArea = getPlotArea();
 
     // Draw grid and axes
     drawAmplitudeAxis(g, plotArea);
@@ -43,14 +118,37 @@ void SpectrumDisplay::paint(juce::Graphics& g)
     g.setColour(juce::Colour(0xff404040));
     g.drawRect(plotArea, 1.0f);
 
+    const juce::int64 backgroundEndUs = Perf::getTimeMicroseconds();
+
+    // Curves run past the plot edges when zoomed in
+    juce::Graphics::ScopedSaveState clipState(g);
+    g.reduceClipRegion(plotArea.toNearestInt());
+
+    // Long-term curves sit underneath everything live
+    if (showLongTerm)
+        drawLongTerm(g, plotArea);
+
     // Draw spectrums for enabled tracks
-    if (displayMode == DisplayMode::Overlay)
+    if (isFrozen())
+    {
+        drawHistory(g, plotArea);
+    }
+    else if (displayMode == DisplayMode::Overlay)
     {
         // Overlay mode: draw each track independently from bottom
-        for (const auto& track : cachedTracks)
+        const bool drawEnvelopes = static_cast<int>(cachedTracks.size()) <= maxTracksWithEnvelope;
+
+        for (size_t i = 0; i < cachedTracks.size() && i < trackPyramids.size(); ++i)
         {
-            if (track.enabled)
-                drawSpectrum(g, track, plotArea, nullptr);
+            const auto& track = cachedTracks[i];
+            if (!track.enabled)
+                continue;
+
+            if (drawEnvelopes)
+                drawEnvelope(g, trackPyramids[i].pyramid, track.layout, track.sampleRate,
+                             track.colour.withAlpha(0.15f), plotArea);
+
+            drawSpectrum(g, trackPyramids[i].pyramid, track.layout, track.sampleRate, track.colour, plotArea);
         }
     }
     else if (displayMode == DisplayMode::Stacked)
@@ -58,67 +156,245 @@ void SpectrumDisplay::paint(juce::Graphics& g)
         // Stacked mode: accumulate spectrums
         std::array<float, SpectrumConstants::NUM_BINS> accumulatedSpectrum;
         accumulatedSpectrum.fill(0.0f);
+        BinLayout accumulatedLayout = BinLayout::Linear;
 
         for (const auto& track : cachedTracks)
         {
             if (track.enabled)
             {
-                // Draw this track starting from accumulated baseline
-                drawSpectrum(g, track, plotArea, &accumulatedSpectrum);
-
-                // Add this track's spectrum to the accumulator
-                for (size_t i = 0; i < SpectrumConstants::NUM_BINS; ++i)
+                // Bins of the two layouts don't line up, so a change of layout starts a new stack
+                if (track.layout != accumulatedLayout)
                 {
-                    accumulatedSpectrum[i] += track.smoothedSpectrum[i];
+                    accumulatedSpectrum.fill(0.0f);
+                    accumulatedLayout = track.layout;
                 }
+
+                // Add this track's spectrum to the accumulator, then draw the new top
+                juce::FloatVectorOperations::add(accumulatedSpectrum.data(), track.smoothedSpectrum.data(),
+                                                 SpectrumConstants::NUM_BINS);
+
+                auto buildStartUs = Perf::getTimeMicroseconds();
+                scratchPyramid.build(accumulatedSpectrum.data());
+                paintPrepareUs += Perf::getTimeMicroseconds() - buildStartUs;
+
+                drawSpectrum(g, scratchPyramid, track.layout, track.sampleRate, track.colour, plotArea);
             }
         }
     }
+    else if (displayMode == DisplayMode::Summed)
+    {
+        // Summed mode: per-track layers (optional) underneath the single summed curve
+        if (showSumLayers)
+        {
+            for (size_t i = 0; i < cachedLayerPower.size() && i < cachedTracks.size(); ++i)
+                drawBandCurve(g, cachedLayerPower[i], cachedTracks[i].colour.withAlpha(0.3f), plotArea, true);
+        }
+
+        drawBandCurve(g, cachedSummedPower, juce::Colour(0xffe0e0e0), plotArea, false);
+    }
+
+    // A frozen view presents old frames, which would skew the latency figures
+    if (!isFrozen())
+        trackManager.recordPresented(cachedTracks);
+
+    Perf::record(Perf::Timer::paintBackground, backgroundEndUs - paintStartUs);
+    Perf::record(Perf::Timer::paintPrepare, paintPrepareUs);
+    Perf::record(Perf::Timer::paintStroke, paintStrokeUs);
+    Perf::record(Perf::Timer::paintTotal, Perf::getTimeMicroseconds() - paintStartUs);
+    Perf::add(Perf::Counter::paints);
 }
 
 void SpectrumDisplay::resized()
 {
+    curvePointCache.clear();
 }
 
-void SpectrumDisplay::timerCallback()
+void SpectrumDisplay::mouseDown(const juce::MouseEvent& event)
 {
-    cachedTracks = trackManager.getEnabledTracks();
-    repaint();
+    juce::ignoreUnused(event);
+
+    dragStartMinFrequency = minFrequency;
+    dragStartMaxFrequency = maxFrequency;
+    dragStartMinDb = minDb;
+    dragStartMaxDb = maxDb;
 }
 
-float SpectrumDisplay::binToX(int bin, float width, double sampleRate) const
+void SpectrumDisplay::mouseDrag(const juce::MouseEvent& event)
 {
-    // Calculate frequency for this bin
-    float frequency = static_cast<float>(bin) * static_cast<float>(sampleRate) / static_cast<float>(SpectrumConstants::FFT_SIZE);
-    return frequencyToX(frequency, width);
+    auto plotArea = getPlotArea();
+    if (plotArea.isEmpty())
+        return;
+
+    // Pan frequency on the log scale and dB linearly, relative to where the drag started
+    float dx = static_cast<float>(event.getDistanceFromDragStartX());
+    float dy = static_cast<float>(event.getDistanceFromDragStartY());
+
+    float logShift = -dx / plotArea.getWidth() * std::log(dragStartMaxFrequency / dragStartMinFrequency);
+    float frequencyFactor = std::exp(logShift);
+    float dbShift = dy / plotArea.getHeight() * (dragStartMaxDb - dragStartMinDb);
+
+    setViewRange(dragStartMinFrequency * frequencyFactor, dragStartMaxFrequency * frequencyFactor,
+                 dragStartMinDb + dbShift, dragStartMaxDb + dbShift);
 }
 
-float SpectrumDisplay::frequencyToX(float frequency, float width) const
+void SpectrumDisplay::mouseDoubleClick(const juce::MouseEvent& event)
+{
+    juce::ignoreUnused(event);
+    resetView();
+}
+
+void SpectrumDisplay::mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel)
 {
-    // Clamp frequency to display range
-    frequency = juce::jlimit(minFrequency, maxFrequency, frequency);
+    auto plotArea = getPlotArea();
+    if (plotArea.isEmpty())
+        return;
+
+    float delta = wheel.isReversed ? -wheel.deltaY : wheel.deltaY;
+    float zoom = std::pow(2.0f, -delta * 4.0f);  // < 1 zooms in
 
-    // Logarithmic scale mapping
-    float logMin = std::log10(minFrequency);
-    float logMax = std::log10(maxFrequency);
-    float logFreq = std::log10(frequency);
+    auto position = event.position;
 
-    return width * (logFreq - logMin) / (logMax - logMin);
+    if (event.mods.isShiftDown() || position.x < plotArea.getX())
+    {
+        // dB zoom around the cursor (shift, or wheel over the dB axis)
+        float fraction = juce::jlimit(0.0f, 1.0f, (plotArea.getBottom() - position.y) / plotArea.getHeight());
+        if (dbScaling == DbScaling::Compressed)
+            fraction = std::sqrt(fraction);
+
+        float anchorDb = minDb + fraction * (maxDb - minDb);
+        float newSpan = (maxDb - minDb) * zoom;
+        setViewRange(minFrequency, maxFrequency, anchorDb - fraction * newSpan, anchorDb - fraction * newSpan + newSpan);
+    }
+    else
+    {
+        // Frequency zoom around the cursor
+        float x = juce::jlimit(0.0f, plotArea.getWidth(), position.x - plotArea.getX());
+        float fraction = x / plotArea.getWidth();
+        float anchorFrequency = xToFrequency(x, plotArea.getWidth());
+
+        float newLogSpan = std::log(maxFrequency / minFrequency) * zoom;
+        float newMinFrequency = anchorFrequency / std::exp(fraction * newLogSpan);
+        setViewRange(newMinFrequency, newMinFrequency * std::exp(newLogSpan), minDb, maxDb);
+    }
 }
 
-float SpectrumDisplay::magnitudeToY(float magnitude, float height) const
+void SpectrumDisplay::refresh()
 {
-    // Convert to dB
-    float db;
-    if (magnitude <= 0.0f)
-        db = minDb;
-    else
-        db = 20.0f * std::log10(magnitude);
+    Perf::ScopedTimer snapshotTimer(Perf::Timer::snapshotUpdate);
+
+    // Statistics move slowly, so don't pull them every frame
+    if (showLongTerm && juce::Time::getMillisecondCounter() - lastStatisticsUpdateTime >= statisticsUpdateIntervalMs)
+    {
+        updateStatisticsCache();
+        repaint();
+    }
+
+    // Frozen: only the set of tracks (and their colours) can change what's drawn
+    if (isFrozen())
+    {
+        if (trackManager.getLayoutVersion() != cachedLayoutVersion)
+        {
+            trackManager.updateEnabledSnapshot(cachedTracks, cachedLayoutVersion);
+            repaint();
+        }
+
+        return;
+    }
+
+    if (trackManager.updateEnabledSnapshot(cachedTracks, cachedLayoutVersion))
+    {
+        updatePyramids();
+
+        if (displayMode == DisplayMode::Summed)
+            updateSummedCache();
+
+        repaint();
+    }
+}
+
+void SpectrumDisplay::updatePyramids()
+{
+    trackPyramids.resize(cachedTracks.size());
+
+    // Once per new frame, and only for tracks whose data changed
+    for (size_t i = 0; i < cachedTracks.size(); ++i)
+    {
+        const auto& track = cachedTracks[i];
+        auto& trackPyramid = trackPyramids[i];
+
+        if (trackPyramid.trackId != track.trackId || trackPyramid.version != track.version)
+        {
+            trackPyramid.pyramid.build(track.smoothedSpectrum.data());
+            trackPyramid.trackId = track.trackId;
+            trackPyramid.version = track.version;
+        }
+    }
+}
+
+void SpectrumDisplay::updateStatisticsCache()
+{
+    lastStatisticsUpdateTime = juce::Time::getMillisecondCounter();
+
+    // Summaries are kept per track id so their buffers are reused between updates
+    for (auto it = cachedStatistics.begin(); it != cachedStatistics.end();)
+    {
+        bool stillShown = std::any_of(cachedTracks.begin(), cachedTracks.end(),
+                                      [&it](const TrackData& track) { return track.enabled && track.trackId == it->first; });
+        it = stillShown ? std::next(it) : cachedStatistics.erase(it);
+    }
+
+    for (const auto& track : cachedTracks)
+    {
+        if (track.enabled && !trackManager.getTrackStatistics(track.trackId, cachedStatistics[track.trackId]))
+            cachedStatistics.erase(track.trackId);
+    }
+}
+
+void SpectrumDisplay::updateSummedCache()
+{
+    trackManager.getSummedPower(cachedSummedPower);
+
+    if (!showSumLayers)
+    {
+        cachedLayerPower.clear();
+        return;
+    }
+
+    cachedLayerPower.resize(cachedTracks.size());
+    for (size_t i = 0; i < cachedTracks.size(); ++i)
+    {
+        if (!trackManager.getTrackSummedPower(cachedTracks[i].trackId, cachedLayerPower[i]))
+            cachedLayerPower[i].clear();
+    }
+}
+
+juce::Rectangle<float> SpectrumDisplay::getPlotArea() const
+{
+    return getLocalBounds().toFloat()
+                           .withTrimmedLeft(static_cast<float>(leftMargin))
+                           .withTrimmedBottom(static_cast<float>(bottomMargin))
+                           .withTrimmedTop(static_cast<float>(topMargin))
+                           .withTrimmedRight(static_cast<float>(rightMargin));
+}
 
+float SpectrumDisplay::frequencyToX(float frequency, float width) const
+{
+    // Logarithmic scale mapping (not clamped: points outside the view are clipped)
+    frequency = juce::jmax(1.0f, frequency);
+    return width * std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+}
+
+float SpectrumDisplay::xToFrequency(float x, float width) const
+{
+    return minFrequency * std::pow(maxFrequency / minFrequency, x / width);
+}
+
+float SpectrumDisplay::dbToY(float db, float height) const
+{
     // Clamp to display range
     db = juce::jlimit(minDb, maxDb, db);
 
-    // Normalize dB to 0-1 range (1.0 = loud/0dB, 0.0 = quiet/-90dB)
+    // Normalize dB to 0-1 range (1.0 = top of view, 0.0 = bottom of view)
     float normalized = (db - minDb) / (maxDb - minDb);
 
     // Apply scaling based on mode
@@ -126,143 +402,346 @@ float SpectrumDisplay::magnitudeToY(float magnitude, float height) const
     {
         // Apply compression to lower volumes (power curve)
         // This makes low volumes take up less vertical space (compressed toward bottom)
-        normalized = std::pow(normalized, 2.0f);  // Square for compression
+        normalized = normalized * normalized;  // Square for compression
     }
 
-    // Map to y-coordinate (0 dB at top, minDb at bottom)
+    // Map to y-coordinate (maxDb at top, minDb at bottom)
     return height * (1.0f - normalized);
 }
 
-void SpectrumDisplay::drawSpectrum(juce::Graphics& g, const TrackData& track, juce::Rectangle<float> area, const std::array<float, SpectrumConstants::NUM_BINS>* baselineSpectrum)
+float SpectrumDisplay::magnitudeToY(float magnitude, float height) const
 {
-    float plotWidth = area.getWidth();
-    float plotHeight = area.getHeight();
+    float db = magnitude > 0.0f ? 20.0f * std::log10(magnitude) : minDb;
+    return dbToY(db, height);
+}
 
-    // Build array of point data with peak-holding for densely packed bins
-    struct SpectrumPoint
+const std::vector<SpectrumDisplay::CurvePoint>& SpectrumDisplay::getCurvePoints(BinLayout layout, double sampleRate,
+                                                                                float width)
+{
+    if (width != curvePointsWidth)
     {
-        float x;
-        float y;
-        float magnitude;
-    };
+        curvePointCache.clear();
+        curvePointsWidth = width;
+    }
+
+    const auto key = std::make_pair(layout, sampleRate);
+    auto it = curvePointCache.find(key);
+    if (it != curvePointCache.end())
+        return it->second;
 
-    std::vector<SpectrumPoint> points;
-    points.reserve(SpectrumConstants::NUM_BINS);
+    std::vector<CurvePoint> points;
 
-    // Collect all visible bins
-    for (int bin = 0; bin < SpectrumConstants::NUM_BINS; ++bin)
+    if (sampleRate > 0.0 && width > 0.0f)
     {
-        float frequency = static_cast<float>(bin) * static_cast<float>(track.sampleRate) / static_cast<float>(SpectrumConstants::FFT_SIZE);
+        auto toBin = [layout, sampleRate](double frequency) { return frequencyToBin(layout, sampleRate, frequency); };
+        auto toFrequency = [layout, sampleRate](double bin) { return static_cast<float>(getBinFrequency(layout, sampleRate, bin)); };
 
-        // Skip bins outside display range
-        if (frequency < minFrequency || frequency > maxFrequency)
-            continue;
+        // Visible bins plus one either side, so the curve runs off the plot edges (linear bin 0 is DC)
+        int firstBin = juce::jmax(layout == BinLayout::Linear ? 1 : 0, static_cast<int>(std::floor(toBin(minFrequency))));
+        int lastBin = juce::jmin(SpectrumConstants::NUM_BINS - 1, static_cast<int>(std::ceil(toBin(maxFrequency))));
 
-        // Calculate magnitude: baseline + this track's contribution
-        float magnitude = track.smoothedSpectrum[static_cast<size_t>(bin)];
-        if (baselineSpectrum != nullptr)
+        int bin = firstBin;
+        while (bin <= lastBin)
         {
-            magnitude += (*baselineSpectrum)[static_cast<size_t>(bin)];
+            // Group every bin within minPixelSpacing of this one into a single peak-hold point;
+            // when zoomed in this is one point per bin
+            float x = frequencyToX(toFrequency(bin), width);
+            double groupEndFrequency = xToFrequency(x + minPixelSpacing, width);
+            int endBin = juce::jlimit(bin + 1, lastBin + 1, static_cast<int>(std::ceil(toBin(groupEndFrequency))));
+
+            float centreX = frequencyToX(toFrequency(0.5 * (bin + endBin - 1)), width);
+            points.push_back({ centreX, bin, endBin });
+
+            bin = endBin;
         }
+    }
+
+    return curvePointCache.emplace(key, std::move(points)).first->second;
+}
 
-        float x = area.getX() + binToX(bin, plotWidth, track.sampleRate);
-        float y = area.getY() + magnitudeToY(magnitude, plotHeight);
+void SpectrumDisplay::drawSpectrum(juce::Graphics& g, const SpectrumPyramid& pyramid, BinLayout layout,
+                                   double sampleRate, juce::Colour colour, juce::Rectangle<float> area)
+{
+    const juce::int64 prepareStartUs = Perf::getTimeMicroseconds();
+
+    const auto& curvePoints = getCurvePoints(layout, sampleRate, area.getWidth());
+    if (curvePoints.size() < 2)
+        return;
 
-        points.push_back({x, y, magnitude});
+    // Peak-hold each point from the pyramid: O(log bins) per point, whatever the zoom
+    pointScratch.clear();
+    for (const auto& point : curvePoints)
+    {
+        float y = dbToY(pyramid.getMaxDb(point.startBin, point.endBin), area.getHeight());
+        pointScratch.push_back({ area.getX() + point.x, area.getY() + y });
     }
 
-    if (points.empty())
+    // Draw smooth curve using quadratic interpolation for smoother appearance
+    juce::Path spectrumPath;
+    spectrumPath.startNewSubPath(pointScratch[0]);
+
+    if (pointScratch.size() == 2)
+    {
+        // Just draw a line
+        spectrumPath.lineTo(pointScratch[1]);
+    }
+    else
+    {
+        // Use quadratic curves for smooth interpolation
+        for (size_t i = 1; i < pointScratch.size() - 1; ++i)
+        {
+            // Control point is the current point
+            // End point is halfway to the next point
+            auto end = (pointScratch[i] + pointScratch[i + 1]) * 0.5f;
+            spectrumPath.quadraticTo(pointScratch[i], end);
+        }
+
+        // Draw final segment to last point
+        spectrumPath.quadraticTo(pointScratch.back(), pointScratch.back());
+    }
+
+    const juce::int64 strokeStartUs = Perf::getTimeMicroseconds();
+
+    g.setColour(colour);
+    g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+
+    paintPrepareUs += strokeStartUs - prepareStartUs;
+    paintStrokeUs += Perf::getTimeMicroseconds() - strokeStartUs;
+}
+
+void SpectrumDisplay::drawEnvelope(juce::Graphics& g, const SpectrumPyramid& pyramid, BinLayout layout,
+                                   double sampleRate, juce::Colour colour, juce::Rectangle<float> area)
+{
+    const juce::int64 prepareStartUs = Perf::getTimeMicroseconds();
+
+    const auto& curvePoints = getCurvePoints(layout, sampleRate, area.getWidth());
+    if (curvePoints.size() < 2)
         return;
 
-    // Apply peak-hold: merge points that are very close in x-space, keeping the peak
-    std::vector<SpectrumPoint> mergedPoints;
-    mergedPoints.reserve(points.size());
+    // Along the maxima, then back along the minima; only differs where a point spans several bins
+    juce::Path envelope;
+    for (size_t i = 0; i < curvePoints.size(); ++i)
+    {
+        const auto& point = curvePoints[i];
+        float x = area.getX() + point.x;
+        float y = area.getY() + dbToY(pyramid.getMaxDb(point.startBin, point.endBin), area.getHeight());
+
+        if (i == 0)
+            envelope.startNewSubPath(x, y);
+        else
+            envelope.lineTo(x, y);
+    }
+
+    for (auto it = curvePoints.rbegin(); it != curvePoints.rend(); ++it)
+    {
+        float x = area.getX() + it->x;
+        float y = area.getY() + dbToY(pyramid.getMinDb(it->startBin, it->endBin), area.getHeight());
+        envelope.lineTo(x, y);
+    }
+
+    envelope.closeSubPath();
 
-    constexpr float minPixelSpacing = 2.0f; // Minimum pixels between points
+    const juce::int64 strokeStartUs = Perf::getTimeMicroseconds();
 
-    mergedPoints.push_back(points[0]);
+    g.setColour(colour);
+    g.fillPath(envelope);
+
+    paintPrepareUs += strokeStartUs - prepareStartUs;
+    paintStrokeUs += Perf::getTimeMicroseconds() - strokeStartUs;
+}
+
+void SpectrumDisplay::drawBandCurve(juce::Graphics& g, const std::vector<float>& bandPower, juce::Colour colour,
+                                    juce::Rectangle<float> area, bool filled)
+{
+    const juce::int64 prepareStartUs = Perf::getTimeMicroseconds();
 
-    for (size_t i = 1; i < points.size(); ++i)
+    const auto& grid = trackManager.getSummedGrid();
+    const int numBands = juce::jmin(grid.getNumBands(), static_cast<int>(bandPower.size()));
+    if (numBands < 2)
+        return;
+
+    // Bands are already log-spaced at about one point per few pixels, so straight
+    // segments between band centres are smooth enough
+    juce::Path path;
+    for (int band = 0; band < numBands; ++band)
     {
-        float dx = points[i].x - mergedPoints.back().x;
+        float x = area.getX() + frequencyToX(grid.getBandCentre(band), area.getWidth());
+        float y = area.getY() + magnitudeToY(std::sqrt(bandPower[static_cast<size_t>(band)]), area.getHeight());
 
-        if (dx < minPixelSpacing)
-        {
-            // Points are close together - keep the peak (higher magnitude = lower y)
-            if (points[i].magnitude > mergedPoints.back().magnitude)
-            {
-                mergedPoints.back() = points[i];
-            }
-        }
+        if (band == 0)
+            path.startNewSubPath(x, y);
         else
-        {
-            mergedPoints.push_back(points[i]);
-        }
+            path.lineTo(x, y);
     }
 
-    // Draw smooth curve using quadratic interpolation for smoother appearance
-    juce::Path spectrumPath;
+    if (filled)
+    {
+        path.lineTo(area.getX() + frequencyToX(grid.getBandCentre(numBands - 1), area.getWidth()), area.getBottom());
+        path.lineTo(area.getX() + frequencyToX(grid.getBandCentre(0), area.getWidth()), area.getBottom());
+        path.closeSubPath();
+    }
+
+    const juce::int64 strokeStartUs = Perf::getTimeMicroseconds();
 
-    if (mergedPoints.size() > 0)
+    g.setColour(colour);
+
+    if (filled)
+        g.fillPath(path);
+    else
+        g.strokePath(path, juce::PathStrokeType(1.5f));
+
+    paintPrepareUs += strokeStartUs - prepareStartUs;
+    paintStrokeUs += Perf::getTimeMicroseconds() - strokeStartUs;
+}
+
+void SpectrumDisplay::drawHistory(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const auto& history = trackManager.getHistory();
+    const auto numBands = static_cast<size_t>(history.getNumBands());
+
+    historyPower.resize(numBands);
+    historySum.assign(numBands, 0.0f);
+
+    // Rows are decoded in place from the arena; nothing is copied out of the history
+    for (const auto& track : cachedTracks)
     {
-        spectrumPath.startNewSubPath(mergedPoints[0].x, mergedPoints[0].y);
+        if (!track.enabled)
+            continue;
 
-        if (mergedPoints.size() == 1)
+        const auto* row = history.getRow(history.getLane(track.trackId), frozenSlot);
+        if (row == nullptr)
+            continue;
+
+        history.decodePower(row, historyPower.data());
+
+        if (displayMode == DisplayMode::Overlay)
         {
-            // Just one point, nothing to draw
+            drawBandCurve(g, historyPower, track.colour, area, false);
+            continue;
         }
-        else if (mergedPoints.size() == 2)
+
+        juce::FloatVectorOperations::add(historySum.data(), historyPower.data(), static_cast<int>(numBands));
+
+        if (displayMode == DisplayMode::Stacked)
+            drawBandCurve(g, historySum, track.colour, area, false);
+        else if (showSumLayers)
+            drawBandCurve(g, historyPower, track.colour.withAlpha(0.3f), area, true);
+    }
+
+    if (displayMode == DisplayMode::Summed)
+        drawBandCurve(g, historySum, juce::Colour(0xffe0e0e0), area, false);
+}
+
+void SpectrumDisplay::drawLongTerm(juce::Graphics& g, juce::Rectangle<float> area)
+{
+    const juce::int64 prepareStartUs = Perf::getTimeMicroseconds();
+    juce::int64 strokeUs = 0;
+
+    const auto& grid = trackManager.getHistory().getGrid();
+    const int numBands = grid.getNumBands();
+
+    auto addCurve = [&](juce::Path& path, const std::vector<float>& db, bool reversed, bool startNew)
+    {
+        for (int i = 0; i < numBands; ++i)
         {
-            // Just draw a line
-            spectrumPath.lineTo(mergedPoints[1].x, mergedPoints[1].y);
+            int band = reversed ? numBands - 1 - i : i;
+            float x = area.getX() + frequencyToX(grid.getBandCentre(band), area.getWidth());
+            float y = area.getY() + dbToY(db[static_cast<size_t>(band)], area.getHeight());
+
+            if (i == 0 && startNew)
+                path.startNewSubPath(x, y);
+            else
+                path.lineTo(x, y);
         }
-        else
-        {
-            // Use quadratic curves for smooth interpolation
-            for (size_t i = 1; i < mergedPoints.size() - 1; ++i)
-            {
-                // Control point is the current point
-                // End point is halfway to the next point
-                float endX = (mergedPoints[i].x + mergedPoints[i + 1].x) * 0.5f;
-                float endY = (mergedPoints[i].y + mergedPoints[i + 1].y) * 0.5f;
+    };
 
-                spectrumPath.quadraticTo(mergedPoints[i].x, mergedPoints[i].y, endX, endY);
-            }
+    const float dashes[] = { 4.0f, 3.0f };
 
-            // Draw final segment to last point
-            size_t lastIdx = mergedPoints.size() - 1;
-            spectrumPath.quadraticTo(mergedPoints[lastIdx].x, mergedPoints[lastIdx].y,
-                                     mergedPoints[lastIdx].x, mergedPoints[lastIdx].y);
-        }
+    for (const auto& track : cachedTracks)
+    {
+        auto it = cachedStatistics.find(track.trackId);
+        if (!track.enabled || it == cachedStatistics.end()
+            || static_cast<int>(it->second.averageDb.size()) < numBands)
+            continue;
+
+        const auto& summary = it->second;
 
-        g.setColour(track.colour);
-        g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+        // 10-90th percentile range as a band, median dashed, average solid
+        juce::Path range;
+        addCurve(range, summary.p90Db, false, true);
+        addCurve(range, summary.p10Db, true, false);
+        range.closeSubPath();
+
+        juce::Path median;
+        addCurve(median, summary.p50Db, false, true);
+        juce::Path dashedMedian;
+        juce::PathStrokeType(1.0f).createDashedStroke(dashedMedian, median, dashes, 2);
+
+        juce::Path average;
+        addCurve(average, summary.averageDb, false, true);
+
+        const juce::int64 strokeStartUs = Perf::getTimeMicroseconds();
+
+        g.setColour(track.colour.withAlpha(0.12f));
+        g.fillPath(range);
+        g.setColour(track.colour.withAlpha(0.5f));
+        g.fillPath(dashedMedian);
+        g.setColour(track.colour.withAlpha(0.8f));
+        g.strokePath(average, juce::PathStrokeType(1.0f));
+
+        strokeUs += Perf::getTimeMicroseconds() - strokeStartUs;
     }
+
+    paintPrepareUs += Perf::getTimeMicroseconds() - prepareStartUs - strokeUs;
+    paintStrokeUs += strokeUs;
 }
 
 void SpectrumDisplay::drawFrequencyAxis(juce::Graphics& g, juce::Rectangle<float> area)
 {
-    g.setColour(juce::Colour(0xff606060));
     g.setFont(juce::FontOptions(11.0f));
 
-    // Frequency labels to display
-    const float frequencies[] = { 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000 };
-    const char* labels[] = { "20", "50", "100", "200", "500", "1k", "2k", "5k", "10k", "20k" };
+    // 1-2-5 steps per decade, or every integer multiple when zoomed into less than a decade
+    static const float coarseSteps[] = { 1, 2, 5 };
+    static const float fineSteps[] = { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+
+    const bool useFineSteps = std::log10(maxFrequency / minFrequency) < 1.0f;
+    const float* steps = useFineSteps ? fineSteps : coarseSteps;
+    const int numSteps = useFineSteps ? 9 : 3;
 
-    for (int i = 0; i < 10; ++i)
+    int firstDecade = static_cast<int>(std::floor(std::log10(minFrequency)));
+    int lastDecade = static_cast<int>(std::ceil(std::log10(maxFrequency)));
+    float lastLabelX = -1000.0f;
+
+    for (int decade = firstDecade; decade <= lastDecade; ++decade)
     {
-        float x = area.getX() + frequencyToX(frequencies[i], area.getWidth());
+        float decadeBase = std::pow(10.0f, static_cast<float>(decade));
 
-        // Draw grid line
-        g.setColour(juce::Colour(0xff303030));
-        g.drawVerticalLine(static_cast<int>(x), area.getY(), area.getBottom());
+        for (int i = 0; i < numSteps; ++i)
+        {
+            float frequency = steps[i] * decadeBase;
+            if (frequency < minFrequency || frequency > maxFrequency)
+                continue;
 
-        // Draw label
-        g.setColour(juce::Colour(0xff808080));
-        g.drawText(labels[i],
-                   static_cast<int>(x) - 20, static_cast<int>(area.getBottom()) + 4,
-                   40, 16,
-                   juce::Justification::centredTop);
+            float x = area.getX() + frequencyToX(frequency, area.getWidth());
+
+            // Draw grid line
+            g.setColour(juce::Colour(0xff303030));
+            g.drawVerticalLine(static_cast<int>(x), area.getY(), area.getBottom());
+
+            // Draw label (skip if it would collide with the previous one)
+            if (x - lastLabelX < 30.0f)
+                continue;
+
+            juce::String label = frequency >= 1000.0f ? juce::String(juce::roundToInt(frequency / 1000.0f)) + "k"
+                                                      : juce::String(juce::roundToInt(frequency));
+
+            g.setColour(juce::Colour(0xff808080));
+            g.drawText(label,
+                       static_cast<int>(x) - 20, static_cast<int>(area.getBottom()) + 4,
+                       40, 16,
+                       juce::Justification::centredTop);
+            lastLabelX = x;
+        }
     }
 }
 
@@ -270,12 +749,21 @@ void SpectrumDisplay::drawAmplitudeAxis(juce::Graphics& g, juce::Rectangle<float
 {
     g.setFont(juce::FontOptions(11.0f));
 
-    // dB levels to display
-    const float dbLevels[] = { 0, -12, -24, -36, -48, -60, -72, -84 };
+    // Pick the finest step that gives at most 10 lines (12 dB for the default view)
+    static const float steps[] = { 1, 2, 3, 6, 12, 24 };
+    float step = 24.0f;
+    for (float candidate : steps)
+    {
+        if ((maxDb - minDb) / candidate <= 10.0f)
+        {
+            step = candidate;
+            break;
+        }
+    }
 
-    for (float db : dbLevels)
+    for (float db = std::ceil(minDb / step) * step; db <= maxDb; db += step)
     {
-        float y = area.getY() + magnitudeToY(std::pow(10.0f, db / 20.0f), area.getHeight());
+        float y = area.getY() + dbToY(db, area.getHeight());
 
         // Draw grid line
         g.setColour(juce::Colour(0xff303030));
@@ -283,7 +771,7 @@ void SpectrumDisplay::drawAmplitudeAxis(juce::Graphics& g, juce::Rectangle<float
 
         // Draw label
         g.setColour(juce::Colour(0xff808080));
-        juce::String label = juce::String(static_cast<int>(db));
+        juce::String label = juce::String(juce::roundToInt(db));
         g.drawText(label,
                    2, static_cast<int>(y) - 8,
                    leftMargin - 6, 16,
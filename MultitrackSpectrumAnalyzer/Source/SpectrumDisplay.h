@@ -2,11 +2,13 @@
 
 #include <JuceHeader.h>
 #include "TrackManager.h"
+#include "SpectrumPyramid.h"
 
 enum class DisplayMode
 {
     Overlay,    // All tracks start from bottom (default)
-    Stacked     // Stack tracks on top of each other (cumulative)
+    Stacked,    // Stack tracks on top of each other (cumulative)
+    Summed      // Power sum of all tracks on a common frequency grid
 };
 
 enum class DbScaling
@@ -15,8 +17,13 @@ enum class DbScaling
     Compressed  // Compressed scale for low volumes
 };
 
-class SpectrumDisplay : public juce::Component,
-                        private juce::Timer
+/// Main spectrum view.
+///
+/// Supports zooming (mouse wheel) and panning (drag) on both axes; double-click
+/// resets the view. Each track's spectrum is reduced to a min/max pyramid once
+/// per new frame, and bin -> pixel tables are cached until the view changes,
+/// so painting costs O(pixels) per track at any zoom level.
+class SpectrumDisplay : public juce::Component
 {
 public:
     SpectrumDisplay(TrackManager& trackManager);
@@ -25,23 +32,96 @@ public:
     void paint(juce::Graphics& g) override;
     void resized() override;
 
+    void mouseDown(const juce::MouseEvent& event) override;
+    void mouseDrag(const juce::MouseEvent& event) override;
+    void mouseDoubleClick(const juce::MouseEvent& event) override;
+    void mouseWheelMove(const juce::MouseEvent& event, const juce::MouseWheelDetails& wheel) override;
+
     void setDisplayMode(DisplayMode mode);
     void setDbScaling(DbScaling scaling);
 
-private:
-    void timerCallback() override;
+    /// In Summed mode, also fill each track's contribution underneath the sum.
+    void setShowSumLayers(bool shouldShow);
+
+    /// Sets the visible frequency and dB ranges (clamped to the allowed limits).
+    void setViewRange(float newMinFrequency, float newMaxFrequency, float newMinDb, float newMaxDb);
+
+    /// Returns to the full 20Hz-20kHz, -90..0 dB view.
+    void resetView();
+
+    /// Draws each track's long-term average spectrum and its 10-90th percentile
+    /// range (median dashed) underneath the live curves (see SpectrumStatistics).
+    void setShowLongTerm(bool shouldShow);
 
-    /// Convert frequency bin index to x-coordinate (logarithmic scale).
-    float binToX(int bin, float width, double sampleRate) const;
+    /// Shows every track as it was at a slot of the TrackManager's history instead
+    /// of the live spectra (see SpectrumHistory). -1 goes back to live.
+    void setFrozenSlot(juce::int64 slot);
+    bool isFrozen() const { return frozenSlot >= 0; }
 
-    /// Convert frequency to x-coordinate (logarithmic scale).
+    /// Pulls changed tracks from the TrackManager and repaints if needed.
+    /// Called by the FrameScheduler when new data is available.
+    void refresh();
+
+private:
+    /// One point of a drawn curve: an x position and the bins it reduces.
+    struct CurvePoint
+    {
+        float x;       // Relative to the plot area
+        int startBin;
+        int endBin;    // Exclusive
+    };
+
+    /// A track's pyramid, tagged with the track version it was built from.
+    struct TrackPyramid
+    {
+        juce::String trackId;
+        juce::uint32 version { 0 };
+        SpectrumPyramid pyramid;
+    };
+
+    juce::Rectangle<float> getPlotArea() const;
+
+    /// Convert frequency to x-coordinate (logarithmic scale, current view).
     float frequencyToX(float frequency, float width) const;
 
+    /// Convert x-coordinate back to frequency (current view).
+    float xToFrequency(float x, float width) const;
+
+    /// Convert dB to y-coordinate (current view and scaling).
+    float dbToY(float db, float height) const;
+
     /// Convert normalized magnitude (0-1) to y-coordinate (dB scale).
     float magnitudeToY(float magnitude, float height) const;
 
-    /// Draw single track's spectrum curve.
-    void drawSpectrum(juce::Graphics& g, const TrackData& track, juce::Rectangle<float> area, const std::array<float, SpectrumConstants::NUM_BINS>* baselineSpectrum = nullptr);
+    /// Curve points for a bin layout and sample rate at the current view; rebuilt only when the view changes.
+    const std::vector<CurvePoint>& getCurvePoints(BinLayout layout, double sampleRate, float width);
+
+    /// Rebuild pyramids for tracks whose data changed since the last frame.
+    void updatePyramids();
+
+    /// Draw a spectrum curve from its pyramid (peak-hold per point).
+    void drawSpectrum(juce::Graphics& g, const SpectrumPyramid& pyramid, BinLayout layout, double sampleRate,
+                      juce::Colour colour, juce::Rectangle<float> area);
+
+    /// Draw the min/max envelope of a spectrum where points cover several bins.
+    void drawEnvelope(juce::Graphics& g, const SpectrumPyramid& pyramid, BinLayout layout, double sampleRate,
+                      juce::Colour colour, juce::Rectangle<float> area);
+
+    /// Draw a curve of per-band power on the TrackManager's summed grid.
+    void drawBandCurve(juce::Graphics& g, const std::vector<float>& bandPower, juce::Colour colour,
+                       juce::Rectangle<float> area, bool filled);
+
+    /// Draw the frozen slot's rows straight from the history, in the current display mode.
+    void drawHistory(juce::Graphics& g, juce::Rectangle<float> area);
+
+    /// Pull the long-term statistics of the enabled tracks from the TrackManager.
+    void updateStatisticsCache();
+
+    /// Draw the long-term average and percentile range of each enabled track.
+    void drawLongTerm(juce::Graphics& g, juce::Rectangle<float> area);
+
+    /// Pull the summed spectrum (and per-track layers if shown) from the TrackManager.
+    void updateSummedCache();
 
     /// Draw frequency axis labels and grid lines.
     void drawFrequencyAxis(juce::Graphics& g, juce::Rectangle<float> area);
@@ -51,15 +131,65 @@ private:
 
     TrackManager& trackManager;
     std::vector<TrackData> cachedTracks;
+    juce::uint32 cachedLayoutVersion { 0 };
+    std::vector<TrackPyramid> trackPyramids;  // Same order as cachedTracks
+    SpectrumPyramid scratchPyramid;           // Stacked mode layers
+    std::vector<juce::Point<float>> pointScratch;
+
+    // Paint time split, accumulated over one paint() (see PerfCounters)
+    juce::int64 paintPrepareUs { 0 };
+    juce::int64 paintStrokeUs { 0 };
 
     DisplayMode displayMode { DisplayMode::Overlay };
     DbScaling dbScaling { DbScaling::Linear };
-
-    // Display range
-    static constexpr float minFrequency = 20.0f;
-    static constexpr float maxFrequency = 20000.0f;
-    static constexpr float minDb = -90.0f;
-    static constexpr float maxDb = 0.0f;
+    bool showSumLayers { false };
+
+    // Summed mode data (power per band of the TrackManager's summed grid)
+    std::vector<float> cachedSummedPower;
+    std::vector<std::vector<float>> cachedLayerPower;  // Same order as cachedTracks
+
+    // Long-term statistics per track, refreshed at most every statisticsUpdateIntervalMs
+    bool showLongTerm { false };
+    std::map<juce::String, SpectrumStatistics::Summary> cachedStatistics;
+    juce::uint32 lastStatisticsUpdateTime { 0 };
+    static constexpr juce::uint32 statisticsUpdateIntervalMs = 500;
+
+    // Frozen view: history slot being shown (-1 = live), and decode buffers for its rows
+    juce::int64 frozenSlot { -1 };
+    std::vector<float> historyPower;
+    std::vector<float> historySum;
+
+    // Curve points per sample rate, valid for curvePointsWidth and the current view
+    std::map<std::pair<BinLayout, double>, std::vector<CurvePoint>> curvePointCache;
+    float curvePointsWidth { 0.0f };
+
+    // Current view
+    float minFrequency { defaultMinFrequency };
+    float maxFrequency { defaultMaxFrequency };
+    float minDb { defaultMinDb };
+    float maxDb { defaultMaxDb };
+
+    // State captured when a drag starts
+    float dragStartMinFrequency { 0.0f };
+    float dragStartMaxFrequency { 0.0f };
+    float dragStartMinDb { 0.0f };
+    float dragStartMaxDb { 0.0f };
+
+    // Default view and zoom limits
+    static constexpr float defaultMinFrequency = 20.0f;
+    static constexpr float defaultMaxFrequency = 20000.0f;
+    static constexpr float defaultMinDb = -90.0f;
+    static constexpr float defaultMaxDb = 0.0f;
+    static constexpr float lowestDb = -120.0f;
+    static constexpr float highestDb = 6.0f;
+    static constexpr float minFrequencyRatio = 1.25f;  // Narrowest view: about a third of an octave
+    static constexpr float minDbSpan = 6.0f;
+
+    // Envelopes stop being readable beyond a handful of overlaid tracks
+    static constexpr int maxTracksWithEnvelope = 8;
+
+    // Minimum pixels between curve points
+    static constexpr float minPixelSpacing = 2.0f;
 
     // Layout margins
     static constexpr int leftMargin = 45;
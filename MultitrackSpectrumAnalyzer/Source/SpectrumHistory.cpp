@@ -0,0 +1,143 @@
+#include "SpectrumHistory.h"
+#include <cmath>
+#include <cstring>
+
+SpectrumHistory::SpectrumHistory(size_t memoryBudgetBytes, double historySecondsToKeep, int slotsPerSecondToUse)
+    : slotsPerSecond(juce::jmax(1, slotsPerSecondToUse)),
+      slotsPerLane(juce::jmax(1, static_cast<int>(std::ceil(historySecondsToKeep * slotsPerSecond)))),
+      rowBytes(static_cast<size_t>(grid.getNumBands()))
+{
+    const size_t laneBytes = static_cast<size_t>(slotsPerLane) * rowBytes;
+    maxLanes = static_cast<int>(juce::jmax<size_t>(1, memoryBudgetBytes / laneBytes));
+    arenaBytes = static_cast<size_t>(maxLanes) * laneBytes;
+
+    // Left uninitialised: a lane's rows are written before they can be read, so
+    // pages the budget allows for but no track uses are never touched
+    arena.malloc(arenaBytes);
+    lanes.reserve(static_cast<size_t>(maxLanes));
+
+    bandPower.resize(rowBytes);
+    rowScratch.resize(rowBytes);
+
+    for (int code = 1; code < 256; ++code)
+        powerForCode[static_cast<size_t>(code)] = std::pow(10.0f, codeToDb(static_cast<juce::uint8>(code)) / 10.0f);
+}
+
+void SpectrumHistory::append(const juce::String& trackId, const float* magnitudes, double sampleRate, BinLayout layout,
+                             juce::int64 timeMs)
+{
+    if (sampleRate <= 0.0)
+        return;
+
+    // Magnitude -> power, onto the common grid, then to 8-bit dB
+    juce::FloatVectorOperations::multiply(binPower.data(), magnitudes, magnitudes, SpectrumConstants::NUM_BINS);
+    getBinMapping(sampleRate, layout).map(binPower.data(), bandPower.data());
+    encodeRow(rowScratch.data());
+
+    int laneIndex = getLane(trackId);
+    if (laneIndex < 0)
+    {
+        if (static_cast<int>(lanes.size()) >= maxLanes)
+            return;  // Over budget: this track goes without history
+
+        laneIndex = static_cast<int>(lanes.size());
+        Lane newLane;
+        newLane.rows = arena.get() + static_cast<size_t>(laneIndex) * static_cast<size_t>(slotsPerLane) * rowBytes;
+        lanes.push_back(newLane);
+        laneIds.emplace(trackId, laneIndex);
+    }
+
+    auto& lane = lanes[static_cast<size_t>(laneIndex)];
+    const juce::int64 slot = getSlotForTime(timeMs);
+
+    if (lane.newestSlot >= 0 && slot <= lane.newestSlot)
+    {
+        // Same slot (or the clock stepped back): peak-hold into the newest row
+        auto* row = getRowPointer(lane, lane.newestSlot);
+        for (size_t band = 0; band < rowBytes; ++band)
+            row[band] = juce::jmax(row[band], rowScratch[band]);
+        return;
+    }
+
+    if (lane.newestSlot >= 0)
+    {
+        // Fill the gap since the previous frame, but never more than one lap of the ring
+        const auto* previous = getRowPointer(lane, lane.newestSlot);
+        for (auto gapSlot = juce::jmax(lane.newestSlot + 1, slot - slotsPerLane + 1); gapSlot < slot; ++gapSlot)
+        {
+            if (gapSlot - lane.newestSlot <= maxHoldSlots)
+                std::memcpy(getRowPointer(lane, gapSlot), previous, rowBytes);
+            else
+                std::memset(getRowPointer(lane, gapSlot), 0, rowBytes);
+        }
+    }
+
+    std::memcpy(getRowPointer(lane, slot), rowScratch.data(), rowBytes);
+    lane.newestSlot = slot;
+    newestSlot = juce::jmax(newestSlot, slot);
+}
+
+int SpectrumHistory::getLane(const juce::String& trackId) const
+{
+    auto it = laneIds.find(trackId);
+    return it != laneIds.end() ? it->second : -1;
+}
+
+juce::int64 SpectrumHistory::getSlotForTime(juce::int64 timeMs) const
+{
+    return timeMs * slotsPerSecond / 1000;
+}
+
+juce::int64 SpectrumHistory::getTimeForSlot(juce::int64 slot) const
+{
+    return slot * 1000 / slotsPerSecond;
+}
+
+const juce::uint8* SpectrumHistory::getRow(int lane, juce::int64 slot) const
+{
+    if (lane < 0 || lane >= static_cast<int>(lanes.size()))
+        return nullptr;
+
+    const auto& l = lanes[static_cast<size_t>(lane)];
+    if (l.newestSlot < 0 || slot > l.newestSlot || slot <= l.newestSlot - slotsPerLane)
+        return nullptr;
+
+    return getRowPointer(l, slot);
+}
+
+void SpectrumHistory::decodePower(const juce::uint8* row, float* output) const
+{
+    for (size_t band = 0; band < rowBytes; ++band)
+        output[band] = powerForCode[row[band]];
+}
+
+juce::uint8* SpectrumHistory::getRowPointer(const Lane& lane, juce::int64 slot) const
+{
+    return lane.rows + static_cast<size_t>(slot % slotsPerLane) * rowBytes;
+}
+
+const LogFrequencyGrid::BinMapping& SpectrumHistory::getBinMapping(double sampleRate, BinLayout layout)
+{
+    const auto key = std::make_pair(layout, sampleRate);
+    auto it = binMappings.find(key);
+    if (it == binMappings.end())
+        it = binMappings.emplace(key, grid.createBinMapping(sampleRate, layout)).first;
+
+    return it->second;
+}
+
+void SpectrumHistory::encodeRow(juce::uint8* row) const
+{
+    for (size_t band = 0; band < rowBytes; ++band)
+    {
+        const float power = bandPower[band];
+        if (power <= 0.0f)
+        {
+            row[band] = 0;
+            continue;
+        }
+
+        const float steps = (10.0f * std::log10(power) - minDb) / dbPerStep;
+        row[band] = static_cast<juce::uint8>(juce::jlimit(0, 255, juce::roundToInt(steps)));
+    }
+}
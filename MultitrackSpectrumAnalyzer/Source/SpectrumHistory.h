@@ -0,0 +1,113 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumData.h"
+#include "../../Common/LogFrequencyGrid.h"
+#include <limits>
+
+/// The last few seconds of every track's spectrum, for freezing and scrubbing.
+///
+/// Rows are 8-bit dB on the common log grid (half a dB per step), written into
+/// fixed time slots so finding the row for a time is arithmetic rather than a
+/// search. All lanes live in one arena allocated up front from a memory budget;
+/// tracks beyond what the budget holds simply have no history. Nothing is
+/// allocated or moved after construction, so a row pointer stays valid until
+/// the ring wraps back over it (historySeconds later).
+///
+/// Not locked: appends come from TrackManager::updateTrack and reads from the
+/// displays, both on the message thread.
+class SpectrumHistory
+{
+public:
+    static constexpr size_t defaultMemoryBudget = 64 * 1024 * 1024;
+    static constexpr double defaultHistorySeconds = 30.0;
+    static constexpr int defaultSlotsPerSecond = 50;
+
+    // 8-bit row encoding: 0 = silence / no data, 255 = maxDb
+    static constexpr float dbPerStep = 0.5f;
+    static constexpr float maxDb = 0.0f;
+    static constexpr float minDb = maxDb - 255.0f * dbPerStep;
+
+    SpectrumHistory(size_t memoryBudgetBytes = defaultMemoryBudget,
+                    double historySecondsToKeep = defaultHistorySeconds,
+                    int slotsPerSecondToUse = defaultSlotsPerSecond);
+
+    const LogFrequencyGrid& getGrid() const { return grid; }
+    int getNumBands() const { return grid.getNumBands(); }
+    int getSlotsPerSecond() const { return slotsPerSecond; }
+    int getSlotsPerLane() const { return slotsPerLane; }
+    int getMaxLanes() const { return maxLanes; }
+    int getNumLanes() const { return static_cast<int>(laneIds.size()); }
+    size_t getArenaBytes() const { return arenaBytes; }
+
+    /// Adds a frame of NUM_BINS linear magnitudes in the given layout. Frames landing in the same slot
+    /// are peak-held; short gaps repeat the previous row, longer ones read as silence.
+    void append(const juce::String& trackId, const float* magnitudes, double sampleRate, BinLayout layout,
+                juce::int64 timeMs);
+
+    /// The frame last passed to append() (whichever track it was for, and even if
+    /// that track is over budget) as band power and as row codes, so other per-band
+    /// consumers don't map it onto the grid again. Valid until the next append().
+    const float* getLastBandPower() const { return bandPower.data(); }
+    const juce::uint8* getLastRow() const { return rowScratch.data(); }
+
+    /// Lane index of a track, or -1 if it has none (no frames yet, or over budget).
+    int getLane(const juce::String& trackId) const;
+
+    /// Slot that a wall-clock time (Time::currentTimeMillis) falls in.
+    juce::int64 getSlotForTime(juce::int64 timeMs) const;
+    juce::int64 getTimeForSlot(juce::int64 slot) const;
+
+    /// Newest slot written by any track (-1 before the first frame).
+    juce::int64 getNewestSlot() const { return newestSlot; }
+
+    /// Oldest slot that is still held for every lane.
+    juce::int64 getOldestSlot() const { return juce::jmax<juce::int64>(0, newestSlot - slotsPerLane + 1); }
+
+    /// Row of getNumBands() codes for a lane at a slot, pointing into the arena.
+    /// nullptr if the slot has been overwritten or not reached yet.
+    const juce::uint8* getRow(int lane, juce::int64 slot) const;
+
+    static float codeToDb(juce::uint8 code) { return code == 0 ? -std::numeric_limits<float>::infinity()
+                                                                : minDb + static_cast<float>(code) * dbPerStep; }
+
+    /// Decodes a row into band power (the unit TrackManager::getSummedPower uses).
+    void decodePower(const juce::uint8* row, float* bandPower) const;
+
+private:
+    struct Lane
+    {
+        juce::uint8* rows { nullptr };
+        juce::int64 newestSlot { -1 };
+    };
+
+    juce::uint8* getRowPointer(const Lane& lane, juce::int64 slot) const;
+    const LogFrequencyGrid::BinMapping& getBinMapping(double sampleRate, BinLayout layout);
+    void encodeRow(juce::uint8* row) const;
+
+    LogFrequencyGrid grid;
+    std::map<std::pair<BinLayout, double>, LogFrequencyGrid::BinMapping> binMappings;  // Keyed by layout and sample rate
+
+    int slotsPerSecond;
+    int slotsPerLane;
+    size_t rowBytes;
+    int maxLanes;
+    size_t arenaBytes;
+    juce::HeapBlock<juce::uint8> arena;
+
+    std::vector<Lane> lanes;
+    std::map<juce::String, int> laneIds;
+    juce::int64 newestSlot { -1 };
+
+    // Gaps up to this long (frame rates below the slot rate) repeat the last row
+    static constexpr int maxHoldSlots = 5;
+
+    std::array<float, 256> powerForCode {};
+
+    // Scratch buffers (avoid allocating per frame)
+    std::array<float, SpectrumConstants::NUM_BINS> binPower {};
+    std::vector<float> bandPower;
+    std::vector<juce::uint8> rowScratch;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumHistory)
+};
@@ -0,0 +1,100 @@
+#include "SpectrumPyramid.h"
+#include <cstring>
+
+namespace
+{
+    /// Fast 20*log10(x) for display. Splits the float into exponent and mantissa
+    /// and fits log2 of the mantissa with a quadratic (error < 0.05 dB).
+    inline float fastDecibels(float magnitude)
+    {
+        if (magnitude <= 1.0e-10f)
+            return SpectrumPyramid::floorDb;
+
+        juce::int32 bits;
+        std::memcpy(&bits, &magnitude, sizeof(bits));
+
+        const float exponent = static_cast<float>(((bits >> 23) & 255) - 128);
+        bits = (bits & ~(255 << 23)) | (127 << 23);
+
+        float mantissa;
+        std::memcpy(&mantissa, &bits, sizeof(mantissa));
+
+        const float log2Value = exponent + (-0.34484843f * mantissa + 2.02466578f) * mantissa - 0.67487759f;
+
+        constexpr float decibelsPerOctave = 6.0205999f;  // 20 * log10(2)
+        return log2Value * decibelsPerOctave;
+    }
+}
+
+void SpectrumPyramid::build(const float* magnitudes)
+{
+    // Level 0: one dB value per bin
+    for (int bin = 0; bin < numBins; ++bin)
+    {
+        float db = fastDecibels(magnitudes[bin]);
+        maxLevels[static_cast<size_t>(bin)] = db;
+        minLevels[static_cast<size_t>(bin)] = db;
+    }
+
+    // Each level above reduces pairs of the level below
+    size_t source = 0;
+    size_t dest = static_cast<size_t>(numBins);
+
+    for (int size = numBins / 2; size >= 1; size /= 2)
+    {
+        for (int i = 0; i < size; ++i)
+        {
+            size_t left = source + static_cast<size_t>(2 * i);
+            maxLevels[dest + static_cast<size_t>(i)] = juce::jmax(maxLevels[left], maxLevels[left + 1]);
+            minLevels[dest + static_cast<size_t>(i)] = juce::jmin(minLevels[left], minLevels[left + 1]);
+        }
+
+        source = dest;
+        dest += static_cast<size_t>(size);
+    }
+}
+
+float SpectrumPyramid::getMaxDb(int startBin, int endBin) const
+{
+    // Bottom-up walk: take unpaired edge nodes, then move up a level
+    float result = floorDb;
+    size_t offset = 0;
+    int size = numBins;
+
+    while (startBin < endBin)
+    {
+        if (startBin & 1)
+            result = juce::jmax(result, maxLevels[offset + static_cast<size_t>(startBin++)]);
+        if (endBin & 1)
+            result = juce::jmax(result, maxLevels[offset + static_cast<size_t>(--endBin)]);
+
+        startBin >>= 1;
+        endBin >>= 1;
+        offset += static_cast<size_t>(size);
+        size >>= 1;
+    }
+
+    return result;
+}
+
+float SpectrumPyramid::getMinDb(int startBin, int endBin) const
+{
+    float result = std::numeric_limits<float>::max();
+    size_t offset = 0;
+    int size = numBins;
+
+    while (startBin < endBin)
+    {
+        if (startBin & 1)
+            result = juce::jmin(result, minLevels[offset + static_cast<size_t>(startBin++)]);
+        if (endBin & 1)
+            result = juce::jmin(result, minLevels[offset + static_cast<size_t>(--endBin)]);
+
+        startBin >>= 1;
+        endBin >>= 1;
+        offset += static_cast<size_t>(size);
+        size >>= 1;
+    }
+
+    return result == std::numeric_limits<float>::max() ? floorDb : result;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumData.h"
+
+/// Multi-level min/max pyramid over one spectrum's bins, in dB.
+///
+/// Level 0 holds every bin, each level above halves the resolution. Any bin
+/// range can then be reduced to its min or max in O(log bins), so drawing at
+/// any zoom level costs O(pixels) rather than O(bins). dB conversion happens
+/// once in build(), not on every paint.
+class SpectrumPyramid
+{
+public:
+    static constexpr int numBins = SpectrumConstants::NUM_BINS;
+
+    /// Rebuilds all levels from linear magnitudes (normalized 0-1).
+    void build(const float* magnitudes);
+
+    /// Highest dB value over bins [startBin, endBin).
+    float getMaxDb(int startBin, int endBin) const;
+
+    /// Lowest dB value over bins [startBin, endBin).
+    float getMinDb(int startBin, int endBin) const;
+
+    /// Value used for silent bins (well below any display range).
+    static constexpr float floorDb = -200.0f;
+
+private:
+    static_assert((numBins & (numBins - 1)) == 0, "Pyramid needs a power-of-two bin count");
+
+    // Levels stored back to back: numBins + numBins/2 + ... + 1 < 2 * numBins
+    std::array<float, numBins * 2> maxLevels {};
+    std::array<float, numBins * 2> minLevels {};
+};
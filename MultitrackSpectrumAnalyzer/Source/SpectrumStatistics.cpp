@@ -0,0 +1,94 @@
+#include "SpectrumStatistics.h"
+#include <cmath>
+
+SpectrumStatistics::SpectrumStatistics(int numBandsToUse)
+    : numBands(numBandsToUse)
+{
+}
+
+void SpectrumStatistics::add(const juce::String& trackId, const float* bandPower, const juce::uint8* rowCodes)
+{
+    auto it = tracks.find(trackId);
+    if (it == tracks.end())
+    {
+        Track track;
+        track.powerSum.assign(static_cast<size_t>(numBands), 0.0);
+        track.levelCounts.assign(static_cast<size_t>(numBands) * numLevelBins, 0);
+        it = tracks.emplace(trackId, std::move(track)).first;
+    }
+
+    auto& track = it->second;
+    ++track.numFrames;
+
+    // Straight-line loops over contiguous arrays, left for the compiler to vectorise
+    double* powerSum = track.powerSum.data();
+    for (int band = 0; band < numBands; ++band)
+        powerSum[band] += static_cast<double>(bandPower[band]);
+
+    juce::uint32* counts = track.levelCounts.data();
+    for (int band = 0; band < numBands; ++band)
+        ++counts[band * numLevelBins + (rowCodes[band] >> 1)];
+}
+
+bool SpectrumStatistics::getSummary(const juce::String& trackId, Summary& summary) const
+{
+    auto it = tracks.find(trackId);
+    if (it == tracks.end() || it->second.numFrames == 0)
+        return false;
+
+    const auto& track = it->second;
+    const auto size = static_cast<size_t>(numBands);
+
+    summary.numFrames = track.numFrames;
+    summary.averageDb.resize(size);
+    summary.p10Db.resize(size);
+    summary.p50Db.resize(size);
+    summary.p90Db.resize(size);
+
+    for (size_t band = 0; band < size; ++band)
+    {
+        const double meanPower = track.powerSum[band] / static_cast<double>(track.numFrames);
+        summary.averageDb[band] = meanPower > 0.0
+                                    ? juce::jmax(SpectrumHistory::minDb, static_cast<float>(10.0 * std::log10(meanPower)))
+                                    : SpectrumHistory::minDb;
+
+        const auto* counts = track.levelCounts.data() + band * numLevelBins;
+        summary.p10Db[band] = getPercentileDb(counts, track.numFrames, 0.1);
+        summary.p50Db[band] = getPercentileDb(counts, track.numFrames, 0.5);
+        summary.p90Db[band] = getPercentileDb(counts, track.numFrames, 0.9);
+    }
+
+    return true;
+}
+
+void SpectrumStatistics::reset()
+{
+    tracks.clear();
+}
+
+float SpectrumStatistics::getPercentileDb(const juce::uint32* counts, juce::int64 numFrames, double fraction) const
+{
+    // Walk the cumulative counts to the bin holding the target rank, then
+    // interpolate within its 1 dB
+    const double target = fraction * static_cast<double>(numFrames);
+    constexpr float binDb = 2.0f * SpectrumHistory::dbPerStep;
+
+    double cumulative = 0.0;
+    for (int bin = 0; bin < numLevelBins; ++bin)
+    {
+        const auto count = static_cast<double>(counts[bin]);
+        if (count > 0.0 && cumulative + count >= target)
+        {
+            if (bin == 0)
+                return SpectrumHistory::minDb;
+
+            const float position = static_cast<float>((target - cumulative) / count);
+            const float binLowDb = SpectrumHistory::minDb + (static_cast<float>(bin) * 2.0f - 0.5f) * SpectrumHistory::dbPerStep;
+            return binLowDb + position * binDb;
+        }
+
+        cumulative += count;
+    }
+
+    return SpectrumHistory::maxDb;
+}
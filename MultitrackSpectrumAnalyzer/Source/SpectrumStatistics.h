@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SpectrumHistory.h"
+
+/// Long-term average spectrum and per-band level percentiles of each track.
+///
+/// Every frame adds its band power to a running sum and one count per band to
+/// a fixed 1 dB histogram, so memory per track is fixed and querying costs the
+/// same after a minute as after a whole album. Frames come in as the 8-bit rows
+/// SpectrumHistory already encodes (see SpectrumHistory::getLastRow), so
+/// nothing is mapped onto the grid twice.
+class SpectrumStatistics
+{
+public:
+    /// Histogram bins per band: one per two row codes (1 dB), bin 0 = silence.
+    static constexpr int numLevelBins = 128;
+
+    /// Per-band curves in dB, one entry per grid band.
+    struct Summary
+    {
+        juce::int64 numFrames { 0 };
+        std::vector<float> averageDb;  // Power average (long-term average spectrum); silence = SpectrumHistory::minDb
+        std::vector<float> p10Db;
+        std::vector<float> p50Db;
+        std::vector<float> p90Db;
+    };
+
+    explicit SpectrumStatistics(int numBandsToUse);
+
+    /// Adds one frame: band power and the matching SpectrumHistory row codes.
+    void add(const juce::String& trackId, const float* bandPower, const juce::uint8* rowCodes);
+
+    /// Fills summary for a track, O(bands). False if the track has no frames.
+    bool getSummary(const juce::String& trackId, Summary& summary) const;
+
+    /// Starts every track's accumulation again (e.g. for the next song).
+    void reset();
+
+private:
+    struct Track
+    {
+        juce::int64 numFrames { 0 };
+        std::vector<double> powerSum;          // Per band
+        std::vector<juce::uint32> levelCounts; // numBands * numLevelBins, band-major
+    };
+
+    float getPercentileDb(const juce::uint32* counts, juce::int64 numFrames, double fraction) const;
+
+    int numBands;
+    std::map<juce::String, Track> tracks;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumStatistics)
+};
@@ -0,0 +1,84 @@
+#include "SummedSpectrum.h"
+
+SummedSpectrum::SummedSpectrum()
+{
+    totalPower.assign(static_cast<size_t>(grid.getNumBands()), 0.0);
+    newContribution.assign(static_cast<size_t>(grid.getNumBands()), 0.0);
+}
+
+void SummedSpectrum::updateTrack(const juce::String& trackId, const float* magnitudes, double sampleRate, BinLayout layout)
+{
+    if (sampleRate <= 0.0)
+        return;
+
+    const int numBands = grid.getNumBands();
+
+    // Magnitude -> power, then onto the common grid
+    juce::FloatVectorOperations::multiply(binPower.data(), magnitudes, magnitudes, SpectrumConstants::NUM_BINS);
+    getBinMapping(sampleRate, layout).map(binPower.data(), newContribution.data());
+
+    auto it = contributions.find(trackId);
+    if (it == contributions.end())
+    {
+        juce::FloatVectorOperations::add(totalPower.data(), newContribution.data(), numBands);
+        contributions.emplace(trackId, newContribution);
+    }
+    else
+    {
+        // Swap out the old contribution: total += new - old
+        juce::FloatVectorOperations::subtract(totalPower.data(), it->second.data(), numBands);
+        juce::FloatVectorOperations::add(totalPower.data(), newContribution.data(), numBands);
+        std::swap(it->second, newContribution);
+    }
+
+    if (++updatesSinceResum >= resumInterval)
+        resum();
+}
+
+void SummedSpectrum::removeTrack(const juce::String& trackId)
+{
+    if (contributions.erase(trackId) > 0)
+        resum();
+}
+
+void SummedSpectrum::getTotalPower(std::vector<float>& output) const
+{
+    output.resize(totalPower.size());
+
+    // Clamp tiny negative residues left by subtraction
+    for (size_t i = 0; i < totalPower.size(); ++i)
+        output[i] = static_cast<float>(juce::jmax(0.0, totalPower[i]));
+}
+
+bool SummedSpectrum::getTrackPower(const juce::String& trackId, std::vector<float>& output) const
+{
+    auto it = contributions.find(trackId);
+    if (it == contributions.end())
+        return false;
+
+    output.resize(it->second.size());
+    for (size_t i = 0; i < it->second.size(); ++i)
+        output[i] = static_cast<float>(it->second[i]);
+
+    return true;
+}
+
+const LogFrequencyGrid::BinMapping& SummedSpectrum::getBinMapping(double sampleRate, BinLayout layout)
+{
+    const auto key = std::make_pair(layout, sampleRate);
+    auto it = binMappings.find(key);
+    if (it == binMappings.end())
+        it = binMappings.emplace(key, grid.createBinMapping(sampleRate, layout)).first;
+
+    return it->second;
+}
+
+void SummedSpectrum::resum()
+{
+    std::fill(totalPower.begin(), totalPower.end(), 0.0);
+
+    for (const auto& pair : contributions)
+        juce::FloatVectorOperations::add(totalPower.data(), pair.second.data(), grid.getNumBands());
+
+    updatesSinceResum = 0;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumData.h"
+#include "../../Common/LogFrequencyGrid.h"
+
+/// Incrementally maintained power sum of many tracks on the common log grid.
+///
+/// Each track's contribution is kept, so updating one track subtracts its old
+/// band powers and adds the new ones (O(bands)) instead of re-summing every
+/// track. Accumulation is in double precision and the total is rebuilt from
+/// scratch periodically and whenever a track leaves, so cancellation error
+/// can't build up over long sessions.
+class SummedSpectrum
+{
+public:
+    SummedSpectrum();
+
+    /// Replaces a track's contribution. magnitudes holds NUM_BINS linear magnitudes in the given layout.
+    void updateTrack(const juce::String& trackId, const float* magnitudes, double sampleRate, BinLayout layout);
+
+    /// Removes a track's contribution (no-op if it isn't part of the sum).
+    void removeTrack(const juce::String& trackId);
+
+    const LogFrequencyGrid& getGrid() const { return grid; }
+
+    /// Copies the summed power per band.
+    void getTotalPower(std::vector<float>& output) const;
+
+    /// Copies one track's power per band. Returns false if the track isn't summed.
+    bool getTrackPower(const juce::String& trackId, std::vector<float>& output) const;
+
+private:
+    const LogFrequencyGrid::BinMapping& getBinMapping(double sampleRate, BinLayout layout);
+    void resum();
+
+    LogFrequencyGrid grid;
+    std::map<std::pair<BinLayout, double>, LogFrequencyGrid::BinMapping> binMappings;  // Keyed by layout and sample rate
+
+    std::map<juce::String, std::vector<double>> contributions;  // Band power per track
+    std::vector<double> totalPower;
+
+    // Scratch buffers (avoid allocating per update)
+    std::array<float, SpectrumConstants::NUM_BINS> binPower {};
+    std::vector<double> newContribution;
+
+    int updatesSinceResum { 0 };
+    static constexpr int resumInterval = 1 << 16;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SummedSpectrum)
+};
@@ -6,13 +6,14 @@ class ColourChangeListener : public juce::ChangeListener
 public:
     ColourChangeListener(juce::Component::SafePointer<TrackItem> item,
                          juce::ColourSelector* selector)
-        : safeItem(item), colourSelector(selector)
+        : safeItem(item), colourSelector(selector), trackId(item->getTrackId())
     {
     }
 
     void changeListenerCallback(juce::ChangeBroadcaster*) override
     {
-        if (safeItem != nullptr && colourSelector != nullptr)
+        // Items are recycled by the track list, so make sure it still shows the same track
+        if (safeItem != nullptr && colourSelector != nullptr && safeItem->getTrackId() == trackId)
         {
             auto newColour = colourSelector->getCurrentColour();
             safeItem->setTrackColour(newColour);
@@ -24,6 +25,7 @@ public:
 private:
     juce::Component::SafePointer<TrackItem> safeItem;
     juce::ColourSelector* colourSelector;
+    juce::String trackId;
 };
 
 TrackItem::TrackItem(const juce::String& id,
@@ -72,9 +74,47 @@ void TrackItem::paint(juce::Graphics& g)
     auto textBounds = getLocalBounds()
         .withTrimmedLeft(24 + spacing)
         .withTrimmedRight(colourSwatchSize + spacing);
+
+    // Relay CPU column, right-aligned next to the swatch
+    if (loadText.isNotEmpty())
+    {
+        auto loadBounds = textBounds.removeFromRight(loadColumnWidth);
+        g.setColour(isOffline ? juce::Colours::grey : (isLoadHigh ? juce::Colours::orange : juce::Colour(0xff909090)));
+        g.setFont(juce::FontOptions(11.0f));
+        g.drawText(loadText, loadBounds, juce::Justification::centredRight);
+    }
+
     g.setColour(isOffline ? juce::Colours::grey : juce::Colours::lightgrey);
     g.setFont(juce::FontOptions(14.0f));
     g.drawText(trackName, textBounds, juce::Justification::centredLeft);
+
+    // Loudness bar along the bottom: momentary fill, short-term tick, true peak warning at the end
+    if (showsLoudness)
+    {
+        auto meterBounds = textBounds.removeFromBottom(meterHeight + 1).withTrimmedBottom(1).toFloat();
+        auto toX = [&meterBounds](float lufs) {
+            return meterBounds.getX() + meterBounds.getWidth() * juce::jlimit(0.0f, 1.0f, 1.0f - lufs / meterFloorLufs);
+        };
+
+        const bool truePeakWarning = maxTruePeakDb > truePeakWarningDb;
+        auto warningBounds = meterBounds.removeFromRight(static_cast<float>(meterHeight * 2));
+        meterBounds.removeFromRight(1.0f);
+
+        g.setColour(juce::Colours::black.withAlpha(0.4f));
+        g.fillRect(meterBounds);
+
+        g.setColour(trackColour.withAlpha(0.8f));
+        g.fillRect(meterBounds.withRight(toX(loudness.momentaryLufs)));
+
+        if (loudness.shortTermLufs > meterFloorLufs)
+        {
+            g.setColour(juce::Colours::white.withAlpha(0.8f));
+            g.fillRect(juce::Rectangle<float>(toX(loudness.shortTermLufs) - 1.0f, meterBounds.getY(), 2.0f, meterBounds.getHeight()));
+        }
+
+        g.setColour(truePeakWarning ? juce::Colours::red : juce::Colours::black.withAlpha(0.4f));
+        g.fillRect(warningBounds);
+    }
 }
 
 void TrackItem::mouseDown(const juce::MouseEvent& event)
@@ -137,6 +177,9 @@ void TrackItem::setToggleState(bool enabled)
 
 void TrackItem::setTrackColour(const juce::Colour& colour)
 {
+    if (colour == trackColour)
+        return;
+
     trackColour = colour;
     toggleButton.setColour(juce::ToggleButton::tickColourId, colour);
     repaint();
@@ -144,12 +187,79 @@ void TrackItem::setTrackColour(const juce::Colour& colour)
 
 void TrackItem::setTrackName(const juce::String& name)
 {
+    if (name == trackName)
+        return;
+
     trackName = name;
     repaint();
 }
 
 void TrackItem::setOfflineStatus(bool offline)
 {
+    if (offline == isOffline)
+        return;
+
     isOffline = offline;
     repaint();
 }
+
+void TrackItem::setProcessingLoad(bool hasLoad, const SpectrumMessages::ProcessingLoad& load)
+{
+    juce::String newText, newTooltip;
+    bool newIsHigh = false;
+
+    if (hasLoad)
+    {
+        newText = juce::String(load.load * 100.0f, load.load < 0.1f ? 2 : 1) + "%";
+        newIsHigh = load.peakLoad >= highPeakLoad;
+        newTooltip = "Relay CPU " + newText + " (worst block " + juce::String(juce::roundToInt(load.peakLoad * 100.0f)) + "%)\n"
+                   + "processBlock: mean " + juce::String(load.meanBlockUs, 1) + " us, max " + juce::String(load.maxBlockUs, 1) + " us\n"
+                   + "Analysis frame: mean " + juce::String(load.meanFftUs, 1) + " us";
+    }
+
+    if (newText == loadText && newIsHigh == isLoadHigh && newTooltip == loadTooltip)
+        return;
+
+    loadText = newText;
+    isLoadHigh = newIsHigh;
+    loadTooltip = newTooltip;
+    updateTooltip();
+    repaint();
+}
+
+void TrackItem::setLoudness(bool hasLoudness, const SpectrumMessages::LoudnessReading& reading, float maxTruePeak)
+{
+    const bool newShowsLoudness = hasLoudness && !isOffline;
+
+    if (newShowsLoudness == showsLoudness && maxTruePeak == maxTruePeakDb
+        && (!newShowsLoudness || (reading.momentaryLufs == loudness.momentaryLufs
+                                  && reading.shortTermLufs == loudness.shortTermLufs
+                                  && reading.rmsDb == loudness.rmsDb
+                                  && reading.truePeakDb == loudness.truePeakDb)))
+        return;
+
+    showsLoudness = newShowsLoudness;
+    loudness = reading;
+    maxTruePeakDb = maxTruePeak;
+
+    auto format = [](float db, const char* unit) {
+        return db > SpectrumMessages::LOUDNESS_FLOOR_DB ? juce::String(db, 1) + " " + unit : juce::String("-inf ") + unit;
+    };
+
+    loudnessTooltip.clear();
+    if (showsLoudness)
+        loudnessTooltip = "Momentary " + format(reading.momentaryLufs, "LUFS") + ", short-term " + format(reading.shortTermLufs, "LUFS") + "\n"
+                        + "RMS " + format(reading.rmsDb, "dBFS") + "\n"
+                        + "True peak " + format(reading.truePeakDb, "dBTP") + " (max " + format(maxTruePeak, "dBTP") + ")";
+
+    updateTooltip();
+    repaint();
+}
+
+void TrackItem::updateTooltip()
+{
+    if (loadTooltip.isEmpty() || loudnessTooltip.isEmpty())
+        setTooltip(loadTooltip + loudnessTooltip);
+    else
+        setTooltip(loadTooltip + "\n" + loudnessTooltip);
+}
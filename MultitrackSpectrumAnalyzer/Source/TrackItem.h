@@ -1,7 +1,9 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../../Common/SpectrumMessages.h"
 
-class TrackItem : public juce::Component
+class TrackItem : public juce::Component,
+                  public juce::SettableTooltipClient
 {
 public:
     TrackItem(const juce::String& trackId,
@@ -17,27 +19,48 @@ public:
     std::function<void(bool enabled)> onToggleChanged;
     std::function<void(juce::Colour colour)> onColourChanged;
 
-    // Setters
+    // Setters (no-ops if the value is unchanged, so rows can be refreshed cheaply)
+    void setTrackId(const juce::String& id) { trackId = id; }
     void setToggleState(bool enabled);
     void setTrackColour(const juce::Colour& colour);
     void setTrackName(const juce::String& name);
     void setOfflineStatus(bool isOffline);
 
+    /// The relay's CPU figures from its heartbeat (shown as a load column, details in the tooltip).
+    void setProcessingLoad(bool hasLoad, const SpectrumMessages::ProcessingLoad& load);
+
+    /// The relay's loudness meter (shown as a bar under the name, details in the tooltip).
+    /// maxTruePeakDb lights the clip warning until the statistics are reset.
+    void setLoudness(bool hasLoudness, const SpectrumMessages::LoudnessReading& loudness, float maxTruePeakDb);
+
     juce::String getTrackId() const { return trackId; }
 
 private:
     void showColourSelector();
+    void updateTooltip();
 
     juce::String trackId;
     juce::String trackName;
     juce::Colour trackColour;
     bool isEnabled { true };
     bool isOffline { false };
+    juce::String loadText;           // Empty if the relay doesn't report its load
+    bool isLoadHigh { false };
+    juce::String loadTooltip;
+    bool showsLoudness { false };    // False if the relay doesn't send loudness, or is offline
+    SpectrumMessages::LoudnessReading loudness;
+    float maxTruePeakDb { SpectrumMessages::LOUDNESS_FLOOR_DB };
+    juce::String loudnessTooltip;
 
     juce::ToggleButton toggleButton;
     juce::Rectangle<int> colourSwatchBounds;
 
     static constexpr int colourSwatchSize = 20;
+    static constexpr int loadColumnWidth = 40;
+    static constexpr float highPeakLoad = 0.5f;  // A block using half its budget is a dropout risk
+    static constexpr float meterFloorLufs = -60.0f;    // Left end of the loudness bar (right end is 0)
+    static constexpr float truePeakWarningDb = -1.0f;  // EBU R128 maximum true peak
+    static constexpr int meterHeight = 3;
     static constexpr int spacing = 4;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackItem)
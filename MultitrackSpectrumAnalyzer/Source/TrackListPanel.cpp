@@ -9,20 +9,24 @@ TrackListPanel::TrackListPanel(TrackManager& tm)
     titleLabel.setColour(juce::Label::textColourId, juce::Colour(0xffc0c0c0));
     addAndMakeVisible(titleLabel);
 
+    // Virtualized track list: rows are materialized only while visible
+    listBox.setModel(this);
+    listBox.setRowHeight(rowHeight);
+    listBox.setColour(juce::ListBox::backgroundColourId, juce::Colours::transparentBlack);
+    listBox.setColour(juce::ListBox::outlineColourId, juce::Colours::transparentBlack);
+    addAndMakeVisible(listBox);
+
     // Set up resizer
     constrainer.setMinimumWidth(100);
     constrainer.setMaximumWidth(400);
     addAndMakeVisible(resizer);
     addComponentListener(this);
-
-    // Refresh track list at 4Hz
-    startTimerHz(4);
 }
 
 TrackListPanel::~TrackListPanel()
 {
     removeComponentListener(this);
-    stopTimer();
+    listBox.setModel(nullptr);
 }
 
 void TrackListPanel::paint(juce::Graphics& g)
@@ -33,12 +37,23 @@ void TrackListPanel::paint(juce::Graphics& g)
     g.setColour(juce::Colour(0xff404040));
     g.drawLine(static_cast<float>(getWidth() - 1), 0.0f,
                static_cast<float>(getWidth() - 1), static_cast<float>(getHeight()));
+}
 
-    // Draw drop indicator line
+void TrackListPanel::paintOverChildren(juce::Graphics& g)
+{
+    // Draw drop indicator line (over the list rows)
     if (dropInsertionIndex >= 0)
     {
-        int titleHeight = 24 + 8;  // Title height + spacing
-        int y = titleHeight + dropInsertionIndex * (28 + 4);
+        int numRows = getNumRows();
+        int y = listBox.getY();
+
+        if (numRows > 0)
+        {
+            auto row = listBox.getRowPosition(juce::jmin(dropInsertionIndex, numRows - 1), true);
+            y += (dropInsertionIndex < numRows) ? row.getY() : row.getBottom();
+        }
+
+        y = juce::jlimit(listBox.getY(), listBox.getBottom(), y);
 
         g.setColour(juce::Colours::white);
         g.fillRect(0, y - 1, getWidth(), 2);
@@ -57,12 +72,13 @@ void TrackListPanel::resized()
     titleLabel.setBounds(area.removeFromTop(24));
     area.removeFromTop(8);
 
-    // Layout track items
-    for (auto* item : trackItems)
-    {
-        item->setBounds(area.removeFromTop(28));
-        area.removeFromTop(4);
-    }
+    // Only the visible rows get laid out
+    listBox.setBounds(area);
+}
+
+void TrackListPanel::refresh()
+{
+    listBox.updateContent();
 }
 
 void TrackListPanel::componentMovedOrResized(juce::Component& component,
@@ -77,9 +93,54 @@ void TrackListPanel::componentMovedOrResized(juce::Component& component,
     }
 }
 
-void TrackListPanel::timerCallback()
+int TrackListPanel::getNumRows()
+{
+    return trackManager.getTrackCount();
+}
+
+void TrackListPanel::paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected)
 {
-    rebuildTrackList();
+    // Rows are drawn by their TrackItem components
+    juce::ignoreUnused(rowNumber, g, width, height, rowIsSelected);
+}
+
+juce::Component* TrackListPanel::refreshComponentForRow(int rowNumber, bool isRowSelected,
+                                                        juce::Component* existingComponentToUpdate)
+{
+    juce::ignoreUnused(isRowSelected);
+
+    TrackListEntry entry;
+    if (!trackManager.getTrackListEntry(rowNumber, entry))
+    {
+        delete existingComponentToUpdate;
+        return nullptr;
+    }
+
+    auto* item = dynamic_cast<TrackItem*>(existingComponentToUpdate);
+    if (item == nullptr)
+    {
+        delete existingComponentToUpdate;
+        item = new TrackItem(entry.trackId, entry.trackName, entry.colour);
+
+        // Items are recycled across rows, so callbacks use whichever track the item shows now
+        item->onToggleChanged = [this, item](bool enabled) {
+            trackManager.setTrackEnabled(item->getTrackId(), enabled);
+        };
+
+        item->onColourChanged = [this, item](juce::Colour colour) {
+            trackManager.setTrackColour(item->getTrackId(), colour);
+        };
+    }
+
+    item->setTrackId(entry.trackId);
+    item->setTrackName(entry.trackName);
+    item->setTrackColour(entry.colour);
+    item->setToggleState(entry.enabled);
+    item->setOfflineStatus(entry.offline);
+    item->setProcessingLoad(entry.hasProcessingLoad, entry.processingLoad);
+    item->setLoudness(entry.hasLoudness, entry.loudness, entry.maxTruePeakDb);
+
+    return item;
 }
 
 bool TrackListPanel::isInterestedInDragSource(const SourceDetails& details)
@@ -90,8 +151,12 @@ bool TrackListPanel::isInterestedInDragSource(const SourceDetails& details)
 
 void TrackListPanel::itemDragMove(const SourceDetails& details)
 {
-    dropInsertionIndex = getInsertionIndexForY(details.localPosition.y);
-    repaint();
+    int newIndex = getInsertionIndexForY(details.localPosition.y);
+    if (newIndex != dropInsertionIndex)
+    {
+        dropInsertionIndex = newIndex;
+        repaint();
+    }
 }
 
 void TrackListPanel::itemDragExit(const SourceDetails& details)
@@ -105,83 +170,19 @@ void TrackListPanel::itemDropped(const SourceDetails& details)
     juce::String draggedTrackId = details.description.toString();
     trackManager.reorderTrack(draggedTrackId, dropInsertionIndex);
 
+    // Reflect the new order immediately rather than waiting for the next frame;
+    // only the visible rows are refreshed
+    listBox.updateContent();
+
     dropInsertionIndex = -1;
     repaint();
 }
 
 int TrackListPanel::getInsertionIndexForY(int y) const
 {
-    // Calculate which track position the Y coordinate corresponds to
-    // Account for title label height (24px + 8px spacing) and track spacing (28px + 4px per item)
-    int titleHeight = 24 + 8;
-    int yRelative = y - titleHeight;
-
-    if (yRelative < 0)
+    // ListBox accounts for scrolling and row height
+    if (y < listBox.getY())
         return 0;
 
-    int trackHeight = 28 + 4;  // height + spacing
-    int index = (yRelative + trackHeight / 2) / trackHeight;
-
-    return juce::jlimit(0, trackItems.size(), index);
-}
-
-void TrackListPanel::rebuildTrackList()
-{
-    auto tracks = trackManager.getActiveTracksOrdered();
-
-    // Check if track list has changed (by track IDs)
-    std::vector<juce::String> newTrackIds;
-    for (const auto& track : tracks)
-        newTrackIds.push_back(track.trackId);
-
-    if (newTrackIds == currentTrackIds)
-    {
-        // No change in track list, just update item states
-        for (int i = 0; i < trackItems.size() && i < static_cast<int>(tracks.size()); ++i)
-        {
-            // Find matching track and update state without triggering callback
-            for (const auto& track : tracks)
-            {
-                if (track.trackId == currentTrackIds[static_cast<size_t>(i)])
-                {
-                    trackItems[i]->setToggleState(track.enabled);
-                    trackItems[i]->setTrackName(track.trackName);
-                    trackItems[i]->setTrackColour(track.colour);
-                    trackItems[i]->setOfflineStatus(track.status == TrackStatus::Offline);
-                    break;
-                }
-            }
-        }
-        return;
-    }
-
-    // Track list changed, rebuild items
-    currentTrackIds = newTrackIds;
-    trackItems.clear();
-
-    for (const auto& track : tracks)
-    {
-        auto* item = trackItems.add(new TrackItem(
-            track.trackId,
-            track.trackName,
-            track.colour
-        ));
-
-        item->setToggleState(track.enabled);
-        item->setOfflineStatus(track.status == TrackStatus::Offline);
-
-        // Wire up callbacks
-        juce::String trackId = track.trackId;
-        item->onToggleChanged = [this, trackId](bool enabled) {
-            trackManager.setTrackEnabled(trackId, enabled);
-        };
-
-        item->onColourChanged = [this, trackId](juce::Colour colour) {
-            trackManager.setTrackColour(trackId, colour);
-        };
-
-        addAndMakeVisible(item);
-    }
-
-    resized();
+    return listBox.getInsertionIndexForPosition(0, y - listBox.getY());
 }
@@ -4,10 +4,16 @@
 #include "TrackManager.h"
 #include "TrackItem.h"
 
+/// Sidebar listing all tracks.
+///
+/// Backed by a juce::ListBox, so only the visible rows have TrackItem
+/// components and those are recycled as the list scrolls. Rows are pulled
+/// from the TrackManager on demand, so refresh() and reordering only cost
+/// O(visible rows) however many tracks there are.
 class TrackListPanel : public juce::Component,
                        public juce::DragAndDropContainer,
                        public juce::DragAndDropTarget,
-                       private juce::Timer,
+                       private juce::ListBoxModel,
                        private juce::ComponentListener
 {
 public:
@@ -15,10 +21,15 @@ public:
     ~TrackListPanel() override;
 
     void paint(juce::Graphics& g) override;
+    void paintOverChildren(juce::Graphics& g) override;
     void resized() override;
 
     int getPreferredWidth() const { return currentWidth; }
 
+    /// Syncs the visible rows with the TrackManager. Called by the FrameScheduler
+    /// when the track layout changes.
+    void refresh();
+
     void componentMovedOrResized(juce::Component& component,
                                 bool wasMoved,
                                 bool wasResized) override;
@@ -30,15 +41,18 @@ public:
     void itemDropped(const SourceDetails& details) override;
 
 private:
-    void timerCallback() override;
-    void rebuildTrackList();
+    // ListBoxModel interface
+    int getNumRows() override;
+    void paintListBoxItem(int rowNumber, juce::Graphics& g, int width, int height, bool rowIsSelected) override;
+    juce::Component* refreshComponentForRow(int rowNumber, bool isRowSelected,
+                                            juce::Component* existingComponentToUpdate) override;
+
     int getInsertionIndexForY(int y) const;
 
     TrackManager& trackManager;
 
     juce::Label titleLabel;
-    juce::OwnedArray<TrackItem> trackItems;
-    std::vector<juce::String> currentTrackIds;  // Track IDs for change detection
+    juce::ListBox listBox;
 
     int dropInsertionIndex { -1 };  // -1 = no drop indicator
 
@@ -46,5 +60,7 @@ private:
     juce::ComponentBoundsConstrainer constrainer;
     int currentWidth { 180 };
 
+    static constexpr int rowHeight = 28 + 4;  // Item height + spacing
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TrackListPanel)
 };
@@ -1,4 +1,5 @@
 #include "TrackManager.h"
+#include "PerfCounters.h"
 
 const std::array<juce::Colour, 8> TrackManager::trackColours = {
     juce::Colour(0xff4fc3f7),  // Light blue
@@ -17,9 +18,11 @@ TrackManager::TrackManager()
 
 void TrackManager::updateTrackPresence(const juce::String& trackId,
                                        const juce::String& trackName,
-                                       double sampleRate)
+                                       double sampleRate,
+                                       const SpectrumMessages::ProcessingLoad* processingLoad)
 {
     juce::ScopedLock sl(lock);
+    Perf::ScopedTimer lockTimer(Perf::Timer::trackLockHold);
 
     auto it = tracks.find(trackId);
     if (it == tracks.end())
@@ -34,19 +37,34 @@ void TrackManager::updateTrackPresence(const juce::String& trackId,
         newTrack.lastSpectrumTime = 0;  // No spectrum data yet
         newTrack.status = TrackStatus::Active;
         newTrack.enabled = true;
+        newTrack.hasProcessingLoad = processingLoad != nullptr;
+        if (processingLoad != nullptr)
+            newTrack.processingLoad = *processingLoad;
+        markDataChanged(newTrack);
 
         tracks[trackId] = newTrack;
 
         // Add to insertion order list (always at the end)
-        customTrackOrder.push_back(trackId);
+        appendToTrackOrder(trackId);
+        markLayoutChanged();
     }
     else
     {
         // Update display name and timestamp (don't reset offline status on heartbeat)
-        it->second.trackName = trackName;
-        it->second.sampleRate = sampleRate;
+        if (it->second.trackName != trackName || it->second.sampleRate != sampleRate)
+        {
+            it->second.trackName = trackName;
+            it->second.sampleRate = sampleRate;
+            markDataChanged(it->second);
+            markLayoutChanged();
+        }
         it->second.lastUpdateTime = juce::Time::currentTimeMillis();
         // Status will be reset to Active only when spectrum data arrives
+
+        // Only the track list shows CPU figures and it polls them, so no version bump
+        it->second.hasProcessingLoad = processingLoad != nullptr;
+        if (processingLoad != nullptr)
+            it->second.processingLoad = *processingLoad;
     }
 }
 
@@ -54,9 +72,12 @@ void TrackManager::updateTrack(const juce::String& trackId,
                                 const juce::String& trackName,
                                 const float* spectrumData,
                                 int numBins,
-                                double sampleRate)
+                                double sampleRate,
+                                const SpectrumMessages::FrameHeader* header,
+                                BinLayout layout)
 {
     juce::ScopedLock sl(lock);
+    Perf::ScopedTimer lockTimer(Perf::Timer::trackLockHold);
 
     // Smoothing factor for exponential moving average (0-1)
     // Lower = more smoothing, Higher = more responsive
@@ -70,6 +91,7 @@ void TrackManager::updateTrack(const juce::String& trackId,
         newTrack.trackId = trackId;
         newTrack.trackName = trackName;
         newTrack.sampleRate = sampleRate;
+        newTrack.layout = layout;
         newTrack.colour = getNextColour();
         newTrack.lastUpdateTime = juce::Time::currentTimeMillis();
         newTrack.lastSpectrumTime = juce::Time::currentTimeMillis();
@@ -83,26 +105,47 @@ void TrackManager::updateTrack(const juce::String& trackId,
             newTrack.spectrum[static_cast<size_t>(i)] = spectrumData[i];
             newTrack.smoothedSpectrum[static_cast<size_t>(i)] = spectrumData[i]; // Initialize with first value
         }
+        recordFrame(newTrack, header);
+        markDataChanged(newTrack);
+        summedSpectrum.updateTrack(trackId, newTrack.smoothedSpectrum.data(), sampleRate, layout);
+        addToHistory(newTrack);
 
         tracks[trackId] = newTrack;
 
         // Add to insertion order list (always at the end)
-        customTrackOrder.push_back(trackId);
+        appendToTrackOrder(trackId);
+        markLayoutChanged();
     }
     else
     {
         // Update existing track and reset to Active if was offline
+        if (it->second.trackName != trackName)
+            markLayoutChanged();
+
         it->second.trackName = trackName;
         it->second.sampleRate = sampleRate;
         it->second.lastUpdateTime = juce::Time::currentTimeMillis();
         it->second.lastSpectrumTime = juce::Time::currentTimeMillis();
+        recordFrame(it->second, header);
 
         bool wasOffline = (it->second.status == TrackStatus::Offline);
         if (wasOffline)
         {
             it->second.status = TrackStatus::Active;
+            masking.setTrackIncluded(trackId, it->second.enabled);
+            markLayoutChanged();
         }
 
+        if (it->second.decaying)
+        {
+            it->second.decaying = false;
+            --numDecayingTracks;
+        }
+
+        // Bins of the other layout are different frequencies, so there's nothing to smooth towards
+        const bool layoutChanged = (it->second.layout != layout);
+        it->second.layout = layout;
+
         int copySize = juce::jmin(numBins, SpectrumConstants::NUM_BINS);
         for (int i = 0; i < copySize; ++i)
         {
@@ -110,26 +153,63 @@ void TrackManager::updateTrack(const juce::String& trackId,
 
             // Apply exponential moving average smoothing
             // If just came back online, reset smoothed value to avoid jump from zero
-            if (wasOffline)
+            if (wasOffline || layoutChanged)
                 it->second.smoothedSpectrum[static_cast<size_t>(i)] = spectrumData[i];
             else
                 it->second.smoothedSpectrum[static_cast<size_t>(i)] =
                     smoothingFactor * spectrumData[i] +
                     (1.0f - smoothingFactor) * it->second.smoothedSpectrum[static_cast<size_t>(i)];
         }
+
+        markDataChanged(it->second);
+        addToHistory(it->second);
+
+        if (it->second.enabled)
+            summedSpectrum.updateTrack(trackId, it->second.smoothedSpectrum.data(), sampleRate, layout);
     }
 }
 
+void TrackManager::updateTrackLoudness(const juce::String& trackId, const SpectrumMessages::LoudnessReading& loudness)
+{
+    juce::ScopedLock sl(lock);
+
+    auto it = tracks.find(trackId);
+    if (it == tracks.end() || it->second.status == TrackStatus::Offline)
+        return;
+
+    recordLoudness(it->second, loudness);
+    markDataChanged(it->second);
+}
+
 void TrackManager::updateStaleTrack()
 {
     juce::ScopedLock sl(lock);
+    Perf::ScopedTimer lockTimer(Perf::Timer::trackLockHold);
 
     // Use same decay factor as active tracks for consistent visual appearance
-    // This is 1.0 - smoothingFactor (0.25) from active track smoothing
-    constexpr float decayFactor = 0.75f;
+    // This is 1.0 - smoothingFactor (0.25) from active track smoothing, applied
+    // per 30Hz tick; scaled by elapsed time so the caller's rate doesn't matter
+    constexpr float decayFactorPerTick = 0.75f;
+    constexpr double decayTickMs = 1000.0 / 30.0;
+
+    // Below this the curve is off the bottom of the display, so stop animating
+    constexpr float silenceThreshold = 1.0e-5f;
 
     juce::int64 now = juce::Time::currentTimeMillis();
 
+    // Held: time stands still, and fading resumes from here once released
+    if (staleHold)
+    {
+        lastStaleUpdateTime = now;
+        return;
+    }
+
+    float decayFactor = 1.0f;
+    if (lastStaleUpdateTime > 0)
+        decayFactor = static_cast<float>(std::pow(decayFactorPerTick,
+                                                  static_cast<double>(now - lastStaleUpdateTime) / decayTickMs));
+    lastStaleUpdateTime = now;
+
     for (auto& pair : tracks)
     {
         auto& track = pair.second;
@@ -143,19 +223,176 @@ void TrackManager::updateStaleTrack()
             if (track.lastSpectrumTime > 0 && timeSinceSpectrum > SpectrumConstants::TRACK_TIMEOUT_MS)
             {
                 track.status = TrackStatus::Offline;
+                masking.setTrackIncluded(track.trackId, false);
                 // Zero out raw spectrum but let smoothed spectrum decay naturally
                 track.spectrum.fill(0.0f);
+                track.hasLoudness = false;
+                track.decaying = true;
+                ++numDecayingTracks;
+                markDataChanged(track);
+                markLayoutChanged();
             }
         }
-        else if (track.status == TrackStatus::Offline)
+        else if (track.decaying && decayFactor < 1.0f)
         {
             // Apply exponential decay to smoothed spectrum while offline
-            for (size_t i = 0; i < track.smoothedSpectrum.size(); ++i)
+            auto* smoothed = track.smoothedSpectrum.data();
+            const int numBins = static_cast<int>(track.smoothedSpectrum.size());
+            juce::FloatVectorOperations::multiply(smoothed, decayFactor, numBins);
+
+            if (juce::FloatVectorOperations::findMaximum(smoothed, numBins) < silenceThreshold)
             {
-                track.smoothedSpectrum[i] *= decayFactor;
+                track.smoothedSpectrum.fill(0.0f);
+                track.decaying = false;
+                --numDecayingTracks;
             }
+
+            markDataChanged(track);
+
+            if (track.enabled)
+                summedSpectrum.updateTrack(track.trackId, smoothed, track.sampleRate, track.layout);
+        }
+    }
+}
+
+void TrackManager::setStaleHold(bool shouldHold)
+{
+    juce::ScopedLock sl(lock);
+
+    if (staleHold && !shouldHold)
+    {
+        const juce::int64 now = juce::Time::currentTimeMillis();
+        for (auto& pair : tracks)
+        {
+            if (pair.second.lastSpectrumTime > 0)
+                pair.second.lastSpectrumTime = now;
         }
     }
+
+    staleHold = shouldHold;
+}
+
+void TrackManager::setTrackOffline(const juce::String& trackId)
+{
+    juce::ScopedLock sl(lock);
+
+    auto it = tracks.find(trackId);
+    if (it == tracks.end())
+        return;
+
+    auto& track = it->second;
+    if (track.decaying)
+    {
+        track.decaying = false;
+        --numDecayingTracks;
+    }
+
+    if (track.status == TrackStatus::Active)
+    {
+        track.status = TrackStatus::Offline;
+        masking.setTrackIncluded(trackId, false);
+        markLayoutChanged();
+    }
+
+    track.spectrum.fill(0.0f);
+    track.smoothedSpectrum.fill(0.0f);
+    track.hasLoudness = false;
+    markDataChanged(track);
+
+    if (track.enabled)
+        summedSpectrum.updateTrack(trackId, track.smoothedSpectrum.data(), track.sampleRate, track.layout);
+}
+
+bool TrackManager::isAnimating() const
+{
+    juce::ScopedLock sl(lock);
+    return numDecayingTracks > 0 && !staleHold;
+}
+
+bool TrackManager::updateEnabledSnapshot(std::vector<TrackData>& snapshot,
+                                         juce::uint32& snapshotLayoutVersion) const
+{
+    juce::ScopedLock sl(lock);
+    Perf::ScopedTimer lockTimer(Perf::Timer::trackLockHold);
+
+    // Layout changed: rebuild in display order
+    if (snapshotLayoutVersion != layoutVersion.load())
+    {
+        snapshot.clear();
+        for (const auto& trackId : customTrackOrder)
+        {
+            auto it = tracks.find(trackId);
+            if (it != tracks.end() && it->second.enabled)
+                snapshot.push_back(it->second);
+        }
+
+        snapshotLayoutVersion = layoutVersion.load();
+        return true;
+    }
+
+    // Same layout: only copy tracks that changed since the last refresh
+    bool changed = false;
+    for (auto& cached : snapshot)
+    {
+        auto it = tracks.find(cached.trackId);
+        if (it != tracks.end() && it->second.version != cached.version)
+        {
+            cached = it->second;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+void TrackManager::getSummedPower(std::vector<float>& output) const
+{
+    juce::ScopedLock sl(lock);
+    summedSpectrum.getTotalPower(output);
+}
+
+bool TrackManager::getTrackSummedPower(const juce::String& trackId, std::vector<float>& output) const
+{
+    juce::ScopedLock sl(lock);
+    return summedSpectrum.getTrackPower(trackId, output);
+}
+
+bool TrackManager::getTrackStatistics(const juce::String& trackId, SpectrumStatistics::Summary& summary) const
+{
+    juce::ScopedLock sl(lock);
+    return statistics.getSummary(trackId, summary);
+}
+
+void TrackManager::resetStatistics()
+{
+    juce::ScopedLock sl(lock);
+    statistics.reset();
+
+    for (auto& pair : tracks)
+    {
+        pair.second.maxTruePeakDb = pair.second.hasLoudness ? pair.second.loudness.truePeakDb
+                                                            : SpectrumMessages::LOUDNESS_FLOOR_DB;
+        markDataChanged(pair.second);
+    }
+}
+
+void TrackManager::getMaskingReport(MaskingReport& report)
+{
+    juce::ScopedLock sl(lock);
+    masking.update(report);
+
+    for (auto& conflict : report.conflicts)
+    {
+        auto a = tracks.find(conflict.trackIdA);
+        auto b = tracks.find(conflict.trackIdB);
+        if (a == tracks.end() || b == tracks.end())
+            continue;
+
+        conflict.nameA = a->second.trackName;
+        conflict.colourA = a->second.colour;
+        conflict.nameB = b->second.trackName;
+        conflict.colourB = b->second.colour;
+    }
 }
 
 std::vector<TrackData> TrackManager::getActiveTracks() const
@@ -211,13 +448,88 @@ int TrackManager::getTrackCount() const
     return static_cast<int>(tracks.size());
 }
 
+IngestStats TrackManager::getIngestStats() const
+{
+    juce::ScopedLock sl(lock);
+    return ingestStats;
+}
+
+SessionLoad TrackManager::getSessionLoad() const
+{
+    juce::ScopedLock sl(lock);
+
+    SessionLoad sessionLoad;
+    for (const auto& pair : tracks)
+    {
+        const auto& track = pair.second;
+        if (!track.hasProcessingLoad || track.status == TrackStatus::Offline)
+            continue;
+
+        ++sessionLoad.numReporting;
+        sessionLoad.totalLoad += track.processingLoad.load;
+        sessionLoad.maxPeakLoad = juce::jmax(sessionLoad.maxPeakLoad, static_cast<double>(track.processingLoad.peakLoad));
+    }
+
+    return sessionLoad;
+}
+
+void TrackManager::recordPresented(const std::vector<TrackData>& snapshot)
+{
+    // Snapshot tracks are copies, so no need for the track lock (the tracker has its own)
+    const juce::int64 now = SpectrumMessages::getMonotonicTimeMicroseconds();
+
+    for (const auto& track : snapshot)
+    {
+        if (track.captureTimeUs > 0)
+            latencyTracker.recordPresented(track.trackId, track.captureTimeUs, now);
+    }
+}
+
+bool TrackManager::getTrackListEntry(int index, TrackListEntry& entry) const
+{
+    juce::ScopedLock sl(lock);
+
+    if (index < 0 || index >= static_cast<int>(customTrackOrder.size()))
+        return false;
+
+    auto it = tracks.find(customTrackOrder[static_cast<size_t>(index)]);
+    if (it == tracks.end())
+        return false;
+
+    entry.trackId = it->second.trackId;
+    entry.trackName = it->second.trackName;
+    entry.colour = it->second.colour;
+    entry.enabled = it->second.enabled;
+    entry.offline = (it->second.status == TrackStatus::Offline);
+    entry.framesReceived = it->second.framesReceived;
+    entry.framesDropped = it->second.framesDropped;
+    entry.framesOutOfOrder = it->second.framesOutOfOrder;
+    entry.hasProcessingLoad = it->second.hasProcessingLoad;
+    entry.processingLoad = it->second.processingLoad;
+    entry.hasLoudness = it->second.hasLoudness;
+    entry.loudness = it->second.loudness;
+    entry.maxTruePeakDb = it->second.maxTruePeakDb;
+    return true;
+}
+
 void TrackManager::setTrackEnabled(const juce::String& trackId, bool enabled)
 {
     juce::ScopedLock sl(lock);
 
     auto it = tracks.find(trackId);
     if (it != tracks.end())
+    {
         it->second.enabled = enabled;
+        markDataChanged(it->second);
+
+        if (enabled)
+            summedSpectrum.updateTrack(trackId, it->second.smoothedSpectrum.data(), it->second.sampleRate,
+                                       it->second.layout);
+        else
+            summedSpectrum.removeTrack(trackId);
+        masking.setTrackIncluded(trackId, enabled && it->second.status == TrackStatus::Active);
+        markLayoutChanged();
+    }
 }
 
 void TrackManager::setTrackColour(const juce::String& trackId, const juce::Colour& colour)
@@ -226,21 +538,46 @@ void TrackManager::setTrackColour(const juce::String& trackId, const juce::Colou
 
     auto it = tracks.find(trackId);
     if (it != tracks.end())
+    {
         it->second.colour = colour;
+        markDataChanged(it->second);
+        markLayoutChanged();
+    }
+}
+
+void TrackManager::appendToTrackOrder(const juce::String& trackId)
+{
+    trackOrderIndex[trackId] = static_cast<int>(customTrackOrder.size());
+    customTrackOrder.push_back(trackId);
 }
 
 void TrackManager::reorderTrack(const juce::String& trackId, int newIndex)
 {
     juce::ScopedLock sl(lock);
 
-    // Remove from current position
-    auto it = std::find(customTrackOrder.begin(), customTrackOrder.end(), trackId);
-    if (it != customTrackOrder.end())
-        customTrackOrder.erase(it);
+    auto found = trackOrderIndex.find(trackId);
+    if (found == trackOrderIndex.end())
+    {
+        appendToTrackOrder(trackId);
+        found = trackOrderIndex.find(trackId);
+    }
+
+    // newIndex is the track's position once moved; rotate it there through the rows in between
+    const int oldIndex = found->second;
+    newIndex = juce::jlimit(0, static_cast<int>(customTrackOrder.size()) - 1, newIndex);
+    if (newIndex == oldIndex)
+        return;
 
-    // Insert at new position
-    newIndex = juce::jlimit(0, static_cast<int>(customTrackOrder.size()), newIndex);
-    customTrackOrder.insert(customTrackOrder.begin() + newIndex, trackId);
+    auto order = customTrackOrder.begin();
+    if (newIndex < oldIndex)
+        std::rotate(order + newIndex, order + oldIndex, order + oldIndex + 1);
+    else
+        std::rotate(order + oldIndex, order + oldIndex + 1, order + newIndex + 1);
+
+    for (int i = juce::jmin(oldIndex, newIndex); i <= juce::jmax(oldIndex, newIndex); ++i)
+        trackOrderIndex[customTrackOrder[static_cast<size_t>(i)]] = i;
+
+    markLayoutChanged();
 }
 
 juce::Colour TrackManager::getNextColour()
@@ -249,3 +586,105 @@ juce::Colour TrackManager::getNextColour()
     ++colourIndex;
     return colour;
 }
+
+void TrackManager::markDataChanged(TrackData& track)
+{
+    ++track.version;
+    ++dataVersion;
+}
+
+void TrackManager::markLayoutChanged()
+{
+    ++layoutVersion;
+}
+
+void TrackManager::addToHistory(const TrackData& track)
+{
+    if (track.sampleRate <= 0.0)
+        return;
+
+    // The history maps the frame onto its grid once; the statistics reuse that
+    history.append(track.trackId, track.spectrum.data(), track.sampleRate, track.layout, track.lastSpectrumTime);
+    statistics.add(track.trackId, history.getLastBandPower(), history.getLastRow());
+    masking.updateTrack(track.trackId, history.getLastBandPower(),
+                        track.enabled && track.status == TrackStatus::Active);
+}
+
+void TrackManager::recordFrame(TrackData& track, const SpectrumMessages::FrameHeader* header)
+{
+    // Larger jumps forwards, or anything more than a few frames backwards, is a relay
+    // restart (sequence reset) rather than loss or reordering
+    constexpr juce::uint32 maxCountedGap = 1u << 20;
+    constexpr juce::uint32 maxReorderDistance = 64;
+    static_assert(maxReorderDistance <= 64, "Missing frames are remembered in a 64-bit mask");
+
+    ++track.framesReceived;
+    ++ingestStats.framesReceived;
+
+    if (header == nullptr)
+        return;
+
+    if (header->captureTimeUs > 0)
+    {
+        track.captureTimeUs = header->captureTimeUs;
+        track.ingestTimeUs = SpectrumMessages::getMonotonicTimeMicroseconds();
+        track.hostSamplePosition = header->hostSamplePosition;
+        latencyTracker.recordIngest(track.trackId, track.captureTimeUs, track.ingestTimeUs);
+    }
+
+    if (header->hasLoudness)
+        recordLoudness(track, header->loudness);
+
+    if (track.hasSequence)
+    {
+        juce::uint32 gap = header->sequence - track.lastSequence - 1;
+        juce::uint32 behind = track.lastSequence - header->sequence;
+
+        if (gap < maxCountedGap)
+        {
+            track.framesDropped += gap;
+            ingestStats.framesDropped += gap;
+            Perf::add(Perf::Counter::framesDropped, gap);
+
+            // The old newest frame moves gap + 1 places back, and the gap's frames are now missing
+            const juce::uint32 shift = gap + 1;
+            track.missingSequences = shift < 64 ? track.missingSequences << shift : 0;
+            track.missingSequences |= gap < 64 ? (juce::uint64 { 1 } << gap) - 1 : ~juce::uint64 { 0 };
+        }
+        else if (behind < maxReorderDistance)
+        {
+            // Older than the newest frame (reordered or duplicated): counted, but keep the newest
+            // sequence. Only a frame that was missing fills a gap already counted as dropped;
+            // duplicates and repeats of the newest frame don't
+            ++track.framesOutOfOrder;
+            ++ingestStats.framesOutOfOrder;
+            Perf::add(Perf::Counter::framesOutOfOrder);
+
+            const juce::uint64 bit = behind > 0 ? juce::uint64 { 1 } << (behind - 1) : 0;
+            if ((track.missingSequences & bit) != 0)
+            {
+                track.missingSequences &= ~bit;
+                --track.framesDropped;
+                --ingestStats.framesDropped;
+                Perf::add(Perf::Counter::framesDropped, -1);
+            }
+
+            return;
+        }
+        else
+        {
+            // Relay restart: nothing before the new sequence is missing
+            track.missingSequences = 0;
+        }
+    }
+
+    track.lastSequence = header->sequence;
+    track.hasSequence = true;
+}
+
+void TrackManager::recordLoudness(TrackData& track, const SpectrumMessages::LoudnessReading& loudness)
+{
+    track.hasLoudness = true;
+    track.loudness = loudness;
+    track.maxTruePeakDb = juce::jmax(track.maxTruePeakDb, loudness.truePeakDb);
+}
@@ -2,6 +2,13 @@
 
 #include <JuceHeader.h>
 #include "../../Common/SpectrumData.h"
+#include "../../Common/SpectrumMessages.h"
+#include "SummedSpectrum.h"
+#include "LatencyTracker.h"
+#include "SpectrumHistory.h"
+#include "SpectrumStatistics.h"
+#include "MaskingDetector.h"
+#include <unordered_map>
 
 enum class TrackStatus { Active, Offline };
 
@@ -10,6 +17,7 @@ struct TrackData
     juce::String trackId;      // Unique identifier (UUID from plugin)
     juce::String trackName;    // Display name
     double sampleRate { 0.0 };
+    BinLayout layout { BinLayout::Linear };  // Of spectrum / smoothedSpectrum, as the relay sent it
     juce::Colour colour;
     juce::int64 lastUpdateTime { 0 };       // Last heartbeat or spectrum update
     juce::int64 lastSpectrumTime { 0 };     // Last spectrum data update (for offline detection)
@@ -17,6 +25,64 @@ struct TrackData
     std::array<float, SpectrumConstants::NUM_BINS> spectrum { 0.0f };         // Raw spectrum data
     std::array<float, SpectrumConstants::NUM_BINS> smoothedSpectrum { 0.0f }; // Temporally smoothed for display
     bool enabled { true };
+    bool decaying { false };   // Offline and smoothed spectrum still fading out
+    juce::uint32 version { 0 }; // Bumped whenever any field of this track changes
+
+    // Ingest accounting (sequence numbers come from the message header, if the relay sends one)
+    juce::int64 framesReceived { 0 };
+    juce::int64 framesDropped { 0 };
+    juce::int64 framesOutOfOrder { 0 };
+    juce::uint32 lastSequence { 0 };
+    juce::uint64 missingSequences { 0 };  // Bit n: lastSequence - 1 - n was counted as dropped and hasn't arrived
+    bool hasSequence { false };
+
+    // Stamps of the newest frame (from the message header; 0 / -1 if the relay doesn't send them)
+    juce::int64 captureTimeUs { 0 };        // Monotonic time the audio reached the relay
+    juce::int64 ingestTimeUs { 0 };         // Monotonic time the frame reached the TrackManager
+    juce::int64 hostSamplePosition { -1 };  // Host timeline position of the frame's last sample
+
+    // Relay's own CPU cost, from its latest heartbeat (not reported by older relays)
+    bool hasProcessingLoad { false };
+    SpectrumMessages::ProcessingLoad processingLoad;
+
+    // Relay's loudness meter, from the newest frame (not sent by older relays; cleared when offline)
+    bool hasLoudness { false };
+    SpectrumMessages::LoudnessReading loudness;
+    float maxTruePeakDb { SpectrumMessages::LOUDNESS_FLOOR_DB };  // Since the track appeared or resetStatistics()
+};
+
+/// Spectrum frames received and lost in transit, summed over all tracks.
+struct IngestStats
+{
+    juce::int64 framesReceived { 0 };
+    juce::int64 framesDropped { 0 };
+    juce::int64 framesOutOfOrder { 0 };
+};
+
+/// Relay CPU cost summed over the online tracks that report it.
+struct SessionLoad
+{
+    int numReporting { 0 };
+    double totalLoad { 0.0 };      // Sum of each relay's processBlock time / audio time (1.0 = one core)
+    double maxPeakLoad { 0.0 };    // Worst single block of any relay, as a share of its duration
+};
+
+/// Lightweight per-track info for the track list (no spectrum data).
+struct TrackListEntry
+{
+    juce::String trackId;
+    juce::String trackName;
+    juce::Colour colour;
+    bool enabled { true };
+    bool offline { false };
+    juce::int64 framesReceived { 0 };
+    juce::int64 framesDropped { 0 };
+    juce::int64 framesOutOfOrder { 0 };
+    bool hasProcessingLoad { false };
+    SpectrumMessages::ProcessingLoad processingLoad;
+    bool hasLoudness { false };
+    SpectrumMessages::LoudnessReading loudness;
+    float maxTruePeakDb { SpectrumMessages::LOUDNESS_FLOOR_DB };
 };
 
 class TrackManager
@@ -24,21 +90,84 @@ class TrackManager
 public:
     TrackManager();
 
-    /// Update track presence (called on heartbeat)
+    /// Update track presence (called on heartbeat). The relay's CPU figures are
+    /// passed along if its heartbeat carried them.
     void updateTrackPresence(const juce::String& trackId, 
                             const juce::String& trackName, 
-                            double sampleRate);
+                            double sampleRate,
+                            const SpectrumMessages::ProcessingLoad* processingLoad = nullptr);
 
-    /// Update track with new spectrum data
+    /// Update track with new spectrum data. The header (if the relay sent one)
+    /// is used to count frames dropped between the relay and here. A change of
+    /// layout restarts the track's smoothing.
     void updateTrack(const juce::String& trackId,
                     const juce::String& trackName,
                     const float* spectrumData,
                     int numBins,
-                    double sampleRate);
+                    double sampleRate,
+                    const SpectrumMessages::FrameHeader* header = nullptr,
+                    BinLayout layout = BinLayout::Linear);
+
+    /// Update a track's loudness reading from a source without frame headers (an
+    /// aggregator link). Frames that carry one in their header don't need this.
+    void updateTrackLoudness(const juce::String& trackId, const SpectrumMessages::LoudnessReading& loudness);
 
-    /// Updates stale tracks: marks as offline and zeros spectrum, never removes
+    /// Updates stale tracks: marks as offline and zeros spectrum, never removes.
+    /// Decay of offline tracks is time-based, so this can be called at any rate.
     void updateStaleTrack();
 
+    /// While held, tracks don't go offline for lack of frames and offline tracks stop
+    /// fading, so a paused or scrubbed session keeps showing the frame at its playhead.
+    /// Releasing the hold restarts every track's timeout from then.
+    void setStaleHold(bool shouldHold);
+
+    /// Takes a track offline at once with its spectrum cleared instead of fading, e.g.
+    /// when a replayed session seeks back to before the track's first frame.
+    void setTrackOffline(const juce::String& trackId);
+
+    /// True while any offline track's smoothed spectrum is still fading out.
+    bool isAnimating() const;
+
+    /// Incremented whenever any track's data or state changes. Cheap to poll.
+    juce::uint32 getDataVersion() const { return dataVersion.load(); }
+
+    /// Incremented when tracks are added, reordered, enabled/disabled, renamed,
+    /// recoloured or change online status (i.e. anything the track list shows).
+    juce::uint32 getLayoutVersion() const { return layoutVersion.load(); }
+
+    /// Brings a snapshot of enabled tracks (in display order) up to date, copying
+    /// only tracks whose version changed. Rebuilds it if the layout changed.
+    /// Returns true if anything in the snapshot changed.
+    bool updateEnabledSnapshot(std::vector<TrackData>& snapshot,
+                               juce::uint32& snapshotLayoutVersion) const;
+
+    /// Grid that the summed spectrum is computed on.
+    const LogFrequencyGrid& getSummedGrid() const { return summedSpectrum.getGrid(); }
+
+    /// The last few seconds of every track's raw spectrum, for freeze and scrub.
+    /// Written by updateTrack, so only read it on the thread that ingests frames
+    /// (the message thread).
+    const SpectrumHistory& getHistory() const { return history; }
+
+    /// Long-term average and 10/50/90th percentile levels of a track's raw spectrum
+    /// on the history grid, since it first appeared or the last resetStatistics().
+    /// O(bands) whatever the session length. False if the track has no frames.
+    bool getTrackStatistics(const juce::String& trackId, SpectrumStatistics::Summary& summary) const;
+
+    /// Starts the long-term statistics of every track again, including the
+    /// maximum true peak.
+    void resetStatistics();
+
+    /// Bands where enabled, online tracks compete and the worst pairs (see
+    /// MaskingDetector). Compares only pairs that changed since the last call.
+    void getMaskingReport(MaskingReport& report);
+
+    /// Copies the power sum of all enabled tracks (one value per grid band).
+    void getSummedPower(std::vector<float>& output) const;
+
+    /// Copies one enabled track's contribution to the sum. False if not summed.
+    bool getTrackSummedPower(const juce::String& trackId, std::vector<float>& output) const;
+
     /// Returns list of currently active tracks (thread-safe copy).
     std::vector<TrackData> getActiveTracks() const;
 
@@ -50,23 +179,72 @@ public:
 
     int getTrackCount() const;
 
+    /// Frames received and dropped since startup, over all tracks.
+    IngestStats getIngestStats() const;
+
+    /// CPU cost of all online relays, from their heartbeats.
+    SessionLoad getSessionLoad() const;
+
+    /// Capture -> ingest -> present latency per track.
+    const LatencyTracker& getLatencyTracker() const { return latencyTracker; }
+
+    /// Called by displays after painting a snapshot, to record when its frames were presented.
+    void recordPresented(const std::vector<TrackData>& snapshot);
+
+    /// Gets the track at a position in display order without copying its spectrum.
+    /// Returns false if the index is out of range.
+    bool getTrackListEntry(int index, TrackListEntry& entry) const;
+
     /// Enable or disable a track
     void setTrackEnabled(const juce::String& trackId, bool enabled);
 
     /// Set custom color for a track
     void setTrackColour(const juce::String& trackId, const juce::Colour& colour);
 
-    /// Reorder track to new position
+    /// Moves a track to a new position in the list. Finding it is O(1); only the rows
+    /// between its old and new positions shift, so a drag costs the distance dragged.
     void reorderTrack(const juce::String& trackId, int newIndex);
 
 private:
     juce::Colour getNextColour();
+    void markDataChanged(TrackData& track);
+    void markLayoutChanged();
+    void recordFrame(TrackData& track, const SpectrumMessages::FrameHeader* header);
+    void recordLoudness(TrackData& track, const SpectrumMessages::LoudnessReading& loudness);
+    void addToHistory(const TrackData& track);
+    void appendToTrackOrder(const juce::String& trackId);
 
     std::map<juce::String, TrackData> tracks;  // Key is trackId (UUID)
     mutable juce::CriticalSection lock;
     int colourIndex { 0 };
 
-    std::vector<juce::String> customTrackOrder;  // Empty = alphabetical
+    struct TrackIdHash
+    {
+        size_t operator()(const juce::String& trackId) const noexcept { return static_cast<size_t>(trackId.hashCode64()); }
+    };
+
+    std::vector<juce::String> customTrackOrder;  // Display order: arrival, then as dragged
+    std::unordered_map<juce::String, int, TrackIdHash> trackOrderIndex;  // Position of each track in customTrackOrder
+
+    std::atomic<juce::uint32> dataVersion { 0 };
+    std::atomic<juce::uint32> layoutVersion { 0 };
+    juce::int64 lastStaleUpdateTime { 0 };
+    int numDecayingTracks { 0 };
+    bool staleHold { false };
+    IngestStats ingestStats;
+    LatencyTracker latencyTracker;
+
+    // Power sum of enabled tracks, updated per track as smoothed spectra change
+    SummedSpectrum summedSpectrum;
+
+    // Recent raw spectra of every track, in one fixed-size arena
+    SpectrumHistory history;
+
+    // Per-band long-term average and level histograms, fed from the history's encoded rows
+    SpectrumStatistics statistics { history.getNumBands() };
+
+    // Pairwise band conflicts, also fed from the history's band power
+    MaskingDetector masking { history.getGrid() };
 
     // Predefined colour palette for tracks
     static const std::array<juce::Colour, 8> trackColours;
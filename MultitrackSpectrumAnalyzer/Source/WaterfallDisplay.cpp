@@ -0,0 +1,344 @@
+#include "WaterfallDisplay.h"
+#include "../../Common/SpectrumData.h"
+#include "PerfCounters.h"
+#include <cmath>
+
+Waterfall::Waterfall(int w, int rows)
+    : width(w),
+      historyRows(rows),
+      image(juce::Image::ARGB, w, rows, true, juce::SoftwareImageType())
+{
+}
+
+void Waterfall::pushRow(const float* pixelMagnitudes, const ColourLut& lut, float minDb, float maxDb)
+{
+    // Rows are written upwards so the newest data sits directly above the previous row
+    writeRow = (writeRow + historyRows - 1) % historyRows;
+
+    juce::Image::BitmapData data(image, 0, writeRow, width, 1, juce::Image::BitmapData::writeOnly);
+    auto* pixels = reinterpret_cast<juce::PixelARGB*>(data.getLinePointer(0));
+
+    const float scale = static_cast<float>(colourLutSize - 1) / (maxDb - minDb);
+
+    for (int x = 0; x < width; ++x)
+    {
+        float magnitude = pixelMagnitudes[x];
+        float db = magnitude > 0.0f ? 20.0f * std::log10(magnitude) : minDb;
+        int index = juce::jlimit(0, colourLutSize - 1, static_cast<int>((db - minDb) * scale));
+        pixels[x] = lut[static_cast<size_t>(index)];
+    }
+}
+
+void Waterfall::draw(juce::Graphics& g, juce::Rectangle<int> area) const
+{
+    int rows = juce::jmin(area.getHeight(), historyRows);
+    int w = juce::jmin(area.getWidth(), width);
+    if (rows <= 0 || w <= 0)
+        return;
+
+    // Newest rows run from writeRow to the bottom of the image, then wrap to the top
+    int firstRows = juce::jmin(rows, historyRows - writeRow);
+    g.drawImage(image, area.getX(), area.getY(), w, firstRows, 0, writeRow, w, firstRows);
+
+    int secondRows = rows - firstRows;
+    if (secondRows > 0)
+        g.drawImage(image, area.getX(), area.getY() + firstRows, w, secondRows, 0, 0, w, secondRows);
+}
+
+WaterfallDisplay::WaterfallDisplay(TrackManager& tm)
+    : trackManager(tm),
+      colourLut(createColourLut())
+{
+    // Force a full snapshot on the first refresh
+    cachedLayoutVersion = trackManager.getLayoutVersion() - 1;
+
+    sumLane.name = "Sum";
+    sumLane.colour = juce::Colours::lightgrey;
+}
+
+WaterfallDisplay::~WaterfallDisplay()
+{
+}
+
+void WaterfallDisplay::paint(juce::Graphics& g)
+{
+    Perf::ScopedTimer paintTimer(Perf::Timer::paintTotal);
+    Perf::add(Perf::Counter::paints);
+
+    g.fillAll(juce::Colour(0xff1a1a1a));
+
+    auto plotArea = getPlotArea();
+    drawFrequencyAxis(g, plotArea);
+
+    if (trackLanes.empty())
+        return;
+
+    // Sum lane on top, only worth showing with more than one track
+    std::vector<const Lane*> lanes;
+    if (trackLanes.size() > 1)
+        lanes.push_back(&sumLane);
+    for (const auto& lane : trackLanes)
+        lanes.push_back(&lane);
+
+    int numLanes = static_cast<int>(lanes.size());
+    int laneHeight = (plotArea.getHeight() - laneSpacing * (numLanes - 1)) / numLanes;
+    if (laneHeight <= 0)
+        return;
+
+    g.setFont(juce::FontOptions(11.0f));
+
+    auto area = plotArea;
+    for (const auto* lane : lanes)
+    {
+        auto laneArea = area.removeFromTop(laneHeight);
+        area.removeFromTop(laneSpacing);
+
+        if (lane->waterfall != nullptr)
+            lane->waterfall->draw(g, laneArea);
+
+        g.setColour(lane->colour);
+        g.drawText(lane->name, laneArea.reduced(4, 2), juce::Justification::topLeft);
+    }
+
+    trackManager.recordPresented(cachedTracks);
+}
+
+void WaterfallDisplay::resized()
+{
+    if (getPlotArea().getWidth() != laneWidth)
+        syncLanes();
+}
+
+void WaterfallDisplay::refresh()
+{
+    Perf::ScopedTimer snapshotTimer(Perf::Timer::snapshotUpdate);
+
+    bool layoutChanged = cachedLayoutVersion != trackManager.getLayoutVersion();
+    trackManager.updateEnabledSnapshot(cachedTracks, cachedLayoutVersion);
+
+    if (layoutChanged || getPlotArea().getWidth() != laneWidth)
+        syncLanes();
+
+    if (laneWidth <= 0 || trackLanes.empty())
+    {
+        repaint();
+        return;
+    }
+
+    // Scroll every lane by one row so all lanes stay time-aligned
+    for (size_t i = 0; i < cachedTracks.size(); ++i)
+    {
+        computePixelMagnitudes(cachedTracks[i], pixelMagnitudes.data());
+        trackLanes[i].waterfall->pushRow(pixelMagnitudes.data(), colourLut, minDb, maxDb);
+    }
+
+    computeSummedPixelMagnitudes(pixelMagnitudes.data());
+    sumLane.waterfall->pushRow(pixelMagnitudes.data(), colourLut, minDb, maxDb);
+
+    repaint(getPlotArea());
+}
+
+void WaterfallDisplay::syncLanes()
+{
+    int width = getPlotArea().getWidth();
+    if (width <= 0)
+    {
+        laneWidth = 0;
+        trackLanes.clear();
+        sumLane.waterfall.reset();
+        return;
+    }
+
+    // New width: history and pixel tables are no longer valid
+    if (width != laneWidth)
+    {
+        laneWidth = width;
+        pixelBinTables.clear();
+        trackLanes.clear();
+        sumLane.waterfall.reset();
+    }
+
+    // Split the memory budget across all lanes (tracks + sum)
+    size_t numLanes = cachedTracks.size() + 1;
+    size_t bytesPerRow = static_cast<size_t>(width) * sizeof(juce::PixelARGB);
+    int historyRows = static_cast<int>(juce::jlimit<size_t>(1, static_cast<size_t>(maxHistoryRows),
+                                                            memoryBudgetBytes / (numLanes * bytesPerRow)));
+
+    // Keep the history of tracks that are still shown, as long as it fits the budget
+    std::vector<Lane> newLanes;
+    newLanes.reserve(cachedTracks.size());
+
+    for (const auto& track : cachedTracks)
+    {
+        Lane lane;
+        lane.trackId = track.trackId;
+        lane.name = track.trackName;
+        lane.colour = track.colour;
+
+        auto existing = std::find_if(trackLanes.begin(), trackLanes.end(),
+                                     [&track](const Lane& l) { return l.trackId == track.trackId; });
+
+        if (existing != trackLanes.end() && existing->waterfall != nullptr
+            && existing->waterfall->getHistoryRows() <= historyRows)
+            lane.waterfall = std::move(existing->waterfall);
+        else
+            lane.waterfall = std::make_unique<Waterfall>(width, historyRows);
+
+        newLanes.push_back(std::move(lane));
+    }
+
+    trackLanes = std::move(newLanes);
+
+    if (sumLane.waterfall == nullptr || sumLane.waterfall->getHistoryRows() > historyRows)
+        sumLane.waterfall = std::make_unique<Waterfall>(width, historyRows);
+
+    pixelMagnitudes.resize(static_cast<size_t>(width));
+}
+
+const std::vector<WaterfallDisplay::PixelBinRange>& WaterfallDisplay::getPixelBinTable(BinLayout layout, double sampleRate)
+{
+    const auto key = std::make_pair(layout, sampleRate);
+    auto it = pixelBinTables.find(key);
+    if (it != pixelBinTables.end())
+        return it->second;
+
+    std::vector<PixelBinRange> table(static_cast<size_t>(laneWidth));
+    const float width = static_cast<float>(laneWidth);
+    const int firstBin = layout == BinLayout::Linear ? 1 : 0;  // Linear bin 0 is DC
+    auto toBin = [layout, sampleRate](double frequency) { return frequencyToBin(layout, sampleRate, frequency); };
+
+    for (int x = 0; x < laneWidth; ++x)
+    {
+        double lowFrequency = xToFrequency(static_cast<float>(x), width);
+        double highFrequency = xToFrequency(static_cast<float>(x + 1), width);
+
+        // Bins whose centre falls inside this pixel column
+        int startBin = static_cast<int>(std::ceil(toBin(lowFrequency)));
+        int endBin = static_cast<int>(std::ceil(toBin(highFrequency)));
+
+        // Column narrower than a bin: use the nearest bin
+        if (endBin <= startBin)
+        {
+            startBin = juce::roundToInt(toBin(0.5 * (lowFrequency + highFrequency)));
+            endBin = startBin + 1;
+        }
+
+        startBin = juce::jlimit(firstBin, SpectrumConstants::NUM_BINS - 1, startBin);
+        endBin = juce::jlimit(startBin + 1, SpectrumConstants::NUM_BINS, endBin);
+
+        table[static_cast<size_t>(x)] = { startBin, endBin };
+    }
+
+    return pixelBinTables.emplace(key, std::move(table)).first->second;
+}
+
+void WaterfallDisplay::computePixelMagnitudes(const TrackData& track, float* output)
+{
+    if (track.sampleRate <= 0.0)
+    {
+        std::fill(output, output + laneWidth, 0.0f);
+        return;
+    }
+
+    const auto& table = getPixelBinTable(track.layout, track.sampleRate);
+    const float* spectrum = track.smoothedSpectrum.data();
+
+    // Peak-hold over all bins in each column, as in SpectrumDisplay
+    for (int x = 0; x < laneWidth; ++x)
+    {
+        const auto& range = table[static_cast<size_t>(x)];
+        float peak = spectrum[range.startBin];
+        for (int bin = range.startBin + 1; bin < range.endBin; ++bin)
+            peak = juce::jmax(peak, spectrum[bin]);
+        output[x] = peak;
+    }
+}
+
+void WaterfallDisplay::computeSummedPixelMagnitudes(float* output)
+{
+    trackManager.getSummedPower(summedPower);
+
+    const auto& grid = trackManager.getSummedGrid();
+    const int numBands = static_cast<int>(summedPower.size());
+    const float width = static_cast<float>(laneWidth);
+
+    // Peak-hold over the bands in each column, or the nearest band if the column is narrower
+    for (int x = 0; x < laneWidth; ++x)
+    {
+        float lowBand = grid.frequencyToBand(xToFrequency(static_cast<float>(x), width));
+        float highBand = grid.frequencyToBand(xToFrequency(static_cast<float>(x + 1), width));
+
+        int startBand = juce::jlimit(0, numBands - 1, static_cast<int>(lowBand));
+        int endBand = juce::jlimit(startBand + 1, numBands, static_cast<int>(highBand));
+
+        float peak = 0.0f;
+        for (int band = startBand; band < endBand; ++band)
+            peak = juce::jmax(peak, summedPower[static_cast<size_t>(band)]);
+
+        output[x] = std::sqrt(peak);
+    }
+}
+
+juce::Rectangle<int> WaterfallDisplay::getPlotArea() const
+{
+    return getLocalBounds().withTrimmedLeft(leftMargin)
+                           .withTrimmedBottom(bottomMargin)
+                           .withTrimmedTop(topMargin)
+                           .withTrimmedRight(rightMargin);
+}
+
+float WaterfallDisplay::frequencyToX(float frequency, float width) const
+{
+    frequency = juce::jlimit(minFrequency, maxFrequency, frequency);
+
+    float logMin = std::log10(minFrequency);
+    float logMax = std::log10(maxFrequency);
+    return width * (std::log10(frequency) - logMin) / (logMax - logMin);
+}
+
+float WaterfallDisplay::xToFrequency(float x, float width) const
+{
+    return minFrequency * std::pow(maxFrequency / minFrequency, x / width);
+}
+
+void WaterfallDisplay::drawFrequencyAxis(juce::Graphics& g, juce::Rectangle<int> area)
+{
+    g.setFont(juce::FontOptions(11.0f));
+
+    const float frequencies[] = { 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 20000 };
+    const char* labels[] = { "20", "50", "100", "200", "500", "1k", "2k", "5k", "10k", "20k" };
+
+    for (int i = 0; i < 10; ++i)
+    {
+        int x = area.getX() + static_cast<int>(frequencyToX(frequencies[i], static_cast<float>(area.getWidth())));
+
+        // Tick mark below the plot
+        g.setColour(juce::Colour(0xff404040));
+        g.drawVerticalLine(x, static_cast<float>(area.getBottom()), static_cast<float>(area.getBottom() + 4));
+
+        g.setColour(juce::Colour(0xff808080));
+        g.drawText(labels[i],
+                   x - 20, area.getBottom() + 4,
+                   40, 16,
+                   juce::Justification::centredTop);
+    }
+}
+
+Waterfall::ColourLut WaterfallDisplay::createColourLut()
+{
+    // Dark-to-bright perceptual ramp: quiet bins fade into the background
+    juce::ColourGradient gradient(juce::Colour(0xff000000), 0.0f, 0.0f,
+                                  juce::Colour(0xfffcffa4), 1.0f, 0.0f, false);
+    gradient.addColour(0.25, juce::Colour(0xff1b0c41));
+    gradient.addColour(0.50, juce::Colour(0xff87216b));
+    gradient.addColour(0.75, juce::Colour(0xfff3761b));
+
+    Waterfall::ColourLut lut;
+    for (int i = 0; i < Waterfall::colourLutSize; ++i)
+    {
+        auto position = static_cast<double>(i) / static_cast<double>(Waterfall::colourLutSize - 1);
+        lut[static_cast<size_t>(i)] = gradient.getColourAtPosition(position).getPixelARGB();
+    }
+
+    return lut;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "TrackManager.h"
+
+/// Scrolling spectrogram stored in a ring-buffered image.
+///
+/// Each pushRow() colours exactly one image row (newest rows are written
+/// upwards), so adding a frame never touches the rest of the history, and
+/// drawing is at most two blits around the wrap point.
+class Waterfall
+{
+public:
+    static constexpr int colourLutSize = 256;
+    using ColourLut = std::array<juce::PixelARGB, colourLutSize>;
+
+    Waterfall(int width, int historyRows);
+
+    /// Writes one row from per-pixel magnitudes (normalized 0-1, width entries).
+    void pushRow(const float* pixelMagnitudes, const ColourLut& lut, float minDb, float maxDb);
+
+    /// Draws the newest rows into area (1:1, no scaling), newest at the top.
+    void draw(juce::Graphics& g, juce::Rectangle<int> area) const;
+
+    int getWidth() const { return width; }
+    int getHistoryRows() const { return historyRows; }
+
+private:
+    int width;
+    int historyRows;
+    int writeRow { 0 };  // Row holding the newest data
+    juce::Image image;
+};
+
+/// Waterfall view of all enabled tracks, plus their power sum, as stacked lanes.
+class WaterfallDisplay : public juce::Component
+{
+public:
+    WaterfallDisplay(TrackManager& trackManager);
+    ~WaterfallDisplay() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+    /// Pulls changed tracks from the TrackManager and scrolls every lane by one row.
+    void refresh();
+
+private:
+    /// Pixel column -> range of FFT bins it covers, for one sample rate.
+    struct PixelBinRange
+    {
+        int startBin;
+        int endBin;  // Exclusive, always > startBin
+    };
+
+    struct Lane
+    {
+        juce::String trackId;
+        juce::String name;
+        juce::Colour colour;
+        std::unique_ptr<Waterfall> waterfall;
+    };
+
+    const std::vector<PixelBinRange>& getPixelBinTable(BinLayout layout, double sampleRate);
+    void syncLanes();
+    void computePixelMagnitudes(const TrackData& track, float* output);
+    void computeSummedPixelMagnitudes(float* output);
+    juce::Rectangle<int> getPlotArea() const;
+    float frequencyToX(float frequency, float width) const;
+    float xToFrequency(float x, float width) const;
+    void drawFrequencyAxis(juce::Graphics& g, juce::Rectangle<int> area);
+
+    static Waterfall::ColourLut createColourLut();
+
+    TrackManager& trackManager;
+    std::vector<TrackData> cachedTracks;
+    juce::uint32 cachedLayoutVersion { 0 };
+
+    Lane sumLane;
+    std::vector<Lane> trackLanes;  // Same order as cachedTracks
+    int laneWidth { 0 };
+
+    std::map<std::pair<BinLayout, double>, std::vector<PixelBinRange>> pixelBinTables;  // Keyed by layout and sample rate
+    std::vector<float> pixelMagnitudes;
+    std::vector<float> summedPower;
+
+    const Waterfall::ColourLut colourLut;
+
+    // Display range (matches SpectrumDisplay)
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDb = -90.0f;
+    static constexpr float maxDb = 0.0f;
+
+    // Total pixel memory for all lanes; bounds how much history each lane keeps
+    static constexpr size_t memoryBudgetBytes = 64 * 1024 * 1024;
+    static constexpr int maxHistoryRows = 2048;
+
+    // Layout margins
+    static constexpr int leftMargin = 10;
+    static constexpr int bottomMargin = 25;
+    static constexpr int topMargin = 10;
+    static constexpr int rightMargin = 10;
+    static constexpr int laneSpacing = 2;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaterfallDisplay)
+};
@@ -0,0 +1,123 @@
+#include "HalfBandDecimator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 32; ++k)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+}
+
+HalfBandDecimator::HalfBandDecimator(int numCoefficientsToUse)
+    : numCoefficients(numCoefficientsToUse),
+      evenHistory(2 * numCoefficientsToUse - 1),
+      oddHistory(numCoefficientsToUse)
+{
+    jassert(numCoefficients > 0 && numCoefficients <= maxCoefficients);
+
+    // Kaiser-windowed sinc at a quarter of the input rate; odd taps only, scaled so the
+    // pairs sum to 0.5 and the whole filter (with its 0.5 centre tap) has unity DC gain
+    constexpr double beta = 8.0;
+    const double halfLength = 2.0 * numCoefficients;
+
+    double sum = 0.0;
+    for (int k = 0; k < numCoefficients; ++k)
+    {
+        const double n = 2.0 * k + 1.0;
+        const double x = juce::MathConstants<double>::pi * n / 2.0;
+        const double window = besselI0(beta * std::sqrt(1.0 - (n / halfLength) * (n / halfLength))) / besselI0(beta);
+        const double tap = 0.5 * std::sin(x) / x * window;
+
+        coefficients[static_cast<size_t>(k)] = static_cast<float>(tap);
+        sum += tap;
+    }
+
+    for (int k = 0; k < numCoefficients; ++k)
+        coefficients[static_cast<size_t>(k)] = static_cast<float>(coefficients[static_cast<size_t>(k)] * 0.25 / sum);
+}
+
+void HalfBandDecimator::reset()
+{
+    even.fill(0.0f);
+    odd.fill(0.0f);
+    hasPendingEven = false;
+}
+
+int HalfBandDecimator::process(const float* input, int numInputSamples, float* output) noexcept
+{
+    int numOutputs = 0;
+    int numPairs = 0;
+    int position = 0;
+
+    // Complete the pair the previous call left open
+    if (hasPendingEven && numInputSamples > 0)
+    {
+        odd[oddHistory] = input[position++];
+        numPairs = 1;
+        hasPendingEven = false;
+    }
+
+    while (numInputSamples - position >= 2)
+    {
+        const int count = juce::jmin((numInputSamples - position) / 2, maxChunkPairs - numPairs);
+        float* evenDest = even.data() + evenHistory + numPairs;
+        float* oddDest = odd.data() + oddHistory + numPairs;
+
+        for (int j = 0; j < count; ++j)
+        {
+            evenDest[j] = input[position + 2 * j];
+            oddDest[j] = input[position + 2 * j + 1];
+        }
+
+        numPairs += count;
+        position += 2 * count;
+
+        if (numPairs == maxChunkPairs)
+        {
+            filterChunk(output + numOutputs, numPairs);
+            numOutputs += numPairs;
+            numPairs = 0;
+        }
+    }
+
+    if (numPairs > 0)
+    {
+        filterChunk(output + numOutputs, numPairs);
+        numOutputs += numPairs;
+    }
+
+    if (position < numInputSamples)
+    {
+        even[evenHistory] = input[position];
+        hasPendingEven = true;
+    }
+
+    return numOutputs;
+}
+
+void HalfBandDecimator::filterChunk(float* output, int numPairs) noexcept
+{
+    // Output m (delayed by 2 * numCoefficients - 1 input samples) is
+    //     0.5 * odd[m - numCoefficients] + sum_k c_k * (even[m - numCoefficients - k] + even[m - numCoefficients + 1 + k])
+    // which, with the histories in front of the chunk, are all contiguous runs
+    juce::FloatVectorOperations::copyWithMultiply(output, odd.data(), 0.5f, numPairs);
+
+    for (int k = 0; k < numCoefficients; ++k)
+    {
+        const float c = coefficients[static_cast<size_t>(k)];
+        juce::FloatVectorOperations::addWithMultiply(output, even.data() + numCoefficients - 1 - k, c, numPairs);
+        juce::FloatVectorOperations::addWithMultiply(output, even.data() + numCoefficients + k, c, numPairs);
+    }
+
+    // Keep what the next chunk reaches back to
+    std::copy(even.begin() + numPairs, even.begin() + numPairs + evenHistory, even.begin());
+    std::copy(odd.begin() + numPairs, odd.begin() + numPairs + oddHistory, odd.begin());
+}
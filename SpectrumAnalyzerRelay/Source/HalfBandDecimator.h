@@ -0,0 +1,43 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+/// Halves the sample rate with a half-band FIR (Kaiser, beta 8). At the default
+/// 47 taps it's flat to within 0.001 dB up to 0.38 of the output rate and below
+/// -80 dB from 0.62; shorter ones widen the transition band around 0.5.
+///
+/// Every other tap of a half-band filter is zero, so each output is the centre
+/// tap times one odd input sample plus numCoefficients symmetric pairs of even
+/// ones. Input is split into even and odd sample streams and filtered a chunk
+/// at a time, one coefficient per pass over contiguous outputs, so the work is
+/// all FloatVectorOperations calls and never branches per sample.
+class HalfBandDecimator
+{
+public:
+    static constexpr int maxCoefficients = 12;  // Non-zero taps per side (4 * n - 1 taps in all)
+
+    explicit HalfBandDecimator(int numCoefficientsToUse = maxCoefficients);
+
+    void reset();
+
+    /// Writes (numInputSamples + pending) / 2 outputs, where pending is 1 if the
+    /// previous call left an odd input sample over. Returns the number written.
+    int process(const float* input, int numInputSamples, float* output) noexcept;
+
+private:
+    static constexpr int maxChunkPairs = 256;
+
+    void filterChunk(float* output, int numPairs) noexcept;
+
+    const int numCoefficients;
+    const int evenHistory;  // Even samples before the chunk the filter reaches back to
+    const int oddHistory;   // Odd samples the centre tap lags by
+
+    std::array<float, maxCoefficients> coefficients {};
+
+    std::array<float, 2 * maxCoefficients - 1 + maxChunkPairs> even {};
+    std::array<float, maxCoefficients + maxChunkPairs> odd {};
+    bool hasPendingEven { false };  // even[evenHistory] holds a sample waiting for its odd partner
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HalfBandDecimator)
+};
@@ -0,0 +1,239 @@
+#include "LoudnessMeter.h"
+#include <cmath>
+
+void LoudnessMeter::prepare(double sampleRate)
+{
+    for (int c = 0; c < maxChannels; ++c)
+    {
+        shelfState1[c] = shelfState2[c] = 0.0f;
+        highPassState1[c] = highPassState2[c] = 0.0f;
+        weightedSum[c] = plainSum[c] = 0.0;
+
+        for (auto& sample : history[c])
+            sample = 0.0f;
+    }
+
+    blockSamples = 0;
+    blockIndex = 0;
+    numBlocks = 0;
+    historyIndex = 0;
+    truePeak = 0.0f;
+
+    blockLength = sampleRate > 0.0 ? juce::roundToInt(sampleRate * 0.1) : 0;
+    if (blockLength == 0)
+        return;
+
+    // BS.1770 K-weighting, redesigned for this rate by the bilinear transform
+    // (the standard only tabulates 48 kHz coefficients)
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+
+        shelf.b0 = static_cast<float>((vh + vb * k / q + k * k) / a0);
+        shelf.b1 = static_cast<float>(2.0 * (k * k - vh) / a0);
+        shelf.b2 = static_cast<float>((vh - vb * k / q + k * k) / a0);
+        shelf.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        shelf.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+
+        const double k = std::tan(juce::MathConstants<double>::pi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+
+        highPass.b0 = 1.0f;
+        highPass.b1 = -2.0f;
+        highPass.b2 = 1.0f;
+        highPass.a1 = static_cast<float>(2.0 * (k * k - 1.0) / a0);
+        highPass.a2 = static_cast<float>((1.0 - k / q + k * k) / a0);
+    }
+
+    // Interpolator: Blackman-windowed sinc cut off at the input's Nyquist frequency,
+    // split into its phases, each normalised to unity gain at DC
+    constexpr int numTaps = oversampling * tapsPerPhase;
+    const double centre = 0.5 * (numTaps - 1);
+
+    for (int phase = 0; phase < oversampling; ++phase)
+    {
+        double sum = 0.0;
+        for (int tap = 0; tap < tapsPerPhase; ++tap)
+        {
+            const int n = phase + oversampling * tap;
+            const double x = (n - centre) / oversampling;
+            const double sinc = std::abs(x) < 1.0e-9 ? 1.0 : std::sin(juce::MathConstants<double>::pi * x)
+                                                                / (juce::MathConstants<double>::pi * x);
+            const double w = 0.42 - 0.5 * std::cos(juce::MathConstants<double>::twoPi * (n + 0.5) / numTaps)
+                           + 0.08 * std::cos(2.0 * juce::MathConstants<double>::twoPi * (n + 0.5) / numTaps);
+
+            // Tap k weights the sample k steps back, which sits at tapsPerPhase - 1 - k in the window
+            phaseCoefficients[phase][tapsPerPhase - 1 - tap] = static_cast<float>(sinc * w);
+            sum += sinc * w;
+        }
+
+        for (auto& coefficient : phaseCoefficients[phase])
+            coefficient = static_cast<float>(coefficient / sum);
+    }
+}
+
+void LoudnessMeter::process(const float* const* channels, int numChannels, int numSamples) noexcept
+{
+    if (blockLength == 0 || numChannels <= 0)
+        return;
+
+    // Mono feeds its one channel to both lanes and mutes the second
+    numActiveChannels = juce::jmin(numChannels, maxChannels);
+    const float* inputs[maxChannels];
+    for (int c = 0; c < maxChannels; ++c)
+    {
+        inputs[c] = channels[juce::jmin(c, numActiveChannels - 1)];
+        laneGain[c] = c < numActiveChannels ? 1.0f : 0.0f;
+    }
+
+    // Split the block where 100 ms blocks end
+    int position = 0;
+    while (position < numSamples)
+    {
+        const int count = juce::jmin(numSamples - position, blockLength - blockSamples);
+        processRun(inputs, position, count);
+
+        position += count;
+        blockSamples += count;
+        if (blockSamples == blockLength)
+            finishBlock();
+    }
+}
+
+void LoudnessMeter::processRun(const float* const* inputs, int start, int numSamples) noexcept
+{
+    // Locals, so the compiler keeps the state in registers across the loop
+    const auto s = shelf;
+    const auto h = highPass;
+    float s1[maxChannels], s2[maxChannels], h1[maxChannels], h2[maxChannels];
+    float weighted[maxChannels] {}, plain[maxChannels] {};
+    float peak = truePeak;
+
+    for (int c = 0; c < maxChannels; ++c)
+    {
+        s1[c] = shelfState1[c];
+        s2[c] = shelfState2[c];
+        h1[c] = highPassState1[c];
+        h2[c] = highPassState2[c];
+    }
+
+    for (int i = start; i < start + numSamples; ++i)
+    {
+        float x[maxChannels];
+        for (int c = 0; c < maxChannels; ++c)
+            x[c] = inputs[c][i] * laneGain[c];
+
+        // K-weighting, both lanes at once
+        for (int c = 0; c < maxChannels; ++c)
+        {
+            const float y = s.b0 * x[c] + s1[c];
+            s1[c] = s.b1 * x[c] - s.a1 * y + s2[c];
+            s2[c] = s.b2 * x[c] - s.a2 * y;
+
+            const float z = h.b0 * y + h1[c];
+            h1[c] = h.b1 * y - h.a1 * z + h2[c];
+            h2[c] = h.b2 * y - h.a2 * z;
+
+            weighted[c] += z * z;
+            plain[c] += x[c] * x[c];
+        }
+
+        // True peak: every interpolated phase between this sample and the previous ones
+        for (int c = 0; c < maxChannels; ++c)
+        {
+            history[c][historyIndex] = x[c];
+            history[c][historyIndex + tapsPerPhase] = x[c];
+            const float* window = history[c] + historyIndex + 1;
+
+            for (int phase = 0; phase < oversampling; ++phase)
+            {
+                float sum = 0.0f;
+                for (int tap = 0; tap < tapsPerPhase; ++tap)
+                    sum += phaseCoefficients[phase][tap] * window[tap];
+
+                peak = juce::jmax(peak, std::abs(sum));
+            }
+
+            peak = juce::jmax(peak, std::abs(x[c]));
+        }
+
+        historyIndex = historyIndex + 1 < tapsPerPhase ? historyIndex + 1 : 0;
+    }
+
+    for (int c = 0; c < maxChannels; ++c)
+    {
+        shelfState1[c] = s1[c];
+        shelfState2[c] = s2[c];
+        highPassState1[c] = h1[c];
+        highPassState2[c] = h2[c];
+        weightedSum[c] += weighted[c];
+        plainSum[c] += plain[c];
+    }
+
+    truePeak = peak;
+}
+
+void LoudnessMeter::finishBlock() noexcept
+{
+    // Channel weights are all 1 for mono and stereo (BS.1770 only weights surrounds)
+    double weighted = 0.0;
+    double plain = 0.0;
+    for (int c = 0; c < maxChannels; ++c)
+    {
+        weighted += weightedSum[c];
+        plain += plainSum[c];
+        weightedSum[c] = 0.0;
+        plainSum[c] = 0.0;
+    }
+
+    blockWeighted[blockIndex] = weighted / blockLength;
+    blockPlain[blockIndex] = plain / (static_cast<double>(blockLength) * numActiveChannels);
+    blockPeak[blockIndex] = truePeak;
+    blockIndex = (blockIndex + 1) % shortTermBlocks;
+    numBlocks = juce::jmin(numBlocks + 1, shortTermBlocks);
+    blockSamples = 0;
+    truePeak = 0.0f;
+}
+
+void LoudnessMeter::getReading(SpectrumMessages::LoudnessReading& reading) const noexcept
+{
+    // Until a window has filled, it covers the blocks there are
+    auto newest = [this](int age) { return (blockIndex - age + shortTermBlocks) % shortTermBlocks; };
+    auto meanOfNewest = [this, &newest](const double* blocks, int count) {
+        count = juce::jmin(count, numBlocks);
+        double sum = 0.0;
+        for (int age = 1; age <= count; ++age)
+            sum += blocks[newest(age)];
+        return count > 0 ? sum / count : 0.0;
+    };
+
+    reading.momentaryLufs = toDb(meanOfNewest(blockWeighted, momentaryBlocks), -0.691f);
+    reading.shortTermLufs = toDb(meanOfNewest(blockWeighted, shortTermBlocks), -0.691f);
+    reading.rmsDb = toDb(meanOfNewest(blockPlain, momentaryBlocks), 0.0f);
+
+    // The block being filled and the ones before it, to cover 400 ms
+    float peak = truePeak;
+    for (int age = 1; age < juce::jmin(momentaryBlocks, numBlocks + 1); ++age)
+        peak = juce::jmax(peak, blockPeak[newest(age)]);
+
+    reading.truePeakDb = toDb(static_cast<double>(peak) * peak, 0.0f);
+}
+
+float LoudnessMeter::toDb(double meanSquare, float offset) noexcept
+{
+    if (meanSquare <= 0.0)
+        return SpectrumMessages::LOUDNESS_FLOOR_DB;
+
+    return juce::jmax(SpectrumMessages::LOUDNESS_FLOOR_DB, offset + static_cast<float>(10.0 * std::log10(meanSquare)));
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumMessages.h"
+
+/// Loudness (ITU-R BS.1770 momentary and short-term), RMS and true peak of the
+/// relay's input, measured in processBlock on the same block as the spectrum.
+///
+/// Both channels of the bus go through the K-weighting biquads together, one
+/// lane each with their filter state side by side, so the per-sample loop is a
+/// fixed pair of independent lanes the compiler can vectorise; a mono bus runs
+/// the second lane at zero gain. Mean squares are kept per 100 ms block:
+/// momentary loudness and RMS cover the last 4 blocks, short-term loudness the
+/// last 30. True peak is the largest magnitude of the signal upsampled 4x by a
+/// 48-tap polyphase FIR (4 phases of 12 taps), over the same 400 ms as momentary
+/// loudness, so a reader sampling less often than every frame misses no peaks.
+///
+/// process() and getReading() are both called from the audio thread, so
+/// nothing is locked or allocated after prepare().
+class LoudnessMeter
+{
+public:
+    static constexpr int maxChannels = 2;
+    static constexpr int oversampling = 4;
+    static constexpr int tapsPerPhase = 12;
+    static constexpr int momentaryBlocks = 4;    // 400 ms
+    static constexpr int shortTermBlocks = 30;   // 3 s
+
+    LoudnessMeter() = default;
+
+    /// Designs the filters for the sample rate and clears all state.
+    void prepare(double sampleRate);
+
+    /// Adds a block. Channels past maxChannels are ignored.
+    void process(const float* const* channels, int numChannels, int numSamples) noexcept;
+
+    /// Current levels.
+    void getReading(SpectrumMessages::LoudnessReading& reading) const noexcept;
+
+private:
+    struct BiquadCoefficients
+    {
+        float b0 { 1.0f }, b1 { 0.0f }, b2 { 0.0f }, a1 { 0.0f }, a2 { 0.0f };
+    };
+
+    void processRun(const float* const* inputs, int start, int numSamples) noexcept;
+    void finishBlock() noexcept;
+    static float toDb(double meanSquare, float offset) noexcept;
+
+    // K-weighting: high shelf (head effects) then high-pass (RLB), transposed direct form II
+    BiquadCoefficients shelf, highPass;
+    float shelfState1[maxChannels] {}, shelfState2[maxChannels] {};
+    float highPassState1[maxChannels] {}, highPassState2[maxChannels] {};
+    float laneGain[maxChannels] {};
+
+    // Sums of squares in the block being filled (K-weighted and unweighted)
+    double weightedSum[maxChannels] {};
+    double plainSum[maxChannels] {};
+    int blockLength { 0 };      // Samples per 100 ms block; 0 until prepared
+    int blockSamples { 0 };
+    int numActiveChannels { 1 };
+
+    // Completed blocks, newest at blockIndex - 1: weighted power summed over channels,
+    // unweighted power averaged over them, and true peak
+    double blockWeighted[shortTermBlocks] {};
+    double blockPlain[shortTermBlocks] {};
+    float blockPeak[shortTermBlocks] {};
+    int blockIndex { 0 };
+    int numBlocks { 0 };
+
+    // True peak: phase coefficients ordered oldest sample first, and each channel's
+    // last tapsPerPhase samples written twice so the window is always contiguous
+    float phaseCoefficients[oversampling][tapsPerPhase] {};
+    float history[maxChannels][2 * tapsPerPhase] {};
+    int historyIndex { 0 };
+    float truePeak { 0.0f };    // Of the block being filled
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LoudnessMeter)
+};
@@ -0,0 +1,180 @@
+#include "MultiResolutionAnalyzer.h"
+#include <algorithm>
+#include <cmath>
+
+MultiResolutionAnalyzer::MultiResolutionAnalyzer()
+{
+    binSources.resize(static_cast<size_t>(SpectrumConstants::NUM_BINS));
+
+    // Hann, normalised like SpectrumProcessor's table (one-sided, coherent gain corrected)
+    AnalysisWindow::fill({}, windowTable.data(), fftSize);
+    const auto properties = AnalysisWindow::measure(windowTable.data(), fftSize);
+    juce::FloatVectorOperations::multiply(windowTable.data(), static_cast<float>(2.0 / (properties.coherentGain * fftSize)), fftSize);
+}
+
+void MultiResolutionAnalyzer::prepare(double sampleRate)
+{
+    reset();
+
+    const auto& grid = getLogBinGrid();
+    constexpr int numStageBins = fftSize / 2;
+
+    for (int bin = 0; bin < SpectrumConstants::NUM_BINS; ++bin)
+    {
+        auto& source = binSources[static_cast<size_t>(bin)];
+        source = {};
+
+        const double low = grid.getBandEdge(bin);
+        const double high = grid.getBandEdge(bin + 1);
+
+        // Walk down from the shortest window: stop at the first stage fine enough for
+        // this bin, or before the first one that can't reach up to it
+        double chosenBinHz = 0.0;
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            const double rate = sampleRate / static_cast<double>(1 << stage);
+            const double limit = stage == 0 ? 0.5 * rate : usableFraction * rate;
+            if (high > limit)
+                break;
+
+            source.stage = stage;
+            chosenBinHz = rate / fftSize;
+
+            if (chosenBinHz <= high - low)
+                break;
+        }
+
+        if (source.stage < 0)
+            continue;  // Above Nyquist for this sample rate: silent
+
+        // Stage bins whose centre falls inside [low, high), as LogFrequencyGrid maps them
+        const int start = juce::jmax(1, static_cast<int>(std::ceil(low / chosenBinHz)));
+        const int end = juce::jmin(numStageBins, static_cast<int>(std::ceil(high / chosenBinHz)));
+
+        if (end > start)
+        {
+            source.start = start;
+            source.count = end - start;
+        }
+        else
+        {
+            const double centre = juce::jmin(grid.getBandCentre(bin) / chosenBinHz, numStageBins - 1.001);
+            source.start = static_cast<int>(centre);
+            source.fraction = static_cast<float>(centre - source.start);
+        }
+    }
+}
+
+void MultiResolutionAnalyzer::reset()
+{
+    for (auto& stage : stages)
+    {
+        stage.buffer.fill(0.0f);
+        stage.magnitudes.fill(0.0f);
+        stage.writeIndex = 0;
+        stage.samplesSinceHop = 0;
+    }
+
+    for (auto& decimator : decimators)
+        decimator.reset();
+}
+
+int MultiResolutionAnalyzer::process(const float* input, int numSamples) noexcept
+{
+    int numFrames = 0;
+
+    // Chunks bound the decimated block sizes, so the scratch buffers are fixed
+    for (int position = 0; position < numSamples; position += maxChunkSize)
+    {
+        const int chunkSize = juce::jmin(maxChunkSize, numSamples - position);
+
+        // Each stage decimates the one above it before that one runs its hops, so the
+        // stitch at a full-rate hop sees every stage up to date with the same block
+        const float* stageInput = input + position;
+        int stageSamples = chunkSize;
+        std::array<const float*, numStages> inputs {};
+        std::array<int, numStages> sizes {};
+
+        for (int stage = 0; stage < numStages; ++stage)
+        {
+            inputs[static_cast<size_t>(stage)] = stageInput;
+            sizes[static_cast<size_t>(stage)] = stageSamples;
+
+            if (stage + 1 < numStages)
+            {
+                auto& output = decimated[static_cast<size_t>(stage)];
+                stageSamples = decimators[static_cast<size_t>(stage)].process(stageInput, stageSamples, output.data());
+                stageInput = output.data();
+            }
+        }
+
+        const int hopsBefore = stages[0].samplesSinceHop;
+        for (int stage = numStages - 1; stage >= 0; --stage)
+            pushSamples(stage, inputs[static_cast<size_t>(stage)], sizes[static_cast<size_t>(stage)]);
+
+        numFrames += (hopsBefore + chunkSize) / hopSize;
+    }
+
+    return numFrames;
+}
+
+void MultiResolutionAnalyzer::pushSamples(int stageIndex, const float* samples, int numSamples) noexcept
+{
+    auto& stage = stages[static_cast<size_t>(stageIndex)];
+
+    // Runs up to the next hop, each copied in at most two pieces around the wrap
+    int position = 0;
+    while (position < numSamples)
+    {
+        const int count = juce::jmin(numSamples - position, hopSize - stage.samplesSinceHop);
+        const int firstPart = juce::jmin(count, fftSize - stage.writeIndex);
+
+        juce::FloatVectorOperations::copy(stage.buffer.data() + stage.writeIndex, samples + position, firstPart);
+        juce::FloatVectorOperations::copy(stage.buffer.data(), samples + position + firstPart, count - firstPart);
+
+        stage.writeIndex = (stage.writeIndex + count) % fftSize;
+        stage.samplesSinceHop += count;
+        position += count;
+
+        if (stage.samplesSinceHop == hopSize)
+        {
+            computeSpectrum(stage);
+            stage.samplesSinceHop = 0;
+        }
+    }
+}
+
+void MultiResolutionAnalyzer::computeSpectrum(Stage& stage) noexcept
+{
+    // Oldest sample first: the write index is where the next one would go. Windowed
+    // and normalised on the way into the FFT buffer, as in SpectrumProcessor
+    const int firstPart = fftSize - stage.writeIndex;
+    juce::FloatVectorOperations::multiply(fftData.data(), stage.buffer.data() + stage.writeIndex, windowTable.data(), firstPart);
+    juce::FloatVectorOperations::multiply(fftData.data() + firstPart, stage.buffer.data(), windowTable.data() + firstPart,
+                                          stage.writeIndex);
+
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+    juce::FloatVectorOperations::copy(stage.magnitudes.data(), fftData.data(), static_cast<int>(stage.magnitudes.size()));
+}
+
+void MultiResolutionAnalyzer::getSpectrum(float* output) const noexcept
+{
+    for (size_t bin = 0; bin < binSources.size(); ++bin)
+    {
+        const auto& source = binSources[bin];
+        float value = 0.0f;
+
+        if (source.stage >= 0)
+        {
+            const float* magnitudes = stages[static_cast<size_t>(source.stage)].magnitudes.data();
+
+            if (source.count > 0)
+                value = juce::FloatVectorOperations::findMaximum(magnitudes + source.start, source.count);
+            else
+                value = magnitudes[source.start] * (1.0f - source.fraction)
+                      + magnitudes[source.start + 1] * source.fraction;
+        }
+
+        output[bin] = value;
+    }
+}
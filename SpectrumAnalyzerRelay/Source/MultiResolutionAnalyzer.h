@@ -0,0 +1,92 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "HalfBandDecimator.h"
+#include "../../Common/SpectrumData.h"
+#include "../../Common/LogFrequencyGrid.h"
+#include "../../Common/AnalysisWindow.h"
+
+/// Spectrum with fine resolution at the low end and short windows at the top,
+/// stitched onto the NUM_BINS log-spaced bins of BinLayout::Log.
+///
+/// The input runs through a cascade of half-band decimators, and each stage
+/// (full rate, 1/2, ... 1/16) has its own 1024-point FFT with 50% overlap, so
+/// every stage's window is twice as long as the one above and its bins twice as
+/// fine: ~43 Hz at the top, ~2.7 Hz at the bottom (8x finer than one 2048-point
+/// FFT). Each output bin takes the shortest-window stage whose bins are no wider
+/// than it, or failing that the finest stage that still covers it; a bin wider
+/// than its stage's bins gets their peak, a narrower one interpolates.
+///
+/// Lower stages run at a fraction of the rate, so a frame costs 1 + 1/2 + ... +
+/// 1/16 = 1.94 FFTs of 1024 points (together a bit under one 2048-point FFT),
+/// plus the decimators at about 13 multiply-adds per input sample.
+///
+/// Magnitudes are normalised like SpectrumProcessor's, so a sine reads the same
+/// level in either analysis; broadband noise reads lower where the bins are
+/// narrower, as it would in any finer analysis.
+class MultiResolutionAnalyzer
+{
+public:
+    static constexpr int numStages = 5;
+    static constexpr int fftOrder = 10;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;   // In each stage's own samples; at full rate, every 512 input samples
+
+    MultiResolutionAnalyzer();
+
+    /// Builds the stitching table for the sample rate and clears all state.
+    void prepare(double sampleRate);
+
+    /// Clears the stages' buffers and spectra (e.g. when switching analysis).
+    void reset();
+
+    /// Adds input samples. Returns the number of output frames completed, i.e.
+    /// full-rate stage hops; the newest ended getSamplesSinceLastFrame() samples
+    /// before the end of the block.
+    int process(const float* input, int numSamples) noexcept;
+
+    int getSamplesSinceLastFrame() const { return stages[0].samplesSinceHop; }
+
+    /// Stitches the stages' newest spectra into NUM_BINS log-layout magnitudes.
+    void getSpectrum(float* output) const noexcept;
+
+private:
+    struct Stage
+    {
+        std::array<float, fftSize> buffer {};   // Circular
+        int writeIndex { 0 };
+        int samplesSinceHop { 0 };
+        std::array<float, fftSize / 2> magnitudes {};
+    };
+
+    /// Where an output bin comes from: peak of count bins from start, or (count 0)
+    /// interpolated between start and start + 1. stage < 0 = silent (above Nyquist).
+    struct BinSource
+    {
+        int stage { -1 };
+        int start { 0 };
+        int count { 0 };
+        float fraction { 0.0f };
+    };
+
+    void pushSamples(int stageIndex, const float* samples, int numSamples) noexcept;
+    void computeSpectrum(Stage& stage) noexcept;
+
+    // Stitched bins are only taken from a decimated stage up to this fraction of its
+    // rate, inside the half-band filter's flat passband
+    static constexpr double usableFraction = 0.35;
+
+    static constexpr int maxChunkSize = 512;
+
+    std::array<Stage, numStages> stages;
+    std::array<HalfBandDecimator, numStages - 1> decimators;
+    std::array<std::array<float, maxChunkSize / 2 + 1>, numStages - 1> decimated {};
+
+    juce::dsp::FFT fft { fftOrder };
+    alignas(32) std::array<float, fftSize> windowTable {};   // Hann with the normalisation folded in
+    alignas(32) std::array<float, fftSize * 2> fftData {};
+
+    std::vector<BinSource> binSources;  // NUM_BINS entries
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MultiResolutionAnalyzer)
+};
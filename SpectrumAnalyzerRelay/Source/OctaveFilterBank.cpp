@@ -0,0 +1,253 @@
+#include "OctaveFilterBank.h"
+#include <cmath>
+#include <complex>
+
+namespace
+{
+    struct BandPassSection
+    {
+        float b0, a1, a2;
+    };
+
+    /// 4th-order Butterworth band-pass between two edges, as two biquads. The low-pass
+    /// prototype pole maps to two band-pass poles, each of which (with its conjugate)
+    /// makes one section b0 * (1 - z^-2) / (1 + a1 z^-1 + a2 z^-2); the edges are
+    /// prewarped, so the bilinear transform leaves them at -3 dB and the centre at 0 dB.
+    void designBandPass(double lowEdge, double highEdge, double rate, BandPassSection& first, BandPassSection& second)
+    {
+        const double pi = juce::MathConstants<double>::pi;
+        const double k = 2.0 * rate;
+        const double low = k * std::tan(pi * lowEdge / rate);
+        const double high = k * std::tan(pi * highEdge / rate);
+        const double bandwidth = high - low;
+
+        // Roots of s^2 - p * bandwidth * s + low * high = 0 for the prototype pole p
+        const std::complex<double> p(-juce::MathConstants<double>::sqrt2 / 2.0, juce::MathConstants<double>::sqrt2 / 2.0);
+        const auto pb = p * bandwidth;
+        const auto root = std::sqrt(pb * pb - 4.0 * low * high);
+        const std::complex<double> poles[] = { 0.5 * (pb + root), 0.5 * (pb - root) };
+
+        BandPassSection* sections[] = { &first, &second };
+        for (int i = 0; i < 2; ++i)
+        {
+            // Analog section bandwidth * s / (s^2 + c1 s + c0)
+            const double c1 = -2.0 * poles[i].real();
+            const double c0 = std::norm(poles[i]);
+            const double d0 = k * k + c1 * k + c0;
+
+            sections[i]->b0 = static_cast<float>(bandwidth * k / d0);
+            sections[i]->a1 = static_cast<float>(2.0 * (c0 - k * k) / d0);
+            sections[i]->a2 = static_cast<float>((k * k - c1 * k + c0) / d0);
+        }
+    }
+}
+
+void OctaveFilterBank::prepare(double sampleRate, int bandsPerOctaveToUse) noexcept
+{
+    jassert(OctaveBands::isValidBandsPerOctave(bandsPerOctaveToUse));
+
+    bandsPerOctave = bandsPerOctaveToUse;
+    frameInterval = juce::jmax(1, juce::roundToInt(sampleRate / framesPerSecond));
+
+    for (auto& stage : stages)
+        stage = {};
+
+    // Bands are assigned lowest first, so a stage's lanes are in band order
+    numActiveBands = 0;
+    numStages = 1;
+    std::array<int, maxStages> bandsInStage {};
+
+    for (int band = 0; band < OctaveBands::getNumBands(bandsPerOctave); ++band)
+    {
+        const double lowEdge = OctaveBands::getBandEdge(bandsPerOctave, band, -1);
+        const double highEdge = OctaveBands::getBandEdge(bandsPerOctave, band, 1);
+        if (highEdge >= 0.45 * sampleRate)
+            break;
+
+        int stageIndex = 0;
+        while (stageIndex + 1 < maxStages
+               && highEdge <= 0.25 * sampleRate / static_cast<double>(1 << (2 * (stageIndex + 1))))
+            ++stageIndex;
+
+        const int lane = bandsInStage[static_cast<size_t>(stageIndex)]++;
+        jassert(lane < maxLanes);
+
+        auto& stage = stages[static_cast<size_t>(stageIndex)];
+        const double rate = sampleRate / static_cast<double>(1 << (2 * stageIndex));
+        const auto group = static_cast<size_t>(lane / lanesPerGroup);
+        const auto element = static_cast<size_t>(lane % lanesPerGroup);
+
+        BandPassSection first, second;
+        designBandPass(lowEdge, highEdge, rate, first, second);
+        stage.b0First[group].set(element, first.b0);
+        stage.a1First[group].set(element, first.a1);
+        stage.a2First[group].set(element, first.a2);
+        stage.b0Second[group].set(element, second.b0);
+        stage.a1Second[group].set(element, second.a1);
+        stage.a2Second[group].set(element, second.a2);
+
+        const double timeConstant = juce::jmax(0.01, 3.0 / OctaveBands::getCentreFrequency(bandsPerOctave, band));
+        stage.envelopeCoefficient[group].set(element, static_cast<float>(1.0 - std::exp(-1.0 / (timeConstant * rate))));
+
+        bandSlots[static_cast<size_t>(band)] = { stageIndex, lane };
+        numStages = juce::jmax(numStages, stageIndex + 1);
+        ++numActiveBands;
+    }
+
+    // Padding lanes keep all-zero coefficients and so stay silent
+    for (int i = 0; i < numStages; ++i)
+        stages[static_cast<size_t>(i)].numGroups = (bandsInStage[static_cast<size_t>(i)] + lanesPerGroup - 1) / lanesPerGroup;
+
+    reset();
+}
+
+void OctaveFilterBank::reset() noexcept
+{
+    const auto zero = Vec::expand(0.0f);
+    for (auto& stage : stages)
+    {
+        stage.z1First.fill(zero);
+        stage.z2First.fill(zero);
+        stage.z1Second.fill(zero);
+        stage.z2Second.fill(zero);
+        stage.envelope.fill(zero);
+    }
+
+    for (auto& decimator : firstHalves)
+        decimator.reset();
+
+    for (auto& decimator : secondHalves)
+        decimator.reset();
+
+    for (auto& levels : frameLevels)
+        levels.fill(0.0f);
+
+    numBlockFrames = 0;
+    newestFrame = 0;
+    samplesSinceFrame = 0;
+}
+
+int OctaveFilterBank::process(const float* input, int numSamples) noexcept
+{
+    int numFrames = 0;
+    int position = 0;
+
+    // Chunks end on frame boundaries, so each frame reads every stage up to that sample
+    while (position < numSamples)
+    {
+        const int chunkSize = juce::jmin(maxChunkSize, numSamples - position, frameInterval - samplesSinceFrame);
+        processChunk(input + position, chunkSize);
+
+        position += chunkSize;
+        samplesSinceFrame += chunkSize;
+
+        if (samplesSinceFrame == frameInterval)
+        {
+            // Every frame of the block is kept, so none is lost to a block longer than the interval
+            newestFrame = numFrames % maxFramesPerBlock;
+            auto& levels = frameLevels[static_cast<size_t>(newestFrame)];
+
+            for (int band = 0; band < numActiveBands; ++band)
+            {
+                const auto& slot = bandSlots[static_cast<size_t>(band)];
+                levels[static_cast<size_t>(band)] = stages[static_cast<size_t>(slot.stage)]
+                                                        .envelope[static_cast<size_t>(slot.lane / lanesPerGroup)]
+                                                        .get(static_cast<size_t>(slot.lane % lanesPerGroup));
+            }
+
+            frameEnds[static_cast<size_t>(newestFrame)] = position;
+            samplesSinceFrame = 0;
+            ++numFrames;
+        }
+    }
+
+    numBlockFrames = numFrames;
+    return numFrames;
+}
+
+void OctaveFilterBank::processChunk(const float* input, int numSamples) noexcept
+{
+    const float* stageInput = input;
+    int stageSamples = numSamples;
+
+    for (int i = 0; i < numStages; ++i)
+    {
+        if (i > 0)
+        {
+            const auto d = static_cast<size_t>(i - 1);
+            stageSamples = firstHalves[d].process(stageInput, stageSamples, halfRate[d].data());
+            stageSamples = secondHalves[d].process(halfRate[d].data(), stageSamples, quarterRate[d].data());
+            stageInput = quarterRate[d].data();
+        }
+
+        processStage(stages[static_cast<size_t>(i)], stageInput, stageSamples);
+    }
+}
+
+void OctaveFilterBank::processStage(Stage& stage, const float* input, int numSamples) noexcept
+{
+    // Transposed direct form II with b1 = 0, b2 = -b0. Every lane sees the same input
+    // sample, so each line is one operation on a whole register of bands; the state
+    // stays in registers for the block
+    const auto zero = Vec::expand(0.0f);
+
+    for (size_t group = 0; group < static_cast<size_t>(stage.numGroups); ++group)
+    {
+        const Vec b0First = stage.b0First[group], a1First = stage.a1First[group], a2First = stage.a2First[group];
+        const Vec b0Second = stage.b0Second[group], a1Second = stage.a1Second[group], a2Second = stage.a2Second[group];
+        const Vec coefficient = stage.envelopeCoefficient[group];
+
+        Vec z1First = stage.z1First[group], z2First = stage.z2First[group];
+        Vec z1Second = stage.z1Second[group], z2Second = stage.z2Second[group];
+        Vec envelope = stage.envelope[group];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const Vec x = Vec::expand(input[i]);
+
+            const Vec y = b0First * x + z1First;
+            z1First = z2First - a1First * y;
+            z2First = zero - b0First * x - a2First * y;
+
+            const Vec w = b0Second * y + z1Second;
+            z1Second = z2Second - a1Second * w;
+            z2Second = zero - b0Second * y - a2Second * w;
+
+            envelope += coefficient * (w * w - envelope);
+        }
+
+        stage.z1First[group] = z1First;
+        stage.z2First[group] = z2First;
+        stage.z1Second[group] = z1Second;
+        stage.z2Second[group] = z2Second;
+        stage.envelope[group] = envelope;
+    }
+}
+
+void OctaveFilterBank::getLevels(float* levels) const noexcept
+{
+    const auto& meanSquares = frameLevels[static_cast<size_t>(newestFrame)];
+
+    // Mean square to the amplitude of a sine with that power
+    for (int band = 0; band < numActiveBands; ++band)
+        levels[band] = std::sqrt(2.0f * meanSquares[static_cast<size_t>(band)]);
+}
+
+void OctaveFilterBank::getBlockFrameLevels(int frame, float* levels) const noexcept
+{
+    const auto& meanSquares = frameLevels[static_cast<size_t>(getFrameSlot(frame))];
+
+    for (int band = 0; band < numActiveBands; ++band)
+        levels[band] = std::sqrt(2.0f * meanSquares[static_cast<size_t>(band)]);
+}
+
+int OctaveFilterBank::getBlockFrameEnd(int frame) const noexcept
+{
+    return frameEnds[static_cast<size_t>(getFrameSlot(frame))];
+}
+
+int OctaveFilterBank::getFrameSlot(int frame) const noexcept
+{
+    jassert(frame >= 0 && frame < getNumBlockFrames());
+    return (numBlockFrames - getNumBlockFrames() + frame) % maxFramesPerBlock;
+}
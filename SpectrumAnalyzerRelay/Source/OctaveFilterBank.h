@@ -0,0 +1,132 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "HalfBandDecimator.h"
+#include "../../Common/OctaveBands.h"
+
+/// Low-latency alternative to the FFT analysis: a 1/3- or 1/6-octave band-pass
+/// filterbank with an envelope follower per band, read out as an OctaveBands
+/// frame at a fixed rate.
+///
+/// Each band is a 4th-order Butterworth band-pass (two biquads, -3 dB at the band
+/// edges). Bands run in stages of decreasing rate: the input is decimated by 4
+/// (two half-band decimators) per stage, and each band runs in the lowest-rate
+/// stage where its top edge is still within a quarter of the rate. That keeps the
+/// low bands' poles well away from z = 1 in single precision, and since every
+/// stage below the first covers two octaves at a quarter of the rate, the whole
+/// bank costs about as much as the top stage.
+///
+/// Within a stage, the bands' filter and envelope states are stored structure-of-
+/// arrays in SIMD registers, one band per lane (padded with silent lanes), and
+/// each register of bands runs through a whole block at a time with no branches.
+/// The envelopes follow band power with a time constant of 10 ms, or 3 periods of
+/// the band centre where that is longer, so the low bands don't ripple at twice
+/// their frequency.
+class OctaveFilterBank
+{
+public:
+    static constexpr int maxStages = 6;
+    static constexpr int maxLanes = 24;   // Bands in one stage, padded; the first stage holds up to ~3 octaves
+    static constexpr int framesPerSecond = 100;
+    static constexpr int maxFramesPerBlock = 32;   // 320 ms; longer blocks keep their newest frames
+
+    OctaveFilterBank() = default;
+
+    /// Designs the bank for a sample rate and resolution (3 or 6 bands per octave)
+    /// and clears all state. Doesn't allocate, so the audio thread can switch resolution.
+    void prepare(double sampleRate, int bandsPerOctave) noexcept;
+
+    void reset() noexcept;
+
+    int getBandsPerOctave() const { return bandsPerOctave; }
+
+    /// Bands below the Nyquist limit, i.e. the size of the frames this produces.
+    int getNumActiveBands() const { return numActiveBands; }
+
+    /// Adds input samples. Returns the number of frames completed; the newest ended
+    /// getSamplesSinceLastFrame() samples before the end of the block.
+    int process(const float* input, int numSamples) noexcept;
+
+    int getSamplesSinceLastFrame() const { return samplesSinceFrame; }
+
+    /// Band levels of the newest frame (getNumActiveBands() values, lowest band first).
+    void getLevels(float* levels) const noexcept;
+
+    /// Frames of the last process() call that can still be read, oldest first: all of
+    /// them, unless the block held more than maxFramesPerBlock.
+    int getNumBlockFrames() const { return juce::jmin(numBlockFrames, maxFramesPerBlock); }
+
+    /// Band levels of one of the last block's frames (0 = oldest, see getNumBlockFrames()).
+    void getBlockFrameLevels(int frame, float* levels) const noexcept;
+
+    /// Where one of the last block's frames ended, in samples from the start of the block.
+    int getBlockFrameEnd(int frame) const noexcept;
+
+private:
+    using Vec = juce::dsp::SIMDRegister<float>;
+    static constexpr int lanesPerGroup = static_cast<int>(Vec::SIMDNumElements);
+    static constexpr int maxGroups = maxLanes / lanesPerGroup;
+    static_assert(maxLanes % lanesPerGroup == 0, "Lanes must fill whole registers");
+
+    /// One stage's bands, a register of lanes per group. Each band-pass section has b1 = 0 and b2 = -b0.
+    struct Stage
+    {
+        int numGroups { 0 };
+        std::array<Vec, maxGroups> b0First {}, a1First {}, a2First {};
+        std::array<Vec, maxGroups> b0Second {}, a1Second {}, a2Second {};
+        std::array<Vec, maxGroups> envelopeCoefficient {};
+
+        std::array<Vec, maxGroups> z1First {}, z2First {}, z1Second {}, z2Second {};
+        std::array<Vec, maxGroups> envelope {};   // Mean square
+    };
+
+    /// Where a band runs.
+    struct BandSlot
+    {
+        int stage { 0 };
+        int lane { 0 };
+    };
+
+    static void processStage(Stage& stage, const float* input, int numSamples) noexcept;
+    void processChunk(const float* input, int numSamples) noexcept;
+
+    static constexpr int maxChunkSize = 512;
+
+    int bandsPerOctave { 3 };
+    int numActiveBands { 0 };
+    int numStages { 1 };
+    int frameInterval { 441 };
+    int samplesSinceFrame { 0 };
+
+    std::array<Stage, maxStages> stages;
+    std::array<BandSlot, OctaveBands::MAX_BANDS> bandSlots {};
+    // Mean square at each frame of the last block, a ring of maxFramesPerBlock
+    std::array<std::array<float, OctaveBands::MAX_BANDS>, maxFramesPerBlock> frameLevels {};
+    std::array<int, maxFramesPerBlock> frameEnds {};
+    int numBlockFrames { 0 };
+    int newestFrame { 0 };
+
+    int getFrameSlot(int frame) const noexcept;
+
+    // A pair per stage below the first, decimating by 4. Only the bottom quarter of each
+    // stage's band is used, so the first half-band only has to keep aliases out of that
+    // (15 taps) and the second has until 0.75 of its output rate to stop (23 taps)
+    static constexpr int firstHalfCoefficients = 4;
+    static constexpr int secondHalfCoefficients = 6;
+    static_assert(maxStages == 6, "One decimator per stage below the first in each list");
+
+    std::array<HalfBandDecimator, maxStages - 1> firstHalves {
+        HalfBandDecimator { firstHalfCoefficients }, HalfBandDecimator { firstHalfCoefficients },
+        HalfBandDecimator { firstHalfCoefficients }, HalfBandDecimator { firstHalfCoefficients },
+        HalfBandDecimator { firstHalfCoefficients }
+    };
+    std::array<HalfBandDecimator, maxStages - 1> secondHalves {
+        HalfBandDecimator { secondHalfCoefficients }, HalfBandDecimator { secondHalfCoefficients },
+        HalfBandDecimator { secondHalfCoefficients }, HalfBandDecimator { secondHalfCoefficients },
+        HalfBandDecimator { secondHalfCoefficients }
+    };
+    std::array<std::array<float, maxChunkSize / 2 + 1>, maxStages - 1> halfRate {};
+    std::array<std::array<float, maxChunkSize / 4 + 1>, maxStages - 1> quarterRate {};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OctaveFilterBank)
+};
@@ -66,11 +66,80 @@ SpectrumAnalyzerRelayAudioProcessorEditor::SpectrumAnalyzerRelayAudioProcessorEd
     };
     addAndMakeVisible(oscPortEditor);
 
+    // Analysis: one 2048-point FFT, multi-resolution (finer low end, log bins), or a
+    // low-latency octave filterbank. Item ids are the processor's AnalysisMode + 1
+    analysisLabel.setText("Analysis:", juce::dontSendNotification);
+    addAndMakeVisible(analysisLabel);
+
+    analysisCombo.addItem("FFT 2048", 1);
+    analysisCombo.addItem("Multi-resolution", 2);
+    analysisCombo.addItem("1/3 octave bank", 3);
+    analysisCombo.addItem("1/6 octave bank", 4);
+    analysisCombo.setSelectedId(static_cast<int>(audioProcessor.getAnalysisMode()) + 1, juce::dontSendNotification);
+    analysisCombo.onChange = [this]()
+    {
+        using Mode = SpectrumAnalyzerRelayAudioProcessor::AnalysisMode;
+        audioProcessor.setAnalysisMode(static_cast<Mode>(analysisCombo.getSelectedId() - 1));
+        updateWindowControls();
+        sendModeCombo.setEnabled(audioProcessor.getAnalysisMode() == Mode::Fft);
+    };
+    addAndMakeVisible(analysisCombo);
+
+    // FFT window. Item ids are AnalysisWindow::Type + 1
+    windowLabel.setText("Window:", juce::dontSendNotification);
+    addAndMakeVisible(windowLabel);
+
+    for (int type = 0; type < AnalysisWindow::NUM_TYPES; ++type)
+        windowCombo.addItem(AnalysisWindow::getName(static_cast<AnalysisWindow::Type>(type)), type + 1);
+
+    windowCombo.setSelectedId(static_cast<int>(audioProcessor.getWindow().type) + 1, juce::dontSendNotification);
+    windowCombo.onChange = [this]()
+    {
+        auto choice = audioProcessor.getWindow();
+        choice.type = static_cast<AnalysisWindow::Type>(windowCombo.getSelectedId() - 1);
+        audioProcessor.setWindow(choice);
+        updateWindowControls();
+    };
+    addAndMakeVisible(windowCombo);
+
+    // Kaiser beta (indented under the window): higher trades a wider main lobe for lower sidelobes
+    kaiserBetaLabel.setText("Beta:", juce::dontSendNotification);
+    addAndMakeVisible(kaiserBetaLabel);
+
+    kaiserBetaSlider.setSliderStyle(juce::Slider::LinearHorizontal);
+    kaiserBetaSlider.setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+    kaiserBetaSlider.setRange(0.0, static_cast<double>(AnalysisWindow::MAX_KAISER_BETA), 0.1);
+    kaiserBetaSlider.setValue(audioProcessor.getWindow().kaiserBeta, juce::dontSendNotification);
+    kaiserBetaSlider.onValueChange = [this]()
+    {
+        auto choice = audioProcessor.getWindow();
+        choice.kaiserBeta = static_cast<float>(kaiserBetaSlider.getValue());
+        audioProcessor.setWindow(choice);
+    };
+    addAndMakeVisible(kaiserBetaSlider);
+
+    updateWindowControls();
+
+    // Send mode: every bin, or peaks only (for tonal tracks, ~10x less bandwidth)
+    sendModeLabel.setText("Send:", juce::dontSendNotification);
+    addAndMakeVisible(sendModeLabel);
+
+    sendModeCombo.addItem("Full spectrum", 1);
+    sendModeCombo.addItem("Peaks only", 2);
+    sendModeCombo.setSelectedId(audioProcessor.isPeakMode() ? 2 : 1, juce::dontSendNotification);
+    sendModeCombo.onChange = [this]()
+    {
+        audioProcessor.setPeakMode(sendModeCombo.getSelectedId() == 2);
+    };
+
+    // Peaks are found on FFT bins only
+    sendModeCombo.setEnabled(audioProcessor.getAnalysisMode() == SpectrumAnalyzerRelayAudioProcessor::AnalysisMode::Fft);
+    addAndMakeVisible(sendModeCombo);
 
     // Start timer to refresh DAW track name (in case DAW provides it after editor is created)
     startTimerHz(2);  // Check twice per second
 
-    setSize(300, 210);
+    setSize(300, 330);
 }
 
 SpectrumAnalyzerRelayAudioProcessorEditor::~SpectrumAnalyzerRelayAudioProcessorEditor()
@@ -113,6 +182,43 @@ void SpectrumAnalyzerRelayAudioProcessorEditor::resized()
     row = area.removeFromTop(24);
     oscPortLabel.setBounds(row.removeFromLeft(80));
     oscPortEditor.setBounds(row.removeFromLeft(70));
+
+    area.removeFromTop(6);
+
+    // Analysis
+    row = area.removeFromTop(24);
+    analysisLabel.setBounds(row.removeFromLeft(80));
+    analysisCombo.setBounds(row.removeFromLeft(130));
+
+    area.removeFromTop(6);
+
+    // Window
+    row = area.removeFromTop(24);
+    windowLabel.setBounds(row.removeFromLeft(80));
+    windowCombo.setBounds(row.removeFromLeft(130));
+
+    area.removeFromTop(2);
+
+    // Kaiser beta (indented)
+    row = area.removeFromTop(24);
+    row.removeFromLeft(20);  // Indent
+    kaiserBetaLabel.setBounds(row.removeFromLeft(60));
+    kaiserBetaSlider.setBounds(row);
+
+    area.removeFromTop(6);
+
+    // Send mode
+    row = area.removeFromTop(24);
+    sendModeLabel.setBounds(row.removeFromLeft(80));
+    sendModeCombo.setBounds(row.removeFromLeft(130));
+}
+
+void SpectrumAnalyzerRelayAudioProcessorEditor::updateWindowControls()
+{
+    // The window only applies to the single FFT, and beta only to Kaiser
+    const bool fft = audioProcessor.getAnalysisMode() == SpectrumAnalyzerRelayAudioProcessor::AnalysisMode::Fft;
+    windowCombo.setEnabled(fft);
+    kaiserBetaSlider.setEnabled(fft && audioProcessor.getWindow().type == AnalysisWindow::Type::Kaiser);
 }
 
 void SpectrumAnalyzerRelayAudioProcessorEditor::timerCallback()
@@ -15,6 +15,7 @@ public:
 
 private:
     void timerCallback() override;
+    void updateWindowControls();
     SpectrumAnalyzerRelayAudioProcessor& audioProcessor;
 
     juce::Label titleLabel;
@@ -29,5 +30,16 @@ private:
     juce::Label oscPortLabel;
     juce::TextEditor oscPortEditor;
 
+    juce::Label analysisLabel;
+    juce::ComboBox analysisCombo;
+
+    juce::Label windowLabel;
+    juce::ComboBox windowCombo;
+    juce::Label kaiserBetaLabel;
+    juce::Slider kaiserBetaSlider;
+
+    juce::Label sendModeLabel;
+    juce::ComboBox sendModeCombo;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyzerRelayAudioProcessorEditor)
 };
@@ -19,6 +19,10 @@ SpectrumAnalyzerRelayAudioProcessor::SpectrumAnalyzerRelayAudioProcessor()
     // Default names
     dawTrackName = "Track " + trackId.substring(0, 8);
     customTrackName = "Track " + trackId.substring(0, 8);
+
+    // Peak and octave modes fill these on the audio thread, so they must never need to grow there
+    peakFrame.peaks.reserve(SpectrumConstants::MAX_SENT_PEAKS);
+    bandFrame.levels.reserve(OctaveBands::MAX_BANDS);
     
     // Start heartbeat timer
     startTimer(SpectrumConstants::HEARTBEAT_INTERVAL_MS);
@@ -96,6 +100,8 @@ void SpectrumAnalyzerRelayAudioProcessor::prepareToPlay(double sampleRate, int s
 {
     juce::ignoreUnused(samplesPerBlock);
     spectrumProcessor.prepare(sampleRate);
+    loudnessMeter.prepare(sampleRate);
+    filterBankActive = false;  // Redesigned for the new rate on the next block that needs it
     connectOSC();
 }
 
@@ -129,6 +135,11 @@ void SpectrumAnalyzerRelayAudioProcessor::processBlock(juce::AudioBuffer<float>&
     juce::ignoreUnused(midiMessages);
     juce::ScopedNoDenormals noDenormals;
 
+    // CPU accounting: the whole call, and the analysis frames computed within it
+    const auto blockStartTicks = juce::Time::getHighResolutionTicks();
+    const auto fftTicksBefore = spectrumProcessor.getFFTTicks() + filterBankTicks;
+    const auto numFFTsBefore = spectrumProcessor.getNumFFTs() + numFilterBankFrames;
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -136,16 +147,31 @@ void SpectrumAnalyzerRelayAudioProcessor::processBlock(juce::AudioBuffer<float>&
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    // Process FFT if relay is enabled
+    // Analyse if relay is enabled
     if (relayEnabled.load() && totalNumInputChannels > 0)
     {
+        // Stamp frames with when this block arrived and where it sits on the host timeline
+        const juce::int64 blockTimeUs = SpectrumMessages::getMonotonicTimeMicroseconds();
+        juce::int64 blockSamplePosition = -1;
+        if (auto* playHead = getPlayHead())
+        {
+            if (auto position = playHead->getPosition())
+            {
+                if (auto timeInSamples = position->getTimeInSamples())
+                    blockSamplePosition = *timeInSamples;
+            }
+        }
+
+        // Metering per channel, before the mono sum below, while the block is still in cache
+        loudnessMeter.process(buffer.getArrayOfReadPointers(), totalNumInputChannels, buffer.getNumSamples());
+
         // For stereo, sum both channels to mono for analysis
         // For mono, just use the single channel
         if (totalNumInputChannels == 1)
         {
             // Mono input
             const float* channelData = buffer.getReadPointer(0);
-            spectrumProcessor.process(channelData, buffer.getNumSamples());
+            analyse(channelData, buffer.getNumSamples());
         }
         else
         {
@@ -159,15 +185,71 @@ void SpectrumAnalyzerRelayAudioProcessor::processBlock(juce::AudioBuffer<float>&
                 monoBuffer[i] = (leftChannel[i] + rightChannel[i]) * 0.5f;
             }
 
-            spectrumProcessor.process(monoBuffer.data(), buffer.getNumSamples());
+            analyse(monoBuffer.data(), buffer.getNumSamples());
+        }
+
+        // Send band levels or spectrum data via OSC when a new frame is ready
+        if (filterBankActive)
+        {
+            // Every frame the block completed, so the bands go out at the bank's fixed rate
+            // whatever the block size
+            for (int frame = 0; frame < filterBank.getNumBlockFrames(); ++frame)
+            {
+                juce::int64 frameSamplePosition = -1;
+                if (blockSamplePosition >= 0)
+                    frameSamplePosition = blockSamplePosition + filterBank.getBlockFrameEnd(frame);
+
+                sendBandsViaOSC(frame, blockTimeUs, frameSamplePosition);
+            }
         }
+        else if (spectrumProcessor.isSpectrumReady())
+        {
+            juce::int64 frameSamplePosition = -1;
+            if (blockSamplePosition >= 0)
+                frameSamplePosition = blockSamplePosition + buffer.getNumSamples()
+                                    - spectrumProcessor.getSamplesSinceLastFrame();
 
-        // Send spectrum data via OSC when new FFT data is ready
-        if (spectrumProcessor.isSpectrumReady())
-            sendSpectrumViaOSC();
+            sendSpectrumViaOSC(blockTimeUs, frameSamplePosition);
+        }
     }
 
     // Audio passes through unchanged - no modification needed since we only read
+
+    loadMeter.addBlock(juce::Time::getHighResolutionTicks() - blockStartTicks,
+                       spectrumProcessor.getFFTTicks() + filterBankTicks - fftTicksBefore,
+                       spectrumProcessor.getNumFFTs() + numFilterBankFrames - numFFTsBefore,
+                       buffer.getNumSamples(), spectrumProcessor.getSampleRate());
+}
+
+void SpectrumAnalyzerRelayAudioProcessor::analyse(const float* samples, int numSamples)
+{
+    const auto mode = analysisMode.load();
+
+    if (mode == AnalysisMode::ThirdOctave || mode == AnalysisMode::SixthOctave)
+    {
+        // Designing the bank only fills fixed-size tables, so switching happens right here
+        const int bandsPerOctave = mode == AnalysisMode::SixthOctave ? 6 : 3;
+        if (!filterBankActive || filterBank.getBandsPerOctave() != bandsPerOctave)
+        {
+            filterBank.prepare(spectrumProcessor.getSampleRate(), bandsPerOctave);
+            filterBankActive = true;
+        }
+
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const int numFrames = filterBank.process(samples, numSamples);
+        filterBankTicks += juce::Time::getHighResolutionTicks() - startTicks;
+        numFilterBankFrames += static_cast<juce::uint32>(numFrames);
+        return;
+    }
+
+    filterBankActive = false;
+    spectrumProcessor.process(samples, numSamples);
+}
+
+void SpectrumAnalyzerRelayAudioProcessor::setAnalysisMode(AnalysisMode mode)
+{
+    analysisMode = mode;
+    spectrumProcessor.setMultiResolution(mode == AnalysisMode::MultiResolution);
 }
 
 bool SpectrumAnalyzerRelayAudioProcessor::hasEditor() const
@@ -196,15 +278,10 @@ void SpectrumAnalyzerRelayAudioProcessor::sendHeartbeat()
     if (!oscConnected.load())
         return;
 
-    // Build OSC address: /wxc-tools/heartbeat/<trackId>
-    juce::String address = SpectrumConstants::OSC_HEARTBEAT_PREFIX + trackId;
-
-    // Create heartbeat message with effective track name and sample rate
-    juce::OSCMessage message(address.toRawUTF8());
-    message.addString(getEffectiveTrackName());
-    message.addFloat32(static_cast<float>(spectrumProcessor.getSampleRate()));
-
-    oscSender.send(message);
+    // Heartbeat carries the effective track name, sample rate and our own CPU cost
+    auto load = loadMeter.takeLoad();
+    oscSender.send(SpectrumMessages::createHeartbeatMessage(trackId, getEffectiveTrackName(),
+                                                            spectrumProcessor.getSampleRate(), &load));
 }
 
 void SpectrumAnalyzerRelayAudioProcessor::setOscPort(int port)
@@ -216,28 +293,58 @@ void SpectrumAnalyzerRelayAudioProcessor::setOscPort(int port)
     }
 }
 
-void SpectrumAnalyzerRelayAudioProcessor::sendSpectrumViaOSC()
+void SpectrumAnalyzerRelayAudioProcessor::sendSpectrumViaOSC(juce::int64 captureTimeUs, juce::int64 hostSamplePosition)
 {
     if (!oscConnected.load())
         return;
 
-    std::array<float, SpectrumConstants::NUM_BINS> spectrum;
-    spectrumProcessor.getSpectrum(spectrum);
+    const auto header = makeFrameHeader(captureTimeUs, hostSamplePosition);
+    const auto layout = spectrumProcessor.getBinLayout();
 
-    // Build OSC address: /wxc-tools/spectrum/<trackId>
-    juce::String address = SpectrumConstants::OSC_ADDRESS_PREFIX + trackId;
+    if (peakMode.load() && layout == BinLayout::Linear)
+    {
+        spectrumProcessor.getPeaks(peakFrame);
+        oscSender.send(SpectrumMessages::createPeaksMessage(trackId, getEffectiveTrackName(),
+                                                            spectrumProcessor.getSampleRate(), peakFrame, header));
+        return;
+    }
 
-    // Create OSC message with spectrum data
-    // Format: [trackName, fftSize, sampleRate, magnitude[0], magnitude[1], ..., magnitude[NUM_BINS-1]]
-    juce::OSCMessage message(address.toRawUTF8());
-    message.addString(getEffectiveTrackName());
-    message.addFloat32(static_cast<float>(SpectrumConstants::FFT_SIZE));
-    message.addFloat32(static_cast<float>(spectrumProcessor.getSampleRate()));
+    // Coded at the source: half the bytes of float magnitudes, and the log is already taken
+    std::array<juce::uint16, SpectrumConstants::NUM_BINS> codes;
+    spectrumProcessor.getSpectrumCodes(codes);
 
-    for (int i = 0; i < SpectrumConstants::NUM_BINS; ++i)
-        message.addFloat32(spectrum[static_cast<size_t>(i)]);
+    oscSender.send(SpectrumMessages::createCodedSpectrumMessage(trackId, getEffectiveTrackName(),
+                                                                spectrumProcessor.getSampleRate(),
+                                                                codes.data(), SpectrumConstants::NUM_BINS,
+                                                                header, layout));
+}
+
+void SpectrumAnalyzerRelayAudioProcessor::sendBandsViaOSC(int frame, juce::int64 captureTimeUs, juce::int64 hostSamplePosition)
+{
+    if (!oscConnected.load())
+        return;
+
+    // Within the capacity reserved in the constructor
+    bandFrame.bandsPerOctave = filterBank.getBandsPerOctave();
+    bandFrame.levels.resize(static_cast<size_t>(filterBank.getNumActiveBands()));
+    filterBank.getBlockFrameLevels(frame, bandFrame.levels.data());
 
-    oscSender.send(message);
+    oscSender.send(SpectrumMessages::createBandsMessage(trackId, getEffectiveTrackName(),
+                                                        spectrumProcessor.getSampleRate(), bandFrame,
+                                                        makeFrameHeader(captureTimeUs, hostSamplePosition)));
+}
+
+SpectrumMessages::FrameHeader SpectrumAnalyzerRelayAudioProcessor::makeFrameHeader(juce::int64 captureTimeUs,
+                                                                                    juce::int64 hostSamplePosition)
+{
+    // Sequence numbers let the analyzer count frames lost in transit
+    SpectrumMessages::FrameHeader header;
+    header.sequence = frameSequence++;
+    header.captureTimeUs = captureTimeUs;
+    header.hostSamplePosition = hostSamplePosition;
+    header.hasLoudness = true;
+    loudnessMeter.getReading(header.loudness);
+    return header;
 }
 
 void SpectrumAnalyzerRelayAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
@@ -250,6 +357,10 @@ void SpectrumAnalyzerRelayAudioProcessor::getStateInformation(juce::MemoryBlock&
     xml.setAttribute("useCustomTrackName", useCustomTrackName);
     xml.setAttribute("relayEnabled", relayEnabled.load());
     xml.setAttribute("oscPort", oscPort);
+    xml.setAttribute("peakMode", peakMode.load());
+    xml.setAttribute("analysisMode", static_cast<int>(analysisMode.load()));
+    xml.setAttribute("window", static_cast<int>(getWindow().type));
+    xml.setAttribute("kaiserBeta", static_cast<double>(getWindow().kaiserBeta));
     copyXmlToBinary(xml, destData);
 }
 
@@ -280,6 +391,17 @@ void SpectrumAnalyzerRelayAudioProcessor::setStateInformation(const void* data,
         useCustomTrackName = xml->getBoolAttribute("useCustomTrackName", false);
         relayEnabled = xml->getBoolAttribute("relayEnabled", true);
         oscPort = xml->getIntAttribute("oscPort", SpectrumConstants::DEFAULT_OSC_PORT);
+        peakMode = xml->getBoolAttribute("peakMode", false);
+
+        // States from before the octave modes only have the multi-resolution switch
+        const auto legacyMode = xml->getBoolAttribute("multiResolution", false) ? AnalysisMode::MultiResolution
+                                                                                : AnalysisMode::Fft;
+        const int mode = xml->getIntAttribute("analysisMode", static_cast<int>(legacyMode));
+        setAnalysisMode(static_cast<AnalysisMode>(juce::jlimit(0, static_cast<int>(AnalysisMode::SixthOctave), mode)));
+
+        const int window = juce::jlimit(0, AnalysisWindow::NUM_TYPES - 1, xml->getIntAttribute("window", 0));
+        setWindow({ static_cast<AnalysisWindow::Type>(window),
+                    static_cast<float>(xml->getDoubleAttribute("kaiserBeta", AnalysisWindow::DEFAULT_KAISER_BETA)) });
     }
 }
 
@@ -2,7 +2,11 @@
 
 #include <JuceHeader.h>
 #include "SpectrumProcessor.h"
+#include "ProcessingLoadMeter.h"
+#include "LoudnessMeter.h"
+#include "OctaveFilterBank.h"
 #include "../../Common/SpectrumData.h"
+#include "../../Common/SpectrumMessages.h"
 
 class SpectrumAnalyzerRelayAudioProcessor : public juce::AudioProcessor,
                                            private juce::Timer
@@ -45,6 +49,33 @@ public:
     bool isRelayEnabled() const { return relayEnabled.load(); }
     void setRelayEnabled(bool enabled) { relayEnabled = enabled; }
 
+    /// Peak mode sends each frame as its strongest peaks over a coarse noise floor
+    /// (see SpectralPeaks) instead of every bin: about a tenth of the bandwidth,
+    /// suited to mostly tonal tracks.
+    bool isPeakMode() const { return peakMode.load(); }
+    void setPeakMode(bool enabled) { peakMode = enabled; }
+
+    /// How the track is analysed. Multi-resolution sends log-spaced bins, fine at the
+    /// low end (see MultiResolutionAnalyzer); the octave modes send 1/3- or 1/6-octave
+    /// band levels from a filterbank at a fixed 100 frames/s, with meter-like latency
+    /// (see OctaveFilterBank). Peak mode only applies to the plain FFT; the others
+    /// always send their frames in full.
+    enum class AnalysisMode
+    {
+        Fft,
+        MultiResolution,
+        ThirdOctave,
+        SixthOctave
+    };
+
+    AnalysisMode getAnalysisMode() const { return analysisMode.load(); }
+    void setAnalysisMode(AnalysisMode mode);
+
+    /// FFT analysis window (see AnalysisWindow). Only the plain FFT uses it; readings
+    /// stay calibrated whichever is chosen.
+    AnalysisWindow::Choice getWindow() const { return spectrumProcessor.getWindow(); }
+    void setWindow(const AnalysisWindow::Choice& choice) { spectrumProcessor.setWindow(choice); }
+
     int getOscPort() const { return oscPort; }
     void setOscPort(int port);
 
@@ -68,18 +99,36 @@ private:
     void timerCallback() override;
     void connectOSC();
     void sendHeartbeat();
-    void sendSpectrumViaOSC();
+    void sendSpectrumViaOSC(juce::int64 captureTimeUs, juce::int64 hostSamplePosition);
+    void sendBandsViaOSC(int frame, juce::int64 captureTimeUs, juce::int64 hostSamplePosition);
+    void analyse(const float* samples, int numSamples);
+    SpectrumMessages::FrameHeader makeFrameHeader(juce::int64 captureTimeUs, juce::int64 hostSamplePosition);
+
     SpectrumProcessor spectrumProcessor;
+    OctaveFilterBank filterBank;       // Used instead of spectrumProcessor in the octave modes
+    ProcessingLoadMeter loadMeter;     // Own processBlock cost, sent with each heartbeat
+    LoudnessMeter loudnessMeter;       // Read into each frame's header
 
     juce::String trackId;              // Unique identifier (UUID)
     juce::String dawTrackName;         // Track name from DAW (via updateTrackProperties)
     juce::String customTrackName;      // User-defined custom name
     bool useCustomTrackName { false }; // If true, send customTrackName; otherwise send dawTrackName
     std::atomic<bool> relayEnabled { true };
+    std::atomic<bool> peakMode { false };
+    std::atomic<AnalysisMode> analysisMode { AnalysisMode::Fft };
 
     juce::OSCSender oscSender;
     int oscPort { SpectrumConstants::DEFAULT_OSC_PORT };
     std::atomic<bool> oscConnected { false };
+    juce::uint32 frameSequence { 0 };  // Sent in each spectrum message's header
+    SpectralPeaks::PeakFrame peakFrame; // Peak mode scratch (reserved up front)
+    OctaveBands::BandFrame bandFrame;   // Octave mode scratch (reserved up front)
+
+    // Audio thread: filterbank state, and its time and frames for the load meter
+    // (counted like SpectrumProcessor's FFT frames)
+    bool filterBankActive { false };
+    juce::int64 filterBankTicks { 0 };
+    juce::uint32 numFilterBankFrames { 0 };
 
     // Temporary buffer for summing stereo to mono
     std::vector<float> monoBuffer;
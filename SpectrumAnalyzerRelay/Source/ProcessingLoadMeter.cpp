@@ -0,0 +1,65 @@
+#include "ProcessingLoadMeter.h"
+
+namespace
+{
+    double ticksToMicroseconds(juce::int64 ticks)
+    {
+        return 1.0e6 * static_cast<double>(ticks) / static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+    }
+}
+
+void ProcessingLoadMeter::addBlock(juce::int64 blockTicks, juce::int64 fftTicks, juce::uint32 numFFTs,
+                                   int numSamples, double sampleRate) noexcept
+{
+    if (numSamples <= 0 || sampleRate <= 0.0)
+        return;
+
+    // What the block is allowed to take: its own duration in real time
+    const auto budgetTicks = static_cast<juce::int64>(numSamples / sampleRate
+                                                      * static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()));
+
+    addTo(totalBlockTicks, blockTicks);
+    addTo(totalBudgetTicks, budgetTicks);
+    addTo(totalFftTicks, fftTicks);
+    addTo(totalFFTs, static_cast<juce::int64>(numFFTs));
+    addTo(totalBlocks, 1);
+
+    if (blockTicks > maxBlockTicks.load(std::memory_order_relaxed))
+        maxBlockTicks.store(blockTicks, std::memory_order_relaxed);
+
+    const float blockLoad = budgetTicks > 0 ? static_cast<float>(blockTicks) / static_cast<float>(budgetTicks) : 0.0f;
+    if (blockLoad > maxBlockLoad.load(std::memory_order_relaxed))
+        maxBlockLoad.store(blockLoad, std::memory_order_relaxed);
+}
+
+SpectrumMessages::ProcessingLoad ProcessingLoadMeter::takeLoad()
+{
+    const auto blockTicks = totalBlockTicks.load(std::memory_order_relaxed);
+    const auto budgetTicks = totalBudgetTicks.load(std::memory_order_relaxed);
+    const auto fftTicks = totalFftTicks.load(std::memory_order_relaxed);
+    const auto ffts = totalFFTs.load(std::memory_order_relaxed);
+    const auto blocks = totalBlocks.load(std::memory_order_relaxed);
+
+    SpectrumMessages::ProcessingLoad load;
+    load.numBlocks = static_cast<juce::uint32>(blocks - lastBlocks);
+    load.maxBlockUs = static_cast<float>(ticksToMicroseconds(maxBlockTicks.exchange(0, std::memory_order_relaxed)));
+    load.peakLoad = maxBlockLoad.exchange(0.0f, std::memory_order_relaxed);
+
+    if (load.numBlocks > 0)
+        load.meanBlockUs = static_cast<float>(ticksToMicroseconds(blockTicks - lastBlockTicks) / load.numBlocks);
+
+    if (ffts > lastFFTs)
+        load.meanFftUs = static_cast<float>(ticksToMicroseconds(fftTicks - lastFftTicks) / static_cast<double>(ffts - lastFFTs));
+
+    if (budgetTicks > lastBudgetTicks)
+        load.load = static_cast<float>(static_cast<double>(blockTicks - lastBlockTicks)
+                                       / static_cast<double>(budgetTicks - lastBudgetTicks));
+
+    lastBlockTicks = blockTicks;
+    lastBudgetTicks = budgetTicks;
+    lastFftTicks = fftTicks;
+    lastFFTs = ffts;
+    lastBlocks = blocks;
+
+    return load;
+}
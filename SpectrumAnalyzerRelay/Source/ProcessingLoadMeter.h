@@ -0,0 +1,50 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Common/SpectrumMessages.h"
+
+/// Measures the relay's own audio thread cost, for reporting in heartbeats.
+///
+/// The audio thread adds one entry per processBlock. It only stores to relaxed
+/// atomics: running totals and the interval's maxima. The heartbeat thread
+/// diffs the totals against its previous call and resets the maxima, so
+/// neither side ever waits on the other.
+class ProcessingLoadMeter
+{
+public:
+    ProcessingLoadMeter() = default;
+
+    /// Audio thread. blockTicks is the whole processBlock; fftTicks and numFFTs
+    /// the part of it spent computing analysis frames (see SpectrumProcessor::getFFTTicks;
+    /// in the octave modes, the filterbank's 10 ms frames).
+    void addBlock(juce::int64 blockTicks, juce::int64 fftTicks, juce::uint32 numFFTs,
+                  int numSamples, double sampleRate) noexcept;
+
+    /// Heartbeat thread. Figures since the previous call.
+    SpectrumMessages::ProcessingLoad takeLoad();
+
+private:
+    static void addTo(std::atomic<juce::int64>& total, juce::int64 amount) noexcept
+    {
+        // Single writer: no read-modify-write needed
+        total.store(total.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    // Written by the audio thread
+    std::atomic<juce::int64> totalBlockTicks { 0 };
+    std::atomic<juce::int64> totalBudgetTicks { 0 };
+    std::atomic<juce::int64> totalFftTicks { 0 };
+    std::atomic<juce::int64> totalFFTs { 0 };
+    std::atomic<juce::int64> totalBlocks { 0 };
+    std::atomic<juce::int64> maxBlockTicks { 0 };  // Reset by takeLoad()
+    std::atomic<float> maxBlockLoad { 0.0f };      // Reset by takeLoad()
+
+    // Totals at the previous takeLoad()
+    juce::int64 lastBlockTicks { 0 };
+    juce::int64 lastBudgetTicks { 0 };
+    juce::int64 lastFftTicks { 0 };
+    juce::int64 lastFFTs { 0 };
+    juce::int64 lastBlocks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProcessingLoadMeter)
+};
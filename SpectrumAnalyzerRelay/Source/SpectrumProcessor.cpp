@@ -1,23 +1,126 @@
 #include "SpectrumProcessor.h"
+#include <algorithm>
+#include <cmath>
 
 SpectrumProcessor::SpectrumProcessor()
 {
     inputBuffer.fill(0.0f);
     fftData.fill(0.0f);
     magnitudeSpectrum.fill(0.0f);
+    spectrumCodes.fill(0);
+
+    buildWindow(pendingWindow);
+    activeWindow = pendingWindow.choice;
+    windowProperties = pendingWindow.properties;
+    windowTable = pendingWindow.table;
+}
+
+void SpectrumProcessor::setWindow(const AnalysisWindow::Choice& choice)
+{
+    // Kaiser's Bessel series and measure() are far too slow for processBlock, so the
+    // table is built here and handed over whole
+    PreparedWindow window;
+    window.choice = { choice.type, juce::jlimit(0.0f, AnalysisWindow::MAX_KAISER_BETA, choice.kaiserBeta) };
+    buildWindow(window);
+
+    const juce::SpinLock::ScopedLockType lock(pendingWindowLock);
+    pendingWindow = window;
+    requestedKaiserBeta = window.choice.kaiserBeta;
+    requestedWindowType = static_cast<int>(window.choice.type);
+    windowPending = true;
+}
+
+AnalysisWindow::Choice SpectrumProcessor::getWindow() const
+{
+    return { static_cast<AnalysisWindow::Type>(requestedWindowType.load()), requestedKaiserBeta.load() };
+}
+
+void SpectrumProcessor::buildWindow(PreparedWindow& window)
+{
+    AnalysisWindow::fill(window.choice, window.table.data(), SpectrumConstants::FFT_SIZE);
+    window.properties = AnalysisWindow::measure(window.table.data(), SpectrumConstants::FFT_SIZE);
+
+    // A sine of amplitude A on a bin reads A * sum(window) / 2 from the FFT
+    const double sum = window.properties.coherentGain * SpectrumConstants::FFT_SIZE;
+    juce::FloatVectorOperations::multiply(window.table.data(), static_cast<float>(2.0 / sum), SpectrumConstants::FFT_SIZE);
 }
 
 void SpectrumProcessor::prepare(double sampleRate)
 {
     currentSampleRate = sampleRate;
+    multiResolution.prepare(sampleRate);
+    restart();
+
+    // Floor band bin ranges for this sample rate; bands narrower than a bin use the nearest one
+    const auto& grid = SpectralPeaks::getFloorGrid();
+    const double binHz = sampleRate / SpectrumConstants::FFT_SIZE;
+
+    for (int band = 0; band < SpectralPeaks::NUM_FLOOR_BANDS; ++band)
+    {
+        int start = juce::jlimit(1, SpectrumConstants::NUM_BINS - 1, static_cast<int>(std::ceil(grid.getBandEdge(band) / binHz)));
+        int end = juce::jlimit(1, SpectrumConstants::NUM_BINS, static_cast<int>(std::ceil(grid.getBandEdge(band + 1) / binHz)));
+
+        if (end <= start)
+        {
+            start = juce::jlimit(1, SpectrumConstants::NUM_BINS - 1, juce::roundToInt(grid.getBandCentre(band) / binHz));
+            end = start + 1;
+        }
+
+        floorBandBins[static_cast<size_t>(band)] = { start, end };
+    }
+
+    for (int bin = 0; bin < SpectrumConstants::NUM_BINS; ++bin)
+    {
+        float position = grid.frequencyToBand(juce::jmax(1.0f, static_cast<float>(bin * binHz)));
+        binFloorBand[static_cast<size_t>(bin)] = static_cast<juce::uint8>(
+            juce::jlimit(0, SpectralPeaks::NUM_FLOOR_BANDS - 1, static_cast<int>(position)));
+    }
+}
+
+void SpectrumProcessor::restart()
+{
     inputBufferIndex = 0;
     samplesSinceLastFFT = 0;
     inputBuffer.fill(0.0f);
+    multiResolution.reset();
     spectrumReady = false;
 }
 
 void SpectrumProcessor::process(const float* inputData, int numSamples)
 {
+    if (multiResolutionRequested.load() != multiResolutionActive)
+    {
+        multiResolutionActive = !multiResolutionActive;
+        restart();
+    }
+
+    // Only the table changes, so frames already buffered go through the new window.
+    // If setWindow() holds the lock, the new table is taken at the next block instead.
+    if (windowPending.load())
+    {
+        const juce::SpinLock::ScopedTryLockType lock(pendingWindowLock);
+        if (lock.isLocked())
+        {
+            activeWindow = pendingWindow.choice;
+            windowProperties = pendingWindow.properties;
+            windowTable = pendingWindow.table;
+            windowPending = false;
+        }
+    }
+
+    if (multiResolutionActive)
+    {
+        const auto startTicks = juce::Time::getHighResolutionTicks();
+        const int numFrames = multiResolution.process(inputData, numSamples);
+        fftTicks += juce::Time::getHighResolutionTicks() - startTicks;
+
+        numFFTs += static_cast<juce::uint32>(numFrames);
+        samplesSinceLastFFT = multiResolution.getSamplesSinceLastFrame();
+        if (numFrames > 0)
+            spectrumReady = true;
+        return;
+    }
+
     for (int i = 0; i < numSamples; ++i)
     {
         // Add sample to circular buffer
@@ -36,34 +139,44 @@ void SpectrumProcessor::process(const float* inputData, int numSamples)
 
 void SpectrumProcessor::processFFT()
 {
-    // Copy samples from circular buffer to FFT buffer in correct order
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+
+    // Unwrap the circular buffer (oldest sample first) and window it in the same pass;
+    // the table carries the normalisation, so the FFT's magnitudes come out calibrated
     const int firstPartSize = SpectrumConstants::FFT_SIZE - inputBufferIndex;
-    std::copy(inputBuffer.begin() + inputBufferIndex,
-              inputBuffer.begin() + inputBufferIndex + firstPartSize,
-              fftData.begin());
-    std::copy(inputBuffer.begin(),
-              inputBuffer.begin() + inputBufferIndex,
-              fftData.begin() + firstPartSize);
+    juce::FloatVectorOperations::multiply(fftData.data(), inputBuffer.data() + inputBufferIndex,
+                                          windowTable.data(), firstPartSize);
+    juce::FloatVectorOperations::multiply(fftData.data() + firstPartSize, inputBuffer.data(),
+                                          windowTable.data() + firstPartSize, inputBufferIndex);
 
-    // Apply window function
-    window.multiplyWithWindowingTable(fftData.data(), SpectrumConstants::FFT_SIZE);
+    // Forward FFT (in-place, real input), positive frequencies only
+    fft.performRealOnlyForwardTransform(fftData.data(), true);
 
-    // Perform forward FFT (in-place, real input)
-    fft.performFrequencyOnlyForwardTransform(fftData.data());
+    convertBins(fftData.data(), magnitudeSpectrum.data(), spectrumCodes.data(), SpectrumConstants::NUM_BINS);
 
-    // Convert to magnitude spectrum (normalized)
-    const float maxMagnitude = static_cast<float>(SpectrumConstants::FFT_SIZE);
-    constexpr float windowCompensation = 2.0f;  // Hann window coherent gain correction
+    fftTicks += juce::Time::getHighResolutionTicks() - startTicks;
+    ++numFFTs;
 
-    for (int i = 0; i < SpectrumConstants::NUM_BINS; ++i)
+    spectrumReady = true;
+}
+
+void SpectrumProcessor::convertBins(const float* complexBins, float* magnitudes, juce::uint16* codes, int numBins) noexcept
+{
+    // Power and its code in one branch-free pass, which the compiler vectorises. The
+    // square roots get a pass of their own: std::sqrt may set errno, which keeps any
+    // loop it's in scalar
+    for (int i = 0; i < numBins; ++i)
     {
-        // fftData now contains magnitudes after performFrequencyOnlyForwardTransform
-        // Normalize by FFT size and compensate for Hann window amplitude reduction
-        float magnitude = (fftData[i] / maxMagnitude) * windowCompensation;
-        magnitudeSpectrum[i] = magnitude;
+        const float re = complexBins[2 * i];
+        const float im = complexBins[2 * i + 1];
+        const float power = re * re + im * im;
+
+        magnitudes[i] = power;
+        codes[i] = SpectrumCodes::fromPower(power);
     }
 
-    spectrumReady = true;
+    for (int i = 0; i < numBins; ++i)
+        magnitudes[i] = std::sqrt(magnitudes[i]);
 }
 
 bool SpectrumProcessor::isSpectrumReady() const
@@ -73,6 +186,86 @@ bool SpectrumProcessor::isSpectrumReady() const
 
 void SpectrumProcessor::getSpectrum(std::array<float, SpectrumConstants::NUM_BINS>& output)
 {
-    output = magnitudeSpectrum;
+    if (multiResolutionActive)
+        multiResolution.getSpectrum(output.data());
+    else
+        output = magnitudeSpectrum;
+
+    spectrumReady = false;
+}
+
+void SpectrumProcessor::getSpectrumCodes(std::array<juce::uint16, SpectrumConstants::NUM_BINS>& output)
+{
+    if (multiResolutionActive)
+    {
+        std::array<float, SpectrumConstants::NUM_BINS> magnitudes;
+        multiResolution.getSpectrum(magnitudes.data());
+        SpectrumCodes::fromMagnitudes(magnitudes.data(), output.data(), SpectrumConstants::NUM_BINS);
+    }
+    else
+    {
+        output = spectrumCodes;
+    }
+
+    spectrumReady = false;
+}
+
+void SpectrumProcessor::getPeaks(SpectralPeaks::PeakFrame& peaks)
+{
+    const float* magnitudes = magnitudeSpectrum.data();
+    peaks.window = activeWindow;
+
+    // Noise floor: median of each band's bins, which a few peaks barely move
+    for (int band = 0; band < SpectralPeaks::NUM_FLOOR_BANDS; ++band)
+    {
+        const auto range = floorBandBins[static_cast<size_t>(band)];
+        const int count = range.second - range.first;
+
+        std::copy(magnitudes + range.first, magnitudes + range.second, floorScratch.begin());
+        std::nth_element(floorScratch.begin(), floorScratch.begin() + count / 2, floorScratch.begin() + count);
+        peaks.floor[static_cast<size_t>(band)] = floorScratch[static_cast<size_t>(count / 2)];
+    }
+
+    // Local maxima standing clear of their band's floor
+    int numCandidates = 0;
+    for (int bin = 1; bin < SpectrumConstants::NUM_BINS - 1; ++bin)
+    {
+        const float magnitude = magnitudes[bin];
+        if (magnitude > magnitudes[bin - 1] && magnitude >= magnitudes[bin + 1] && magnitude > minPeakMagnitude
+            && magnitude > peakFloorRatio * peaks.floor[binFloorBand[static_cast<size_t>(bin)]])
+        {
+            peakCandidates[static_cast<size_t>(numCandidates++)] = bin;
+        }
+    }
+
+    // Keep the strongest, loudest first
+    const int numPeaks = juce::jmin(numCandidates, SpectrumConstants::MAX_SENT_PEAKS);
+    std::partial_sort(peakCandidates.begin(), peakCandidates.begin() + numPeaks, peakCandidates.begin() + numCandidates,
+                      [magnitudes](int a, int b) { return magnitudes[a] > magnitudes[b]; });
+
+    // Parabola through the dB levels of the peak bin and its neighbours: its vertex is
+    // the peak's frequency and level to a fraction of a bin
+    const float binHz = static_cast<float>(currentSampleRate / SpectrumConstants::FFT_SIZE);
+    auto toDb = [](float magnitude) { return 20.0f * std::log10(juce::jmax(1.0e-12f, magnitude)); };
+
+    // A flat-topped main lobe already reads the level at the peak bin; the parabola would only add error
+    const bool refineLevel = windowProperties.scallopingLossDb > 0.1;
+
+    peaks.peaks.resize(static_cast<size_t>(numPeaks));
+    for (int i = 0; i < numPeaks; ++i)
+    {
+        const int bin = peakCandidates[static_cast<size_t>(i)];
+        const float a = toDb(magnitudes[bin - 1]);
+        const float b = toDb(magnitudes[bin]);
+        const float c = toDb(magnitudes[bin + 1]);
+
+        const float curvature = a - 2.0f * b + c;
+        const float offset = curvature < 0.0f ? juce::jlimit(-0.5f, 0.5f, 0.5f * (a - c) / curvature) : 0.0f;
+
+        auto& peak = peaks.peaks[static_cast<size_t>(i)];
+        peak.frequency = (static_cast<float>(bin) + offset) * binHz;
+        peak.magnitude = refineLevel ? std::pow(10.0f, (b - 0.25f * (a - c) * offset) / 20.0f) : magnitudes[bin];
+    }
+
     spectrumReady = false;
 }
@@ -2,6 +2,10 @@
 
 #include <JuceHeader.h>
 #include "../../Common/SpectrumData.h"
+#include "../../Common/SpectralPeaks.h"
+#include "../../Common/AnalysisWindow.h"
+#include "../../Common/SpectrumCodes.h"
+#include "MultiResolutionAnalyzer.h"
 
 class SpectrumProcessor
 {
@@ -15,6 +19,28 @@ public:
     /// and triggers FFT when enough samples collected.
     void process(const float* inputData, int numSamples);
 
+    /// Switches between the single 2048-point FFT (linear bins) and the
+    /// multi-resolution analysis (log bins, see MultiResolutionAnalyzer). Safe from
+    /// any thread; takes effect at the next process(), which starts both afresh.
+    void setMultiResolution(bool shouldUseMultiResolution) { multiResolutionRequested = shouldUseMultiResolution; }
+    bool isMultiResolution() const { return multiResolutionRequested.load(); }
+
+    /// Window for the 2048-point FFT (the multi-resolution analysis always uses Hann).
+    /// Safe from any thread but the audio one: the table is built here, on the caller's
+    /// thread, and process() picks it up and uses it from the next frame on.
+    /// Whatever the window, a bin-centred sine reads its amplitude.
+    void setWindow(const AnalysisWindow::Choice& choice);
+    AnalysisWindow::Choice getWindow() const;
+
+    /// Coherent gain, ENBW and scalloping of the window in use. Magnitudes are already
+    /// corrected for the coherent gain; divide a bin's power by the noise bandwidth
+    /// (noiseBandwidthBins * sampleRate / FFT_SIZE) to read noise as power density.
+    /// Only read it from the thread that calls process().
+    const AnalysisWindow::Properties& getWindowProperties() const { return windowProperties; }
+
+    /// Layout of the bins getSpectrum() returns. Only read it from the thread that calls process().
+    BinLayout getBinLayout() const { return multiResolutionActive ? BinLayout::Log : BinLayout::Linear; }
+
     /// Returns true if new spectrum data is available since last getSpectrum() call.
     bool isSpectrumReady() const;
 
@@ -22,17 +48,65 @@ public:
     /// Clears the ready flag.
     void getSpectrum(std::array<float, SpectrumConstants::NUM_BINS>& output);
 
+    /// The current spectrum as dB codes (see SpectrumCodes), as the relay sends it.
+    /// FFT frames are coded as they're computed; multi-resolution frames are coded here.
+    /// Clears the ready flag.
+    void getSpectrumCodes(std::array<juce::uint16, SpectrumConstants::NUM_BINS>& output);
+
+    /// Peak mode alternative to getSpectrum(): the strongest local maxima of the current
+    /// spectrum (at most MAX_SENT_PEAKS, frequency and level refined by parabolic
+    /// interpolation on dB) and the median level of each noise floor band.
+    /// Clears the ready flag. Doesn't allocate once peaks.peaks has reserved MAX_SENT_PEAKS.
+    /// Linear layout only. peaks.window is set to the window in use.
+    void getPeaks(SpectralPeaks::PeakFrame& peaks);
+
     double getSampleRate() const { return currentSampleRate; }
 
+    /// The pass after the FFT: complex bins (re, im interleaved, as
+    /// performRealOnlyForwardTransform writes them) to magnitudes and dB codes.
+    /// The window table already carries the calibration, so there's nothing left to scale.
+    static void convertBins(const float* complexBins, float* magnitudes, juce::uint16* codes, int numBins) noexcept;
+
+    /// Samples received since the last FFT frame completed. After process(), the
+    /// newest frame ended this many samples before the end of the block.
+    int getSamplesSinceLastFrame() const { return samplesSinceLastFFT; }
+
+    /// Running totals of time spent computing FFT frames (high resolution ticks)
+    /// and of frames computed, for CPU accounting. In multi-resolution mode a frame
+    /// is one full-rate hop and the time is all of the analysis. Only read them from
+    /// the thread that calls process().
+    juce::int64 getFFTTicks() const { return fftTicks; }
+    juce::uint32 getNumFFTs() const { return numFFTs; }
+
 private:
     void processFFT();
+    void restart();
+
+    // A window table ready for the FFT, with the window it was built from
+    struct PreparedWindow
+    {
+        AnalysisWindow::Choice choice;
+        AnalysisWindow::Properties properties;
+        alignas(32) std::array<float, SpectrumConstants::FFT_SIZE> table {};
+    };
+
+    static void buildWindow(PreparedWindow& window);
 
     // JUCE FFT
     juce::dsp::FFT fft { SpectrumConstants::FFT_ORDER };
-    juce::dsp::WindowingFunction<float> window {
-        SpectrumConstants::FFT_SIZE,
-        juce::dsp::WindowingFunction<float>::hann
-    };
+
+    // Window scaled by 2 / sum(window): the one-sided, coherent gain corrected normalisation
+    // folded in, so a single multiply takes the buffer to calibrated FFT input
+    alignas(32) std::array<float, SpectrumConstants::FFT_SIZE> windowTable {};
+    AnalysisWindow::Choice activeWindow;
+    AnalysisWindow::Properties windowProperties;
+    std::atomic<int> requestedWindowType { static_cast<int>(AnalysisWindow::Type::Hann) };
+    std::atomic<float> requestedKaiserBeta { AnalysisWindow::DEFAULT_KAISER_BETA };
+
+    // Built by setWindow() and copied over by process(), which only tries the lock
+    PreparedWindow pendingWindow;
+    juce::SpinLock pendingWindowLock;
+    std::atomic<bool> windowPending { false };
 
     // Circular input buffer
     std::array<float, SpectrumConstants::FFT_SIZE> inputBuffer {};
@@ -40,10 +114,30 @@ private:
     int samplesSinceLastFFT { 0 };
 
     // FFT working buffer (needs 2x size for real FFT)
-    std::array<float, SpectrumConstants::FFT_SIZE * 2> fftData {};
+    alignas(32) std::array<float, SpectrumConstants::FFT_SIZE * 2> fftData {};
 
-    // Output magnitude spectrum
+    // Output magnitude spectrum, and the same as dB codes
     std::array<float, SpectrumConstants::NUM_BINS> magnitudeSpectrum {};
+    std::array<juce::uint16, SpectrumConstants::NUM_BINS> spectrumCodes {};
+
+    // Peak mode: bins of each noise floor band, the floor band of each bin, and scratch
+    std::array<std::pair<int, int>, SpectralPeaks::NUM_FLOOR_BANDS> floorBandBins {};  // [start, end)
+    std::array<juce::uint8, SpectrumConstants::NUM_BINS> binFloorBand {};
+    std::array<float, SpectrumConstants::NUM_BINS> floorScratch {};
+    std::array<int, SpectrumConstants::NUM_BINS / 2> peakCandidates {};
+
+    // A local maximum is only a peak this far above its band's floor (+6 dB), and above -100 dB
+    static constexpr float peakFloorRatio = 2.0f;
+    static constexpr float minPeakMagnitude = 1.0e-5f;
+
+    // Multi-resolution analysis, used instead of the above while active
+    MultiResolutionAnalyzer multiResolution;
+    std::atomic<bool> multiResolutionRequested { false };
+    bool multiResolutionActive { false };
+
+    // CPU accounting (see getFFTTicks)
+    juce::int64 fftTicks { 0 };
+    juce::uint32 numFFTs { 0 };
 
     // Thread-safe ready flag
     std::atomic<bool> spectrumReady { false };
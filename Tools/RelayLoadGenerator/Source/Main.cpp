@@ -0,0 +1,193 @@
+/*
+  ==============================================================================
+
+    Simulates a fleet of SpectrumAnalyzerRelay instances without a DAW, sending
+    real heartbeat and spectrum messages to a running MultitrackSpectrumAnalyzer.
+
+    Usage: RelayLoadGenerator [--tracks <n>] [--speed <x>] [--duration <seconds>]
+                              [--wav <file>] [--sample-rate <hz>] [--block <samples>]
+                              [--host <address>] [--port <port>]
+
+      --tracks       number of virtual relays (default 100)
+      --speed        1 = real time, 4 = four times real time, 0 = as fast as possible
+      --duration     stop after this many seconds (default: run until killed)
+      --wav          play an audio file (looped, offset per track) instead of tones
+      --sample-rate  synthetic signal sample rate (default 48000)
+      --block        host block size in samples (default 512)
+
+    Prints sent frames per second; compare with the received/dropped counts in the
+    analyzer's status bar to find where ingest or rendering falls behind.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "VirtualTrack.h"
+#include <iostream>
+
+namespace
+{
+    /// Loads a file, mixed down to mono. Returns the file's sample rate, or 0 on failure.
+    double loadAudioFile(const juce::File& file, juce::AudioBuffer<float>& audio)
+    {
+        juce::AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+        if (reader == nullptr || reader->lengthInSamples <= 0)
+            return 0.0;
+
+        const int numChannels = static_cast<int>(reader->numChannels);
+        const int numSamples = static_cast<int>(juce::jmin(reader->lengthInSamples,
+                                                           static_cast<juce::int64>(std::numeric_limits<int>::max())));
+
+        juce::AudioBuffer<float> fileBuffer(numChannels, numSamples);
+        reader->read(&fileBuffer, 0, numSamples, 0, true, true);
+
+        audio.setSize(1, numSamples);
+        audio.clear();
+        for (int channel = 0; channel < numChannels; ++channel)
+            audio.addFrom(0, 0, fileBuffer, channel, 0, numSamples, 1.0f / static_cast<float>(numChannels));
+
+        return reader->sampleRate;
+    }
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.containsOption ("--help|-h"))
+    {
+        std::cout << "Usage: " << args.executableName
+                  << " [--tracks <n>] [--speed <x>] [--duration <seconds>] [--wav <file>]"
+                     " [--sample-rate <hz>] [--block <samples>] [--host <address>] [--port <port>]" << std::endl;
+        return 0;
+    }
+
+    auto optionOr = [&args] (const juce::String& option, const juce::String& fallback)
+    {
+        return args.containsOption (option) ? args.getValueForOption (option) : fallback;
+    };
+
+    const int numTracks = juce::jmax (1, optionOr ("--tracks", "100").getIntValue());
+    const double speed = juce::jmax (0.0, optionOr ("--speed", "1").getDoubleValue());
+    const double duration = optionOr ("--duration", "0").getDoubleValue();
+    const int blockSize = juce::jlimit (16, 16384, optionOr ("--block", "512").getIntValue());
+    const juce::String host = optionOr ("--host", "127.0.0.1");
+    const int port = optionOr ("--port", juce::String (SpectrumConstants::DEFAULT_OSC_PORT)).getIntValue();
+    double sampleRate = optionOr ("--sample-rate", "48000").getDoubleValue();
+
+    juce::AudioBuffer<float> fileAudio;
+    if (args.containsOption ("--wav"))
+    {
+        auto file = args.getFileForOption ("--wav");
+        sampleRate = loadAudioFile (file, fileAudio);
+        if (sampleRate <= 0.0)
+        {
+            std::cout << "Could not read " << file.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    juce::OSCSender sender;
+    if (! sender.connect (host, port))
+    {
+        std::cout << "Could not connect to " << host << ":" << port << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<VirtualTrack>> tracks;
+    tracks.reserve (static_cast<size_t>(numTracks));
+    for (int i = 0; i < numTracks; ++i)
+        tracks.push_back (std::make_unique<VirtualTrack> (i, numTracks, sampleRate,
+                                                          fileAudio.getNumSamples() > 0 ? &fileAudio : nullptr));
+
+    std::cout << numTracks << " virtual tracks @ " << sampleRate << " Hz, block " << blockSize
+              << ", speed " << (speed > 0.0 ? juce::String (speed) + "x" : juce::String ("unthrottled"))
+              << " -> " << host << ":" << port << std::endl;
+
+    // Announce every track before any spectra arrive, as relays do on load
+    for (auto& track : tracks)
+        track->sendHeartbeat (sender);
+
+    const double blockIntervalMs = speed > 0.0 ? blockSize * 1000.0 / sampleRate / speed : 0.0;
+    const double startTime = juce::Time::getMillisecondCounterHiRes();
+    double nextBlockTime = startTime;
+    double nextHeartbeatTime = startTime + SpectrumConstants::HEARTBEAT_INTERVAL_MS;
+    double nextReportTime = startTime + 1000.0;
+
+    juce::int64 totalFramesSent = 0, framesSinceReport = 0, lateBlocks = 0;
+    juce::int64 totalSamples = 0;
+    double busyMsSinceReport = 0.0;
+
+    for (;;)
+    {
+        const double blockStart = juce::Time::getMillisecondCounterHiRes();
+
+        for (auto& track : tracks)
+        {
+            if (track->processBlock (blockSize, sender))
+                ++framesSinceReport;
+        }
+
+        totalSamples += blockSize;
+        const double now = juce::Time::getMillisecondCounterHiRes();
+        busyMsSinceReport += now - blockStart;
+
+        // Heartbeats are on wall-clock time, like the relay's timer
+        if (now >= nextHeartbeatTime)
+        {
+            for (auto& track : tracks)
+                track->sendHeartbeat (sender);
+            nextHeartbeatTime += SpectrumConstants::HEARTBEAT_INTERVAL_MS;
+        }
+
+        if (now >= nextReportTime)
+        {
+            const double elapsedSeconds = (now - startTime) / 1000.0;
+            const double periodMs = 1000.0 + (now - nextReportTime);
+            int sendFailures = 0;
+            for (auto& track : tracks)
+                sendFailures += track->getSendFailures();
+
+            totalFramesSent += framesSinceReport;
+
+            std::cout << juce::String (elapsedSeconds, 0).paddedLeft (' ', 5) << "s"
+                      << "  sent " << juce::String (framesSinceReport * 1000.0 / periodMs, 0).paddedLeft (' ', 7) << " frames/s"
+                      << "  total " << totalFramesSent
+                      << "  audio " << juce::String (totalSamples / sampleRate / elapsedSeconds, 2) << "x real time"
+                      << "  load " << juce::String (100.0 * busyMsSinceReport / periodMs, 0) << "%"
+                      << "  late blocks " << lateBlocks
+                      << "  send failures " << sendFailures << std::endl;
+
+            framesSinceReport = 0;
+            busyMsSinceReport = 0.0;
+            nextReportTime += 1000.0;
+        }
+
+        if (duration > 0.0 && now - startTime >= duration * 1000.0)
+            break;
+
+        if (blockIntervalMs > 0.0)
+        {
+            nextBlockTime += blockIntervalMs;
+
+            if (nextBlockTime > now)
+            {
+                juce::Thread::sleep (static_cast<int> (nextBlockTime - now));
+            }
+            else if (now - nextBlockTime > 1000.0)
+            {
+                // More than a second behind: the machine can't generate this load. Count it and resync.
+                ++lateBlocks;
+                nextBlockTime = now;
+            }
+        }
+    }
+
+    totalFramesSent += framesSinceReport;
+    std::cout << "Sent " << totalFramesSent << " spectrum frames from " << numTracks << " tracks" << std::endl;
+    return 0;
+}
@@ -0,0 +1,105 @@
+#include "VirtualTrack.h"
+
+VirtualTrack::VirtualTrack(int index, int numTracks, double sr, const juce::AudioBuffer<float>* audio)
+    : trackId(juce::Uuid().toString()),
+      trackName("Load " + juce::String(index + 1).paddedLeft('0', 3)),
+      sampleRate(sr),
+      fileAudio(audio),
+      random(index + 1)
+{
+    processor.prepare(sampleRate);
+
+    // Spread tones log-spaced from 40 Hz to 10 kHz so tracks are told apart on screen
+    double position = numTracks > 1 ? index / static_cast<double>(numTracks - 1) : 0.0;
+    double toneFrequency = 40.0 * std::pow(10000.0 / 40.0, position);
+    tonePhaseIncrement = juce::MathConstants<double>::twoPi * toneFrequency / sampleRate;
+    swellPhaseIncrement = juce::MathConstants<double>::twoPi * (0.1 + 0.05 * (index % 7)) / sampleRate;
+
+    if (fileAudio != nullptr && fileAudio->getNumSamples() > 0)
+        filePosition = static_cast<int>(static_cast<juce::int64>(fileAudio->getNumSamples()) * index / juce::jmax(1, numTracks));
+}
+
+bool VirtualTrack::processBlock(int numSamples, juce::OSCSender& sender)
+{
+    const juce::int64 blockTimeUs = SpectrumMessages::getMonotonicTimeMicroseconds();
+
+    block.resize(static_cast<size_t>(numSamples));
+    fillBlock(block.data(), numSamples);
+
+    // CPU accounting covers what the plugin's processBlock does: analysis and sending
+    const auto startTicks = juce::Time::getHighResolutionTicks();
+    const auto fftTicksBefore = processor.getFFTTicks();
+    const auto numFFTsBefore = processor.getNumFFTs();
+    const bool sent = analyseAndSend(numSamples, blockTimeUs, sender);
+
+    loadMeter.addBlock(juce::Time::getHighResolutionTicks() - startTicks,
+                       processor.getFFTTicks() - fftTicksBefore,
+                       processor.getNumFFTs() - numFFTsBefore,
+                       numSamples, sampleRate);
+    return sent;
+}
+
+bool VirtualTrack::analyseAndSend(int numSamples, juce::int64 blockTimeUs, juce::OSCSender& sender)
+{
+    processor.process(block.data(), numSamples);
+    samplePosition += numSamples;
+
+    if (!processor.isSpectrumReady())
+        return false;
+
+    processor.getSpectrumCodes(spectrumCodes);
+
+    SpectrumMessages::FrameHeader header;
+    header.sequence = frameSequence++;
+    header.captureTimeUs = blockTimeUs;
+    header.hostSamplePosition = samplePosition - processor.getSamplesSinceLastFrame();
+
+    if (!sender.send(SpectrumMessages::createCodedSpectrumMessage(trackId, trackName, sampleRate,
+                                                                  spectrumCodes.data(), SpectrumConstants::NUM_BINS,
+                                                                  header)))
+    {
+        ++sendFailures;
+        return false;
+    }
+
+    return true;
+}
+
+void VirtualTrack::sendHeartbeat(juce::OSCSender& sender)
+{
+    auto load = loadMeter.takeLoad();
+    if (!sender.send(SpectrumMessages::createHeartbeatMessage(trackId, trackName, sampleRate, &load)))
+        ++sendFailures;
+}
+
+void VirtualTrack::fillBlock(float* output, int numSamples)
+{
+    if (fileAudio != nullptr && fileAudio->getNumSamples() > 0)
+    {
+        // Loop the file
+        const float* source = fileAudio->getReadPointer(0);
+        const int fileLength = fileAudio->getNumSamples();
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output[i] = source[filePosition];
+            filePosition = (filePosition + 1) % fileLength;
+        }
+        return;
+    }
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float swell = 0.5f + 0.5f * static_cast<float>(std::sin(swellPhase));
+        output[i] = 0.25f * swell * static_cast<float>(std::sin(tonePhase))
+                  + 0.02f * (random.nextFloat() * 2.0f - 1.0f);
+
+        tonePhase += tonePhaseIncrement;
+        if (tonePhase >= juce::MathConstants<double>::twoPi)
+            tonePhase -= juce::MathConstants<double>::twoPi;
+
+        swellPhase += swellPhaseIncrement;
+        if (swellPhase >= juce::MathConstants<double>::twoPi)
+            swellPhase -= juce::MathConstants<double>::twoPi;
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../../SpectrumAnalyzerRelay/Source/SpectrumProcessor.h"
+#include "../../../SpectrumAnalyzerRelay/Source/ProcessingLoadMeter.h"
+#include "../../../Common/SpectrumMessages.h"
+
+/// One simulated relay instance: its own track id, SpectrumProcessor and audio
+/// source, sending the same heartbeat and spectrum messages as the plugin.
+class VirtualTrack
+{
+public:
+    /// fileAudio (mono, at sampleRate) is shared between tracks; each track starts
+    /// at a different offset. Pass nullptr for a synthetic tone-plus-noise signal.
+    VirtualTrack(int index, int numTracks, double sampleRate, const juce::AudioBuffer<float>* fileAudio);
+
+    /// Produces and analyses one host block, sending a spectrum message if an FFT
+    /// completed (as the relay's processBlock does). Returns true if one was sent.
+    bool processBlock(int numSamples, juce::OSCSender& sender);
+
+    void sendHeartbeat(juce::OSCSender& sender);
+
+    int getSendFailures() const { return sendFailures; }
+
+private:
+    void fillBlock(float* output, int numSamples);
+    bool analyseAndSend(int numSamples, juce::int64 blockTimeUs, juce::OSCSender& sender);
+
+    juce::String trackId;
+    juce::String trackName;
+    double sampleRate;
+
+    SpectrumProcessor processor;
+    ProcessingLoadMeter loadMeter;     // Reported in heartbeats, like the plugin
+    std::vector<float> block;
+    std::array<juce::uint16, SpectrumConstants::NUM_BINS> spectrumCodes;
+    juce::uint32 frameSequence { 0 };
+    juce::int64 samplePosition { 0 };  // Stands in for the host timeline
+    int sendFailures { 0 };
+
+    // File playback
+    const juce::AudioBuffer<float>* fileAudio;
+    int filePosition { 0 };
+
+    // Synthetic signal: a tone (different per track) over noise, slowly swelling
+    double tonePhase { 0.0 };
+    double tonePhaseIncrement { 0.0 };
+    double swellPhase { 0.0 };
+    double swellPhaseIncrement { 0.0 };
+    juce::Random random;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(VirtualTrack)
+};
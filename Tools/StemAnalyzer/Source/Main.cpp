@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Analyses audio files (stems) offline, without a DAW or relays, and writes
+    the spectra every relay would have sent to a session file that the
+    MultitrackSpectrumAnalyzer can open (Open Session..., or --play <file>).
+
+    Usage: StemAnalyzer [--out <file>] [--threads <n>] <audio file> [<audio file> ...]
+
+      --out      session file to write (default: analysis-<time>.wxcsession in
+                 the analyzer's sessions folder)
+      --threads  worker threads (default: one per core)
+
+    Any format juce_audio_formats reads is accepted (WAV, AIFF, FLAC, Ogg, ...).
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../../../MultitrackSpectrumAnalyzer/Source/OfflineAnalysis.h"
+#include <iostream>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    juce::ArgumentList args (argc, argv);
+
+    if (args.size() == 0 || args.containsOption ("--help|-h"))
+    {
+        std::cout << "Usage: " << args.executableName
+                  << " [--out <file>] [--threads <n>] <audio file> [<audio file> ...]" << std::endl;
+        return 0;
+    }
+
+    juce::File sessionFile;
+    OfflineAnalysis::Options options;
+    juce::Array<juce::File> files;
+
+    for (int i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+
+        if (arg == "--out" && i + 1 < args.size())
+            sessionFile = args[++i].resolveAsFile();
+        else if (arg == "--threads" && i + 1 < args.size())
+            options.numThreads = juce::jmax (0, args[++i].text.getIntValue());
+        else if (arg.isOption())
+            std::cout << "Ignoring unknown option " << arg.text << std::endl;
+        else
+            files.add (arg.resolveAsFile());
+    }
+
+    if (files.isEmpty())
+    {
+        std::cout << "No audio files given" << std::endl;
+        return 1;
+    }
+
+    if (sessionFile == juce::File())
+        sessionFile = SessionRecorder::getDefaultSessionDirectory()
+                          .getChildFile ("analysis-" + juce::Time::getCurrentTime().formatted ("%Y%m%d-%H%M%S")
+                                         + SessionRecorder::fileExtension);
+
+    std::cout << "Analysing " << files.size() << " file(s) -> " << sessionFile.getFullPathName() << std::endl;
+
+    int lastPercent = -1;
+    OfflineAnalysis analysis (files, options);
+    auto result = analysis.run (sessionFile, [&lastPercent] (double progress)
+    {
+        const int percent = juce::roundToInt (progress * 100.0);
+        if (percent / 10 != lastPercent / 10)
+            std::cout << "  " << percent << "%" << std::endl;
+        lastPercent = percent;
+        return true;
+    });
+
+    if (! result.succeeded)
+    {
+        std::cout << "Failed: " << result.error << std::endl;
+        return 1;
+    }
+
+    std::cout << result.numFiles << " file(s), " << juce::String (result.sessionSeconds, 1) << " s session, "
+              << result.framesWritten << " frames in " << juce::String (result.elapsedSeconds, 2) << " s ("
+              << juce::String (result.totalAudioSeconds / juce::jmax (result.elapsedSeconds, 0.001), 0)
+              << "x real time over all files)" << std::endl;
+    return 0;
+}